@@ -1250,5 +1250,6 @@ m4_include([m4/check_version_openmpi.m4])
 m4_include([m4/configure_amgx.m4])
 m4_include([m4/configure_cuda.m4])
 m4_include([m4/configure_doxygen.m4])
+m4_include([m4/configure_openmp.m4])
 m4_include([m4/configure_petsc.m4])
 m4_include([m4/package_utilities.m4])
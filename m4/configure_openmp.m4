@@ -0,0 +1,53 @@
+# CONFIGURE_OPENMP
+# ----------------
+# brief: Configures optional OpenMP threading of the stencil kernels.
+
+AC_DEFUN([CONFIGURE_OPENMP],[
+
+AC_ARG_ENABLE([openmp],
+              AS_HELP_STRING([--enable-openmp],
+                             [use OpenMP threads inside each MPI process]),
+              [],
+              [enable_openmp=no])
+
+if test "x$enable_openmp" != xno; then
+
+echo
+echo "==================="
+echo "Configuring OpenMP"
+echo "==================="
+
+PACKAGE_SETUP_ENVIRONMENT
+
+AC_LANG_PUSH([C++])
+OPENMP_CXXFLAGS=""
+for flag in -fopenmp -qopenmp -openmp; do
+  AC_MSG_CHECKING([whether $CXX accepts $flag])
+  OPENMP_save_CXXFLAGS=$CXXFLAGS
+  CXXFLAGS="$CXXFLAGS $flag"
+  AC_LINK_IFELSE([AC_LANG_PROGRAM([[#include <omp.h>]],
+                                  [[return omp_get_max_threads();]])],
+                 [OPENMP_CXXFLAGS=$flag])
+  CXXFLAGS=$OPENMP_save_CXXFLAGS
+  if test -n "$OPENMP_CXXFLAGS"; then
+    AC_MSG_RESULT([yes])
+    break
+  fi
+  AC_MSG_RESULT([no])
+done
+AC_LANG_POP([C++])
+
+if test -z "$OPENMP_CXXFLAGS"; then
+  AC_MSG_ERROR([could not find a flag to enable OpenMP with $CXX])
+fi
+
+PACKAGE_CXXFLAGS_APPEND($OPENMP_CXXFLAGS)
+PACKAGE_LDFLAGS_APPEND($OPENMP_CXXFLAGS)
+
+PACKAGE_RESTORE_ENVIRONMENT
+
+echo
+
+fi
+
+])
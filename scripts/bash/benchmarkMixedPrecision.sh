@@ -0,0 +1,56 @@
+#!/bin/bash
+# file: benchmarkMixedPrecision.sh
+# brief: Compares the time spent in the Poisson solver with the PETSc solver
+#        (double precision, options of the example) and with the
+#        mixed-precision solver (`pSolveType: MIXED`) on 3D examples; both
+#        runs use the GAMG preconditioner of the example. The table is also
+#        written in Markdown to `<output-directory>/results.md`.
+# usage: benchmarkMixedPrecision.sh [-n <processes>] [-t <time-steps>] [-o <output-directory>] [example ...]
+#        examples are relative to the folder `examples/3d` (default: lidDrivenCavity/Re100PeriodicX sphere/Re100)
+# note: petibm3d and mpiexec should be in the PATH.
+
+set -e
+
+PETIBM_DIR=$(cd "$(dirname "$0")/../.." && pwd)
+NPROCS=4
+NSTEPS=20
+OUTDIR=benchmarkMixedPrecision
+while getopts "n:t:o:" opt; do
+  case $opt in
+    n) NPROCS=$OPTARG ;;
+    t) NSTEPS=$OPTARG ;;
+    o) OUTDIR=$OPTARG ;;
+    *) echo "usage: $0 [-n <processes>] [-t <time-steps>] [-o <output-directory>] [example ...]"; exit 1 ;;
+  esac
+done
+shift $((OPTIND-1))
+EXAMPLES=${@:-"lidDrivenCavity/Re100PeriodicX sphere/Re100"}
+
+mkdir -p $OUTDIR
+RESULTS=$OUTDIR/results.md
+echo "$NPROCS processes, $NSTEPS time-steps" > $RESULTS
+echo "" >> $RESULTS
+echo "| example | solver | solvePoisson (s) | iterations | time/iteration (s) |" >> $RESULTS
+echo "|---|---|---|---|---|" >> $RESULTS
+printf "%-32s %-6s %16s %12s %16s\n" "example" "solver" "solvePoisson (s)" "iterations" "time/iteration"
+for example in $EXAMPLES; do
+  for solver in CPU MIXED; do
+    case=$OUTDIR/$(echo $example | tr '/' '_')_$solver
+    rm -rf $case
+    cp -r $PETIBM_DIR/examples/3d/$example $case
+    # run a few time-steps without writing the solution
+    sed -i -e "s/^\(\s*\)nt:.*/\1nt: $NSTEPS/" \
+           -e "s/^\(\s*\)nsave:.*/\1nsave: $((NSTEPS+1))/" \
+           -e "/pSolveType/d" $case/simulationParameters.yaml
+    indent=$(grep -m 1 "^\s*nt:" $case/simulationParameters.yaml | sed "s/nt:.*//")
+    echo "${indent}pSolveType: $solver" >> $case/simulationParameters.yaml
+    mpiexec -n $NPROCS petibm3d -directory $case -log_view :$case/logView.txt > $case/run.log 2>&1
+    # time of the stage `solvePoisson` and sum of the Poisson iterations
+    time=$(awk '$2 == "solvePoisson:" {print $3; exit}' $case/logView.txt)
+    iterations=$(awk -F, 'NR == 1 {for (i = 1; i <= NF; i++) if ($i == "poissonIters") c = i; next}
+                          {sum += $c} END {print sum}' $case/timeSeries.csv)
+    perIteration=$(awk -v t=$time -v i=$iterations 'BEGIN {if (i > 0) printf "%.3e", t/i; else print "-"}')
+    printf "%-32s %-6s %16s %12s %16s\n" $example $solver $time $iterations $perIteration
+    echo "| $example | $solver | $time | $iterations | $perIteration |" >> $RESULTS
+  done
+done
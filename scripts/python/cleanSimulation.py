@@ -43,7 +43,7 @@ def parse_command_line():
   parser.add_argument('--no-forces',
                       dest='forces',
                       action='store_false',
-                      help='do not remove the forces.txt')
+                      help='do not remove the time series (forces)')
   parser.add_argument('--no-vtk',
                       dest='vtk_files',
                       action='store_false',
@@ -51,7 +51,7 @@ def parse_command_line():
   parser.add_argument('--no-iters',
                       dest='iters',
                       action='store_false',
-                      help='do not remove the file iterationCounts.txt')
+                      help='do not remove the time series (iteration counts)')
   parser.add_argument('--no-tensors',
                       dest='tensors',
                       action='store_false',
@@ -91,12 +91,10 @@ def main(args):
                if folder.startswith('0')]
     for folder in folders:
       remove_folder(folder)
-  if args.forces:
-    remove_file(os.path.join(args.directory, 'forces.txt'))
+  if args.forces and args.iters:
+    remove_file(os.path.join(args.directory, 'timeSeries.csv'))
   if args.vtk_files:
     remove_folder(os.path.join(args.directory, 'vtk_files'))
-  if args.iters:
-    remove_file(os.path.join(args.directory, 'iterationCounts.txt'))
   if args.tensors:
     remove_folder(os.path.join(args.directory, 'tensors'))
 
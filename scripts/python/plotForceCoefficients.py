@@ -282,10 +282,11 @@ class Case(object):
     Reads forces from file.
     """
     print('\nReading forces ...')
-    forces_path = os.path.join(self.parameters.directory, 'forces.txt')
-    with open(forces_path, 'r') as infile:
-      data = numpy.loadtxt(infile, dtype=float).transpose()
-    t, forces = data[0], data[1:]
+    time_series_path = os.path.join(self.parameters.directory, 'timeSeries.csv')
+    data = numpy.genfromtxt(time_series_path, delimiter=',', names=True)
+    t = data['time']
+    forces = numpy.array([data[name] for name in data.dtype.names
+                          if name.startswith('body')])
     n_bodies = forces.shape[0] / self.parameters.dimensions
     # keep unique values between time-limits of consideration
     time_limits = self.parameters.time_limits
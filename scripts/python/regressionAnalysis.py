@@ -247,14 +247,15 @@ class TestCase(object):
     """
     Compares forces acting on immersed boundaries (if applicable).
     """
+    def read_forces(directory):
+      data = numpy.genfromtxt(os.path.join(directory, 'timeSeries.csv'),
+                              delimiter=',', names=True)
+      return numpy.array([data[name] for name in data.dtype.names
+                          if name == 'time' or name.startswith('body')])
+
     try:
-      os.path.join(self.directory, 'forces.txt')
-      with open(os.path.join(self.directory, 'forces.txt'), 'r') as infile:
-        forces = numpy.loadtxt(infile,
-                               dtype=float)
-      with open(os.path.join(self.reference, 'forces.txt'), 'r') as infile:
-        forces_reference = numpy.loadtxt(infile,
-                                         dtype=float)
+      forces = read_forces(self.directory)
+      forces_reference = read_forces(self.reference)
       self.compare_arrays(forces, forces_reference,
                           tag='forces')
     except:
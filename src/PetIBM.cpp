@@ -16,6 +16,10 @@
 
 #include "createSolver.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #ifndef DIMENSIONS
 #define DIMENSIONS 2
 #endif
@@ -25,6 +29,25 @@ int main(int argc,char **argv)
 {
   const PetscInt dim = DIMENSIONS;
   PetscErrorCode ierr;
+
+  ierr = MPI_Init(&argc, &argv); if (ierr) return ierr;
+  // processes set aside to write the numerical solution (with -io_servers)
+  PetscMPIInt numServers;
+  PetscBool isServer;
+  ierr = AsyncWriter::splitServers(argc, argv, numServers, isServer);
+  if (ierr)
+  {
+    MPI_Abort(MPI_COMM_WORLD, ierr);
+    return ierr;
+  }
+  if (isServer)
+  {
+    ierr = AsyncWriter::serve(numServers);
+    if (ierr)
+      MPI_Abort(MPI_COMM_WORLD, ierr);
+    ierr = MPI_Finalize();
+    return ierr;
+  }
   
   ierr = PetscInitialize(&argc, &argv, NULL, NULL); CHKERRQ(ierr);
 
@@ -39,6 +62,14 @@ int main(int argc,char **argv)
   if (found)
     directory = dir;
   ierr = PetscPrintf(PETSC_COMM_WORLD, "directory: %s\n", directory.c_str()); CHKERRQ(ierr);
+#ifdef _OPENMP
+  // number of threads set by the environment variable OMP_NUM_THREADS
+  ierr = PetscPrintf(PETSC_COMM_WORLD, "OpenMP threads per process: %d\n", omp_get_max_threads()); CHKERRQ(ierr);
+#endif
+  if (numServers > 0)
+  {
+    ierr = PetscPrintf(PETSC_COMM_WORLD, "output servers: %d\n", numServers); CHKERRQ(ierr);
+  }
 
   // read different input files
   CartesianMesh mesh(directory+"/cartesianMesh.yaml");
@@ -67,6 +98,7 @@ int main(int argc,char **argv)
   ierr = PetscPrintf(PETSC_COMM_WORLD, "\n=====================\n*** PetIBM - Done ***\n=====================\n"); CHKERRQ(ierr);
 
   ierr = PetscFinalize(); CHKERRQ(ierr);
+  ierr = MPI_Finalize();
 
-  return 0;
+  return ierr;
 } // main
\ No newline at end of file
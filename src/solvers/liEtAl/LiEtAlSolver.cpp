@@ -41,6 +41,8 @@ LiEtAlSolver<dim>::LiEtAlSolver(CartesianMesh *cartesianMesh,
   PetscLogStageRegister("RHSForces", &stageRHSForceSystem);
   PetscLogStageRegister("solveForces", &stageSolveForceSystem);
   PetscLogStageRegister("integrateForces", &stageIntegrateForces);
+  NavierStokesSolver<dim>::kernelLog.registerEvent("generateET", &eventGenerateET);
+  NavierStokesSolver<dim>::kernelLog.registerEvent("calculateForces", &eventCalculateForces);
 } // LiEtAl
 
 
@@ -54,7 +56,9 @@ PetscErrorCode LiEtAlSolver<dim>::initialize()
 
   PetscFunctionBeginUser;
 
-  ierr = PetscLogStagePush(NavierStokesSolver<dim>::stageInitialize); CHKERRQ(ierr);
+  // timeline of the stages and events (with -timeline)
+  ierr = NavierStokesSolver<dim>::tracer.initialize(NavierStokesSolver<dim>::parameters->directory); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::tracer.pushStage(NavierStokesSolver<dim>::stageInitialize); CHKERRQ(ierr);
 
   ierr = initializeBodies(); CHKERRQ(ierr);
   ierr = createDMs(); CHKERRQ(ierr);
@@ -64,7 +68,10 @@ PetscErrorCode LiEtAlSolver<dim>::initialize()
   ierr = NavierStokesSolver<dim>::initializeCommon(); CHKERRQ(ierr);
 
   ierr = NavierStokesSolver<dim>::generateGradient(&G); CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(eventGenerateET, 0, 0, 0, 0); CHKERRQ(ierr);
   ierr = generateET(); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::logMatrixAssembly(eventGenerateET, ET, 0.0); CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(eventGenerateET, 0, 0, 0, 0); CHKERRQ(ierr);
   ierr = MatTranspose(ET, MAT_INITIAL_MATRIX, &E); CHKERRQ(ierr);
   Mat BNET;
   ierr = MatDuplicate(ET, MAT_COPY_VALUES, &BNET);
@@ -82,8 +89,14 @@ PetscErrorCode LiEtAlSolver<dim>::initialize()
   rtol = NavierStokesSolver<dim>::parameters->decoupling_rtol;
   maxIters = NavierStokesSolver<dim>::parameters->decoupling_maxIters;
   printStats = NavierStokesSolver<dim>::parameters->decoupling_printStats;
+  numSubIters = 0;
+  subNorm = -1.0;
+  subRatio = -1.0;
 
-  ierr = PetscLogStagePop(); CHKERRQ(ierr);
+  ierr = createTimeSeries(); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::createProbes(); CHKERRQ(ierr);
+
+  ierr = NavierStokesSolver<dim>::tracer.popStage(); CHKERRQ(ierr);
 
   PetscFunctionReturn(0);
 } // initialize
@@ -99,8 +112,6 @@ PetscErrorCode LiEtAlSolver<dim>::stepTime()
 
   PetscFunctionBeginUser;
 
-  ierr = scatterGlobalToLocal(); CHKERRQ(ierr);
-  
   // estimation of the momentum forcing at beginning of time step
   // forceEstimator = 2: use forcing from previous time step
   if (forceEstimator == 1)
@@ -109,6 +120,7 @@ PetscErrorCode LiEtAlSolver<dim>::stepTime()
   }
   else if (forceEstimator == 3)
   {
+    ierr = forces->setHistory(0); CHKERRQ(ierr);
     ierr = assembleRHSForce(NavierStokesSolver<dim>::q); CHKERRQ(ierr);
     ierr = solveForceSystem(fTilde); CHKERRQ(ierr);
   }
@@ -124,6 +136,14 @@ PetscErrorCode LiEtAlSolver<dim>::stepTime()
   PetscReal norm = 1.0, norm_init = 1.0, ratio;
   while (norm > std::max(atol, rtol * norm_init) && iter < maxIters)
   {
+    // the initial guesses are built from (and stored in) the histories of the
+    // previous time-steps in the first sub-iteration only; the following
+    // sub-iterations start from the solutions of the previous one
+    PetscInt history = (iter == 0) ? 0 : -1;
+    ierr = NavierStokesSolver<dim>::velocity->setHistory(history); CHKERRQ(ierr);
+    ierr = NavierStokesSolver<dim>::poisson->setHistory(history); CHKERRQ(ierr);
+    ierr = forces->setHistory((iter == 0) ? 1 : -1); CHKERRQ(ierr);
+
     ierr = updateRHSVelocity(); CHKERRQ(ierr);
     ierr = NavierStokesSolver<dim>::solveIntermediateVelocity(); CHKERRQ(ierr);
 
@@ -172,6 +192,14 @@ PetscErrorCode LiEtAlSolver<dim>::stepTime()
     }
     iter++;
   }
+  numSubIters = iter;
+  ierr = NavierStokesSolver<dim>::velocity->setHistory(0); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::poisson->setHistory(0); CHKERRQ(ierr);
+  if (maxIters > 1)
+  {
+    subNorm = norm;
+    subRatio = ratio;
+  }
 
   NavierStokesSolver<dim>::timeStep++;
 
@@ -179,36 +207,6 @@ PetscErrorCode LiEtAlSolver<dim>::stepTime()
 } // stepTime
 
 
-/*!
- * \brief Scatter global flux vector into local flux vectors.
- */
-template <PetscInt dim>
-PetscErrorCode LiEtAlSolver<dim>::scatterGlobalToLocal()
-{
-  PetscErrorCode ierr;
-
-  PetscFunctionBeginUser;
-
-  if (dim == 2)
-  {
-    ierr = DMCompositeScatter(NavierStokesSolver<dim>::qPack,
-                              NavierStokesSolver<dim>::q,
-                              NavierStokesSolver<dim>::qxLocal,
-                              NavierStokesSolver<dim>::qyLocal); CHKERRQ(ierr);
-  }
-  else
-  {
-    ierr = DMCompositeScatter(NavierStokesSolver<dim>::qPack,
-                              NavierStokesSolver<dim>::q,
-                              NavierStokesSolver<dim>::qxLocal,
-                              NavierStokesSolver<dim>::qyLocal,
-                              NavierStokesSolver<dim>::qzLocal); CHKERRQ(ierr);
-  }
-
-  PetscFunctionReturn(0);
-} // scatterGlobalToLocal
-
-
 /*!
  * \brief Assembles the right hand-side of the velocity system.
  */
@@ -217,7 +215,7 @@ PetscErrorCode LiEtAlSolver<dim>::updateRHSVelocity()
 {
   PetscErrorCode ierr;
 
-  ierr = PetscLogStagePush(NavierStokesSolver<dim>::stageRHSVelocitySystem); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::tracer.pushStage(NavierStokesSolver<dim>::stageRHSVelocitySystem); CHKERRQ(ierr);
 
   if (maxIters > 1)
   {
@@ -231,7 +229,7 @@ PetscErrorCode LiEtAlSolver<dim>::updateRHSVelocity()
   ierr = VecAXPY(NavierStokesSolver<dim>::rhs1, -1.0, tmp); CHKERRQ(ierr);
   ierr = PetscObjectViewFromOptions((PetscObject) NavierStokesSolver<dim>::rhs1, NULL, "-rhs1_vec_view"); CHKERRQ(ierr);
 
-  ierr = PetscLogStagePop(); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::tracer.popStage(); CHKERRQ(ierr);
 
   return 0;
 } // updateRHSVelocity
@@ -249,13 +247,13 @@ PetscErrorCode LiEtAlSolver<dim>::assembleRHSForce(Vec q)
 
   PetscFunctionBeginUser;
 
-  ierr = PetscLogStagePush(stageRHSForceSystem); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::tracer.pushStage(stageRHSForceSystem); CHKERRQ(ierr);
 
   ierr = MatMult(E, q, rhsf);
 
   ierr = PetscObjectViewFromOptions((PetscObject) rhsf, NULL, "-rhsf_vec_view"); CHKERRQ(ierr);
 
-  ierr = PetscLogStagePop(); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::tracer.popStage(); CHKERRQ(ierr);
 
   PetscFunctionReturn(0);
 } // assembleRHSForce
@@ -273,11 +271,11 @@ PetscErrorCode LiEtAlSolver<dim>::solveForceSystem(Vec &f)
 
   PetscFunctionBeginUser;
 
-  ierr = PetscLogStagePush(stageSolveForceSystem); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::tracer.pushStage(stageSolveForceSystem); CHKERRQ(ierr);
 
   ierr = forces->solve(f, rhsf); CHKERRQ(ierr);
   
-  ierr = PetscLogStagePop(); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::tracer.popStage(); CHKERRQ(ierr);
 
   PetscFunctionReturn(0);
 } // solveForceSystem
@@ -295,7 +293,7 @@ PetscErrorCode LiEtAlSolver<dim>::updateFlux(Vec f)
 
   PetscFunctionBeginUser;
 
-  ierr = PetscLogStagePush(NavierStokesSolver<dim>::stageProjectionStep); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::tracer.pushStage(NavierStokesSolver<dim>::stageProjectionStep); CHKERRQ(ierr);
 
   ierr = MatMult(ET, f, tmp); CHKERRQ(ierr);
   ierr = VecPointwiseMult(tmp, NavierStokesSolver<dim>::BN, tmp); CHKERRQ(ierr);
@@ -314,7 +312,7 @@ PetscErrorCode LiEtAlSolver<dim>::updateFlux(Vec f)
              algorithm);
   }
 
-  ierr = PetscLogStagePop(); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::tracer.popStage(); CHKERRQ(ierr);
 
   PetscFunctionReturn(0);
 } // updateFlux
@@ -330,11 +328,11 @@ PetscErrorCode LiEtAlSolver<dim>::solvePoissonSystem(Vec &p)
 {
   PetscErrorCode ierr;
   
-  ierr = PetscLogStagePush(NavierStokesSolver<dim>::stageSolvePoissonSystem); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::tracer.pushStage(NavierStokesSolver<dim>::stageSolvePoissonSystem); CHKERRQ(ierr);
 
   ierr = NavierStokesSolver<dim>::poisson->solve(p, NavierStokesSolver<dim>::rhs2); CHKERRQ(ierr);
   
-  ierr = PetscLogStagePop(); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::tracer.popStage(); CHKERRQ(ierr);
 
   return 0;
 } // solvePoissonSystem
@@ -350,7 +348,7 @@ PetscErrorCode LiEtAlSolver<dim>::projectionStep(Vec p)
 {
   PetscErrorCode ierr;
 
-  ierr = PetscLogStagePush(NavierStokesSolver<dim>::stageProjectionStep); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::tracer.pushStage(NavierStokesSolver<dim>::stageProjectionStep); CHKERRQ(ierr);
   
   ierr = MatMult(NavierStokesSolver<dim>::BNQ, p, NavierStokesSolver<dim>::temp); CHKERRQ(ierr);
   if (algorithm == 1)
@@ -368,7 +366,7 @@ PetscErrorCode LiEtAlSolver<dim>::projectionStep(Vec p)
              algorithm);
   }
 
-  ierr = PetscLogStagePop(); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::tracer.popStage(); CHKERRQ(ierr);
 
   return 0;
 } // projectionStep
@@ -454,6 +452,7 @@ PetscErrorCode LiEtAlSolver<dim>::registerLagPointsOnProcess()
   for (auto &body : bodies)
   {
     ierr = body.registerPointsOnProcess(box); CHKERRQ(ierr);
+    ierr = body.registerPointsInCells(NavierStokesSolver<dim>::mesh); CHKERRQ(ierr);
   }
 
   PetscFunctionReturn(0);
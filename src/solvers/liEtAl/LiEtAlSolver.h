@@ -37,7 +37,8 @@ public:
   Solver *forces; ///< solver for the Lagrangian forces
 
   PetscReal bodyForces[dim]; ///< array with the force in each direction acting on the body
-  std::ofstream forcesFile;  ///< file in which to write the forces
+  PetscInt columnForces,     ///< first column of the forces acting on the bodies in the time series
+           columnSubIters;   ///< first column of the statistics of the sub-iterative process
 
   PetscInt algorithm;      ///< algo index for order of decoupling
   PetscInt forceEstimator; ///< scheme index to estimate momentum forcing
@@ -45,10 +46,15 @@ public:
             rtol;          ///< relative tolerance for sub-iterative process
   PetscInt maxIters;       ///< maximum number of iterations for sub-iterative process
   PetscBool printStats;    ///< prints L2 norm and relative L2 norm when using sub-iterative process
+  PetscInt numSubIters;    ///< number of sub-iterations at the last time step
+  PetscReal subNorm,       ///< L2 norm of the forces variation at the last sub-iteration
+            subRatio;      ///< same, relative to the L2 norm of the forces
 
   PetscLogStage stageRHSForceSystem,
                 stageSolveForceSystem,
                 stageIntegrateForces;
+  PetscLogEvent eventGenerateET,
+                eventCalculateForces;
 
   PetscErrorCode initializeBodies();
   PetscErrorCode getNumLagPoints(PetscInt &n);
@@ -68,12 +74,10 @@ public:
 
   PetscErrorCode calculateForces();
   PetscErrorCode calculateForces2();
-  PetscErrorCode writeForces();
-  PetscErrorCode writeIterationCounts();
+  PetscErrorCode createTimeSeries();
+  PetscErrorCode recordTimeSeries();
   PetscErrorCode writeLagrangianForces(std::string directory);
 
-  PetscErrorCode scatterGlobalToLocal();
-
 public:
   // constructors
   LiEtAlSolver(){ };
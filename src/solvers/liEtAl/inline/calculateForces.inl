@@ -15,6 +15,8 @@ PetscErrorCode LiEtAlSolver<dim>::calculateForces()
 
   PetscFunctionBeginUser;
 
+  ierr = PetscLogEventBegin(eventCalculateForces, 0, 0, 0, 0); CHKERRQ(ierr);
+
   // get access to the global body forces vector
   PetscReal **f;
   ierr = DMDAVecGetArrayDOF(bda, fTilde, &f); CHKERRQ(ierr);
@@ -43,8 +45,14 @@ PetscErrorCode LiEtAlSolver<dim>::calculateForces()
     ierr = MPI_Reduce(localForces, body.forces, dim, MPIU_REAL, MPI_SUM, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
     start = end;
   }
+  // one addition per local force component; the local forces are read once
+  // per body and direction
+  ierr = NavierStokesSolver<dim>::kernelLog.log(eventCalculateForces, dim*info.xm,
+                                                bodies.size()*dim*info.xm*sizeof(PetscReal)); CHKERRQ(ierr);
 
   ierr = DMDAVecRestoreArrayDOF(bda, fTilde, &f); CHKERRQ(ierr);
 
+  ierr = PetscLogEventEnd(eventCalculateForces, 0, 0, 0, 0); CHKERRQ(ierr);
+
   PetscFunctionReturn(0);
 } // calculateForces
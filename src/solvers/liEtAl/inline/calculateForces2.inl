@@ -62,7 +62,7 @@ PetscErrorCode LiEtAlSolver<2>::calculateForces2()
 
   ierr = DMCompositeRestoreAccess(qPack, tmp, &fxGlobal, &fyGlobal); CHKERRQ(ierr);
 
-  ierr = MPI_Reduce(localForces, bodyForces, 2, MPIU_REAL, MPI_SUM, 0, MPI_COMM_WORLD); CHKERRQ(ierr);
+  ierr = MPI_Reduce(localForces, bodyForces, 2, MPIU_REAL, MPI_SUM, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
 
   PetscFunctionReturn(0);
 } // calculateForces2
@@ -140,7 +140,7 @@ PetscErrorCode LiEtAlSolver<3>::calculateForces2()
 
   ierr = DMCompositeRestoreAccess(qPack, tmp, &fxGlobal, &fyGlobal, &fzGlobal); CHKERRQ(ierr);
 
-  ierr = MPI_Reduce(localForces, bodyForces, 3, MPIU_REAL, MPI_SUM, 0, MPI_COMM_WORLD); CHKERRQ(ierr);
+  ierr = MPI_Reduce(localForces, bodyForces, 3, MPIU_REAL, MPI_SUM, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
 
   PetscFunctionReturn(0);
 } // calculateForces2
@@ -26,7 +26,9 @@ PetscErrorCode LiEtAlSolver<dim>::createForceSolver()
 
   prefix = "forces_";
   options = (found) ? std::string(path) : NavierStokesSolver<dim>::parameters->directory + "/solversPetscOptions.info";
-  forces = new KSPSolver(prefix, options);
+  KSPSolver *kspForces = new KSPSolver(prefix, options);
+  ierr = kspForces->setTuningFile(NavierStokesSolver<dim>::parameters->directory + "/" + prefix + "autotuned.info"); CHKERRQ(ierr);
+  forces = kspForces;
   forces->create(EBNET);
 
   PetscFunctionReturn(0);
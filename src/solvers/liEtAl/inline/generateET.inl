@@ -22,12 +22,14 @@ PetscErrorCode LiEtAlSolver<2>::generateET()
 {
   PetscErrorCode ierr;
 
-  PetscInt i, j, l,        // loop indices
+  PetscInt i, j,           // loop indices
            m, n,           // local number of nodes along each direction
            mstart, nstart; // starting indices
   
   PetscInt localIdx, procIdx;
   PetscInt row, ET_col, pointIdx;
+  std::vector<PetscInt> neighbors; // body points whose cell is in the support of the delta function
+  PetscInt numDeltas = 0; // number of evaluations of the delta function
   
   PetscReal value; // to hold the value of the discrete delta function
   PetscReal source[2], // source point, center of the domain of influence
@@ -60,9 +62,12 @@ PetscErrorCode LiEtAlSolver<2>::generateET()
   fLocalSize = fEnd-fStart;
 
   // determine nnz row by row
-  localIdx = 0;
+  PetscInt rowOffset = 0;
   // rows corresponding to fluxes in x-direction
   ierr = DMDAGetCorners(uda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
+  // set by the threads that fail to get the neighboring body points
+  int notFound = 0;
+#pragma omp parallel for private(i, localIdx, hx, hy, target, maxDisp, neighbors, pointIdx, source, disp, ET_col) reduction(||:notFound)
   for (j=nstart; j<nstart+n; j++)
   {
     hy = mesh->dy[j];
@@ -70,6 +75,7 @@ PetscErrorCode LiEtAlSolver<2>::generateET()
     maxDisp[1] = 1.5*hy;
     for (i=mstart; i<mstart+m; i++)
     {
+      localIdx = rowOffset + (j-nstart)*m + (i-mstart);
       ET_d_nnz[localIdx] = 0;
       ET_o_nnz[localIdx] = 0;
       hx = mesh->dx[i];
@@ -78,7 +84,9 @@ PetscErrorCode LiEtAlSolver<2>::generateET()
       // ET portion
       for (auto &body : bodies)
       { 
-        for (l=0; l<body.numPoints; l++)
+        if (!body.findNeighborPoints(mesh, target, maxDisp, bTypes, neighbors))
+          notFound = 1;
+        for (auto l : neighbors)
         {
           pointIdx = body.idxPointsOnProcess[l];
           source[0] = body.X[pointIdx];
@@ -90,11 +98,17 @@ PetscErrorCode LiEtAlSolver<2>::generateET()
           }
         }
       }
-      localIdx++;
     }
   }
+  rowOffset += m*n;
+  if (notFound)
+  {
+    SETERRQ(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Cannot get the body points near the fluxes");
+  }
   // rows corresponding to fluxes in y-direction
   ierr = DMDAGetCorners(vda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
+  notFound = 0;
+#pragma omp parallel for private(i, localIdx, hx, hy, target, maxDisp, neighbors, pointIdx, source, disp, ET_col) reduction(||:notFound)
   for (j=nstart; j<nstart+n; j++)
   {
     hy = mesh->dy[j];
@@ -102,6 +116,7 @@ PetscErrorCode LiEtAlSolver<2>::generateET()
     maxDisp[1] = 1.5*hy;
     for (i=mstart; i<mstart+m; i++)
     {
+      localIdx = rowOffset + (j-nstart)*m + (i-mstart);
       ET_d_nnz[localIdx] = 0;
       ET_o_nnz[localIdx] = 0;
       hx = mesh->dx[i];
@@ -110,7 +125,9 @@ PetscErrorCode LiEtAlSolver<2>::generateET()
       // ET portion
       for (auto &body : bodies)
       { 
-        for (l=0; l<body.numPoints; l++)
+        if (!body.findNeighborPoints(mesh, target, maxDisp, bTypes, neighbors))
+          notFound = 1;
+        for (auto l : neighbors)
         {
           pointIdx = body.idxPointsOnProcess[l];
           source[0] = body.X[pointIdx];
@@ -122,9 +139,13 @@ PetscErrorCode LiEtAlSolver<2>::generateET()
           }
         }
       }
-      localIdx++;
     }
   }
+  rowOffset += m*n;
+  if (notFound)
+  {
+    SETERRQ(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Cannot get the body points near the fluxes");
+  }
 
   // allocate memory for matrix ET
   ierr = MatCreate(PETSC_COMM_WORLD, &ET); CHKERRQ(ierr);
@@ -156,7 +177,8 @@ PetscErrorCode LiEtAlSolver<2>::generateET()
       // ET portion
       for (auto &body : bodies)
       { 
-        for (l=0; l<body.numPoints; l++)
+        ierr = body.getNeighborPoints(mesh, target, maxDisp, bTypes, neighbors); CHKERRQ(ierr);
+        for (auto l : neighbors)
         {
           pointIdx = body.idxPointsOnProcess[l];
           source[0] = body.X[pointIdx];
@@ -165,6 +187,7 @@ PetscErrorCode LiEtAlSolver<2>::generateET()
           {
             ET_col = body.globalIdxPoints[l];
             value = hx*delta(disp[0], disp[1], hx, hy);
+            numDeltas++;
             ierr = MatSetValue(ET, row, ET_col, value, INSERT_VALUES); CHKERRQ(ierr);
           }
         }
@@ -188,7 +211,8 @@ PetscErrorCode LiEtAlSolver<2>::generateET()
       // ET portion
       for (auto &body : bodies)
       { 
-        for (l=0; l<body.numPoints; l++)
+        ierr = body.getNeighborPoints(mesh, target, maxDisp, bTypes, neighbors); CHKERRQ(ierr);
+        for (auto l : neighbors)
         {
           pointIdx = body.idxPointsOnProcess[l];
           source[0] = body.X[pointIdx];
@@ -197,6 +221,7 @@ PetscErrorCode LiEtAlSolver<2>::generateET()
           {
             ET_col = body.globalIdxPoints[l] + 1;
             value = hy*delta(disp[0], disp[1], hx, hy);
+            numDeltas++;
             ierr = MatSetValue(ET, row, ET_col, value, INSERT_VALUES); CHKERRQ(ierr);
           }
         }
@@ -210,6 +235,10 @@ PetscErrorCode LiEtAlSolver<2>::generateET()
 
   ierr = PetscObjectViewFromOptions((PetscObject) ET, NULL, "-ET_mat_view"); CHKERRQ(ierr);
 
+  // evaluations of the delta function (the bytes are logged with the event
+  // by `initialize`)
+  ierr = kernelLog.log(eventGenerateET, numDeltas*(2*dhRomaFlops+2), 0.0); CHKERRQ(ierr);
+
   PetscFunctionReturn(0);
 } // generateET
 
@@ -220,12 +249,14 @@ PetscErrorCode LiEtAlSolver<3>::generateET()
 {
   PetscErrorCode ierr;
 
-  PetscInt i, j, k, l,             // loop indices
+  PetscInt i, j, k,                // loop indices
            m, n, p,                // local number of nodes along each direction
            mstart, nstart, pstart; // starting indices
 
   PetscInt localIdx, procIdx;
   PetscInt row, ET_col, pointIdx;
+  std::vector<PetscInt> neighbors; // body points whose cell is in the support of the delta function
+  PetscInt numDeltas = 0; // number of evaluations of the delta function
   PetscReal value;
   
   PetscReal source[3], target[3];
@@ -258,9 +289,12 @@ PetscErrorCode LiEtAlSolver<3>::generateET()
   fLocalSize = fEnd-fStart;
 
   // determine nnz row by row
-  localIdx = 0;
+  PetscInt rowOffset = 0;
   // rows corresponding to fluxes in x-direction
   ierr = DMDAGetCorners(uda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
+  // set by the threads that fail to get the neighboring body points
+  int notFound = 0;
+#pragma omp parallel for private(i, j, localIdx, hx, hy, hz, target, maxDisp, neighbors, pointIdx, source, disp, ET_col) reduction(||:notFound)
   for (k=pstart; k<pstart+p; k++)
   {
     hz = mesh->dz[k];
@@ -273,6 +307,7 @@ PetscErrorCode LiEtAlSolver<3>::generateET()
       maxDisp[1] = 1.5*hy;
       for (i=mstart; i<mstart+m; i++)
       {
+        localIdx = rowOffset + ((k-pstart)*n + (j-nstart))*m + (i-mstart);
         ET_d_nnz[localIdx] = 0;
         ET_o_nnz[localIdx] = 0;
         hx = mesh->dx[i];
@@ -281,7 +316,9 @@ PetscErrorCode LiEtAlSolver<3>::generateET()
         // ET portion
         for (auto &body : bodies)
         { 
-          for (l=0; l<body.numPoints; l++)
+          if (!body.findNeighborPoints(mesh, target, maxDisp, bTypes, neighbors))
+            notFound = 1;
+          for (auto l : neighbors)
           {
             pointIdx = body.idxPointsOnProcess[l];
             source[0] = body.X[pointIdx];
@@ -294,12 +331,18 @@ PetscErrorCode LiEtAlSolver<3>::generateET()
             }
           }
         }
-        localIdx++;
       }
     }
   }
+  rowOffset += m*n*p;
+  if (notFound)
+  {
+    SETERRQ(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Cannot get the body points near the fluxes");
+  }
   // rows corresponding to fluxes in y-direction
   ierr = DMDAGetCorners(vda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
+  notFound = 0;
+#pragma omp parallel for private(i, j, localIdx, hx, hy, hz, target, maxDisp, neighbors, pointIdx, source, disp, ET_col) reduction(||:notFound)
   for (k=pstart; k<pstart+p; k++)
   {
     hz = mesh->dz[k];
@@ -312,6 +355,7 @@ PetscErrorCode LiEtAlSolver<3>::generateET()
       maxDisp[1] = 1.5*hy;
       for (i=mstart; i<mstart+m; i++)
       {
+        localIdx = rowOffset + ((k-pstart)*n + (j-nstart))*m + (i-mstart);
         ET_d_nnz[localIdx] = 0;
         ET_o_nnz[localIdx] = 0;
         hx = mesh->dx[i];
@@ -320,7 +364,9 @@ PetscErrorCode LiEtAlSolver<3>::generateET()
         // ET portion
         for (auto &body : bodies)
         { 
-          for (l=0; l<body.numPoints; l++)
+          if (!body.findNeighborPoints(mesh, target, maxDisp, bTypes, neighbors))
+            notFound = 1;
+          for (auto l : neighbors)
           {
             pointIdx = body.idxPointsOnProcess[l];
             source[0] = body.X[pointIdx];
@@ -333,12 +379,18 @@ PetscErrorCode LiEtAlSolver<3>::generateET()
             }
           }
         }
-        localIdx++;
       }
     }
   }
+  rowOffset += m*n*p;
+  if (notFound)
+  {
+    SETERRQ(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Cannot get the body points near the fluxes");
+  }
   // rows corresponding to fluxes in z-direction
   ierr = DMDAGetCorners(wda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
+  notFound = 0;
+#pragma omp parallel for private(i, j, localIdx, hx, hy, hz, target, maxDisp, neighbors, pointIdx, source, disp, ET_col) reduction(||:notFound)
   for (k=pstart; k<pstart+p; k++)
   {
     hz = mesh->dz[k];
@@ -351,6 +403,7 @@ PetscErrorCode LiEtAlSolver<3>::generateET()
       maxDisp[1] = 1.5*hy;
       for (i=mstart; i<mstart+m; i++)
       {
+        localIdx = rowOffset + ((k-pstart)*n + (j-nstart))*m + (i-mstart);
         ET_d_nnz[localIdx] = 0;
         ET_o_nnz[localIdx] = 0;
         hx = mesh->dx[i];
@@ -359,7 +412,9 @@ PetscErrorCode LiEtAlSolver<3>::generateET()
         // ET portion
         for (auto &body : bodies)
         { 
-          for (l=0; l<body.numPoints; l++)
+          if (!body.findNeighborPoints(mesh, target, maxDisp, bTypes, neighbors))
+            notFound = 1;
+          for (auto l : neighbors)
           {
             pointIdx = body.idxPointsOnProcess[l];
             source[0] = body.X[pointIdx];
@@ -372,10 +427,14 @@ PetscErrorCode LiEtAlSolver<3>::generateET()
             }
           }
         }
-        localIdx++;
       }
     }
   }
+  rowOffset += m*n*p;
+  if (notFound)
+  {
+    SETERRQ(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Cannot get the body points near the fluxes");
+  }
   
   // allocate memory for matrix ET
   ierr = MatCreate(PETSC_COMM_WORLD, &ET); CHKERRQ(ierr);
@@ -412,7 +471,8 @@ PetscErrorCode LiEtAlSolver<3>::generateET()
         // ET portion
         for (auto &body : bodies)
         { 
-          for (l=0; l<body.numPoints; l++)
+          ierr = body.getNeighborPoints(mesh, target, maxDisp, bTypes, neighbors); CHKERRQ(ierr);
+          for (auto l : neighbors)
           {
             pointIdx = body.idxPointsOnProcess[l];
             source[0] = body.X[pointIdx];
@@ -422,6 +482,7 @@ PetscErrorCode LiEtAlSolver<3>::generateET()
             {
               ET_col = body.globalIdxPoints[l];
               value = hx*delta(disp[0], disp[1], disp[2], hx, hy, hz);
+              numDeltas++;
               ierr = MatSetValue(ET, row, ET_col, value, INSERT_VALUES); CHKERRQ(ierr);
             }
           }
@@ -451,7 +512,8 @@ PetscErrorCode LiEtAlSolver<3>::generateET()
         // ET portion
         for (auto &body : bodies)
         { 
-          for (l=0; l<body.numPoints; l++)
+          ierr = body.getNeighborPoints(mesh, target, maxDisp, bTypes, neighbors); CHKERRQ(ierr);
+          for (auto l : neighbors)
           {
             pointIdx = body.idxPointsOnProcess[l];
             source[0] = body.X[pointIdx];
@@ -461,6 +523,7 @@ PetscErrorCode LiEtAlSolver<3>::generateET()
             {
               ET_col = body.globalIdxPoints[l] + 1;
               value = hy*delta(disp[0], disp[1], disp[2], hx, hy, hz);
+              numDeltas++;
               ierr = MatSetValue(ET, row, ET_col, value, INSERT_VALUES); CHKERRQ(ierr);
             }
           }
@@ -490,7 +553,8 @@ PetscErrorCode LiEtAlSolver<3>::generateET()
         // ET portion
         for (auto &body : bodies)
         { 
-          for (l=0; l<body.numPoints; l++)
+          ierr = body.getNeighborPoints(mesh, target, maxDisp, bTypes, neighbors); CHKERRQ(ierr);
+          for (auto l : neighbors)
           {
             pointIdx = body.idxPointsOnProcess[l];
             source[0] = body.X[pointIdx];
@@ -500,6 +564,7 @@ PetscErrorCode LiEtAlSolver<3>::generateET()
             {
               ET_col = body.globalIdxPoints[l] + 2;
               value = hz*delta(disp[0], disp[1], disp[2], hx, hy, hz);
+              numDeltas++;
               ierr = MatSetValue(ET, row, ET_col, value, INSERT_VALUES); CHKERRQ(ierr);
             }
           }
@@ -514,5 +579,9 @@ PetscErrorCode LiEtAlSolver<3>::generateET()
 
   ierr = PetscObjectViewFromOptions((PetscObject) ET, NULL, "-ET_mat_view"); CHKERRQ(ierr);
 
+  // evaluations of the delta function (the bytes are logged with the event
+  // by `initialize`)
+  ierr = kernelLog.log(eventGenerateET, numDeltas*(3*dhRomaFlops+3), 0.0); CHKERRQ(ierr);
+
   PetscFunctionReturn(0);
 } // generateET
@@ -13,14 +13,11 @@ PetscErrorCode LiEtAlSolver<dim>::writeData()
 
   PetscFunctionBeginUser;
 
-  ierr = PetscLogStagePush(stageIntegrateForces); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::tracer.pushStage(stageIntegrateForces); CHKERRQ(ierr);
   ierr = calculateForces(); CHKERRQ(ierr);
   // ierr = calculateForces2(); CHKERRQ(ierr);
-  ierr = PetscLogStagePop();
-  ierr = PetscLogStagePush(NavierStokesSolver<dim>::stageWriteData); CHKERRQ(ierr);
-  ierr = writeForces(); CHKERRQ(ierr);
-
-  ierr = writeIterationCounts(); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::tracer.popStage();
+  ierr = NavierStokesSolver<dim>::tracer.pushStage(NavierStokesSolver<dim>::stageWriteData); CHKERRQ(ierr);
 
   if (NavierStokesSolver<dim>::timeStep%NavierStokesSolver<dim>::parameters->nsave == 0 ||
       NavierStokesSolver<dim>::timeStep%NavierStokesSolver<dim>::parameters->nrestart == 0)
@@ -34,6 +31,7 @@ PetscErrorCode LiEtAlSolver<dim>::writeData()
     ss << NavierStokesSolver<dim>::parameters->directory << "/" << std::setfill('0') << std::setw(7) << NavierStokesSolver<dim>::timeStep;
     std::string solutionDirectory = ss.str();
     mkdir(solutionDirectory.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+    ierr = NavierStokesSolver<dim>::openSolutionFile(solutionDirectory, FILE_MODE_WRITE); CHKERRQ(ierr);
 
     if (NavierStokesSolver<dim>::parameters->outputFlux)
     {
@@ -49,10 +47,19 @@ PetscErrorCode LiEtAlSolver<dim>::writeData()
       ierr = NavierStokesSolver<dim>::writeConvectiveTerms(solutionDirectory); CHKERRQ(ierr);
     }
     ierr = writeLagrangianForces(solutionDirectory); CHKERRQ(ierr);
+    ierr = NavierStokesSolver<dim>::closeSolutionFile(); CHKERRQ(ierr);
+    // the staged fields are written in the background
+    ierr = NavierStokesSolver<dim>::asyncWriter.commit(); CHKERRQ(ierr);
+    // the fields written in HDF5 files are added to the XDMF files
+    ierr = NavierStokesSolver<dim>::xdmf.writeSnapshot(NavierStokesSolver<dim>::timeStep,
+                                                       NavierStokesSolver<dim>::timeStep*NavierStokesSolver<dim>::parameters->dt); CHKERRQ(ierr);
 
     ierr = PetscPrintf(PETSC_COMM_WORLD, "done\n"); CHKERRQ(ierr);
   }
-  ierr = PetscLogStagePop(); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::tracer.popStage(); CHKERRQ(ierr);
+
+  ierr = NavierStokesSolver<dim>::writeProbes(); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::writeTimeSeries(); CHKERRQ(ierr);
 
   PetscFunctionReturn(0);
 } // writeData
@@ -68,117 +75,75 @@ template <PetscInt dim>
 PetscErrorCode LiEtAlSolver<dim>::writeLagrangianForces(std::string directory)
 {
   PetscErrorCode ierr;
-  PetscViewer viewer;
-  PetscViewerType viewerType;
-  std::string filePath, fileExtension;
 
   PetscFunctionBeginUser;
 
-  if (NavierStokesSolver<dim>::parameters->outputFormat == "hdf5")
-  {
-    viewerType = PETSCVIEWERHDF5;
-    fileExtension = "h5";
-  }
-  else if (NavierStokesSolver<dim>::parameters->outputFormat == "binary")
-  {
-    viewerType = PETSCVIEWERBINARY;
-    fileExtension = "dat";
-  }
-
   // write body forces
-  filePath = directory + "/fTilde." + fileExtension;
-  ierr = PetscObjectSetName((PetscObject) fTilde, "fTilde"); CHKERRQ(ierr);
-  ierr = PetscViewerCreate(PETSC_COMM_WORLD, &viewer); CHKERRQ(ierr); 
-  ierr = PetscViewerSetType(viewer, viewerType); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetMode(viewer, FILE_MODE_WRITE); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetName(viewer, filePath.c_str()); CHKERRQ(ierr);
-  ierr = VecView(fTilde, viewer); CHKERRQ(ierr);
-  ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::viewField(fTilde, "fTilde", directory); CHKERRQ(ierr);
 
   PetscFunctionReturn(0);
 } // writeLambda
 
 
 /*!
- * \brief Writes the iteration count for each KSP solver into a file.
+ * \brief Adds the columns of the time series specific to the decoupled method:
+ *        the wall-times of its stages, the statistics of the force solver,
+ *        of the sub-iterative process and the force in each direction acting
+ *        on each body.
  */
 template <PetscInt dim>
-PetscErrorCode LiEtAlSolver<dim>::writeIterationCounts()
+PetscErrorCode LiEtAlSolver<dim>::createTimeSeries()
 {
   PetscErrorCode ierr;
 
   PetscFunctionBeginUser;
 
-  PetscMPIInt rank;
-  ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
-
-  if (rank == 0)
+  ierr = NavierStokesSolver<dim>::createTimeSeries(); CHKERRQ(ierr);
+  TimeSeries &timeSeries = NavierStokesSolver<dim>::timeSeries;
+  ierr = timeSeries.addStage("RHSForces", stageRHSForceSystem); CHKERRQ(ierr);
+  ierr = timeSeries.addStage("solveForces", stageSolveForceSystem); CHKERRQ(ierr);
+  ierr = timeSeries.addStage("integrateForces", stageIntegrateForces); CHKERRQ(ierr);
+  ierr = timeSeries.addSolver("forces", forces); CHKERRQ(ierr);
+  columnSubIters = timeSeries.addColumn("subIters");
+  timeSeries.addColumn("subForcesVariation");
+  timeSeries.addColumn("subForcesRelativeVariation");
+  const char *directions[3] = {"x", "y", "z"};
+  for (PetscInt bIdx=0; bIdx<numBodies; bIdx++)
   {
-    PetscInt countVelocitySolver,
-             countPoissonSolver,
-             countForceSolver;
-    std::string filePath = NavierStokesSolver<dim>::parameters->directory + "/iterationCounts.txt";
-    if (NavierStokesSolver<dim>::timeStep == 1)
+    for (PetscInt d=0; d<dim; d++)
     {
-      NavierStokesSolver<dim>::iterationCountsFile.open(filePath.c_str());
+      std::stringstream ss;
+      ss << "body" << bIdx << "_f" << directions[d];
+      PetscInt column = timeSeries.addColumn(ss.str());
+      if (bIdx == 0 && d == 0)
+        columnForces = column;
     }
-    else
-    {
-      NavierStokesSolver<dim>::iterationCountsFile.open(filePath.c_str(), std::ios::out | std::ios::app);
-    }
-    ierr = NavierStokesSolver<dim>::velocity->getIters(countVelocitySolver); CHKERRQ(ierr);
-    ierr = NavierStokesSolver<dim>::poisson->getIters(countPoissonSolver); CHKERRQ(ierr);
-    ierr = forces->getIters(countForceSolver); CHKERRQ(ierr);
-    NavierStokesSolver<dim>::iterationCountsFile << NavierStokesSolver<dim>::timeStep << '\t' \
-                                                 << countVelocitySolver << '\t' \
-                                                 << countPoissonSolver << '\t' \
-                                                 << countForceSolver << std::endl;
-    NavierStokesSolver<dim>::iterationCountsFile.close();
   }
 
   PetscFunctionReturn(0);
-} // writeIterationCounts
+} // createTimeSeries
 
 
 /*!
- * \brief Writes force in each direction acting on the body.
+ * \brief Sets the statistics of the sub-iterative process and the force in
+ *        each direction acting on each body.
  */
 template <PetscInt dim>
-PetscErrorCode LiEtAlSolver<dim>::writeForces()
+PetscErrorCode LiEtAlSolver<dim>::recordTimeSeries()
 {
-  PetscErrorCode ierr;
-
   PetscFunctionBeginUser;
 
-  PetscMPIInt rank;
-  ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
-
-  if (rank == 0)
+  TimeSeries &timeSeries = NavierStokesSolver<dim>::timeSeries;
+  timeSeries.set(columnSubIters, numSubIters);
+  timeSeries.set(columnSubIters+1, subNorm);
+  timeSeries.set(columnSubIters+2, subRatio);
+  for (PetscInt bIdx=0; bIdx<numBodies; bIdx++)
   {
-    std::string filePath = NavierStokesSolver<dim>::parameters->directory + "/forces.txt";
-    if (NavierStokesSolver<dim>::timeStep == 1)
-    {
-      forcesFile.open(filePath.c_str());
-    }
-    else
-    {
-      forcesFile.open(filePath.c_str(), std::ios::out | std::ios::app);
-    }
-    forcesFile << NavierStokesSolver<dim>::timeStep*NavierStokesSolver<dim>::parameters->dt;
-    for (PetscInt bIdx=0; bIdx<numBodies; bIdx++)
+    for (PetscInt d=0; d<dim; d++)
     {
-      for (PetscInt d=0; d<dim; d++)
-      {
-        forcesFile << '\t' << bodies[bIdx].forces[d];
-      }
+      timeSeries.set(columnForces + bIdx*dim + d, bodies[bIdx].forces[d]);
     }
-    // for (PetscInt d=0; d<dim; d++)
-    // {
-    //   forcesFile << '\t' << bodyForces[d];
-    // }
-    forcesFile << std::endl;
-    forcesFile.close();
   }
 
   PetscFunctionReturn(0);
-} // writeForces
+} // recordTimeSeries
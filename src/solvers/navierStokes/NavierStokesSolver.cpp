@@ -11,6 +11,7 @@
 #include <sstream>
 #include <string>
 #include <iomanip>
+#include <algorithm>
 #include <sys/stat.h>
 
 #include <petscdmcomposite.h>
@@ -69,6 +70,20 @@ NavierStokesSolver<dim>::NavierStokesSolver(CartesianMesh *cartesianMesh,
   BN = PETSC_NULL;
   RInv = PETSC_NULL;
   MHat = PETSC_NULL;
+  // matrix-free operator
+  qxWork = PETSC_NULL;
+  qyWork = PETSC_NULL;
+  qzWork = PETSC_NULL;
+  RInvq = PETSC_NULL;
+  ADiagonal = PETSC_NULL;
+  selectedExplicitTermsKernel = NULL;
+  selectedMultAKernel = NULL;
+  // split-phase exchange of the ghost points
+  qxGlobal = PETSC_NULL;
+  qyGlobal = PETSC_NULL;
+  qzGlobal = PETSC_NULL;
+  // file of the numerical solution
+  solutionViewer = PETSC_NULL;
   // solvers
   velocity = PETSC_NULL;
   poisson = PETSC_NULL;
@@ -80,6 +95,20 @@ NavierStokesSolver<dim>::NavierStokesSolver(CartesianMesh *cartesianMesh,
   PetscLogStageRegister("solvePoisson", &stageSolvePoissonSystem);
   PetscLogStageRegister("projectionStep", &stageProjectionStep);
   PetscLogStageRegister("writeData", &stageWriteData);
+  // PetscLogEvents (communication exposed or overlapped by computation)
+  PetscLogEventRegister("exchangeGhostsBegin", 0, &eventExchangeGhostsBegin);
+  PetscLogEventRegister("explicitTermsOverlap", 0, &eventExplicitTermsOverlap);
+  PetscLogEventRegister("exchangeGhostsEnd", 0, &eventExchangeGhostsEnd);
+  // PetscLogEvents of the kernels (operations and bytes moved, see `-log_kernels`)
+  kernelLog.registerEvent("explicitTerms", &eventExplicitTerms);
+  kernelLog.registerEvent("updateBoundaryGhosts", &eventUpdateBoundaryGhosts);
+  kernelLog.registerEvent("generateBC1", &eventGenerateBC1);
+  kernelLog.registerEvent("generateR2", &eventGenerateR2);
+  kernelLog.registerEvent("multA", &eventMultA);
+  kernelLog.registerEvent("generateDiagonalMatrices", &eventGenerateDiagonalMatrices);
+  kernelLog.registerEvent("generateA", &eventGenerateA);
+  kernelLog.registerEvent("generateBNQ", &eventGenerateBNQ);
+  kernelLog.registerEvent("generateQTBNQ", &eventGenerateQTBNQ);
 } // NavierStokesSolver
 
 
@@ -91,13 +120,17 @@ PetscErrorCode NavierStokesSolver<dim>::initialize()
 {
   PetscErrorCode ierr;
 
-  ierr = PetscLogStagePush(stageInitialize); CHKERRQ(ierr);
+  // timeline of the stages and events (with -timeline)
+  ierr = tracer.initialize(parameters->directory); CHKERRQ(ierr);
+  ierr = tracer.pushStage(stageInitialize); CHKERRQ(ierr);
   
   ierr = createDMs(); CHKERRQ(ierr);
   ierr = createVecs(); CHKERRQ(ierr);
   ierr = initializeCommon(); CHKERRQ(ierr);
+  ierr = createTimeSeries(); CHKERRQ(ierr);
+  ierr = createProbes(); CHKERRQ(ierr);
   
-  ierr = PetscLogStagePop(); CHKERRQ(ierr);
+  ierr = tracer.popStage(); CHKERRQ(ierr);
 
   return 0;
 } // initialize
@@ -119,13 +152,44 @@ PetscErrorCode NavierStokesSolver<dim>::initializeCommon()
     ierr = writeGrids(); CHKERRQ(ierr);
   }
 #endif
+  // background thread (`outputAsync: true`) or output servers (-io_servers)
+  if (AsyncWriter::hasServers() && parameters->outputFormat != "binary")
+  {
+    SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_SUP, "The output servers (-io_servers) write `outputFormat: binary` only");
+  }
+  ierr = asyncWriter.initialize(parameters->outputAsync, parameters->outputAsyncBuffers); CHKERRQ(ierr);
 
   ierr = createLocalToGlobalMappingsFluxes(); CHKERRQ(ierr);
   ierr = createLocalToGlobalMappingsLambda(); CHKERRQ(ierr);
 
+  ierr = generateMetrics(); CHKERRQ(ierr);
+  ierr = generateHaloFreeBox(); CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(eventGenerateDiagonalMatrices, 0, 0, 0, 0); CHKERRQ(ierr);
   ierr = generateDiagonalMatrices(); CHKERRQ(ierr);
-  ierr = generateA(); CHKERRQ(ierr);
+  {
+    // a few operations for each of the diagonal entries of MHat, RInv and BN
+    PetscInt qLocalSize;
+    ierr = VecGetLocalSize(q, &qLocalSize); CHKERRQ(ierr);
+    ierr = kernelLog.log(eventGenerateDiagonalMatrices, (dim+3)*qLocalSize, 3*qLocalSize*sizeof(PetscReal)); CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(eventGenerateDiagonalMatrices, 0, 0, 0, 0); CHKERRQ(ierr);
+  if (parameters->vMatrixFree)
+  {
+    ierr = generateAShell(); CHKERRQ(ierr);
+  }
+  else
+  {
+    ierr = PetscLogEventBegin(eventGenerateA, 0, 0, 0, 0); CHKERRQ(ierr);
+    ierr = generateA(); CHKERRQ(ierr);
+    // coefficients of the Laplacian (3 operations each)
+    ierr = logMatrixAssembly(eventGenerateA, A, 3.0); CHKERRQ(ierr);
+    ierr = PetscLogEventEnd(eventGenerateA, 0, 0, 0, 0); CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventBegin(eventGenerateBNQ, 0, 0, 0, 0); CHKERRQ(ierr);
   ierr = generateBNQ(); CHKERRQ(ierr);
+  // product of the gradient by BN (the delta functions are logged by the derived classes)
+  ierr = logMatrixAssembly(eventGenerateBNQ, BNQ, 1.0); CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(eventGenerateBNQ, 0, 0, 0, 0); CHKERRQ(ierr);
   ierr = generateQTBNQ(); CHKERRQ(ierr);
   ierr = createSolvers(); CHKERRQ(ierr);
 
@@ -162,15 +226,6 @@ PetscErrorCode NavierStokesSolver<dim>::stepTime()
 {
   PetscErrorCode ierr;
 
-  if (dim == 2)
-  {
-    ierr = DMCompositeScatter(qPack, q, qxLocal, qyLocal); CHKERRQ(ierr);
-  }
-  else
-  {
-    ierr = DMCompositeScatter(qPack, q, qxLocal, qyLocal, qzLocal); CHKERRQ(ierr);
-  }
-
   // solve system for intermediate velocity
   ierr = assembleRHSVelocity(); CHKERRQ(ierr);
   ierr = solveIntermediateVelocity(); CHKERRQ(ierr);
@@ -193,27 +248,212 @@ PetscErrorCode NavierStokesSolver<dim>::stepTime()
 
 /**
  * \brief Assembles the right hand-side of the velocity system.
+ *
+ * The explicit terms are written, already scaled by \f$ \hat{M} \f$, into the
+ * right-hand side in a single sweep; the boundary contributions are then added
+ * to the rows adjacent to the boundaries only.
+ * This is equivalent to \f$ rhs_1 = \hat{M} (r^n + bc_1) \f$ without
+ * streaming the intermediate vectors `rn` and `bc1`.
+ *
+ * The ghost points of the local flux vectors are exchanged while the explicit
+ * terms are computed at the points whose stencils do not involve them; the
+ * remaining points are computed once the exchange is complete.
+ * The events `exchangeGhostsEnd` (exposed communication) and
+ * `explicitTermsOverlap` (computation hiding the communication) of the stage
+ * `RHSVelocity` report how much of the exchange is overlapped.
  */
 template <PetscInt dim>
 PetscErrorCode NavierStokesSolver<dim>::assembleRHSVelocity()
 {
   PetscErrorCode ierr;
 
-  ierr = PetscLogStagePush(stageRHSVelocitySystem); CHKERRQ(ierr);
+  ierr = tracer.pushStage(stageRHSVelocitySystem); CHKERRQ(ierr);
 
-  ierr = calculateExplicitTerms(); CHKERRQ(ierr);
+  // explicit terms use the boundary ghosts of the previous time-step
+  ierr = startGhostExchange(); CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(eventExplicitTermsOverlap, 0, 0, 0, 0); CHKERRQ(ierr);
+  ierr = calculateExplicitTerms(rhs1, PETSC_TRUE, HALO_FREE); CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(eventExplicitTermsOverlap, 0, 0, 0, 0); CHKERRQ(ierr);
+  ierr = finishGhostExchange(); CHKERRQ(ierr);
+  ierr = calculateExplicitTerms(rhs1, PETSC_TRUE, HALO_ADJACENT); CHKERRQ(ierr);
   ierr = updateBoundaryGhosts(); CHKERRQ(ierr);
-  ierr = generateBC1(); CHKERRQ(ierr);
-  ierr = VecWAXPY(rhs1, 1.0, rn, bc1); CHKERRQ(ierr);
-  ierr = VecPointwiseMult(rhs1, MHat, rhs1); CHKERRQ(ierr);
+  ierr = generateBC1(rhs1, PETSC_TRUE); CHKERRQ(ierr);
   ierr = PetscObjectViewFromOptions((PetscObject) rhs1, NULL, "-rhs1_vec_view"); CHKERRQ(ierr);
 
-  ierr = PetscLogStagePop(); CHKERRQ(ierr);
+  ierr = tracer.popStage(); CHKERRQ(ierr);
 
   return 0;
 } // assembleRHSVelocity
 
 
+/**
+ * \brief Computes the box of points whose stencils involve no ghost point.
+ *
+ * The box is common to all flux components: it is the intersection of the
+ * points owned by the process for each component, shrunk by one point in
+ * every direction. Its points are away from the domain boundaries.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::generateHaloFreeBox()
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  DM das[3] = {uda, vda, wda};
+  PetscInt start[3] = {0, 0, 0},
+           size[3] = {1, 1, 1};
+  for (PetscInt d=0; d<3; d++)
+  {
+    haloFreeBox[d][0] = 0;
+    haloFreeBox[d][1] = (d < dim) ? PETSC_MAX_INT : 1;
+  }
+  for (PetscInt c=0; c<dim; c++)
+  {
+    ierr = DMDAGetCorners(das[c], &start[0], &start[1], &start[2], &size[0], &size[1], &size[2]); CHKERRQ(ierr);
+    for (PetscInt d=0; d<dim; d++)
+    {
+      haloFreeBox[d][0] = PetscMax(haloFreeBox[d][0], start[d]+1);
+      haloFreeBox[d][1] = PetscMin(haloFreeBox[d][1], start[d]+size[d]-1);
+    }
+  }
+  for (PetscInt d=0; d<dim; d++)
+    haloFreeBox[d][1] = PetscMax(haloFreeBox[d][1], haloFreeBox[d][0]);
+
+  PetscFunctionReturn(0);
+} // generateHaloFreeBox
+
+
+/**
+ * \brief Counts the points owned by the process on the faces of a DMDA
+ *        next to the non-periodic boundaries (points on an edge are counted
+ *        once per face).
+ *
+ * \param da The DMDA
+ * \param numPoints The number of points
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::countBoundaryPoints(DM da, PetscInt &numPoints)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  PetscInt start[3] = {0, 0, 0},
+           size[3] = {1, 1, 1},
+           global[3] = {1, 1, 1};
+  ierr = DMDAGetCorners(da, &start[0], &start[1], &start[2], &size[0], &size[1], &size[2]); CHKERRQ(ierr);
+  ierr = DMDAGetInfo(da, NULL, &global[0], &global[1], &global[2], NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
+  numPoints = 0;
+  for (PetscInt d=0; d<dim; d++)
+  {
+    if (flow->boundaries[2*d][0].type == PERIODIC)
+      continue;
+    PetscInt facePoints = 1;
+    for (PetscInt e=0; e<dim; e++)
+    {
+      if (e != d)
+        facePoints *= size[e];
+    }
+    if (start[d] == 0)
+      numPoints += facePoints;
+    if (start[d]+size[d] == global[d])
+      numPoints += facePoints;
+  }
+
+  PetscFunctionReturn(0);
+} // countBoundaryPoints
+
+
+/**
+ * \brief Logs the operations and the bytes written (values and column
+ *        indices of the local non-zeros) by the assembly of a matrix.
+ *
+ * \param event The event of the assembly
+ * \param M The assembled matrix
+ * \param flopsPerNonZero Operations to compute a non-zero value
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::logMatrixAssembly(PetscLogEvent event, Mat M, PetscLogDouble flopsPerNonZero)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  MatInfo info;
+  ierr = MatGetInfo(M, MAT_LOCAL, &info); CHKERRQ(ierr);
+  ierr = kernelLog.log(event, flopsPerNonZero*info.nz_used,
+                       info.nz_used*(sizeof(PetscScalar)+sizeof(PetscInt))); CHKERRQ(ierr);
+
+  PetscFunctionReturn(0);
+} // logMatrixAssembly
+
+
+/**
+ * \brief Starts the exchange of the ghost points of the local flux vectors.
+ *
+ * The sub-vectors of `q` remain accessed until `finishGhostExchange`;
+ * they are read by the kernels over the halo-free region meanwhile.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::startGhostExchange()
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  ierr = PetscLogEventBegin(eventExchangeGhostsBegin, 0, 0, 0, 0); CHKERRQ(ierr);
+  if (dim == 2)
+  {
+    ierr = DMCompositeGetAccess(qPack, q, &qxGlobal, &qyGlobal); CHKERRQ(ierr);
+  }
+  else
+  {
+    ierr = DMCompositeGetAccess(qPack, q, &qxGlobal, &qyGlobal, &qzGlobal); CHKERRQ(ierr);
+  }
+  ierr = DMGlobalToLocalBegin(uda, qxGlobal, INSERT_VALUES, qxLocal); CHKERRQ(ierr);
+  ierr = DMGlobalToLocalBegin(vda, qyGlobal, INSERT_VALUES, qyLocal); CHKERRQ(ierr);
+  if (dim == 3)
+  {
+    ierr = DMGlobalToLocalBegin(wda, qzGlobal, INSERT_VALUES, qzLocal); CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(eventExchangeGhostsBegin, 0, 0, 0, 0); CHKERRQ(ierr);
+
+  PetscFunctionReturn(0);
+} // startGhostExchange
+
+
+/**
+ * \brief Completes the exchange of the ghost points of the local flux vectors.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::finishGhostExchange()
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  ierr = PetscLogEventBegin(eventExchangeGhostsEnd, 0, 0, 0, 0); CHKERRQ(ierr);
+  ierr = DMGlobalToLocalEnd(uda, qxGlobal, INSERT_VALUES, qxLocal); CHKERRQ(ierr);
+  ierr = DMGlobalToLocalEnd(vda, qyGlobal, INSERT_VALUES, qyLocal); CHKERRQ(ierr);
+  if (dim == 3)
+  {
+    ierr = DMGlobalToLocalEnd(wda, qzGlobal, INSERT_VALUES, qzLocal); CHKERRQ(ierr);
+  }
+  if (dim == 2)
+  {
+    ierr = DMCompositeRestoreAccess(qPack, q, &qxGlobal, &qyGlobal); CHKERRQ(ierr);
+  }
+  else
+  {
+    ierr = DMCompositeRestoreAccess(qPack, q, &qxGlobal, &qyGlobal, &qzGlobal); CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(eventExchangeGhostsEnd, 0, 0, 0, 0); CHKERRQ(ierr);
+
+  PetscFunctionReturn(0);
+} // finishGhostExchange
+
+
 /**
  * \brief Solves the system for the intermediate fluxes.
  */
@@ -222,11 +462,11 @@ PetscErrorCode NavierStokesSolver<dim>::solveIntermediateVelocity()
 {
   PetscErrorCode ierr;
 
-  ierr = PetscLogStagePush(stageSolveVelocitySystem); CHKERRQ(ierr);
+  ierr = tracer.pushStage(stageSolveVelocitySystem); CHKERRQ(ierr);
 
   ierr = velocity->solve(qStar, rhs1); CHKERRQ(ierr);
   
-  ierr = PetscLogStagePop(); CHKERRQ(ierr);
+  ierr = tracer.popStage(); CHKERRQ(ierr);
 
   return 0;
 } // solveIntermediateVelocity
@@ -240,7 +480,7 @@ PetscErrorCode NavierStokesSolver<dim>::assembleRHSPoisson()
 {
   PetscErrorCode ierr;
 
-  ierr = PetscLogStagePush(stageRHSPoissonSystem); CHKERRQ(ierr);
+  ierr = tracer.pushStage(stageRHSPoissonSystem); CHKERRQ(ierr);
 
   ierr = generateR2(); CHKERRQ(ierr);
   ierr = VecScale(r2, -1.0); CHKERRQ(ierr);
@@ -257,7 +497,7 @@ PetscErrorCode NavierStokesSolver<dim>::assembleRHSPoisson()
 
   ierr = PetscObjectViewFromOptions((PetscObject) rhs2, NULL, "-rhs2_vec_view"); CHKERRQ(ierr);
   
-  ierr = PetscLogStagePop(); CHKERRQ(ierr);
+  ierr = tracer.popStage(); CHKERRQ(ierr);
 
   return 0;
 } // assembleRHSPoisson
@@ -271,11 +511,11 @@ PetscErrorCode NavierStokesSolver<dim>::solvePoissonSystem()
 {
   PetscErrorCode ierr;
   
-  ierr = PetscLogStagePush(stageSolvePoissonSystem); CHKERRQ(ierr);
+  ierr = tracer.pushStage(stageSolvePoissonSystem); CHKERRQ(ierr);
 
   ierr = poisson->solve(lambda, rhs2); CHKERRQ(ierr);
   
-  ierr = PetscLogStagePop(); CHKERRQ(ierr);
+  ierr = tracer.popStage(); CHKERRQ(ierr);
 
   return 0;
 } // solvePoissonSystem
@@ -297,12 +537,12 @@ PetscErrorCode NavierStokesSolver<dim>::projectionStep()
 {
   PetscErrorCode ierr;
 
-  ierr = PetscLogStagePush(stageProjectionStep); CHKERRQ(ierr);
+  ierr = tracer.pushStage(stageProjectionStep); CHKERRQ(ierr);
   
   ierr = MatMult(BNQ, lambda, temp); CHKERRQ(ierr);
   ierr = VecWAXPY(q, -1.0, temp, qStar); CHKERRQ(ierr);
 
-  ierr = PetscLogStagePop(); CHKERRQ(ierr);
+  ierr = tracer.popStage(); CHKERRQ(ierr);
 
   return 0;
 } // projectionStep
@@ -316,13 +556,13 @@ PetscErrorCode NavierStokesSolver<dim>::generateQTBNQ()
 {
   PetscErrorCode ierr;
 
-  PetscLogEvent GENERATE_QTBNQ;
-  ierr = PetscLogEventRegister("generateQTBNQ", 0, &GENERATE_QTBNQ); CHKERRQ(ierr);
-  ierr = PetscLogEventBegin(GENERATE_QTBNQ, 0, 0, 0, 0); CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(eventGenerateQTBNQ, 0, 0, 0, 0); CHKERRQ(ierr);
 
   ierr = MatMatMult(QT, BNQ, MAT_INITIAL_MATRIX, PETSC_DEFAULT, &QTBNQ); CHKERRQ(ierr);
+  // the operations are logged by MatMatMult
+  ierr = logMatrixAssembly(eventGenerateQTBNQ, QTBNQ, 0.0); CHKERRQ(ierr);
 
-  ierr = PetscLogEventEnd(GENERATE_QTBNQ, 0, 0, 0, 0); CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(eventGenerateQTBNQ, 0, 0, 0, 0); CHKERRQ(ierr);
 
   ierr = PetscObjectViewFromOptions((PetscObject) QTBNQ, NULL, "-QTBNQ_mat_view"); CHKERRQ(ierr);
 
@@ -379,6 +619,17 @@ template <PetscInt dim>
 PetscErrorCode NavierStokesSolver<dim>::finalize()
 {
   PetscErrorCode ierr;
+
+  // fields staged but not yet written (`outputAsync: true` or -io_servers)
+  ierr = asyncWriter.flush(); CHKERRQ(ierr);
+  // samples of the probes not yet written
+  ierr = probes.flush(); CHKERRQ(ierr);
+  // records of the time series not yet written
+  ierr = timeSeries.flush(); CHKERRQ(ierr);
+  // rates of the kernels (with -log_kernels)
+  ierr = kernelLog.view(); CHKERRQ(ierr);
+  // timeline and imbalance of the stages and events (with -timeline)
+  ierr = tracer.finalize(); CHKERRQ(ierr);
   
   // DM objects
   if (pda != PETSC_NULL)       {ierr = DMDestroy(&pda); CHKERRQ(ierr);}
@@ -412,6 +663,12 @@ PetscErrorCode NavierStokesSolver<dim>::finalize()
   if (MHat != PETSC_NULL){ierr = VecDestroy(&MHat); CHKERRQ(ierr);}
   if (RInv != PETSC_NULL){ierr = VecDestroy(&RInv); CHKERRQ(ierr);}
   if (BN != PETSC_NULL)  {ierr = VecDestroy(&BN); CHKERRQ(ierr);}
+  // work vectors of the matrix-free operator
+  if (qxWork != PETSC_NULL)   {ierr = VecDestroy(&qxWork); CHKERRQ(ierr);}
+  if (qyWork != PETSC_NULL)   {ierr = VecDestroy(&qyWork); CHKERRQ(ierr);}
+  if (qzWork != PETSC_NULL)   {ierr = VecDestroy(&qzWork); CHKERRQ(ierr);}
+  if (RInvq != PETSC_NULL)    {ierr = VecDestroy(&RInvq); CHKERRQ(ierr);}
+  if (ADiagonal != PETSC_NULL){ierr = VecDestroy(&ADiagonal); CHKERRQ(ierr);}
   // matrices
   if (A != PETSC_NULL)    {ierr = MatDestroy(&A); CHKERRQ(ierr);}
   if (QT != PETSC_NULL)   {ierr = MatDestroy(&QT); CHKERRQ(ierr);}
@@ -429,15 +686,18 @@ PetscErrorCode NavierStokesSolver<dim>::finalize()
 #include "inline/createVecs.inl"
 #include "inline/createSolvers.inl"
 #include "inline/setNullSpace.inl"
+#include "inline/setMultigridDefaults.inl"
 #include "inline/createLocalToGlobalMappingsFluxes.inl"
 #include "inline/createLocalToGlobalMappingsLambda.inl"
 #include "inline/addInitialPerturbation.inl"
 #include "inline/initializeFluxes.inl"
 #include "inline/initializeLambda.inl"
 #include "inline/updateBoundaryGhosts.inl"
+#include "inline/generateMetrics.inl"
 #include "inline/calculateExplicitTerms.inl"
 #include "inline/generateDiagonalMatrices.inl"
 #include "inline/generateA.inl"
+#include "inline/generateAShell.inl"
 #include "inline/generateBC1.inl"
 #include "inline/generateBNQ.inl"
 #include "inline/generateR2.inl"
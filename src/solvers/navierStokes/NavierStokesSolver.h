@@ -10,11 +10,19 @@
 
 #include "CartesianMesh.h"
 #include "FlowDescription.h"
+#include "KernelLog.h"
 #include "SimulationParameters.h"
+#include "TimeSeries.h"
+#include "Tracer.h"
+#include "AsyncWriter.h"
+#include "compression.h"
+#include "XDMFWriter.h"
+#include "Probes.h"
 #include "solvers/solver.h"
 
 #include <fstream>
 #include <memory>
+#include <vector>
 
 #include <petscdmda.h>
 #include <petscksp.h>
@@ -60,13 +68,40 @@ public:
       RInv,
       MHat;
 
+  // metrics of the grid, computed once
+  std::vector<PetscReal> invWidths[dim],          // reciprocals of the cell-widths (with periodic images)
+                         staggeredWidths[dim],    // distances between consecutive cell-centers
+                         invStaggeredWidths[dim]; // reciprocals of the staggered widths
+  std::vector<PetscReal> LMinus[dim][dim],  // 1D stencil coefficients of the Laplacian
+                         LCenter[dim][dim], // (indexed by flux component and direction)
+                         LPlus[dim][dim];
+  // kernels instantiated for the uniformity of the grid along x
+  PetscErrorCode (NavierStokesSolver<dim>::*selectedExplicitTermsKernel)(Vec r, PetscBool scaleByMHat, KernelRegion region);
+  PetscErrorCode (NavierStokesSolver<dim>::*selectedMultAKernel)(Vec x, Vec y);
+
+  // split-phase exchange of the ghost points of the fluxes
+  Vec qxGlobal, qyGlobal, qzGlobal; // sub-vectors of q accessed during the exchange
+  PetscInt haloFreeBox[3][2];       // points whose stencils involve no ghost point
+
+  // data of the matrix-free operator A
+  Vec qxWork, qyWork, qzWork; // ghosted work vectors
+  Vec RInvq,                  // work vector to store R^{-1} x
+      ADiagonal;              // diagonal of the operator
+
   CartesianMesh *mesh;
   FlowDescription<dim> *flow;
   SimulationParameters *parameters;
   
   PetscInt timeStep;
 
-  std::ofstream iterationCountsFile;
+  PetscViewer solutionViewer; // file of all the fields of a time step, while open
+  AsyncWriter asyncWriter;  // writes the fields in the background or on output servers
+  XDMFWriter xdmf;          // time series of the fields written in HDF5 files, by grid
+
+  TimeSeries timeSeries;    // quantities monitored at each time step
+  PetscInt columnTimeStep,  // columns of the time-step index and of the time
+           columnTime;
+  Probes probes;            // velocity and pressure sampled at points, lines and planes
 
   PetscLogStage stageInitialize,
                 stageRHSVelocitySystem,
@@ -75,6 +110,20 @@ public:
                 stageSolvePoissonSystem,
                 stageProjectionStep,
                 stageWriteData;
+  Tracer tracer;            // timeline of the stages and events on every process
+  PetscLogEvent eventExchangeGhostsBegin,
+                eventExplicitTermsOverlap,
+                eventExchangeGhostsEnd;
+  KernelLog kernelLog;      // operations and memory traffic of the kernels
+  PetscLogEvent eventExplicitTerms,
+                eventUpdateBoundaryGhosts,
+                eventGenerateBC1,
+                eventGenerateR2,
+                eventMultA,
+                eventGenerateDiagonalMatrices,
+                eventGenerateA,
+                eventGenerateBNQ,
+                eventGenerateQTBNQ;
 
   // initialize data common to NavierStokesSolver and derived classes
   PetscErrorCode initializeCommon();
@@ -97,6 +146,10 @@ public:
   
   // generate diagonal matrices M and Rinv
   PetscErrorCode generateDiagonalMatrices();
+  // compute reciprocals of grid-spacings and stencil coefficients, and select the kernels
+  PetscErrorCode generateMetrics();
+  // compute 1D stencil coefficients of the Laplacian
+  PetscErrorCode generateLaplacianStencils();
   
   // count number of non-zeros in the diagonal and off-diagonal portions of the parallel matrices
   void countNumNonZeros(PetscInt *cols, size_t numCols, PetscInt rowStart, PetscInt rowEnd, 
@@ -104,6 +157,11 @@ public:
   
   // generate the matrix A
   PetscErrorCode generateA();
+  // generate the matrix-free (shell) operator A
+  PetscErrorCode generateAShell();
+  // apply the matrix-free operator A
+  PetscErrorCode multA(Vec x, Vec y);
+  template <PetscBool uniformX> PetscErrorCode multAKernel(Vec x, Vec y);
   
   // compute matrix \f$ B^N Q \f$
   virtual PetscErrorCode generateBNQ();
@@ -114,15 +172,31 @@ public:
   // calculate and specify to the Krylov solver the null-space of the LHS matrix
   // in the pressure-force system
   virtual PetscErrorCode setNullSpace();
+  // prepare the pressure grid and default options for geometric multigrid
+  PetscErrorCode setMultigridDefaults(std::string prefix);
 
   // assemble RHS of velocity system
   PetscErrorCode assembleRHSVelocity();
   // calculate explicit convective and diffusive terms
   PetscErrorCode calculateExplicitTerms();
+  // calculate explicit terms into a given vector, optionally scaled by MHat
+  PetscErrorCode calculateExplicitTerms(Vec r, PetscBool scaleByMHat, KernelRegion region=ALL_POINTS);
+  template <PetscBool uniformX> PetscErrorCode calculateExplicitTermsKernel(Vec r, PetscBool scaleByMHat, KernelRegion region);
+  // compute the box of points whose stencils involve no ghost point
+  PetscErrorCode generateHaloFreeBox();
+  // count the owned points of a DMDA next to the non-periodic boundaries
+  PetscErrorCode countBoundaryPoints(DM da, PetscInt &numPoints);
+  // log the operations and the bytes written by the assembly of a matrix
+  PetscErrorCode logMatrixAssembly(PetscLogEvent event, Mat M, PetscLogDouble flopsPerNonZero);
+  // start and complete the exchange of the ghost points of the local flux vectors
+  PetscErrorCode startGhostExchange();
+  PetscErrorCode finishGhostExchange();
   // update values in ghost nodes at the domain boundaries
   PetscErrorCode updateBoundaryGhosts();
   // assemble velocity boundary conditions vector
   PetscErrorCode generateBC1();
+  // add boundary contributions to a given vector, optionally scaled by MHat
+  PetscErrorCode generateBC1(Vec b, PetscBool scaleByMHat);
 
   // aasemble RHS of Poisson system
   PetscErrorCode assembleRHSPoisson();
@@ -158,8 +232,26 @@ public:
   PetscErrorCode writeConvectiveTerms(std::string directory);
   // write pressure field into file
   virtual PetscErrorCode writeLambda(std::string directory);
-  // write KSP iteration counts into file
-  virtual PetscErrorCode writeIterationCounts();
+  // open the file of all the fields of a time step (`outputSingleFile: true`)
+  PetscErrorCode openSolutionFile(std::string directory, PetscFileMode mode);
+  // close the file of all the fields of a time step
+  PetscErrorCode closeSolutionFile();
+  // write a field into the open solution file, into its own file or stage it
+  PetscErrorCode viewField(Vec v, std::string name, std::string directory);
+  // read a field from the open solution file or from its own file
+  PetscErrorCode loadField(Vec v, std::string name, std::string directory);
+  // open the file of a single field
+  PetscErrorCode openFieldViewer(std::string name, std::string directory, PetscFileMode mode, PetscViewer &viewer);
+  // add the columns of the quantities monitored at each time step
+  virtual PetscErrorCode createTimeSeries();
+  // set the values of the columns added by derived classes
+  virtual PetscErrorCode recordTimeSeries();
+  // record the quantities monitored at the current time step
+  PetscErrorCode writeTimeSeries();
+  // register the fields with the probes and read the file `probes.yaml`
+  PetscErrorCode createProbes();
+  // sample the fields at the probes
+  PetscErrorCode writeProbes();
   
 public:
   // constructors
@@ -17,6 +17,67 @@ inline PetscReal d2udx2(PetscReal uMinus, PetscReal uCenter, PetscReal uPlus,
 } // d2udx2
 
 
+/**
+ * \brief Covers the points of a region with boxes of owned points.
+ *
+ * The halo-free region is a single box; the halo-adjacent region is made of
+ * at most two slabs per direction around it.
+ *
+ * \param region The region to cover
+ * \param owned Index ranges (half-open) of the points owned by the process
+ * \param haloFree Index ranges of the points whose stencils involve no ghost point
+ * \param boxes Index ranges of the boxes covering the region
+ *
+ * \return The number of boxes
+ */
+inline PetscInt getRegionBoxes(KernelRegion region, const PetscInt (&owned)[3][2],
+                               const PetscInt (&haloFree)[3][2], PetscInt (&boxes)[6][3][2])
+{
+  // halo-free points owned by the process
+  PetscInt inner[3][2];
+  PetscBool empty = PETSC_FALSE;
+  for (PetscInt d=0; d<3; d++)
+  {
+    inner[d][0] = PetscMax(haloFree[d][0], owned[d][0]);
+    inner[d][1] = PetscMax(PetscMin(haloFree[d][1], owned[d][1]), inner[d][0]);
+    if (inner[d][0] == inner[d][1])
+      empty = PETSC_TRUE;
+  }
+  PetscInt numBoxes = 0;
+  if (region == ALL_POINTS || (region == HALO_ADJACENT && empty))
+  {
+    std::copy(&owned[0][0], &owned[0][0]+6, &boxes[numBoxes++][0][0]);
+  }
+  else if (region == HALO_FREE)
+  {
+    if (!empty)
+      std::copy(&inner[0][0], &inner[0][0]+6, &boxes[numBoxes++][0][0]);
+  }
+  else
+  {
+    // peel slabs off the owned points, from the outermost direction inwards
+    PetscInt rest[3][2];
+    std::copy(&owned[0][0], &owned[0][0]+6, &rest[0][0]);
+    for (PetscInt d=2; d>=0; d--)
+    {
+      if (inner[d][0] > rest[d][0])
+      {
+        std::copy(&rest[0][0], &rest[0][0]+6, &boxes[numBoxes][0][0]);
+        boxes[numBoxes++][d][1] = inner[d][0];
+      }
+      if (inner[d][1] < rest[d][1])
+      {
+        std::copy(&rest[0][0], &rest[0][0]+6, &boxes[numBoxes][0][0]);
+        boxes[numBoxes++][d][0] = inner[d][1];
+      }
+      rest[d][0] = inner[d][0];
+      rest[d][1] = inner[d][1];
+    }
+  }
+  return numBoxes;
+} // getRegionBoxes
+
+
 /**
  * \brief Calculates the explicit terms in the discretized Navier-Stokes equations. 
  * This includes the convection term, and the explicit portion of the diffusion
@@ -32,13 +93,104 @@ inline PetscReal d2udx2(PetscReal uMinus, PetscReal uCenter, PetscReal uPlus,
 template <PetscInt dim>
 PetscErrorCode NavierStokesSolver<dim>::calculateExplicitTerms()
 {
+  PetscErrorCode ierr;
+
+  ierr = calculateExplicitTerms(rn, PETSC_FALSE); CHKERRQ(ierr);
+
+  ierr = PetscObjectViewFromOptions((PetscObject) rn, NULL, "-rn_vec_view"); CHKERRQ(ierr);
+
   return 0;
 } // calculateExplicitTerms
 
 
+/**
+ * \brief Calculates the explicit terms and stores them in a given vector.
+ *
+ * When `scaleByMHat` is `PETSC_TRUE`, the explicit terms are multiplied by
+ * the diagonal matrix \f$ \hat{M} \f$ on the fly; its entries are the widths
+ * already used to compute the convective terms.
+ *
+ * Each row of a flux component is split into an interior range, computed
+ * with a branch-free loop over contiguous indices from the reciprocals of
+ * the grid-spacings and the Laplacian stencil coefficients (see
+ * `generateMetrics`), and thin strips next to non-periodic boundaries,
+ * computed point by point with the general formulas.
+ *
+ * The computation can be restricted to a region of the owned points:
+ * `HALO_FREE` only reads the fluxes from the global vector `q` (through the
+ * sub-vectors accessed by `startGhostExchange`) and can thus overlap the
+ * exchange of the ghost points; `HALO_ADJACENT` completes the other points
+ * from the local vectors once the exchange is over.
+ *
+ * The event `explicitTerms` logs the operations of the interior formula
+ * (48 per point in 2D, 77 in 3D, plus one with the scaling) and the
+ * compulsory traffic: the fluxes (all components), the convective terms
+ * (read and written) and the explicit terms (written), assuming that the
+ * neighbouring rows stay in cache.
+ *
+ * \param r The vector in which the explicit terms are stored
+ * \param scaleByMHat Multiplies the explicit terms by \f$ \hat{M} \f$ if `PETSC_TRUE`
+ * \param region Points at which the explicit terms are computed
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::calculateExplicitTerms(Vec r, PetscBool scaleByMHat, KernelRegion region)
+{
+  PetscErrorCode ierr;
+
+  ierr = PetscLogEventBegin(eventExplicitTerms, 0, 0, 0, 0); CHKERRQ(ierr);
+
+  // kernel selected in `generateMetrics`
+  ierr = (this->*selectedExplicitTermsKernel)(r, scaleByMHat, region); CHKERRQ(ierr);
+
+  // number of points of the region
+  DM das[3] = {uda, vda, wda};
+  PetscInt boxes[6][3][2];
+  PetscLogDouble numPoints = 0.0;
+  for (PetscInt c=0; c<dim; c++)
+  {
+    PetscInt start[3] = {0, 0, 0},
+             size[3] = {1, 1, 1};
+    ierr = DMDAGetCorners(das[c], &start[0], &start[1], &start[2], &size[0], &size[1], &size[2]); CHKERRQ(ierr);
+    const PetscInt owned[3][2] = {{start[0], start[0]+size[0]},
+                                  {start[1], start[1]+size[1]},
+                                  {start[2], start[2]+size[2]}};
+    PetscInt numBoxes = getRegionBoxes(region, owned, haloFreeBox, boxes);
+    for (PetscInt b=0; b<numBoxes; b++)
+    {
+      numPoints += (PetscLogDouble) (boxes[b][0][1]-boxes[b][0][0])
+                                   *(boxes[b][1][1]-boxes[b][1][0])
+                                   *(boxes[b][2][1]-boxes[b][2][0]);
+    }
+  }
+  PetscLogDouble flopsPerPoint = ((dim == 2) ? 48.0 : 77.0) + ((scaleByMHat) ? 1.0 : 0.0);
+  ierr = kernelLog.log(eventExplicitTerms, flopsPerPoint*numPoints,
+                       (dim+3)*sizeof(PetscReal)*numPoints); CHKERRQ(ierr);
+
+  ierr = PetscLogEventEnd(eventExplicitTerms, 0, 0, 0, 0); CHKERRQ(ierr);
+
+  return 0;
+} // calculateExplicitTerms
+
+
+/**
+ * \brief Kernel of `calculateExplicitTerms`, instantiated for a grid that is
+ *        either uniform (`uniformX` is `PETSC_TRUE`) or stretched along x.
+ *
+ * The metrics along x are the only ones indexed in the innermost loops;
+ * those along y and z are constant over a row.
+ */
+template <PetscInt dim>
+template <PetscBool uniformX>
+PetscErrorCode NavierStokesSolver<dim>::calculateExplicitTermsKernel(Vec r, PetscBool scaleByMHat, KernelRegion region)
+{
+  return 0;
+} // calculateExplicitTermsKernel
+
+
 // two-dimensional specialization
 template <>
-PetscErrorCode NavierStokesSolver<2>::calculateExplicitTerms()
+template <PetscBool uniformX>
+PetscErrorCode NavierStokesSolver<2>::calculateExplicitTermsKernel(Vec r, PetscBool scaleByMHat, KernelRegion region)
 {
   PetscErrorCode ierr;
 
@@ -46,15 +198,8 @@ PetscErrorCode NavierStokesSolver<2>::calculateExplicitTerms()
            M, N,           // global number of nodes along each direction
            m, n,           // local number of nodes along each direction
            mstart, nstart; // starting indices
-
-  PetscReal HnMinus1; // convection term at previous time-step
-  PetscReal u_W, u_P, u_E, u_S, u_N, // West, Point, East, South, North x-velocities
-            v_W, v_P, v_E, v_S, v_N, // West, Point, East, South, North y-velocities
-            u_w, u_e, u_s, u_n,      // interpolated x-velocities at cell-vertices
-            v_w, v_e, v_s, v_n;      // interpolated y-velocities at cell-vertices
-  PetscReal dxMinus, dxPlus, dyMinus, dyPlus;
-  PetscReal convectionTerm, // value of convection term
-            diffusionTerm;  // value of diffusion term
+  PetscInt boxes[6][3][2], // boxes of owned points covering the region
+           numBoxes, b;
   
   PetscReal *dx = &mesh->dx[0],
             *dy = &mesh->dy[0];
@@ -66,6 +211,8 @@ PetscErrorCode NavierStokesSolver<2>::calculateExplicitTerms()
             alpha = parameters->diffusion.coefficients[1],  // explicit (n) diffusion coefficient
             gamma = parameters->convection.coefficients[1], // explicit (n) convection coefficient
             zeta  = parameters->convection.coefficients[2]; // explicit (n-1) convection coefficient
+  PetscReal dtInv = 1.0/dt,
+            alphaNu = alpha*nu;
 
   PetscBool periodicX = (flow->boundaries[XMINUS][0].type == PERIODIC) ? PETSC_TRUE : PETSC_FALSE,
             periodicY = (flow->boundaries[YMINUS][0].type == PERIODIC) ? PETSC_TRUE : PETSC_FALSE;
@@ -73,50 +220,107 @@ PetscErrorCode NavierStokesSolver<2>::calculateExplicitTerms()
   Vec HxGlobal, HyGlobal;
   ierr = DMCompositeGetAccess(qPack, H,  &HxGlobal, &HyGlobal); CHKERRQ(ierr);
   Vec rxGlobal, ryGlobal;
-  ierr = DMCompositeGetAccess(qPack, rn, &rxGlobal, &ryGlobal); CHKERRQ(ierr);
+  ierr = DMCompositeGetAccess(qPack, r, &rxGlobal, &ryGlobal); CHKERRQ(ierr);
   
-  // access local vectors through multi-dimensional pointers
+  // access fluxes through multi-dimensional pointers
+  // (points of the halo-free region are read from the global vector)
   PetscReal **qx, **qy;
-  ierr = DMDAVecGetArray(uda, qxLocal, &qx); CHKERRQ(ierr);
-  ierr = DMDAVecGetArray(vda, qyLocal, &qy); CHKERRQ(ierr);
+  ierr = DMDAVecGetArrayRead(uda, (region == HALO_FREE) ? qxGlobal : qxLocal, &qx); CHKERRQ(ierr);
+  ierr = DMDAVecGetArrayRead(vda, (region == HALO_FREE) ? qyGlobal : qyLocal, &qy); CHKERRQ(ierr);
   
   // compute explicit terms: x-component
   PetscReal **Hx, **rx;
   ierr = DMDAVecGetArray(uda, HxGlobal, &Hx); CHKERRQ(ierr);
   ierr = DMDAVecGetArray(uda, rxGlobal, &rx); CHKERRQ(ierr);
   ierr = DMDAGetCorners(uda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
+  {
+    const PetscInt owned[3][2] = {{mstart, mstart+m}, {nstart, nstart+n}, {0, 1}};
+    numBoxes = getRegionBoxes(region, owned, haloFreeBox, boxes);
+  }
   ierr = DMDAGetInfo(uda, NULL, &M, &N, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
-  for (j=nstart; j<nstart+n; j++)
+  // explicit term at a single point (also valid next to a boundary)
+  auto explicitTermX = [&](PetscInt i, PetscInt j)
   {
-    for (i=mstart; i<mstart+m; i++)
+    PetscReal HnMinus1; // convection term at previous time-step
+    PetscReal u_W, u_P, u_E, u_S, u_N; // velocities at the node and its neighbours
+    PetscReal u_w, u_e, u_s, u_n, v_s, v_n; // interpolated velocities
+    PetscReal dxMinus, dxPlus, dyMinus, dyPlus;
+    PetscReal convectionTerm, diffusionTerm;
+    // velocity value at nodes
+    u_P = qx[j][i]/dy[j];
+    u_W = qx[j][i-1]/dy[j];
+    u_E = qx[j][i+1]/dy[j];
+    u_S = (j > 0) ? qx[j-1][i]/dy[j-1] : (periodicY) ? qx[j-1][i]/dy[ny-1] : qx[j-1][i];
+    u_N = (j < N-1) ? qx[j+1][i]/dy[j+1] : (periodicY) ? qx[j+1][i]/dy[0] : qx[j+1][i];
+    // interpolated velocity values
+    u_w = 0.5*(u_W + u_P);
+    u_e = 0.5*(u_P + u_E);
+    u_s = (j == 0 && !periodicY) ? u_S : 0.5*(u_S + u_P);
+    u_n = (j == N-1 && !periodicY) ? u_N : 0.5*(u_P + u_N);      
+    dxMinus = dx[i];
+    dxPlus = (i == M-1 && periodicX) ? dx[0] : dx[i+1];
+    v_s = 0.5*(qy[j-1][i]/dxMinus + qy[j-1][i+1]/dxPlus);
+    v_n = 0.5*(qy[j][i]/dxMinus + qy[j][i+1]/dxPlus);
+    // convection term: Hx = d(u^2)/dx + d(uv)/dy
+    HnMinus1 = Hx[j][i];
+    Hx[j][i] = (  (u_e*u_e - u_w*u_w)/(0.5*(dxMinus+dxPlus)) 
+                + (v_n*u_n - v_s*u_s)/dy[j] );
+    convectionTerm = gamma*Hx[j][i] + zeta*HnMinus1;
+    // diffusion term: d^2u/dx^2 + d^2u/dy^2
+    dyMinus = (j > 0) ? 0.5*(dy[j-1] + dy[j]) : (periodicY) ? 0.5*(dy[ny-1] + dy[j]) : 0.5*dy[j];
+    dyPlus = (j < N-1) ? 0.5*(dy[j] + dy[j+1]) : (periodicY) ? 0.5*(dy[j] + dy[0]) : 0.5*dy[j];
+    diffusionTerm = alpha*nu * (  d2udx2(u_W, u_P, u_E, dxMinus, dxPlus)
+                                + d2udx2(u_S, u_P, u_N, dyMinus, dyPlus) );
+    // explicit term
+    rx[j][i] = u_P/dt - convectionTerm + diffusionTerm;
+    if (scaleByMHat)
+      rx[j][i] *= 0.5*(dxMinus + dxPlus);
+  };
+  {
+    // metrics along x are constants when the grid is uniform in that direction
+    const GridMetric<uniformX> idx(invWidths[0], 1), // reciprocals of the cell-widths
+                               sx(staggeredWidths[0]),
+                               isx(invStaggeredWidths[0]),
+                               Lxm(LMinus[0][0]), Lxc(LCenter[0][0]), Lxp(LPlus[0][0]);
+    const PetscReal *idy = &invWidths[1][1];
+    for (b=0; b<numBoxes; b++)
     {
-      // velocity value at nodes
-      u_P = qx[j][i]/dy[j];
-      u_W = qx[j][i-1]/dy[j];
-      u_E = qx[j][i+1]/dy[j];
-      u_S = (j > 0) ? qx[j-1][i]/dy[j-1] : (periodicY) ? qx[j-1][i]/dy[ny-1] : qx[j-1][i];
-      u_N = (j < N-1) ? qx[j+1][i]/dy[j+1] : (periodicY) ? qx[j+1][i]/dy[0] : qx[j+1][i];
-      // interpolated velocity values
-      u_w = 0.5*(u_W + u_P);
-      u_e = 0.5*(u_P + u_E);
-      u_s = (j == 0 && !periodicY) ? u_S : 0.5*(u_S + u_P);
-      u_n = (j == N-1 && !periodicY) ? u_N : 0.5*(u_P + u_N);      
-      dxMinus = dx[i];
-      dxPlus = (i == M-1 && periodicX) ? dx[0] : dx[i+1];
-      v_s = 0.5*(qy[j-1][i]/dxMinus + qy[j-1][i+1]/dxPlus);
-      v_n = 0.5*(qy[j][i]/dxMinus + qy[j][i+1]/dxPlus);
-      // convection term: Hx = d(u^2)/dx + d(uv)/dy
-      HnMinus1 = Hx[j][i];
-      Hx[j][i] = (  (u_e*u_e - u_w*u_w)/(0.5*(dxMinus+dxPlus)) 
-                  + (v_n*u_n - v_s*u_s)/dy[j] );
-      convectionTerm = gamma*Hx[j][i] + zeta*HnMinus1;
-      // diffusion term: d^2u/dx^2 + d^2u/dy^2
-      dyMinus = (j > 0) ? 0.5*(dy[j-1] + dy[j]) : (periodicY) ? 0.5*(dy[ny-1] + dy[j]) : 0.5*dy[j];
-      dyPlus = (j < N-1) ? 0.5*(dy[j] + dy[j+1]) : (periodicY) ? 0.5*(dy[j] + dy[0]) : 0.5*dy[j];
-      diffusionTerm = alpha*nu * (  d2udx2(u_W, u_P, u_E, dxMinus, dxPlus)
-                                  + d2udx2(u_S, u_P, u_N, dyMinus, dyPlus) );
-      // explicit term
-      rx[j][i] = u_P/dt - convectionTerm + diffusionTerm;
+      const PetscInt i0 = boxes[b][0][0], i1 = boxes[b][0][1],
+                     j0 = boxes[b][1][0], j1 = boxes[b][1][1];
+#pragma omp parallel for private(i)
+      for (j=j0; j<j1; j++)
+      {
+        // rows adjacent to a non-periodic boundary use the general treatment
+        PetscInt iStart = (periodicY || (j > 0 && j < N-1)) ? i0 : i1,
+                 iEnd = i1;
+        for (i=i0; i<iStart; i++)
+          explicitTermX(i, j);
+        const PetscReal *qxP = qx[j], *qxS = qx[j-1], *qxN = qx[j+1],
+                        *qyS = qy[j-1], *qyP = qy[j];
+        PetscReal *HxRow = Hx[j], *rxRow = rx[j];
+        const PetscReal iyP = idy[j], iyS = idy[j-1], iyN = idy[j+1],
+                        Lym = LMinus[0][1][j], Lyc = LCenter[0][1][j], Lyp = LPlus[0][1][j];
+        for (i=iStart; i<iEnd; i++)
+        {
+          const PetscReal uP = qxP[i]*iyP, uW = qxP[i-1]*iyP, uE = qxP[i+1]*iyP,
+                          uS = qxS[i]*iyS, uN = qxN[i]*iyN;
+          const PetscReal uw = 0.5*(uW + uP), ue = 0.5*(uP + uE),
+                          us = 0.5*(uS + uP), un = 0.5*(uP + uN);
+          const PetscReal vs = 0.5*(qyS[i]*idx[i] + qyS[i+1]*idx[i+1]),
+                          vn = 0.5*(qyP[i]*idx[i] + qyP[i+1]*idx[i+1]);
+          const PetscReal Hprev = HxRow[i],
+                          Hcur = (ue*ue - uw*uw)*isx[i] + (vn*un - vs*us)*iyP;
+          HxRow[i] = Hcur;
+          rxRow[i] = uP*dtInv - (gamma*Hcur + zeta*Hprev)
+                     + alphaNu*(  Lxm[i]*uW + Lxc[i]*uP + Lxp[i]*uE
+                                + Lym*uS + Lyc*uP + Lyp*uN );
+        }
+        if (scaleByMHat)
+        {
+          for (i=iStart; i<iEnd; i++)
+            rxRow[i] *= sx[i];
+        }
+      }
     }
   }
   ierr = DMDAVecRestoreArray(uda, HxGlobal, &Hx); CHKERRQ(ierr);
@@ -127,61 +331,121 @@ PetscErrorCode NavierStokesSolver<2>::calculateExplicitTerms()
   ierr = DMDAVecGetArray(vda, HyGlobal, &Hy); CHKERRQ(ierr);
   ierr = DMDAVecGetArray(vda, ryGlobal, &ry); CHKERRQ(ierr);
   ierr = DMDAGetCorners(vda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
+  {
+    const PetscInt owned[3][2] = {{mstart, mstart+m}, {nstart, nstart+n}, {0, 1}};
+    numBoxes = getRegionBoxes(region, owned, haloFreeBox, boxes);
+  }
   ierr = DMDAGetInfo(vda, NULL, &M, &N, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
-  for (j=nstart; j<nstart+n; j++)
+  // explicit term at a single point (also valid next to a boundary)
+  auto explicitTermY = [&](PetscInt i, PetscInt j)
   {
-    for (i=mstart; i<mstart+m; i++)
+    PetscReal HnMinus1; // convection term at previous time-step
+    PetscReal v_W, v_P, v_E, v_S, v_N; // velocities at the node and its neighbours
+    PetscReal u_w, u_e, v_w, v_e, v_s, v_n; // interpolated velocities
+    PetscReal dxMinus, dxPlus, dyMinus, dyPlus;
+    PetscReal convectionTerm, diffusionTerm;
+    // velocity value at nodes
+    v_P = qy[j][i]/dx[i];
+    v_W = (i > 0) ? qy[j][i-1]/dx[i-1] : (periodicX) ? qy[j][i-1]/dx[nx-1] : qy[j][i-1];
+    v_E = (i < M-1) ? qy[j][i+1]/dx[i+1] : (periodicX) ? qy[j][i+1]/dx[0] : qy[j][i+1];
+    v_S = qy[j-1][i]/dx[i];
+    v_N = qy[j+1][i]/dx[i];
+    // interpolated velocity values
+    v_w = (i == 0 && !periodicX) ? v_W : 0.5*(v_W + v_P);
+    v_e = (i == M-1 && !periodicX) ? v_E : 0.5*(v_P + v_E);
+    v_s = 0.5*(v_S + v_P);
+    v_n = 0.5*(v_P + v_N);
+    dyMinus = dy[j];
+    dyPlus = (j == N-1 && periodicY) ? dy[0] : dy[j+1];
+    u_w = 0.5*(qx[j][i-1]/dyMinus + qx[j+1][i-1]/dyPlus);
+    u_e = 0.5*(qx[j][i]/dyMinus + qx[j+1][i]/dyPlus);
+    // convection term: Hy = d(uv)/dx + d(v^2)/dy
+    HnMinus1 = Hy[j][i];
+    Hy[j][i] = (  (u_e*v_e - u_w*v_w)/dx[i] 
+                + (v_n*v_n - v_s*v_s)/(0.5*(dyMinus+dyPlus)) );
+    convectionTerm = gamma*Hy[j][i] + zeta*HnMinus1;
+    // diffusion term: d^2v/dx^2 + d^2v/dy^2
+    dxMinus = (i > 0) ? 0.5*(dx[i-1] + dx[i]) : (periodicX) ? 0.5*(dx[nx-1] + dx[i]) : 0.5*dx[i];
+    dxPlus = (i < M-1) ? 0.5*(dx[i] + dx[i+1]) : (periodicX) ? 0.5*(dx[i] + dx[0]) : 0.5*dx[i];
+    diffusionTerm = alpha*nu * (  d2udx2(v_W, v_P, v_E, dxMinus, dxPlus)
+                                + d2udx2(v_S, v_P, v_N, dyMinus, dyPlus) );
+    // explicit term
+    ry[j][i] = v_P/dt - convectionTerm + diffusionTerm;
+    if (scaleByMHat)
+      ry[j][i] *= 0.5*(dyMinus + dyPlus);
+  };
+  {
+    // metrics along x are constants when the grid is uniform in that direction
+    const GridMetric<uniformX> idx(invWidths[0], 1), // reciprocals of the cell-widths
+                               Lxm(LMinus[1][0]), Lxc(LCenter[1][0]), Lxp(LPlus[1][0]);
+    const PetscReal *idy = &invWidths[1][1],
+                    *isy = &invStaggeredWidths[1][0];
+    for (b=0; b<numBoxes; b++)
     {
-      // velocity value at nodes
-      v_P = qy[j][i]/dx[i];
-      v_W = (i > 0) ? qy[j][i-1]/dx[i-1] : (periodicX) ? qy[j][i-1]/dx[nx-1] : qy[j][i-1];
-      v_E = (i < M-1) ? qy[j][i+1]/dx[i+1] : (periodicX) ? qy[j][i+1]/dx[0] : qy[j][i+1];
-      v_S = qy[j-1][i]/dx[i];
-      v_N = qy[j+1][i]/dx[i];
-      // interpolated velocity values
-      v_w = (i == 0 && !periodicX) ? v_W : 0.5*(v_W + v_P);
-      v_e = (i == M-1 && !periodicX) ? v_E : 0.5*(v_P + v_E);
-      v_s = 0.5*(v_S + v_P);
-      v_n = 0.5*(v_P + v_N);
-      dyMinus = dy[j];
-      dyPlus = (j == N-1 && periodicY) ? dy[0] : dy[j+1];
-      u_w = 0.5*(qx[j][i-1]/dyMinus + qx[j+1][i-1]/dyPlus);
-      u_e = 0.5*(qx[j][i]/dyMinus + qx[j+1][i]/dyPlus);
-      // convection term: Hy = d(uv)/dx + d(v^2)/dy
-      HnMinus1 = Hy[j][i];
-      Hy[j][i] = (  (u_e*v_e - u_w*v_w)/dx[i] 
-                  + (v_n*v_n - v_s*v_s)/(0.5*(dyMinus+dyPlus)) );
-      convectionTerm = gamma*Hy[j][i] + zeta*HnMinus1;
-      // diffusion term: d^2v/dx^2 + d^2v/dy^2
-      dxMinus = (i > 0) ? 0.5*(dx[i-1] + dx[i]) : (periodicX) ? 0.5*(dx[nx-1] + dx[i]) : 0.5*dx[i];
-      dxPlus = (i < M-1) ? 0.5*(dx[i] + dx[i+1]) : (periodicX) ? 0.5*(dx[i] + dx[0]) : 0.5*dx[i];
-      diffusionTerm = alpha*nu * (  d2udx2(v_W, v_P, v_E, dxMinus, dxPlus)
-                                  + d2udx2(v_S, v_P, v_N, dyMinus, dyPlus) );
-      // explicit term
-      ry[j][i] = v_P/dt - convectionTerm + diffusionTerm;
+      const PetscInt i0 = boxes[b][0][0], i1 = boxes[b][0][1],
+                     j0 = boxes[b][1][0], j1 = boxes[b][1][1];
+      // points adjacent to a non-periodic boundary in x use the general treatment
+      PetscInt iStart = (periodicX) ? i0 : PetscMax(i0, 1),
+               iEnd = (periodicX) ? i1 : PetscMax(PetscMin(i1, M-1), iStart);
+#pragma omp parallel for private(i)
+      for (j=j0; j<j1; j++)
+      {
+        for (i=i0; i<iStart; i++)
+          explicitTermY(i, j);
+        const PetscReal *qyP = qy[j], *qyS = qy[j-1], *qyN = qy[j+1],
+                        *qxP = qx[j], *qxN = qx[j+1];
+        PetscReal *HyRow = Hy[j], *ryRow = ry[j];
+        const PetscReal iyP = idy[j], iyN = idy[j+1], isyP = isy[j], syP = staggeredWidths[1][j],
+                        Lym = LMinus[1][1][j], Lyc = LCenter[1][1][j], Lyp = LPlus[1][1][j];
+        for (i=iStart; i<iEnd; i++)
+        {
+          const PetscReal vP = qyP[i]*idx[i], vW = qyP[i-1]*idx[i-1], vE = qyP[i+1]*idx[i+1],
+                          vS = qyS[i]*idx[i], vN = qyN[i]*idx[i];
+          const PetscReal vw = 0.5*(vW + vP), ve = 0.5*(vP + vE),
+                          vs = 0.5*(vS + vP), vn = 0.5*(vP + vN);
+          const PetscReal uw = 0.5*(qxP[i-1]*iyP + qxN[i-1]*iyN),
+                          ue = 0.5*(qxP[i]*iyP + qxN[i]*iyN);
+          const PetscReal Hprev = HyRow[i],
+                          Hcur = (ue*ve - uw*vw)*idx[i] + (vn*vn - vs*vs)*isyP;
+          HyRow[i] = Hcur;
+          ryRow[i] = vP*dtInv - (gamma*Hcur + zeta*Hprev)
+                     + alphaNu*(  Lxm[i]*vW + Lxc[i]*vP + Lxp[i]*vE
+                                + Lym*vS + Lyc*vP + Lyp*vN );
+        }
+        if (scaleByMHat)
+        {
+          for (i=iStart; i<iEnd; i++)
+            ryRow[i] *= syP;
+        }
+        for (i=iEnd; i<i1; i++)
+          explicitTermY(i, j);
+      }
     }
   }
   ierr = DMDAVecRestoreArray(vda, HyGlobal, &Hy); CHKERRQ(ierr);
   ierr = DMDAVecRestoreArray(vda, ryGlobal, &ry); CHKERRQ(ierr);
   
-  ierr = DMDAVecRestoreArray(uda, qxLocal, &qx); CHKERRQ(ierr);
-  ierr = DMDAVecRestoreArray(vda, qyLocal, &qy); CHKERRQ(ierr);
+  ierr = DMDAVecRestoreArrayRead(uda, (region == HALO_FREE) ? qxGlobal : qxLocal, &qx); CHKERRQ(ierr);
+  ierr = DMDAVecRestoreArrayRead(vda, (region == HALO_FREE) ? qyGlobal : qyLocal, &qy); CHKERRQ(ierr);
   
   ierr = DMCompositeRestoreAccess(qPack, H,  &HxGlobal, &HyGlobal); CHKERRQ(ierr);
-  ierr = DMCompositeRestoreAccess(qPack, rn, &rxGlobal, &ryGlobal); CHKERRQ(ierr);
+  ierr = DMCompositeRestoreAccess(qPack, r, &rxGlobal, &ryGlobal); CHKERRQ(ierr);
 
-  ierr = PetscObjectViewFromOptions((PetscObject) qxLocal, NULL, "-qxLocal_vec_view"); CHKERRQ(ierr);
-  ierr = PetscObjectViewFromOptions((PetscObject) qyLocal, NULL, "-qyLocal_vec_view"); CHKERRQ(ierr);
-  ierr = PetscObjectViewFromOptions((PetscObject) H, NULL, "-H_vec_view"); CHKERRQ(ierr);
-  ierr = PetscObjectViewFromOptions((PetscObject) rn, NULL, "-rn_vec_view"); CHKERRQ(ierr);
+  if (region != HALO_FREE)
+  {
+    ierr = PetscObjectViewFromOptions((PetscObject) qxLocal, NULL, "-qxLocal_vec_view"); CHKERRQ(ierr);
+    ierr = PetscObjectViewFromOptions((PetscObject) qyLocal, NULL, "-qyLocal_vec_view"); CHKERRQ(ierr);
+    ierr = PetscObjectViewFromOptions((PetscObject) H, NULL, "-H_vec_view"); CHKERRQ(ierr);
+  }
 
   return 0;
-} // calculateExplicitTerms
+} // calculateExplicitTermsKernel
 
 
 // three-dimensional specialization
 template <>
-PetscErrorCode NavierStokesSolver<3>::calculateExplicitTerms()
+template <PetscBool uniformX>
+PetscErrorCode NavierStokesSolver<3>::calculateExplicitTermsKernel(Vec r, PetscBool scaleByMHat, KernelRegion region)
 {
   PetscErrorCode ierr;
 
@@ -189,16 +453,8 @@ PetscErrorCode NavierStokesSolver<3>::calculateExplicitTerms()
            M, N, P,                // global number of nodes along each direction
            m, n, p,                // local number of nodes along each direction
            mstart, nstart, pstart; // starting indices
-
-  PetscReal HnMinus1; // convection term at previous time-step
-  PetscReal u_W, u_P, u_E, u_S, u_N, u_B, u_F, // West, Point, East, South, North, Back, Front x-velocities
-            v_W, v_P, v_E, v_S, v_N, v_B, v_F, // West, Point, East, South, North, Back, Front y-velocities
-            w_W, w_P, w_E, w_S, w_N, w_B, w_F, // West, Point, East, South, North, Back, Front z-velocities
-            u_w, u_e, u_s, u_n, u_b, u_f, // interpolated x-velocities
-            v_w, v_e, v_s, v_n, v_b, v_f, // interpolated y-velocities
-            w_w, w_e, w_s, w_n, w_b, w_f; // interpolated z-velocities
-  PetscReal convectionTerm, // value of convection term
-            diffusionTerm;  // value of diffusion term
+  PetscInt boxes[6][3][2], // boxes of owned points covering the region
+           numBoxes, b;
 
   PetscReal *dx = &mesh->dx[0],
             *dy = &mesh->dy[0],
@@ -212,8 +468,8 @@ PetscErrorCode NavierStokesSolver<3>::calculateExplicitTerms()
             alpha = parameters->diffusion.coefficients[1],  // explicit (n) diffusion coefficient
             gamma = parameters->convection.coefficients[1], // explicit (n) convection coefficient
             zeta  = parameters->convection.coefficients[2]; // explicit (n-1) convection coefficient
-
-  PetscReal dxMinus, dxPlus, dyMinus, dyPlus, dzMinus, dzPlus;
+  PetscReal dtInv = 1.0/dt,
+            alphaNu = alpha*nu;
 
   PetscBool periodicX = (flow->boundaries[XMINUS][0].type == PERIODIC) ? PETSC_TRUE : PETSC_FALSE,
             periodicY = (flow->boundaries[YMINUS][0].type == PERIODIC) ? PETSC_TRUE : PETSC_FALSE,
@@ -222,63 +478,135 @@ PetscErrorCode NavierStokesSolver<3>::calculateExplicitTerms()
   Vec HxGlobal, HyGlobal, HzGlobal;  
   ierr = DMCompositeGetAccess(qPack, H,  &HxGlobal, &HyGlobal, &HzGlobal); CHKERRQ(ierr);
   Vec rxGlobal, ryGlobal, rzGlobal;
-  ierr = DMCompositeGetAccess(qPack, rn, &rxGlobal, &ryGlobal, &rzGlobal); CHKERRQ(ierr);
+  ierr = DMCompositeGetAccess(qPack, r, &rxGlobal, &ryGlobal, &rzGlobal); CHKERRQ(ierr);
   
-  // access local vectors through multi-dimensional pointers
+  // access fluxes through multi-dimensional pointers
+  // (points of the halo-free region are read from the global vector)
   PetscReal ***qx, ***qy, ***qz;
-  ierr = DMDAVecGetArray(uda, qxLocal, &qx); CHKERRQ(ierr);
-  ierr = DMDAVecGetArray(vda, qyLocal, &qy); CHKERRQ(ierr);
-  ierr = DMDAVecGetArray(wda, qzLocal, &qz); CHKERRQ(ierr);
+  ierr = DMDAVecGetArrayRead(uda, (region == HALO_FREE) ? qxGlobal : qxLocal, &qx); CHKERRQ(ierr);
+  ierr = DMDAVecGetArrayRead(vda, (region == HALO_FREE) ? qyGlobal : qyLocal, &qy); CHKERRQ(ierr);
+  ierr = DMDAVecGetArrayRead(wda, (region == HALO_FREE) ? qzGlobal : qzLocal, &qz); CHKERRQ(ierr);
   
   // compute explicit terms: x-component
   PetscReal ***Hx, ***rx;
   ierr = DMDAVecGetArray(uda, HxGlobal, &Hx); CHKERRQ(ierr);
   ierr = DMDAVecGetArray(uda, rxGlobal, &rx); CHKERRQ(ierr);
   ierr = DMDAGetCorners(uda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
+  {
+    const PetscInt owned[3][2] = {{mstart, mstart+m}, {nstart, nstart+n}, {pstart, pstart+p}};
+    numBoxes = getRegionBoxes(region, owned, haloFreeBox, boxes);
+  }
   ierr = DMDAGetInfo(uda, NULL, &M, &N, &P, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
-  for (k=pstart; k<pstart+p; k++)
+  // explicit term at a single point (also valid next to a boundary)
+  auto explicitTermX = [&](PetscInt i, PetscInt j, PetscInt k)
   {
-    for (j=nstart; j<nstart+n; j++)
+    PetscReal HnMinus1; // convection term at previous time-step
+    PetscReal u_W, u_P, u_E, u_S, u_N, u_B, u_F; // velocities at the node and its neighbours
+    PetscReal u_w, u_e, u_s, u_n, u_b, u_f, v_s, v_n, w_b, w_f; // interpolated velocities
+    PetscReal dxMinus, dxPlus, dyMinus, dyPlus, dzMinus, dzPlus;
+    PetscReal convectionTerm, diffusionTerm;
+    // velocity value at nodes
+    u_P = qx[k][j][i]/(dy[j]*dz[k]);
+    u_W = qx[k][j][i-1]/(dy[j]*dz[k]);
+    u_E = qx[k][j][i+1]/(dy[j]*dz[k]);
+    u_S = (j > 0)   ? qx[k][j-1][i]/(dy[j-1]*dz[k]) : (periodicY) ? qx[k][j-1][i]/(dy[ny-1]*dz[k]) : qx[k][j-1][i];
+    u_N = (j < N-1) ? qx[k][j+1][i]/(dy[j+1]*dz[k]) : (periodicY) ? qx[k][j+1][i]/(dy[0]*dz[k])    : qx[k][j+1][i];
+    u_B = (k > 0)   ? qx[k-1][j][i]/(dy[j]*dz[k-1]) : (periodicZ) ? qx[k-1][j][i]/(dy[j]*dz[nz-1]) : qx[k-1][j][i];
+    u_F = (k < P-1) ? qx[k+1][j][i]/(dy[j]*dz[k+1]) : (periodicZ) ? qx[k+1][j][i]/(dy[j]*dz[0])    : qx[k+1][j][i];
+    // interpolated velocity values
+    u_w = 0.5*(u_W + u_P);
+    u_e = 0.5*(u_P + u_E);
+    u_s = (j == 0 && !periodicY)   ? u_S : 0.5*(u_S + u_P);
+    u_n = (j == N-1 && !periodicY) ? u_N : 0.5*(u_P + u_N);
+    u_b = (k == 0 && !periodicZ)   ? u_B : 0.5*(u_B + u_P);
+    u_f = (k == P-1 && !periodicZ) ? u_F : 0.5*(u_P + u_F);
+    dxMinus = dx[i];
+    dxPlus = (i == M-1 && periodicX) ? dx[0] : dx[i+1];
+    v_s = 0.5*(qy[k][j-1][i]/(dxMinus*dz[k]) + qy[k][j-1][i+1]/(dxPlus*dz[k]));
+    v_n = 0.5*(qy[k][j][i]/(dxMinus*dz[k])   + qy[k][j][i+1]/(dxPlus*dz[k]));
+    w_b = 0.5*(qz[k-1][j][i]/(dxMinus*dy[j]) + qz[k-1][j][i+1]/(dxPlus*dy[j]));
+    w_f = 0.5*(qz[k][j][i]/(dxMinus*dy[j])   + qz[k][j][i+1]/(dxPlus*dy[j]));
+    // convection term: Hx = d(u^2)/dx + d(uv)/dy + d(uw)/dz
+    HnMinus1 = Hx[k][j][i];
+    Hx[k][j][i] = (  (u_e*u_e - u_w*u_w)/(0.5*(dxMinus + dxPlus)) 
+                   + (v_n*u_n - v_s*u_s)/dy[j]
+                   + (w_f*u_f - w_b*u_b)/dz[k] );
+    convectionTerm = gamma*Hx[k][j][i] + zeta*HnMinus1;
+    // diffusion term: d^2u/dx^2 + d^2u/dy^2 + d^2u/dz^2
+    dyMinus = (j > 0)  ? 0.5*(dy[j-1] + dy[j]) : (periodicY) ? 0.5*(dy[ny-1] + dy[j]) : 0.5*dy[j];
+    dyPlus = (j < N-1) ? 0.5*(dy[j] + dy[j+1]) : (periodicY) ? 0.5*(dy[j] + dy[0])    : 0.5*dy[j];
+    dzMinus = (k > 0)  ? 0.5*(dz[k-1] + dz[k]) : (periodicZ) ? 0.5*(dz[nz-1] + dz[k]) : 0.5*dz[k];
+    dzPlus = (k < P-1) ? 0.5*(dz[k] + dz[k+1]) : (periodicZ) ? 0.5*(dz[k] + dz[0])    : 0.5*dz[k];
+    diffusionTerm = alpha*nu * (  d2udx2(u_W, u_P, u_E, dxMinus, dxPlus)
+                                + d2udx2(u_S, u_P, u_N, dyMinus, dyPlus)
+                                + d2udx2(u_B, u_P, u_F, dzMinus, dzPlus) );
+    // explicit term
+    rx[k][j][i] = u_P/dt - convectionTerm + diffusionTerm;
+    if (scaleByMHat)
+      rx[k][j][i] *= 0.5*(dxMinus + dxPlus);
+  };
+  {
+    // metrics along x are constants when the grid is uniform in that direction
+    const GridMetric<uniformX> idx(invWidths[0], 1), // reciprocals of the cell-widths
+                               sx(staggeredWidths[0]),
+                               isx(invStaggeredWidths[0]),
+                               Lxm(LMinus[0][0]), Lxc(LCenter[0][0]), Lxp(LPlus[0][0]);
+    const PetscReal *idy = &invWidths[1][1],
+                    *idz = &invWidths[2][1];
+    for (b=0; b<numBoxes; b++)
     {
-      for (i=mstart; i<mstart+m; i++)
+      const PetscInt i0 = boxes[b][0][0], i1 = boxes[b][0][1],
+                     j0 = boxes[b][1][0], j1 = boxes[b][1][1],
+                     k0 = boxes[b][2][0], k1 = boxes[b][2][1];
+#pragma omp parallel for private(i, j)
+      for (k=k0; k<k1; k++)
       {
-        // velocity value at nodes
-        u_P = qx[k][j][i]/(dy[j]*dz[k]);
-        u_W = qx[k][j][i-1]/(dy[j]*dz[k]);
-        u_E = qx[k][j][i+1]/(dy[j]*dz[k]);
-        u_S = (j > 0)   ? qx[k][j-1][i]/(dy[j-1]*dz[k]) : (periodicY) ? qx[k][j-1][i]/(dy[ny-1]*dz[k]) : qx[k][j-1][i];
-        u_N = (j < N-1) ? qx[k][j+1][i]/(dy[j+1]*dz[k]) : (periodicY) ? qx[k][j+1][i]/(dy[0]*dz[k])    : qx[k][j+1][i];
-        u_B = (k > 0)   ? qx[k-1][j][i]/(dy[j]*dz[k-1]) : (periodicZ) ? qx[k-1][j][i]/(dy[j]*dz[nz-1]) : qx[k-1][j][i];
-        u_F = (k < P-1) ? qx[k+1][j][i]/(dy[j]*dz[k+1]) : (periodicZ) ? qx[k+1][j][i]/(dy[j]*dz[0])    : qx[k+1][j][i];
-        // interpolated velocity values
-        u_w = 0.5*(u_W + u_P);
-        u_e = 0.5*(u_P + u_E);
-        u_s = (j == 0 && !periodicY)   ? u_S : 0.5*(u_S + u_P);
-        u_n = (j == N-1 && !periodicY) ? u_N : 0.5*(u_P + u_N);
-        u_b = (k == 0 && !periodicZ)   ? u_B : 0.5*(u_B + u_P);
-        u_f = (k == P-1 && !periodicZ) ? u_F : 0.5*(u_P + u_F);
-        dxMinus = dx[i];
-        dxPlus = (i == M-1 && periodicX) ? dx[0] : dx[i+1];
-        v_s = 0.5*(qy[k][j-1][i]/(dxMinus*dz[k]) + qy[k][j-1][i+1]/(dxPlus*dz[k]));
-        v_n = 0.5*(qy[k][j][i]/(dxMinus*dz[k])   + qy[k][j][i+1]/(dxPlus*dz[k]));
-        w_b = 0.5*(qz[k-1][j][i]/(dxMinus*dy[j]) + qz[k-1][j][i+1]/(dxPlus*dy[j]));
-        w_f = 0.5*(qz[k][j][i]/(dxMinus*dy[j])   + qz[k][j][i+1]/(dxPlus*dy[j]));
-        // convection term: Hx = d(u^2)/dx + d(uv)/dy + d(uw)/dz
-        HnMinus1 = Hx[k][j][i];
-        Hx[k][j][i] = (  (u_e*u_e - u_w*u_w)/(0.5*(dxMinus + dxPlus)) 
-                       + (v_n*u_n - v_s*u_s)/dy[j]
-                       + (w_f*u_f - w_b*u_b)/dz[k] );
-        convectionTerm = gamma*Hx[k][j][i] + zeta*HnMinus1;
-        // diffusion term: d^2u/dx^2 + d^2u/dy^2 + d^2u/dz^2
-        dyMinus = (j > 0)  ? 0.5*(dy[j-1] + dy[j]) : (periodicY) ? 0.5*(dy[ny-1] + dy[j]) : 0.5*dy[j];
-        dyPlus = (j < N-1) ? 0.5*(dy[j] + dy[j+1]) : (periodicY) ? 0.5*(dy[j] + dy[0])    : 0.5*dy[j];
-        dzMinus = (k > 0)  ? 0.5*(dz[k-1] + dz[k]) : (periodicZ) ? 0.5*(dz[nz-1] + dz[k]) : 0.5*dz[k];
-        dzPlus = (k < P-1) ? 0.5*(dz[k] + dz[k+1]) : (periodicZ) ? 0.5*(dz[k] + dz[0])    : 0.5*dz[k];
-        diffusionTerm = alpha*nu * (  d2udx2(u_W, u_P, u_E, dxMinus, dxPlus)
-                                    + d2udx2(u_S, u_P, u_N, dyMinus, dyPlus)
-                                    + d2udx2(u_B, u_P, u_F, dzMinus, dzPlus) );
-        // explicit term
-        rx[k][j][i] = u_P/dt - convectionTerm + diffusionTerm;
+        for (j=j0; j<j1; j++)
+        {
+          // rows adjacent to a non-periodic boundary use the general treatment
+          PetscInt iStart = (   (periodicY || (j > 0 && j < N-1)) 
+                             && (periodicZ || (k > 0 && k < P-1)) ) ? i0 : i1,
+                   iEnd = i1;
+          for (i=i0; i<iStart; i++)
+            explicitTermX(i, j, k);
+          const PetscReal *qxP = qx[k][j], *qxS = qx[k][j-1], *qxN = qx[k][j+1],
+                          *qxB = qx[k-1][j], *qxF = qx[k+1][j],
+                          *qyS = qy[k][j-1], *qyP = qy[k][j],
+                          *qzB = qz[k-1][j], *qzP = qz[k][j];
+          PetscReal *HxRow = Hx[k][j], *rxRow = rx[k][j];
+          const PetscReal iyP = idy[j], izP = idz[k],
+                          aP = iyP*izP, aS = idy[j-1]*izP, aN = idy[j+1]*izP,
+                          aB = iyP*idz[k-1], aF = iyP*idz[k+1],
+                          Lym = LMinus[0][1][j], Lyc = LCenter[0][1][j], Lyp = LPlus[0][1][j],
+                          Lzm = LMinus[0][2][k], Lzc = LCenter[0][2][k], Lzp = LPlus[0][2][k];
+          for (i=iStart; i<iEnd; i++)
+          {
+            const PetscReal uP = qxP[i]*aP, uW = qxP[i-1]*aP, uE = qxP[i+1]*aP,
+                            uS = qxS[i]*aS, uN = qxN[i]*aN,
+                            uB = qxB[i]*aB, uF = qxF[i]*aF;
+            const PetscReal uw = 0.5*(uW + uP), ue = 0.5*(uP + uE),
+                            us = 0.5*(uS + uP), un = 0.5*(uP + uN),
+                            ub = 0.5*(uB + uP), uf = 0.5*(uP + uF);
+            const PetscReal vs = 0.5*izP*(qyS[i]*idx[i] + qyS[i+1]*idx[i+1]),
+                            vn = 0.5*izP*(qyP[i]*idx[i] + qyP[i+1]*idx[i+1]),
+                            wb = 0.5*iyP*(qzB[i]*idx[i] + qzB[i+1]*idx[i+1]),
+                            wf = 0.5*iyP*(qzP[i]*idx[i] + qzP[i+1]*idx[i+1]);
+            const PetscReal Hprev = HxRow[i],
+                            Hcur = (  (ue*ue - uw*uw)*isx[i]
+                                    + (vn*un - vs*us)*iyP
+                                    + (wf*uf - wb*ub)*izP );
+            HxRow[i] = Hcur;
+            rxRow[i] = uP*dtInv - (gamma*Hcur + zeta*Hprev)
+                       + alphaNu*(  Lxm[i]*uW + Lxc[i]*uP + Lxp[i]*uE
+                                  + Lym*uS + Lyc*uP + Lyp*uN
+                                  + Lzm*uB + Lzc*uP + Lzp*uF );
+          }
+          if (scaleByMHat)
+          {
+            for (i=iStart; i<iEnd; i++)
+              rxRow[i] *= sx[i];
+          }
+        }
       }
     }
   }
@@ -290,50 +618,127 @@ PetscErrorCode NavierStokesSolver<3>::calculateExplicitTerms()
   ierr = DMDAVecGetArray(vda, HyGlobal, &Hy); CHKERRQ(ierr);
   ierr = DMDAVecGetArray(vda, ryGlobal, &ry); CHKERRQ(ierr);
   ierr = DMDAGetCorners(vda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
+  {
+    const PetscInt owned[3][2] = {{mstart, mstart+m}, {nstart, nstart+n}, {pstart, pstart+p}};
+    numBoxes = getRegionBoxes(region, owned, haloFreeBox, boxes);
+  }
   ierr = DMDAGetInfo(vda, NULL, &M, &N, &P, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
-  for (k=pstart; k<pstart+p; k++)
+  // explicit term at a single point (also valid next to a boundary)
+  auto explicitTermY = [&](PetscInt i, PetscInt j, PetscInt k)
   {
-    for (j=nstart; j<nstart+n; j++)
+    PetscReal HnMinus1; // convection term at previous time-step
+    PetscReal v_W, v_P, v_E, v_S, v_N, v_B, v_F; // velocities at the node and its neighbours
+    PetscReal u_w, u_e, v_w, v_e, v_s, v_n, v_b, v_f, w_b, w_f; // interpolated velocities
+    PetscReal dxMinus, dxPlus, dyMinus, dyPlus, dzMinus, dzPlus;
+    PetscReal convectionTerm, diffusionTerm;
+    // velocity value at nodes
+    v_P = qy[k][j][i]/(dx[i]*dz[k]);
+    v_W = (i > 0)   ? qy[k][j][i-1]/(dx[i-1]*dz[k]) : (periodicX) ? qy[k][j][i-1]/(dx[nx-1]*dz[k]) : qy[k][j][i-1];
+    v_E = (i < M-1) ? qy[k][j][i+1]/(dx[i+1]*dz[k]) : (periodicX) ? qy[k][j][i+1]/(dx[0]*dz[k])    : qy[k][j][i+1];
+    v_S = qy[k][j-1][i]/(dx[i]*dz[k]);
+    v_N = qy[k][j+1][i]/(dx[i]*dz[k]);
+    v_B = (k > 0)   ? qy[k-1][j][i]/(dx[i]*dz[k-1]) : (periodicZ) ? qy[k-1][j][i]/(dx[i]*dz[nz-1]) : qy[k-1][j][i];
+    v_F = (k < P-1) ? qy[k+1][j][i]/(dx[i]*dz[k+1]) : (periodicZ) ? qy[k+1][j][i]/(dx[i]*dz[0])    : qy[k+1][j][i];
+    // interpolated velocity values
+    v_w = (i == 0 && !periodicX)   ? v_W : 0.5*(v_W + v_P);
+    v_e = (i == M-1 && !periodicX) ? v_E : 0.5*(v_P + v_E);
+    v_s = 0.5*(v_S + v_P);
+    v_n = 0.5*(v_P + v_N);
+    v_b = (k == 0 && !periodicZ)   ? v_B : 0.5*(v_B + v_P);
+    v_f = (k == P-1 && !periodicZ) ? v_F : 0.5*(v_P + v_F);
+    dyMinus = dy[j];
+    dyPlus = (j == N-1 && periodicY) ? dy[0] : dy[j+1];
+    u_w = 0.5*(qx[k][j][i-1]/(dyMinus*dz[k]) + qx[k][j+1][i-1]/(dyPlus*dz[k]));
+    u_e = 0.5*(qx[k][j][i]/(dyMinus*dz[k]) + qx[k][j+1][i]/(dyPlus*dz[k]));
+    w_b = 0.5*(qz[k-1][j][i]/(dx[i]*dyMinus) + qz[k-1][j+1][i]/(dx[i]*dyPlus));
+    w_f = 0.5*(qz[k][j][i]/(dx[i]*dyMinus) + qz[k][j+1][i]/(dx[i]*dyPlus));
+    // convection term: Hy = d(vu)/dx + d(v^2)/dy + d(vw)/dz
+    HnMinus1 = Hy[k][j][i];
+    Hy[k][j][i] = (  (u_e*v_e - u_w*v_w)/dx[i] 
+                   + (v_n*v_n - v_s*v_s)/(0.5*(dyMinus + dyPlus))
+                   + (w_f*v_f - w_b*v_b)/dz[k] );
+    convectionTerm = gamma*Hy[k][j][i] + zeta*HnMinus1;
+    // diffusion term: d^2v/dx^2 + d^2v/dy^2 + d^2v/dz^2
+    dxMinus = (i > 0)  ? 0.5*(dx[i-1] + dx[i]) : (periodicX) ? 0.5*(dx[nx-1] + dx[i]) : 0.5*dx[i];
+    dxPlus = (i < M-1) ? 0.5*(dx[i] + dx[i+1]) : (periodicX) ? 0.5*(dx[i] + dx[0])    : 0.5*dx[i];
+    dzMinus = (k > 0)  ? 0.5*(dz[k-1] + dz[k]) : (periodicZ) ? 0.5*(dz[nz-1] + dz[k]) : 0.5*dz[k];
+    dzPlus = (k < P-1) ? 0.5*(dz[k] + dz[k+1]) : (periodicZ) ? 0.5*(dz[k] + dz[0])    : 0.5*dz[k];
+    diffusionTerm = alpha*nu * (  d2udx2(v_W, v_P, v_E, dxMinus, dxPlus)
+                                + d2udx2(v_S, v_P, v_N, dyMinus, dyPlus)
+                                + d2udx2(v_B, v_P, v_F, dzMinus, dzPlus) );
+    // explicit term
+    ry[k][j][i] = v_P/dt - convectionTerm + diffusionTerm;
+    if (scaleByMHat)
+      ry[k][j][i] *= 0.5*(dyMinus + dyPlus);
+  };
+  {
+    // metrics along x are constants when the grid is uniform in that direction
+    const GridMetric<uniformX> idx(invWidths[0], 1), // reciprocals of the cell-widths
+                               Lxm(LMinus[1][0]), Lxc(LCenter[1][0]), Lxp(LPlus[1][0]);
+    const PetscReal *idy = &invWidths[1][1],
+                    *idz = &invWidths[2][1],
+                    *isy = &invStaggeredWidths[1][0];
+    for (b=0; b<numBoxes; b++)
     {
-      for (i=mstart; i<mstart+m; i++)
+      const PetscInt i0 = boxes[b][0][0], i1 = boxes[b][0][1],
+                     j0 = boxes[b][1][0], j1 = boxes[b][1][1],
+                     k0 = boxes[b][2][0], k1 = boxes[b][2][1];
+#pragma omp parallel for private(i, j)
+      for (k=k0; k<k1; k++)
       {
-        // velocity value at nodes
-        v_P = qy[k][j][i]/(dx[i]*dz[k]);
-        v_W = (i > 0)   ? qy[k][j][i-1]/(dx[i-1]*dz[k]) : (periodicX) ? qy[k][j][i-1]/(dx[nx-1]*dz[k]) : qy[k][j][i-1];
-        v_E = (i < M-1) ? qy[k][j][i+1]/(dx[i+1]*dz[k]) : (periodicX) ? qy[k][j][i+1]/(dx[0]*dz[k])    : qy[k][j][i+1];
-        v_S = qy[k][j-1][i]/(dx[i]*dz[k]);
-        v_N = qy[k][j+1][i]/(dx[i]*dz[k]);
-        v_B = (k > 0)   ? qy[k-1][j][i]/(dx[i]*dz[k-1]) : (periodicZ) ? qy[k-1][j][i]/(dx[i]*dz[nz-1]) : qy[k-1][j][i];
-        v_F = (k < P-1) ? qy[k+1][j][i]/(dx[i]*dz[k+1]) : (periodicZ) ? qy[k+1][j][i]/(dx[i]*dz[0])    : qy[k+1][j][i];
-        // interpolated velocity values
-        v_w = (i == 0 && !periodicX)   ? v_W : 0.5*(v_W + v_P);
-        v_e = (i == M-1 && !periodicX) ? v_E : 0.5*(v_P + v_E);
-        v_s = 0.5*(v_S + v_P);
-        v_n = 0.5*(v_P + v_N);
-        v_b = (k == 0 && !periodicZ)   ? v_B : 0.5*(v_B + v_P);
-        v_f = (k == P-1 && !periodicZ) ? v_F : 0.5*(v_P + v_F);
-        dyMinus = dy[j];
-        dyPlus = (j == N-1 && periodicY) ? dy[0] : dy[j+1];
-        u_w = 0.5*(qx[k][j][i-1]/(dyMinus*dz[k]) + qx[k][j+1][i-1]/(dyPlus*dz[k]));
-        u_e = 0.5*(qx[k][j][i]/(dyMinus*dz[k]) + qx[k][j+1][i]/(dyPlus*dz[k]));
-        w_b = 0.5*(qz[k-1][j][i]/(dx[i]*dyMinus) + qz[k-1][j+1][i]/(dx[i]*dyPlus));
-        w_f = 0.5*(qz[k][j][i]/(dx[i]*dyMinus) + qz[k][j+1][i]/(dx[i]*dyPlus));
-        // convection term: Hy = d(vu)/dx + d(v^2)/dy + d(vw)/dz
-        HnMinus1 = Hy[k][j][i];
-        Hy[k][j][i] = (  (u_e*v_e - u_w*v_w)/dx[i] 
-                       + (v_n*v_n - v_s*v_s)/(0.5*(dyMinus + dyPlus))
-                       + (w_f*v_f - w_b*v_b)/dz[k] );
-        convectionTerm = gamma*Hy[k][j][i] + zeta*HnMinus1;
-        // diffusion term: d^2v/dx^2 + d^2v/dy^2 + d^2v/dz^2
-        dxMinus = (i > 0)  ? 0.5*(dx[i-1] + dx[i]) : (periodicX) ? 0.5*(dx[nx-1] + dx[i]) : 0.5*dx[i];
-        dxPlus = (i < M-1) ? 0.5*(dx[i] + dx[i+1]) : (periodicX) ? 0.5*(dx[i] + dx[0])    : 0.5*dx[i];
-        dzMinus = (k > 0)  ? 0.5*(dz[k-1] + dz[k]) : (periodicZ) ? 0.5*(dz[nz-1] + dz[k]) : 0.5*dz[k];
-        dzPlus = (k < P-1) ? 0.5*(dz[k] + dz[k+1]) : (periodicZ) ? 0.5*(dz[k] + dz[0])    : 0.5*dz[k];
-        diffusionTerm = alpha*nu * (  d2udx2(v_W, v_P, v_E, dxMinus, dxPlus)
-                                    + d2udx2(v_S, v_P, v_N, dyMinus, dyPlus)
-                                    + d2udx2(v_B, v_P, v_F, dzMinus, dzPlus) );
-        // explicit term
-        ry[k][j][i] = v_P/dt - convectionTerm + diffusionTerm;
+        // points adjacent to a non-periodic boundary in x or z use the general treatment
+        PetscInt iStart, iEnd;
+        if (periodicZ || (k > 0 && k < P-1))
+        {
+          iStart = (periodicX) ? i0 : PetscMax(i0, 1);
+          iEnd = (periodicX) ? i1 : PetscMax(PetscMin(i1, M-1), iStart);
+        }
+        else
+          iStart = iEnd = i1;
+        for (j=j0; j<j1; j++)
+        {
+          for (i=i0; i<iStart; i++)
+            explicitTermY(i, j, k);
+          const PetscReal *qyP = qy[k][j], *qyS = qy[k][j-1], *qyN = qy[k][j+1],
+                          *qyB = qy[k-1][j], *qyF = qy[k+1][j],
+                          *qxP = qx[k][j], *qxN = qx[k][j+1],
+                          *qzB = qz[k-1][j], *qzBN = qz[k-1][j+1],
+                          *qzP = qz[k][j], *qzPN = qz[k][j+1];
+          PetscReal *HyRow = Hy[k][j], *ryRow = ry[k][j];
+          const PetscReal iyP = idy[j], iyN = idy[j+1], isyP = isy[j], syP = staggeredWidths[1][j],
+                          izP = idz[k], izB = idz[k-1], izF = idz[k+1],
+                          Lym = LMinus[1][1][j], Lyc = LCenter[1][1][j], Lyp = LPlus[1][1][j],
+                          Lzm = LMinus[1][2][k], Lzc = LCenter[1][2][k], Lzp = LPlus[1][2][k];
+          for (i=iStart; i<iEnd; i++)
+          {
+            const PetscReal vP = qyP[i]*idx[i]*izP, vW = qyP[i-1]*idx[i-1]*izP, vE = qyP[i+1]*idx[i+1]*izP,
+                            vS = qyS[i]*idx[i]*izP, vN = qyN[i]*idx[i]*izP,
+                            vB = qyB[i]*idx[i]*izB, vF = qyF[i]*idx[i]*izF;
+            const PetscReal vw = 0.5*(vW + vP), ve = 0.5*(vP + vE),
+                            vs = 0.5*(vS + vP), vn = 0.5*(vP + vN),
+                            vb = 0.5*(vB + vP), vf = 0.5*(vP + vF);
+            const PetscReal uw = 0.5*izP*(qxP[i-1]*iyP + qxN[i-1]*iyN),
+                            ue = 0.5*izP*(qxP[i]*iyP + qxN[i]*iyN),
+                            wb = 0.5*idx[i]*(qzB[i]*iyP + qzBN[i]*iyN),
+                            wf = 0.5*idx[i]*(qzP[i]*iyP + qzPN[i]*iyN);
+            const PetscReal Hprev = HyRow[i],
+                            Hcur = (  (ue*ve - uw*vw)*idx[i]
+                                    + (vn*vn - vs*vs)*isyP
+                                    + (wf*vf - wb*vb)*izP );
+            HyRow[i] = Hcur;
+            ryRow[i] = vP*dtInv - (gamma*Hcur + zeta*Hprev)
+                       + alphaNu*(  Lxm[i]*vW + Lxc[i]*vP + Lxp[i]*vE
+                                  + Lym*vS + Lyc*vP + Lyp*vN
+                                  + Lzm*vB + Lzc*vP + Lzp*vF );
+          }
+          if (scaleByMHat)
+          {
+            for (i=iStart; i<iEnd; i++)
+              ryRow[i] *= syP;
+          }
+          for (i=iEnd; i<i1; i++)
+            explicitTermY(i, j, k);
+        }
       }
     }
   }
@@ -345,65 +750,144 @@ PetscErrorCode NavierStokesSolver<3>::calculateExplicitTerms()
   ierr = DMDAVecGetArray(wda, HzGlobal, &Hz); CHKERRQ(ierr);
   ierr = DMDAVecGetArray(wda, rzGlobal, &rz); CHKERRQ(ierr);
   ierr = DMDAGetCorners(wda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
+  {
+    const PetscInt owned[3][2] = {{mstart, mstart+m}, {nstart, nstart+n}, {pstart, pstart+p}};
+    numBoxes = getRegionBoxes(region, owned, haloFreeBox, boxes);
+  }
   ierr = DMDAGetInfo(wda, NULL, &M, &N, &P, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
-  for (k=pstart; k<pstart+p; k++)
+  // explicit term at a single point (also valid next to a boundary)
+  auto explicitTermZ = [&](PetscInt i, PetscInt j, PetscInt k)
+  {
+    PetscReal HnMinus1; // convection term at previous time-step
+    PetscReal w_W, w_P, w_E, w_S, w_N, w_B, w_F; // velocities at the node and its neighbours
+    PetscReal u_w, u_e, v_s, v_n, w_w, w_e, w_s, w_n, w_b, w_f; // interpolated velocities
+    PetscReal dxMinus, dxPlus, dyMinus, dyPlus, dzMinus, dzPlus;
+    PetscReal convectionTerm, diffusionTerm;
+    // velocity value at nodes
+    w_P = qz[k][j][i]/(dx[i]*dy[j]);
+    w_W = (i > 0)   ? qz[k][j][i-1]/(dx[i-1]*dy[j]) : (periodicX) ? qz[k][j][i-1]/(dx[nx-1]*dy[j]) : qz[k][j][i-1];
+    w_E = (i < M-1) ? qz[k][j][i+1]/(dx[i+1]*dy[j]) : (periodicX) ? qz[k][j][i+1]/(dx[0]*dy[j])    : qz[k][j][i+1];
+    w_S = (j > 0)   ? qz[k][j-1][i]/(dx[i]*dy[j-1]) : (periodicY) ? qz[k][j-1][i]/(dx[i]*dy[ny-1]) : qz[k][j-1][i];
+    w_N = (j < N-1) ? qz[k][j+1][i]/(dx[i]*dy[j+1]) : (periodicY) ? qz[k][j+1][i]/(dx[i]*dy[0])    : qz[k][j+1][i];
+    w_B = qz[k-1][j][i]/(dx[i]*dy[j]);
+    w_F = qz[k+1][j][i]/(dx[i]*dy[j]);
+    // interpolated velocity values
+    w_w = (i == 0 && !periodicX)   ? w_W : 0.5*(w_W + w_P);
+    w_e = (i == M-1 && !periodicX) ? w_E : 0.5*(w_P + w_E);
+    w_s = (j == 0 && !periodicY)   ? w_S : 0.5*(w_S + w_P);
+    w_n = (j == N-1 && !periodicY) ? w_N : 0.5*(w_P + w_N);
+    w_b = 0.5*(w_B + w_P);
+    w_f = 0.5*(w_P + w_F);
+    dzMinus = dz[k];
+    dzPlus = (k == P-1 && periodicZ) ? dz[0] : dz[k+1];
+    u_w = 0.5*(qx[k][j][i-1]/(dy[j]*dzMinus) + qx[k+1][j][i-1]/(dy[j]*dzPlus));
+    u_e = 0.5*(qx[k][j][i]/(dy[j]*dzMinus) + qx[k+1][j][i]/(dy[j]*dzPlus));
+    v_s = 0.5*(qy[k][j-1][i]/(dx[i]*dzMinus) + qy[k+1][j-1][i]/(dx[i]*dzPlus));
+    v_n = 0.5*(qy[k][j][i]/(dx[i]*dzMinus) + qy[k+1][j][i]/(dx[i]*dzPlus));
+    // convection term: Hz = d(wu)/dx + d(wv)/dy + d(w^2)/dz
+    HnMinus1 = Hz[k][j][i];
+    Hz[k][j][i] = (  (u_e*w_e - u_w*w_w)/dx[i] 
+                   + (v_n*w_n - v_s*w_s)/dy[j]
+                   + (w_f*w_f - w_b*w_b)/(0.5*(dzMinus + dzPlus)) );
+    convectionTerm = gamma*Hz[k][j][i] + zeta*HnMinus1;
+    // diffusion term: d^2w/dx^2 + d^2w/dy^2 + d^2w/dz^2
+    dxMinus = (i > 0)  ? 0.5*(dx[i-1] + dx[i]) : (periodicX) ? 0.5*(dx[nx-1] + dx[i]) : 0.5*dx[i];
+    dxPlus = (i < M-1) ? 0.5*(dx[i] + dx[i+1]) : (periodicX) ? 0.5*(dx[i] + dx[0])    : 0.5*dx[i];
+    dyMinus = (j > 0)  ? 0.5*(dy[j-1] + dy[j]) : (periodicY) ? 0.5*(dy[ny-1] + dy[j]) : 0.5*dy[j];
+    dyPlus = (j < N-1) ? 0.5*(dy[j] + dy[j+1]) : (periodicY) ? 0.5*(dy[j] + dy[0])    : 0.5*dy[j];
+    diffusionTerm = alpha*nu * (  d2udx2(w_W, w_P, w_E, dxMinus, dxPlus)
+                                + d2udx2(w_S, w_P, w_N, dyMinus, dyPlus)
+                                + d2udx2(w_B, w_P, w_F, dzMinus, dzPlus) );
+    // explicit term
+    rz[k][j][i] = w_P/dt - convectionTerm + diffusionTerm;
+    if (scaleByMHat)
+      rz[k][j][i] *= 0.5*(dzMinus + dzPlus);
+  };
   {
-    for (j=nstart; j<nstart+n; j++)
+    // metrics along x are constants when the grid is uniform in that direction
+    const GridMetric<uniformX> idx(invWidths[0], 1), // reciprocals of the cell-widths
+                               Lxm(LMinus[2][0]), Lxc(LCenter[2][0]), Lxp(LPlus[2][0]);
+    const PetscReal *idy = &invWidths[1][1],
+                    *idz = &invWidths[2][1],
+                    *isz = &invStaggeredWidths[2][0];
+    for (b=0; b<numBoxes; b++)
     {
-      for (i=mstart; i<mstart+m; i++)
+      const PetscInt i0 = boxes[b][0][0], i1 = boxes[b][0][1],
+                     j0 = boxes[b][1][0], j1 = boxes[b][1][1],
+                     k0 = boxes[b][2][0], k1 = boxes[b][2][1];
+#pragma omp parallel for private(i, j)
+      for (k=k0; k<k1; k++)
       {
-        // velocity value at nodes
-        w_P = qz[k][j][i]/(dx[i]*dy[j]);
-        w_W = (i > 0)   ? qz[k][j][i-1]/(dx[i-1]*dy[j]) : (periodicX) ? qz[k][j][i-1]/(dx[nx-1]*dy[j]) : qz[k][j][i-1];
-        w_E = (i < M-1) ? qz[k][j][i+1]/(dx[i+1]*dy[j]) : (periodicX) ? qz[k][j][i+1]/(dx[0]*dy[j])    : qz[k][j][i+1];
-        w_S = (j > 0)   ? qz[k][j-1][i]/(dx[i]*dy[j-1]) : (periodicY) ? qz[k][j-1][i]/(dx[i]*dy[ny-1]) : qz[k][j-1][i];
-        w_N = (j < N-1) ? qz[k][j+1][i]/(dx[i]*dy[j+1]) : (periodicY) ? qz[k][j+1][i]/(dx[i]*dy[0])    : qz[k][j+1][i];
-        w_B = qz[k-1][j][i]/(dx[i]*dy[j]);
-        w_F = qz[k+1][j][i]/(dx[i]*dy[j]);
-        // interpolated velocity values
-        w_w = (i == 0 && !periodicX)   ? w_W : 0.5*(w_W + w_P);
-        w_e = (i == M-1 && !periodicX) ? w_E : 0.5*(w_P + w_E);
-        w_s = (j == 0 && !periodicY)   ? w_S : 0.5*(w_S + w_P);
-        w_n = (j == N-1 && !periodicY) ? w_N : 0.5*(w_P + w_N);
-        w_b = 0.5*(w_B + w_P);
-        w_f = 0.5*(w_P + w_F);
-        dzMinus = dz[k];
-        dzPlus = (k == P-1 && periodicZ) ? dz[0] : dz[k+1];
-        u_w = 0.5*(qx[k][j][i-1]/(dy[j]*dzMinus) + qx[k+1][j][i-1]/(dy[j]*dzPlus));
-        u_e = 0.5*(qx[k][j][i]/(dy[j]*dzMinus) + qx[k+1][j][i]/(dy[j]*dzPlus));
-        v_s = 0.5*(qy[k][j-1][i]/(dx[i]*dzMinus) + qy[k+1][j-1][i]/(dx[i]*dzPlus));
-        v_n = 0.5*(qy[k][j][i]/(dx[i]*dzMinus) + qy[k+1][j][i]/(dx[i]*dzPlus));
-        // convection term: Hz = d(wu)/dx + d(wv)/dy + d(w^2)/dz
-        HnMinus1 = Hz[k][j][i];
-        Hz[k][j][i] = (  (u_e*w_e - u_w*w_w)/dx[i] 
-                       + (v_n*w_n - v_s*w_s)/dy[j]
-                       + (w_f*w_f - w_b*w_b)/(0.5*(dzMinus + dzPlus)) );
-        convectionTerm = gamma*Hz[k][j][i] + zeta*HnMinus1;
-        // diffusion term: d^2w/dx^2 + d^2w/dy^2 + d^2w/dz^2
-        dxMinus = (i > 0)  ? 0.5*(dx[i-1] + dx[i]) : (periodicX) ? 0.5*(dx[nx-1] + dx[i]) : 0.5*dx[i];
-        dxPlus = (i < M-1) ? 0.5*(dx[i] + dx[i+1]) : (periodicX) ? 0.5*(dx[i] + dx[0])    : 0.5*dx[i];
-        dyMinus = (j > 0)  ? 0.5*(dy[j-1] + dy[j]) : (periodicY) ? 0.5*(dy[ny-1] + dy[j]) : 0.5*dy[j];
-        dyPlus = (j < N-1) ? 0.5*(dy[j] + dy[j+1]) : (periodicY) ? 0.5*(dy[j] + dy[0])    : 0.5*dy[j];
-        diffusionTerm = alpha*nu * (  d2udx2(w_W, w_P, w_E, dxMinus, dxPlus)
-                                    + d2udx2(w_S, w_P, w_N, dyMinus, dyPlus)
-                                    + d2udx2(w_B, w_P, w_F, dzMinus, dzPlus) );
-        // explicit term
-        rz[k][j][i] = w_P/dt - convectionTerm + diffusionTerm;
+        const PetscReal izP = idz[k], izF = idz[k+1], iszP = isz[k], szP = staggeredWidths[2][k],
+                        Lzm = LMinus[2][2][k], Lzc = LCenter[2][2][k], Lzp = LPlus[2][2][k];
+        for (j=j0; j<j1; j++)
+        {
+          // points adjacent to a non-periodic boundary in x or y use the general treatment
+          PetscInt iStart, iEnd;
+          if (periodicY || (j > 0 && j < N-1))
+          {
+            iStart = (periodicX) ? i0 : PetscMax(i0, 1);
+            iEnd = (periodicX) ? i1 : PetscMax(PetscMin(i1, M-1), iStart);
+          }
+          else
+            iStart = iEnd = i1;
+          for (i=i0; i<iStart; i++)
+            explicitTermZ(i, j, k);
+          const PetscReal *qzP = qz[k][j], *qzS = qz[k][j-1], *qzN = qz[k][j+1],
+                          *qzB = qz[k-1][j], *qzF = qz[k+1][j],
+                          *qxP = qx[k][j], *qxF = qx[k+1][j],
+                          *qyS = qy[k][j-1], *qyFS = qy[k+1][j-1],
+                          *qyP = qy[k][j], *qyFP = qy[k+1][j];
+          PetscReal *HzRow = Hz[k][j], *rzRow = rz[k][j];
+          const PetscReal iyP = idy[j], iyS = idy[j-1], iyN = idy[j+1],
+                          Lym = LMinus[2][1][j], Lyc = LCenter[2][1][j], Lyp = LPlus[2][1][j];
+          for (i=iStart; i<iEnd; i++)
+          {
+            const PetscReal wP = qzP[i]*idx[i]*iyP, wW = qzP[i-1]*idx[i-1]*iyP, wE = qzP[i+1]*idx[i+1]*iyP,
+                            wS = qzS[i]*idx[i]*iyS, wN = qzN[i]*idx[i]*iyN,
+                            wB = qzB[i]*idx[i]*iyP, wF = qzF[i]*idx[i]*iyP;
+            const PetscReal ww = 0.5*(wW + wP), we = 0.5*(wP + wE),
+                            ws = 0.5*(wS + wP), wn = 0.5*(wP + wN),
+                            wb = 0.5*(wB + wP), wf = 0.5*(wP + wF);
+            const PetscReal uw = 0.5*iyP*(qxP[i-1]*izP + qxF[i-1]*izF),
+                            ue = 0.5*iyP*(qxP[i]*izP + qxF[i]*izF),
+                            vs = 0.5*idx[i]*(qyS[i]*izP + qyFS[i]*izF),
+                            vn = 0.5*idx[i]*(qyP[i]*izP + qyFP[i]*izF);
+            const PetscReal Hprev = HzRow[i],
+                            Hcur = (  (ue*we - uw*ww)*idx[i]
+                                    + (vn*wn - vs*ws)*iyP
+                                    + (wf*wf - wb*wb)*iszP );
+            HzRow[i] = Hcur;
+            rzRow[i] = wP*dtInv - (gamma*Hcur + zeta*Hprev)
+                       + alphaNu*(  Lxm[i]*wW + Lxc[i]*wP + Lxp[i]*wE
+                                  + Lym*wS + Lyc*wP + Lyp*wN
+                                  + Lzm*wB + Lzc*wP + Lzp*wF );
+          }
+          if (scaleByMHat)
+          {
+            for (i=iStart; i<iEnd; i++)
+              rzRow[i] *= szP;
+          }
+          for (i=iEnd; i<i1; i++)
+            explicitTermZ(i, j, k);
+        }
       }
     }
   }
   ierr = DMDAVecRestoreArray(wda, HzGlobal, &Hz); CHKERRQ(ierr);
   ierr = DMDAVecRestoreArray(wda, rzGlobal, &rz); CHKERRQ(ierr);
   
-  ierr = DMDAVecRestoreArray(uda, qxLocal, &qx); CHKERRQ(ierr);
-  ierr = DMDAVecRestoreArray(vda, qyLocal, &qy); CHKERRQ(ierr);
-  ierr = DMDAVecRestoreArray(wda, qzLocal, &qz); CHKERRQ(ierr);
+  ierr = DMDAVecRestoreArrayRead(uda, (region == HALO_FREE) ? qxGlobal : qxLocal, &qx); CHKERRQ(ierr);
+  ierr = DMDAVecRestoreArrayRead(vda, (region == HALO_FREE) ? qyGlobal : qyLocal, &qy); CHKERRQ(ierr);
+  ierr = DMDAVecRestoreArrayRead(wda, (region == HALO_FREE) ? qzGlobal : qzLocal, &qz); CHKERRQ(ierr);
   
   ierr = DMCompositeRestoreAccess(qPack, H,  &HxGlobal, &HyGlobal, &HzGlobal); CHKERRQ(ierr);
-  ierr = DMCompositeRestoreAccess(qPack, rn, &rxGlobal, &ryGlobal, &rzGlobal); CHKERRQ(ierr);
+  ierr = DMCompositeRestoreAccess(qPack, r, &rxGlobal, &ryGlobal, &rzGlobal); CHKERRQ(ierr);
 
-  ierr = PetscObjectViewFromOptions((PetscObject) H, NULL, "-H_vec_view"); CHKERRQ(ierr);
-  ierr = PetscObjectViewFromOptions((PetscObject) rn, NULL, "-rn_vec_view"); CHKERRQ(ierr);
+  if (region != HALO_FREE)
+  {
+    ierr = PetscObjectViewFromOptions((PetscObject) H, NULL, "-H_vec_view"); CHKERRQ(ierr);
+  }
 
   return 0;
-} // calculateExplicitTerms
\ No newline at end of file
+} // calculateExplicitTermsKernel
\ No newline at end of file
@@ -3,6 +3,12 @@
  */
 
 #include "solvers/kspsolver.h"
+#include "solvers/componentkspsolver.h"
+#include "solvers/mixedprecisionsolver.h"
+#include "solvers/agglomeratedsolver.h"
+#ifdef PETSC_HAVE_FFTW
+#include "solvers/fftsolver.h"
+#endif
 #ifdef HAVE_AMGX
 #include "solvers/amgxsolver.h"
 #endif
@@ -19,6 +25,9 @@ PetscErrorCode NavierStokesSolver<dim>::createSolvers()
   std::string prefix;
   std::string options;
   PetscInt idx;
+  PetscInt numDMs;
+  KSPSolver *kspVelocity,
+            *kspPoisson;
 
   // possibility to overwrite the path of the configuration file
   // using the command-line parameter: `-velocity_config_file <file-path>`
@@ -31,7 +40,16 @@ PetscErrorCode NavierStokesSolver<dim>::createSolvers()
     case CPU:
       prefix = "velocity_";
       options = (found) ? std::string(path) : parameters->directory + "/solversPetscOptions.info";
-      velocity = new KSPSolver(prefix, options);
+      if (parameters->vComponentSolve == MONOLITHIC)
+      {
+        kspVelocity = new KSPSolver(prefix, options);
+        // options selected by `-velocity_autotune` are saved with the case
+        ierr = kspVelocity->setTuningFile(parameters->directory + "/" + prefix + "autotuned.info"); CHKERRQ(ierr);
+        velocity = kspVelocity;
+      }
+      else
+        velocity = new ComponentKSPSolver(prefix, options, qPack,
+                                          (parameters->vComponentSolve == CONCURRENT) ? PETSC_TRUE : PETSC_FALSE);
       break;
     case GPU:
 #ifdef HAVE_AMGX
@@ -59,9 +77,65 @@ PetscErrorCode NavierStokesSolver<dim>::createSolvers()
     case CPU:
       prefix = "poisson_";
       options = (found) ? std::string(path) : parameters->directory + "/solversPetscOptions.info";
-      poisson = new KSPSolver(prefix, options);
+      kspPoisson = new KSPSolver(prefix, options);
+      ierr = kspPoisson->setTuningFile(parameters->directory + "/" + prefix + "autotuned.info"); CHKERRQ(ierr);
+      ierr = DMCompositeGetNumberDM(lambdaPack, &numDMs); CHKERRQ(ierr);
+      if (numDMs == 1)
+      {
+        // pressure only: geometric multigrid can coarsen the pressure grid
+        ierr = setMultigridDefaults(prefix); CHKERRQ(ierr);
+        ierr = kspPoisson->setDM(pda); CHKERRQ(ierr);
+      }
+      else
+      {
+        // pressure and body forces: blocks of a field-split preconditioner,
+        // the small force block first and the pressure (Schur complement) second
+        IS *isLambda;
+        ierr = DMCompositeGetGlobalISs(lambdaPack, &isLambda); CHKERRQ(ierr);
+        MatNullSpace nsp;
+        ierr = MatNullSpaceCreate(PETSC_COMM_WORLD, PETSC_TRUE, 0, NULL, &nsp); CHKERRQ(ierr);
+        ierr = PetscObjectCompose((PetscObject) isLambda[0], "nullspace", (PetscObject) nsp); CHKERRQ(ierr);
+        ierr = MatNullSpaceDestroy(&nsp); CHKERRQ(ierr);
+        ierr = kspPoisson->addFieldSplit("forces", isLambda[1]); CHKERRQ(ierr);
+        ierr = kspPoisson->addFieldSplit("pressure", isLambda[0]); CHKERRQ(ierr);
+        for (idx=0; idx<numDMs; idx++)
+        {
+          ierr = ISDestroy(&isLambda[idx]); CHKERRQ(ierr);
+        }
+        ierr = PetscFree(isLambda); CHKERRQ(ierr);
+      }
+      poisson = kspPoisson;
       ierr = setNullSpace(); CHKERRQ(ierr);
       break;
+    case MIXED:
+      prefix = "poisson_";
+      options = (found) ? std::string(path) : parameters->directory + "/solversPetscOptions.info";
+      // the null space is needed when the single-precision levels are set up
+      ierr = setNullSpace(); CHKERRQ(ierr);
+      poisson = new MixedPrecisionSolver(prefix, options);
+      break;
+    case AGGLOMERATED:
+      prefix = "poisson_";
+      options = (found) ? std::string(path) : parameters->directory + "/solversPetscOptions.info";
+      // the null space is gathered with the matrix on the solver processes
+      ierr = setNullSpace(); CHKERRQ(ierr);
+      poisson = new AgglomeratedSolver(prefix, options);
+      break;
+    case FFT:
+#ifdef PETSC_HAVE_FFTW
+      {
+        std::vector<PetscReal> widths[3] = {mesh->dx, mesh->dy, mesh->dz};
+        PetscBool periodic[3];
+        for (PetscInt d=0; d<dim; d++)
+          periodic[d] = (flow->boundaries[2*d][0].type == PERIODIC) ? PETSC_TRUE : PETSC_FALSE;
+        poisson = new FFTSolver(pda, widths, mesh->uniform, periodic, parameters->dt);
+      }
+#else
+      ierr = PetscPrintf(PETSC_COMM_WORLD,
+                         "\nERROR: FFTW not available; pSolveType should be set to 'CPU' or 'GPU'.\n");
+      exit(1);
+#endif
+      break;
     case GPU:
 #ifdef HAVE_AMGX
       options = (found) ? std::string(path) : parameters->directory + "/solversAmgXOptions_p.info";
@@ -81,7 +155,7 @@ PetscErrorCode NavierStokesSolver<dim>::createSolvers()
       break;
     default:
       ierr = PetscPrintf(PETSC_COMM_WORLD,
-                         "\nERROR: pSolveType should be either 'CPU' or 'GPU'.\n");
+                         "\nERROR: pSolveType should be 'CPU', 'GPU', 'FFT', 'MIXED' or 'AGGLOMERATED'.\n");
       exit(1);
   }
   poisson->create(QTBNQ);
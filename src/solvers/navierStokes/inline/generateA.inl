@@ -82,36 +82,40 @@ PetscErrorCode NavierStokesSolver<2>::generateA()
   ierr = PetscMalloc(qLocalSize*sizeof(PetscInt), &o_nnz); CHKERRQ(ierr);
 
   // determine the number of non-zeros row by row
-  PetscInt localIdx = 0;
+  PetscInt localIdx, rowOffset = 0;
   PetscInt cols[5];
   PetscReal values[5];
   // rows corresponding to fluxes in x-direction
   PetscReal **uMappingArray;
   ierr = DMDAVecGetArray(uda, uMapping, &uMappingArray); CHKERRQ(ierr);
   ierr = DMDAGetCorners(uda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
+#pragma omp parallel for private(i, localIdx, cols)
   for (j=nstart; j<nstart+n; j++)
   {
     for (i=mstart; i<mstart+m; i++)
     {
+      localIdx = rowOffset + (j-nstart)*m + (i-mstart);
       getColumnIndices(uMappingArray, i, j, cols);
       countNumNonZeros(cols, 5, qStart, qEnd, d_nnz[localIdx], o_nnz[localIdx]);
-      localIdx++;
     }
   }
+  rowOffset += m*n;
   ierr = DMDAVecRestoreArray(uda, uMapping, &uMappingArray); CHKERRQ(ierr);
   // rows corresponding to fluxes in y-direction
   PetscReal **vMappingArray;
   ierr = DMDAVecGetArray(vda, vMapping, &vMappingArray); CHKERRQ(ierr);
   ierr = DMDAGetCorners(vda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
+#pragma omp parallel for private(i, localIdx, cols)
   for (j=nstart; j<nstart+n; j++)
   {
     for (i=mstart; i<mstart+m; i++)
     {
+      localIdx = rowOffset + (j-nstart)*m + (i-mstart);
       getColumnIndices(vMappingArray, i, j, cols);
       countNumNonZeros(cols, 5, qStart, qEnd, d_nnz[localIdx], o_nnz[localIdx]);
-      localIdx++;
     }
   }
+  rowOffset += m*n;
   ierr = DMDAVecRestoreArray(vda, vMapping, &vMappingArray); CHKERRQ(ierr);
 
   // create and allocate memory for matrix A
@@ -207,59 +211,65 @@ PetscErrorCode NavierStokesSolver<3>::generateA()
   ierr = PetscMalloc(qLocalSize*sizeof(PetscInt), &o_nnz); CHKERRQ(ierr);
 
   // determine nnz row by row
-  PetscInt localIdx = 0;
+  PetscInt localIdx, rowOffset = 0;
   PetscInt cols[7];
   PetscReal values[7];
   // rows corresponding to fluxes in x-direction
   PetscReal ***uMappingArray;
   ierr = DMDAVecGetArray(uda, uMapping, &uMappingArray); CHKERRQ(ierr);
   ierr = DMDAGetCorners(uda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
+#pragma omp parallel for private(i, j, localIdx, cols)
   for (k=pstart; k<pstart+p; k++)
   {
     for (j=nstart; j<nstart+n; j++)
     {
       for (i=mstart; i<mstart+m; i++)
       {
+        localIdx = rowOffset + ((k-pstart)*n + (j-nstart))*m + (i-mstart);
         getColumnIndices(uMappingArray, i, j, k, cols);
         countNumNonZeros(cols, 7, qStart, qEnd, d_nnz[localIdx], o_nnz[localIdx]);
-        localIdx++;
       }
     }
   }
+  rowOffset += m*n*p;
   ierr = DMDAVecRestoreArray(uda, uMapping, &uMappingArray); CHKERRQ(ierr);
   // rows corresponding to fluxes in y-direction
   PetscReal ***vMappingArray;
   ierr = DMDAVecGetArray(vda, vMapping, &vMappingArray); CHKERRQ(ierr);
   ierr = DMDAGetCorners(vda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
+#pragma omp parallel for private(i, j, localIdx, cols)
   for (k=pstart; k<pstart+p; k++)
   {
     for (j=nstart; j<nstart+n; j++)
     {
       for (i=mstart; i<mstart+m; i++)
       {
+        localIdx = rowOffset + ((k-pstart)*n + (j-nstart))*m + (i-mstart);
         getColumnIndices(vMappingArray, i, j, k, cols);
         countNumNonZeros(cols, 7, qStart, qEnd, d_nnz[localIdx], o_nnz[localIdx]);
-        localIdx++;
       }
     }
   }
+  rowOffset += m*n*p;
   ierr = DMDAVecRestoreArray(vda, vMapping, &vMappingArray); CHKERRQ(ierr);
   // rows corresponding to fluxes in z-direction
   PetscReal ***wMappingArray;
   ierr = DMDAVecGetArray(wda, wMapping, &wMappingArray); CHKERRQ(ierr);
   ierr = DMDAGetCorners(wda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
+#pragma omp parallel for private(i, j, localIdx, cols)
   for (k=pstart; k<pstart+p; k++)
   {
     for (j=nstart; j<nstart+n; j++)
     {
       for (i=mstart; i<mstart+m; i++)
       {
+        localIdx = rowOffset + ((k-pstart)*n + (j-nstart))*m + (i-mstart);
         getColumnIndices(wMappingArray, i, j, k, cols);
         countNumNonZeros(cols, 7, qStart, qEnd, d_nnz[localIdx], o_nnz[localIdx]);
-        localIdx++;
       }
     }
   }
+  rowOffset += m*n*p;
   ierr = DMDAVecRestoreArray(wda, wMapping, &wMappingArray); CHKERRQ(ierr);
 
   // create and allocate memory for matrix A
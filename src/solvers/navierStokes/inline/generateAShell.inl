@@ -0,0 +1,428 @@
+/***************************************************************************//**
+ * \file generateAShell.inl
+ * \brief Implementation of the matrix-free version of the operator \f$ A \f$
+ *        of the class `NavierStokesSolver`.
+ */
+
+
+/**
+ * \brief Matrix-vector product of the shell matrix \f$ A \f$.
+ *
+ * Callback registered with `MatShellSetOperation`; the context of the shell
+ * matrix is the solver that owns it.
+ */
+template <PetscInt dim>
+PetscErrorCode multAShell(Mat A, Vec x, Vec y)
+{
+  PetscErrorCode ierr;
+
+  NavierStokesSolver<dim> *solver;
+  ierr = MatShellGetContext(A, (void *) &solver); CHKERRQ(ierr);
+  ierr = solver->multA(x, y); CHKERRQ(ierr);
+
+  return 0;
+} // multAShell
+
+
+/**
+ * \brief Returns the diagonal of the shell matrix \f$ A \f$.
+ *
+ * Needed by the Jacobi preconditioner.
+ */
+template <PetscInt dim>
+PetscErrorCode getDiagonalAShell(Mat A, Vec d)
+{
+  PetscErrorCode ierr;
+
+  NavierStokesSolver<dim> *solver;
+  ierr = MatShellGetContext(A, (void *) &solver); CHKERRQ(ierr);
+  ierr = VecCopy(solver->ADiagonal, d); CHKERRQ(ierr);
+
+  return 0;
+} // getDiagonalAShell
+
+
+/**
+ * \brief Creates the matrix-free (shell) version of the operator \f$ A \f$.
+ *
+ * The operator is applied directly from the ghosted local flux arrays and the
+ * one-dimensional stencil coefficients computed in `generateMetrics`;
+ * no matrix is assembled.
+ * Only the diagonal of the operator is stored, so that the velocity system
+ * can be preconditioned with Jacobi (`-velocity_pc_type jacobi`).
+ * Ghost points at non-periodic boundaries remain zero in the work vectors,
+ * which reproduces the columns dropped in the assembled matrix.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::generateAShell()
+{
+  return 0;
+} // generateAShell
+
+
+// two-dimensional specialization
+template <>
+PetscErrorCode NavierStokesSolver<2>::generateAShell()
+{
+  PetscErrorCode ierr;
+
+  PetscInt i, j,           // loop indices
+           m, n,           // local number of nodes along each direction
+           mstart, nstart; // starting indices
+
+  // work vectors
+  ierr = DMCreateLocalVector(uda, &qxWork); CHKERRQ(ierr);
+  ierr = VecSet(qxWork, 0.0); CHKERRQ(ierr);
+  ierr = DMCreateLocalVector(vda, &qyWork); CHKERRQ(ierr);
+  ierr = VecSet(qyWork, 0.0); CHKERRQ(ierr);
+  ierr = VecDuplicate(q, &RInvq); CHKERRQ(ierr);
+
+  // diagonal of the operator
+  PetscReal alpha = parameters->diffusion.coefficients[0]*flow->nu, // implicit diffusion coefficient
+            dtInv = 1.0/parameters->dt;
+  ierr = VecDuplicate(q, &ADiagonal); CHKERRQ(ierr);
+  Vec ADiagonalx, ADiagonaly;
+  ierr = DMCompositeGetAccess(qPack, ADiagonal, &ADiagonalx, &ADiagonaly); CHKERRQ(ierr);
+  // fluxes in x-direction
+  PetscReal **ax;
+  ierr = DMDAVecGetArray(uda, ADiagonalx, &ax); CHKERRQ(ierr);
+  ierr = DMDAGetCorners(uda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
+  for (j=nstart; j<nstart+n; j++)
+  {
+    for (i=mstart; i<mstart+m; i++)
+    {
+      ax[j][i] = dtInv - alpha*(LCenter[0][0][i] + LCenter[0][1][j]);
+    }
+  }
+  ierr = DMDAVecRestoreArray(uda, ADiagonalx, &ax); CHKERRQ(ierr);
+  // fluxes in y-direction
+  PetscReal **ay;
+  ierr = DMDAVecGetArray(vda, ADiagonaly, &ay); CHKERRQ(ierr);
+  ierr = DMDAGetCorners(vda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
+  for (j=nstart; j<nstart+n; j++)
+  {
+    for (i=mstart; i<mstart+m; i++)
+    {
+      ay[j][i] = dtInv - alpha*(LCenter[1][0][i] + LCenter[1][1][j]);
+    }
+  }
+  ierr = DMDAVecRestoreArray(vda, ADiagonaly, &ay); CHKERRQ(ierr);
+  ierr = DMCompositeRestoreAccess(qPack, ADiagonal, &ADiagonalx, &ADiagonaly); CHKERRQ(ierr);
+  ierr = VecPointwiseMult(ADiagonal, ADiagonal, MHat); CHKERRQ(ierr);
+  ierr = VecPointwiseMult(ADiagonal, ADiagonal, RInv); CHKERRQ(ierr);
+
+  // create the shell matrix
+  PetscInt qLocalSize;
+  ierr = VecGetLocalSize(q, &qLocalSize); CHKERRQ(ierr);
+  ierr = MatCreateShell(PETSC_COMM_WORLD, qLocalSize, qLocalSize, PETSC_DETERMINE, PETSC_DETERMINE, (void *) this, &A); CHKERRQ(ierr);
+  ierr = MatShellSetOperation(A, MATOP_MULT, (void (*)(void)) multAShell<2>); CHKERRQ(ierr);
+  ierr = MatShellSetOperation(A, MATOP_GET_DIAGONAL, (void (*)(void)) getDiagonalAShell<2>); CHKERRQ(ierr);
+
+  return 0;
+} // generateAShell
+
+
+// three-dimensional specialization
+template <>
+PetscErrorCode NavierStokesSolver<3>::generateAShell()
+{
+  PetscErrorCode ierr;
+
+  PetscInt i, j, k,                // loop indices
+           m, n, p,                // local number of nodes along each direction
+           mstart, nstart, pstart; // starting indices
+
+  // work vectors
+  ierr = DMCreateLocalVector(uda, &qxWork); CHKERRQ(ierr);
+  ierr = VecSet(qxWork, 0.0); CHKERRQ(ierr);
+  ierr = DMCreateLocalVector(vda, &qyWork); CHKERRQ(ierr);
+  ierr = VecSet(qyWork, 0.0); CHKERRQ(ierr);
+  ierr = DMCreateLocalVector(wda, &qzWork); CHKERRQ(ierr);
+  ierr = VecSet(qzWork, 0.0); CHKERRQ(ierr);
+  ierr = VecDuplicate(q, &RInvq); CHKERRQ(ierr);
+
+  // diagonal of the operator
+  PetscReal alpha = parameters->diffusion.coefficients[0]*flow->nu, // implicit diffusion coefficient
+            dtInv = 1.0/parameters->dt;
+  ierr = VecDuplicate(q, &ADiagonal); CHKERRQ(ierr);
+  Vec ADiagonalx, ADiagonaly, ADiagonalz;
+  ierr = DMCompositeGetAccess(qPack, ADiagonal, &ADiagonalx, &ADiagonaly, &ADiagonalz); CHKERRQ(ierr);
+  // fluxes in x-direction
+  PetscReal ***ax;
+  ierr = DMDAVecGetArray(uda, ADiagonalx, &ax); CHKERRQ(ierr);
+  ierr = DMDAGetCorners(uda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
+  for (k=pstart; k<pstart+p; k++)
+  {
+    for (j=nstart; j<nstart+n; j++)
+    {
+      for (i=mstart; i<mstart+m; i++)
+      {
+        ax[k][j][i] = dtInv - alpha*(LCenter[0][0][i] + LCenter[0][1][j] + LCenter[0][2][k]);
+      }
+    }
+  }
+  ierr = DMDAVecRestoreArray(uda, ADiagonalx, &ax); CHKERRQ(ierr);
+  // fluxes in y-direction
+  PetscReal ***ay;
+  ierr = DMDAVecGetArray(vda, ADiagonaly, &ay); CHKERRQ(ierr);
+  ierr = DMDAGetCorners(vda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
+  for (k=pstart; k<pstart+p; k++)
+  {
+    for (j=nstart; j<nstart+n; j++)
+    {
+      for (i=mstart; i<mstart+m; i++)
+      {
+        ay[k][j][i] = dtInv - alpha*(LCenter[1][0][i] + LCenter[1][1][j] + LCenter[1][2][k]);
+      }
+    }
+  }
+  ierr = DMDAVecRestoreArray(vda, ADiagonaly, &ay); CHKERRQ(ierr);
+  // fluxes in z-direction
+  PetscReal ***az;
+  ierr = DMDAVecGetArray(wda, ADiagonalz, &az); CHKERRQ(ierr);
+  ierr = DMDAGetCorners(wda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
+  for (k=pstart; k<pstart+p; k++)
+  {
+    for (j=nstart; j<nstart+n; j++)
+    {
+      for (i=mstart; i<mstart+m; i++)
+      {
+        az[k][j][i] = dtInv - alpha*(LCenter[2][0][i] + LCenter[2][1][j] + LCenter[2][2][k]);
+      }
+    }
+  }
+  ierr = DMDAVecRestoreArray(wda, ADiagonalz, &az); CHKERRQ(ierr);
+  ierr = DMCompositeRestoreAccess(qPack, ADiagonal, &ADiagonalx, &ADiagonaly, &ADiagonalz); CHKERRQ(ierr);
+  ierr = VecPointwiseMult(ADiagonal, ADiagonal, MHat); CHKERRQ(ierr);
+  ierr = VecPointwiseMult(ADiagonal, ADiagonal, RInv); CHKERRQ(ierr);
+
+  // create the shell matrix
+  PetscInt qLocalSize;
+  ierr = VecGetLocalSize(q, &qLocalSize); CHKERRQ(ierr);
+  ierr = MatCreateShell(PETSC_COMM_WORLD, qLocalSize, qLocalSize, PETSC_DETERMINE, PETSC_DETERMINE, (void *) this, &A); CHKERRQ(ierr);
+  ierr = MatShellSetOperation(A, MATOP_MULT, (void (*)(void)) multAShell<3>); CHKERRQ(ierr);
+  ierr = MatShellSetOperation(A, MATOP_GET_DIAGONAL, (void (*)(void)) getDiagonalAShell<3>); CHKERRQ(ierr);
+
+  return 0;
+} // generateAShell
+
+
+/**
+ * \brief Applies the matrix-free operator: \f$ y = A x \f$.
+ *
+ * \f[ A = \hat{M} \left( \frac{1}{\Delta t} I - \alpha \nu L \right) R^{-1} \f]
+ *
+ * The event `multA` logs the operations of the stencil (`5*dim+4` per point;
+ * those of the scaling by \f$ R^{-1} \f$ are logged by PETSc) and the traffic
+ * of the scaling (3 vectors), of the update of the ghost points (2 vectors)
+ * and of the stencil (the ghosted input, \f$ \hat{M} \f$ and the output).
+ *
+ * \param x The input vector
+ * \param y The output vector
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::multA(Vec x, Vec y)
+{
+  PetscErrorCode ierr;
+
+  ierr = PetscLogEventBegin(eventMultA, 0, 0, 0, 0); CHKERRQ(ierr);
+
+  // kernel selected in `generateMetrics`
+  ierr = (this->*selectedMultAKernel)(x, y); CHKERRQ(ierr);
+
+  PetscInt numPoints;
+  ierr = VecGetLocalSize(x, &numPoints); CHKERRQ(ierr);
+  ierr = kernelLog.log(eventMultA, (5*dim+4)*numPoints, 8*sizeof(PetscReal)*numPoints); CHKERRQ(ierr);
+
+  ierr = PetscLogEventEnd(eventMultA, 0, 0, 0, 0); CHKERRQ(ierr);
+
+  return 0;
+} // multA
+
+
+/**
+ * \brief Kernel of `multA`, instantiated for a grid that is either uniform
+ *        (`uniformX` is `PETSC_TRUE`) or stretched along x.
+ *
+ * Next to a non-periodic boundary in x, the stencil coefficients along x of
+ * the fluxes that are not staggered in x differ from the interior ones;
+ * those points are computed with the coefficient arrays.
+ */
+template <PetscInt dim>
+template <PetscBool uniformX>
+PetscErrorCode NavierStokesSolver<dim>::multAKernel(Vec x, Vec y)
+{
+  return 0;
+} // multAKernel
+
+
+// two-dimensional specialization
+template <>
+template <PetscBool uniformX>
+PetscErrorCode NavierStokesSolver<2>::multAKernel(Vec x, Vec y)
+{
+  PetscErrorCode ierr;
+
+  PetscInt i, j,           // loop indices
+           M,              // global number of nodes along x
+           m, n,           // local number of nodes along each direction
+           mstart, nstart; // starting indices
+
+  // scale the input vector and update ghost points
+  ierr = VecPointwiseMult(RInvq, RInv, x); CHKERRQ(ierr);
+  ierr = DMCompositeScatter(qPack, RInvq, qxWork, qyWork); CHKERRQ(ierr);
+
+  PetscReal alpha = parameters->diffusion.coefficients[0]*flow->nu, // implicit diffusion coefficient
+            dtInv = 1.0/parameters->dt;
+
+  PetscBool periodicX = (flow->boundaries[XMINUS][0].type == PERIODIC) ? PETSC_TRUE : PETSC_FALSE;
+
+  Vec yx, yy;
+  ierr = DMCompositeGetAccess(qPack, y, &yx, &yy); CHKERRQ(ierr);
+  Vec MHatx, MHaty;
+  ierr = DMCompositeGetAccess(qPack, MHat, &MHatx, &MHaty); CHKERRQ(ierr);
+
+  DM das[2] = {uda, vda};
+  Vec works[2] = {qxWork, qyWork},
+      outputs[2] = {yx, yy},
+      scales[2] = {MHatx, MHaty};
+  for (PetscInt c=0; c<2; c++) // flux component
+  {
+    PetscReal **qc, **ac, **mc;
+    ierr = DMDAVecGetArrayRead(das[c], works[c], &qc); CHKERRQ(ierr);
+    ierr = DMDAVecGetArray(das[c], outputs[c], &ac); CHKERRQ(ierr);
+    ierr = DMDAVecGetArrayRead(das[c], scales[c], &mc); CHKERRQ(ierr);
+    ierr = DMDAGetCorners(das[c], &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
+    ierr = DMDAGetInfo(das[c], NULL, &M, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
+    const PetscReal *bxm = &LMinus[c][0][0], *bx0 = &LCenter[c][0][0], *bxp = &LPlus[c][0][0],
+                    *cym = &LMinus[c][1][0], *cy0 = &LCenter[c][1][0], *cyp = &LPlus[c][1][0];
+    // metrics along x are constants when the grid is uniform in that direction
+    const GridMetric<uniformX> cxm(LMinus[c][0]), cx0(LCenter[c][0]), cxp(LPlus[c][0]);
+    PetscInt iStart = mstart,
+             iEnd = mstart+m;
+    if (c != 0 && !periodicX)
+    {
+      iStart = PetscMax(mstart, 1);
+      iEnd = PetscMax(PetscMin(mstart+m, M-1), iStart);
+    }
+    // operator at a point next to a non-periodic boundary in x
+    auto multAtPoint = [&](PetscInt i, PetscInt j)
+    {
+      ac[j][i] = mc[j][i]*(dtInv*qc[j][i]
+                           - alpha*(bxm[i]*qc[j][i-1] + bxp[i]*qc[j][i+1]
+                                    + cym[j]*qc[j-1][i] + cyp[j]*qc[j+1][i]
+                                    + (bx0[i] + cy0[j])*qc[j][i]));
+    };
+    for (j=nstart; j<nstart+n; j++)
+    {
+      for (i=mstart; i<iStart; i++)
+        multAtPoint(i, j);
+      for (i=iStart; i<iEnd; i++)
+      {
+        ac[j][i] = mc[j][i]*(dtInv*qc[j][i]
+                             - alpha*(cxm[i]*qc[j][i-1] + cxp[i]*qc[j][i+1]
+                                      + cym[j]*qc[j-1][i] + cyp[j]*qc[j+1][i]
+                                      + (cx0[i] + cy0[j])*qc[j][i]));
+      }
+      for (i=iEnd; i<mstart+m; i++)
+        multAtPoint(i, j);
+    }
+    ierr = DMDAVecRestoreArrayRead(das[c], works[c], &qc); CHKERRQ(ierr);
+    ierr = DMDAVecRestoreArray(das[c], outputs[c], &ac); CHKERRQ(ierr);
+    ierr = DMDAVecRestoreArrayRead(das[c], scales[c], &mc); CHKERRQ(ierr);
+  }
+
+  ierr = DMCompositeRestoreAccess(qPack, y, &yx, &yy); CHKERRQ(ierr);
+  ierr = DMCompositeRestoreAccess(qPack, MHat, &MHatx, &MHaty); CHKERRQ(ierr);
+
+  return 0;
+} // multAKernel
+
+
+// three-dimensional specialization
+template <>
+template <PetscBool uniformX>
+PetscErrorCode NavierStokesSolver<3>::multAKernel(Vec x, Vec y)
+{
+  PetscErrorCode ierr;
+
+  PetscInt i, j, k,                // loop indices
+           M,                      // global number of nodes along x
+           m, n, p,                // local number of nodes along each direction
+           mstart, nstart, pstart; // starting indices
+
+  // scale the input vector and update ghost points
+  ierr = VecPointwiseMult(RInvq, RInv, x); CHKERRQ(ierr);
+  ierr = DMCompositeScatter(qPack, RInvq, qxWork, qyWork, qzWork); CHKERRQ(ierr);
+
+  PetscReal alpha = parameters->diffusion.coefficients[0]*flow->nu, // implicit diffusion coefficient
+            dtInv = 1.0/parameters->dt;
+
+  PetscBool periodicX = (flow->boundaries[XMINUS][0].type == PERIODIC) ? PETSC_TRUE : PETSC_FALSE;
+
+  Vec yx, yy, yz;
+  ierr = DMCompositeGetAccess(qPack, y, &yx, &yy, &yz); CHKERRQ(ierr);
+  Vec MHatx, MHaty, MHatz;
+  ierr = DMCompositeGetAccess(qPack, MHat, &MHatx, &MHaty, &MHatz); CHKERRQ(ierr);
+
+  DM das[3] = {uda, vda, wda};
+  Vec works[3] = {qxWork, qyWork, qzWork},
+      outputs[3] = {yx, yy, yz},
+      scales[3] = {MHatx, MHaty, MHatz};
+  for (PetscInt c=0; c<3; c++) // flux component
+  {
+    PetscReal ***qc, ***ac, ***mc;
+    ierr = DMDAVecGetArrayRead(das[c], works[c], &qc); CHKERRQ(ierr);
+    ierr = DMDAVecGetArray(das[c], outputs[c], &ac); CHKERRQ(ierr);
+    ierr = DMDAVecGetArrayRead(das[c], scales[c], &mc); CHKERRQ(ierr);
+    ierr = DMDAGetCorners(das[c], &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
+    ierr = DMDAGetInfo(das[c], NULL, &M, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
+    const PetscReal *bxm = &LMinus[c][0][0], *bx0 = &LCenter[c][0][0], *bxp = &LPlus[c][0][0],
+                    *cym = &LMinus[c][1][0], *cy0 = &LCenter[c][1][0], *cyp = &LPlus[c][1][0],
+                    *czm = &LMinus[c][2][0], *cz0 = &LCenter[c][2][0], *czp = &LPlus[c][2][0];
+    // metrics along x are constants when the grid is uniform in that direction
+    const GridMetric<uniformX> cxm(LMinus[c][0]), cx0(LCenter[c][0]), cxp(LPlus[c][0]);
+    PetscInt iStart = mstart,
+             iEnd = mstart+m;
+    if (c != 0 && !periodicX)
+    {
+      iStart = PetscMax(mstart, 1);
+      iEnd = PetscMax(PetscMin(mstart+m, M-1), iStart);
+    }
+    // operator at a point next to a non-periodic boundary in x
+    auto multAtPoint = [&](PetscInt i, PetscInt j, PetscInt k)
+    {
+      ac[k][j][i] = mc[k][j][i]*(dtInv*qc[k][j][i]
+                                 - alpha*(bxm[i]*qc[k][j][i-1] + bxp[i]*qc[k][j][i+1]
+                                          + cym[j]*qc[k][j-1][i] + cyp[j]*qc[k][j+1][i]
+                                          + czm[k]*qc[k-1][j][i] + czp[k]*qc[k+1][j][i]
+                                          + (bx0[i] + cy0[j] + cz0[k])*qc[k][j][i]));
+    };
+    for (k=pstart; k<pstart+p; k++)
+    {
+      for (j=nstart; j<nstart+n; j++)
+      {
+        for (i=mstart; i<iStart; i++)
+          multAtPoint(i, j, k);
+        for (i=iStart; i<iEnd; i++)
+        {
+          ac[k][j][i] = mc[k][j][i]*(dtInv*qc[k][j][i]
+                                     - alpha*(cxm[i]*qc[k][j][i-1] + cxp[i]*qc[k][j][i+1]
+                                              + cym[j]*qc[k][j-1][i] + cyp[j]*qc[k][j+1][i]
+                                              + czm[k]*qc[k-1][j][i] + czp[k]*qc[k+1][j][i]
+                                              + (cx0[i] + cy0[j] + cz0[k])*qc[k][j][i]));
+        }
+        for (i=iEnd; i<mstart+m; i++)
+          multAtPoint(i, j, k);
+      }
+    }
+    ierr = DMDAVecRestoreArrayRead(das[c], works[c], &qc); CHKERRQ(ierr);
+    ierr = DMDAVecRestoreArray(das[c], outputs[c], &ac); CHKERRQ(ierr);
+    ierr = DMDAVecRestoreArrayRead(das[c], scales[c], &mc); CHKERRQ(ierr);
+  }
+
+  ierr = DMCompositeRestoreAccess(qPack, y, &yx, &yy, &yz); CHKERRQ(ierr);
+  ierr = DMCompositeRestoreAccess(qPack, MHat, &MHatx, &MHaty, &MHatz); CHKERRQ(ierr);
+
+  return 0;
+} // multAKernel
@@ -6,10 +6,34 @@
 
 
 /**
- * \brief
+ * \brief Assembles the vector \f$ bc_1 \f$ that contains the contributions of the
+ *        boundary values to the implicit diffusive terms.
  */
 template <PetscInt dim>
 PetscErrorCode NavierStokesSolver<dim>::generateBC1()
+{
+  PetscErrorCode ierr;
+
+  ierr = VecSet(bc1, 0.0); CHKERRQ(ierr);
+  ierr = generateBC1(bc1, PETSC_FALSE); CHKERRQ(ierr);
+
+  ierr = PetscObjectViewFromOptions((PetscObject) bc1, NULL, "-bc1_vec_view"); CHKERRQ(ierr);
+
+  return 0;
+} // generateBC1
+
+
+/**
+ * \brief Adds the contributions of the boundary values to the implicit
+ *        diffusive terms to a given vector.
+ *
+ * Only the rows adjacent to a Dirichlet or convective boundary are visited.
+ *
+ * \param b The vector to which the contributions are added
+ * \param scaleByMHat Multiplies the contributions by \f$ \hat{M} \f$ if `PETSC_TRUE`
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::generateBC1(Vec b, PetscBool scaleByMHat)
 {
   return 0;
 } // generateBC1
@@ -17,10 +41,12 @@ PetscErrorCode NavierStokesSolver<dim>::generateBC1()
 
 // two-dimensional specialization
 template <>
-PetscErrorCode NavierStokesSolver<2>::generateBC1()
+PetscErrorCode NavierStokesSolver<2>::generateBC1(Vec b, PetscBool scaleByMHat)
 {
   PetscErrorCode ierr;
 
+  ierr = PetscLogEventBegin(eventGenerateBC1, 0, 0, 0, 0); CHKERRQ(ierr);
+
   PetscInt i, j,           // loop indices
            M, N,           // global number of nodes along each direction
            m, n,           // local number of nodes along each direction
@@ -35,13 +61,16 @@ PetscErrorCode NavierStokesSolver<2>::generateBC1()
   PetscInt nx = mesh->nx,
            ny = mesh->ny;
 
-  ierr = VecSet(bc1, 0.0); CHKERRQ(ierr);
   Vec bc1xGlobal, bc1yGlobal;
-  ierr = DMCompositeGetAccess(qPack, bc1, &bc1xGlobal, &bc1yGlobal); CHKERRQ(ierr);
+  ierr = DMCompositeGetAccess(qPack, b, &bc1xGlobal, &bc1yGlobal); CHKERRQ(ierr);
+  Vec MHatxGlobal, MHatyGlobal;
+  ierr = DMCompositeGetAccess(qPack, MHat, &MHatxGlobal, &MHatyGlobal); CHKERRQ(ierr);
                  
   // fluxes in x-direction
   PetscReal **bc1x;
   ierr = DMDAVecGetArray(uda, bc1xGlobal, &bc1x); CHKERRQ(ierr);
+  PetscReal **MHatx;
+  ierr = DMDAVecGetArrayRead(uda, MHatxGlobal, &MHatx); CHKERRQ(ierr);
   PetscReal **qx;
   ierr = DMDAVecGetArray(uda, qxLocal, &qx); CHKERRQ(ierr);
   ierr = DMDAGetCorners(uda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
@@ -51,6 +80,7 @@ PetscErrorCode NavierStokesSolver<2>::generateBC1()
   {
     coeffMinus = alpha*nu * 2.0/dx[0]/(dx[0]+dx[1]);
     coeffPlus = alpha*nu * 2.0/dx[nx-1]/(dx[nx-2]+dx[nx-1]);
+#pragma omp parallel for
     for (j=nstart; j<nstart+n; j++) // loop over y-direction
     {
       if (mstart == 0) // left boundary on current process
@@ -59,7 +89,7 @@ PetscErrorCode NavierStokesSolver<2>::generateBC1()
         {
           case CONVECTIVE:
           case DIRICHLET:
-            bc1x[j][0] += coeffMinus*qx[j][-1]/dy[j];
+            bc1x[j][0] += ((scaleByMHat) ? MHatx[j][0] : 1.0)*coeffMinus*qx[j][-1]/dy[j];
             break;
           default:
             break;
@@ -71,7 +101,7 @@ PetscErrorCode NavierStokesSolver<2>::generateBC1()
         {
           case CONVECTIVE:
           case DIRICHLET:
-            bc1x[j][M-1] += coeffPlus*qx[j][M]/dy[j];
+            bc1x[j][M-1] += ((scaleByMHat) ? MHatx[j][M-1] : 1.0)*coeffPlus*qx[j][M]/dy[j];
             break;
           default:
             break;
@@ -84,6 +114,7 @@ PetscErrorCode NavierStokesSolver<2>::generateBC1()
   {
     coeffMinus = alpha*nu * 2.0/(0.5*dy[0])/(0.5*dy[0]+0.5*(dy[0]+dy[1]));
     coeffPlus = alpha*nu * 2.0/(0.5*dy[ny-1])/(0.5*(dy[ny-2]+dy[ny-1])+0.5*dy[ny-1]);
+#pragma omp parallel for
     for (i=mstart; i<mstart+m; i++) // loop over x-direction
     { 
       if (nstart == 0) // bottom boundary on current boundary
@@ -92,7 +123,7 @@ PetscErrorCode NavierStokesSolver<2>::generateBC1()
         {
           case CONVECTIVE:
           case DIRICHLET:
-            bc1x[0][i] += coeffMinus*qx[-1][i];
+            bc1x[0][i] += ((scaleByMHat) ? MHatx[0][i] : 1.0)*coeffMinus*qx[-1][i];
             break;
           default:
             break;
@@ -104,7 +135,7 @@ PetscErrorCode NavierStokesSolver<2>::generateBC1()
         {
           case CONVECTIVE:
           case DIRICHLET:
-            bc1x[N-1][i] += coeffPlus*qx[N][i];
+            bc1x[N-1][i] += ((scaleByMHat) ? MHatx[N-1][i] : 1.0)*coeffPlus*qx[N][i];
             break;
           default:
             break;
@@ -113,11 +144,14 @@ PetscErrorCode NavierStokesSolver<2>::generateBC1()
     }
   }
   ierr = DMDAVecRestoreArray(uda, bc1xGlobal, &bc1x); CHKERRQ(ierr);
+  ierr = DMDAVecRestoreArrayRead(uda, MHatxGlobal, &MHatx); CHKERRQ(ierr);
   ierr = DMDAVecRestoreArray(uda, qxLocal, &qx); CHKERRQ(ierr);
   
   // fluxes in y-direction
   PetscReal **bc1y;
   ierr = DMDAVecGetArray(vda, bc1yGlobal, &bc1y); CHKERRQ(ierr);
+  PetscReal **MHaty;
+  ierr = DMDAVecGetArrayRead(vda, MHatyGlobal, &MHaty); CHKERRQ(ierr);
   PetscReal **qy;
   ierr = DMDAVecGetArray(vda, qyLocal, &qy); CHKERRQ(ierr);
   ierr = DMDAGetCorners(vda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
@@ -127,6 +161,7 @@ PetscErrorCode NavierStokesSolver<2>::generateBC1()
   {
     coeffMinus = alpha*nu * 2.0/(0.5*dx[0])/(0.5*dx[0]+0.5*(dx[0]+dx[1]));
     coeffPlus = alpha*nu * 2.0/(0.5*dx[nx-1])/(0.5*(dx[nx-2]+dx[nx-1])+0.5*dx[nx-1]);
+#pragma omp parallel for
     for (j=nstart; j<nstart+n; j++) //loop over y-direction
     {
       if (mstart == 0) // left boundary on current process
@@ -135,7 +170,7 @@ PetscErrorCode NavierStokesSolver<2>::generateBC1()
         {
           case CONVECTIVE:
           case DIRICHLET:
-            bc1y[j][0] += coeffMinus*qy[j][-1];
+            bc1y[j][0] += ((scaleByMHat) ? MHaty[j][0] : 1.0)*coeffMinus*qy[j][-1];
             break;
           default:
             break;
@@ -147,7 +182,7 @@ PetscErrorCode NavierStokesSolver<2>::generateBC1()
         {
           case CONVECTIVE:
           case DIRICHLET:
-            bc1y[j][M-1] += coeffPlus*qy[j][M];
+            bc1y[j][M-1] += ((scaleByMHat) ? MHaty[j][M-1] : 1.0)*coeffPlus*qy[j][M];
             break;
           default:
             break;
@@ -160,6 +195,7 @@ PetscErrorCode NavierStokesSolver<2>::generateBC1()
   {
     coeffMinus = alpha*nu * 2.0/dy[0]/(dy[0]+dy[1]);
     coeffPlus = alpha*nu * 2.0/dy[ny-1]/(dy[ny-2]+dy[ny-1]);
+#pragma omp parallel for
     for (i=mstart; i<mstart+m; i++) // loop over x-direction
     { 
       if (nstart == 0) // bottom boundary on current process
@@ -168,7 +204,7 @@ PetscErrorCode NavierStokesSolver<2>::generateBC1()
         {
           case CONVECTIVE:
           case DIRICHLET:
-            bc1y[0][i] += coeffMinus*qy[-1][i]/dx[i];
+            bc1y[0][i] += ((scaleByMHat) ? MHaty[0][i] : 1.0)*coeffMinus*qy[-1][i]/dx[i];
             break;
           default:
             break;
@@ -180,7 +216,7 @@ PetscErrorCode NavierStokesSolver<2>::generateBC1()
         {
           case CONVECTIVE:
           case DIRICHLET:
-            bc1y[N-1][i] += coeffPlus*qy[N][i]/dx[i];
+            bc1y[N-1][i] += ((scaleByMHat) ? MHaty[N-1][i] : 1.0)*coeffPlus*qy[N][i]/dx[i];
             break;
           default:
             break;
@@ -189,11 +225,24 @@ PetscErrorCode NavierStokesSolver<2>::generateBC1()
     }
   }
   ierr = DMDAVecRestoreArray(vda, bc1yGlobal, &bc1y); CHKERRQ(ierr);
+  ierr = DMDAVecRestoreArrayRead(vda, MHatyGlobal, &MHaty); CHKERRQ(ierr);
   ierr = DMDAVecRestoreArray(vda, qyLocal, &qy); CHKERRQ(ierr);
 
-  ierr = DMCompositeRestoreAccess(qPack, bc1,  &bc1xGlobal, &bc1yGlobal); CHKERRQ(ierr);
+  ierr = DMCompositeRestoreAccess(qPack, b, &bc1xGlobal, &bc1yGlobal); CHKERRQ(ierr);
+  ierr = DMCompositeRestoreAccess(qPack, MHat, &MHatxGlobal, &MHatyGlobal); CHKERRQ(ierr);
 
-  ierr = PetscObjectViewFromOptions((PetscObject) bc1, NULL, "-bc1_vec_view"); CHKERRQ(ierr);
+  {
+    // up to 4 operations and 4 values moved per boundary point
+    DM das[2] = {uda, vda};
+    PetscInt numPoints = 0, numComponentPoints;
+    for (PetscInt c=0; c<2; c++)
+    {
+      ierr = countBoundaryPoints(das[c], numComponentPoints); CHKERRQ(ierr);
+      numPoints += numComponentPoints;
+    }
+    ierr = kernelLog.log(eventGenerateBC1, 4.0*numPoints, 4*sizeof(PetscReal)*numPoints); CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(eventGenerateBC1, 0, 0, 0, 0); CHKERRQ(ierr);
 
   return 0;
 } // generateBC1
@@ -201,10 +250,12 @@ PetscErrorCode NavierStokesSolver<2>::generateBC1()
 
 // three-dimensional specialization
 template <>
-PetscErrorCode NavierStokesSolver<3>::generateBC1()
+PetscErrorCode NavierStokesSolver<3>::generateBC1(Vec b, PetscBool scaleByMHat)
 {
   PetscErrorCode ierr;
 
+  ierr = PetscLogEventBegin(eventGenerateBC1, 0, 0, 0, 0); CHKERRQ(ierr);
+
   PetscInt i, j, k,                // loop indices 
            M, N, P,                // global number of nodes along each direction
            m, n, p,                // local number of nodes along each direction
@@ -221,13 +272,16 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
   PetscReal alpha = parameters->diffusion.coefficients[0]; // implicit diffusion coefficient
   PetscReal coeffMinus, coeffPlus;
 
-  ierr = VecSet(bc1, 0.0); CHKERRQ(ierr);
   Vec bc1xGlobal, bc1yGlobal, bc1zGlobal;
-  ierr = DMCompositeGetAccess(qPack, bc1, &bc1xGlobal, &bc1yGlobal, &bc1zGlobal); CHKERRQ(ierr);
+  ierr = DMCompositeGetAccess(qPack, b, &bc1xGlobal, &bc1yGlobal, &bc1zGlobal); CHKERRQ(ierr);
+  Vec MHatxGlobal, MHatyGlobal, MHatzGlobal;
+  ierr = DMCompositeGetAccess(qPack, MHat, &MHatxGlobal, &MHatyGlobal, &MHatzGlobal); CHKERRQ(ierr);
   
   // fluxes in x-direction
   PetscReal ***bc1x;
   ierr = DMDAVecGetArray(uda, bc1xGlobal, &bc1x); CHKERRQ(ierr);
+  PetscReal ***MHatx;
+  ierr = DMDAVecGetArrayRead(uda, MHatxGlobal, &MHatx); CHKERRQ(ierr);
   PetscReal ***qx;
   ierr = DMDAVecGetArray(uda, qxLocal, &qx); CHKERRQ(ierr);
   ierr = DMDAGetCorners(uda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
@@ -237,6 +291,7 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
   {
     coeffMinus = alpha*nu * 2.0/dx[0]/(dx[0]+dx[1]);
     coeffPlus = alpha*nu * 2.0/dx[nx-1]/(dx[nx-2]+dx[nx-1]);
+#pragma omp parallel for private(j)
     for (k=pstart; k<pstart+p; k++) // loop over z-direction
     {
       for (j=nstart; j<nstart+n; j++) // loop over y-direction
@@ -247,7 +302,7 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
           {
             case CONVECTIVE:
             case DIRICHLET:
-              bc1x[k][j][0] += coeffMinus*qx[k][j][-1]/(dy[j]*dz[k]);
+              bc1x[k][j][0] += ((scaleByMHat) ? MHatx[k][j][0] : 1.0)*coeffMinus*qx[k][j][-1]/(dy[j]*dz[k]);
               break;
             default:
               break;
@@ -259,7 +314,7 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
           {
             case CONVECTIVE:
             case DIRICHLET:
-              bc1x[k][j][M-1] += coeffPlus*qx[k][j][M]/(dy[j]*dz[k]);
+              bc1x[k][j][M-1] += ((scaleByMHat) ? MHatx[k][j][M-1] : 1.0)*coeffPlus*qx[k][j][M]/(dy[j]*dz[k]);
               break;
             default:
               break;
@@ -273,6 +328,7 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
   {
     coeffMinus = alpha*nu * 2.0/(0.5*dy[0])/(0.5*dy[0]+0.5*(dy[0]+dy[1]));
     coeffPlus = alpha*nu * 2.0/(0.5*dy[ny-1])/(0.5*(dy[ny-2]+dy[ny-1])+0.5*dy[ny-1]);
+#pragma omp parallel for private(i)
     for (k=pstart; k<pstart+p; k++) // loop over z-direction
     {
       for (i=mstart; i<mstart+m; i++) // loop over x-direction
@@ -282,7 +338,7 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
           switch (flow->boundaries[YMINUS][0].type)
           {
             case DIRICHLET:
-              bc1x[k][0][i] += coeffMinus*qx[k][-1][i];
+              bc1x[k][0][i] += ((scaleByMHat) ? MHatx[k][0][i] : 1.0)*coeffMinus*qx[k][-1][i];
               break;
             case CONVECTIVE:
             default:
@@ -295,7 +351,7 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
           {
             case CONVECTIVE:
             case DIRICHLET:
-              bc1x[k][N-1][i] += coeffPlus*qx[k][N][i];
+              bc1x[k][N-1][i] += ((scaleByMHat) ? MHatx[k][N-1][i] : 1.0)*coeffPlus*qx[k][N][i];
               break;
             default:
               break;
@@ -309,6 +365,7 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
   {
     coeffMinus = alpha*nu * 2.0/(0.5*dz[0])/(0.5*dz[0]+0.5*(dz[0]+dz[1]));
     coeffPlus = alpha*nu * 2.0/(0.5*dz[nz-1])/(0.5*(dz[nz-2]+dz[nz-1])+0.5*dz[nz-1]);
+#pragma omp parallel for private(i)
     for (j=nstart; j<nstart+n; j++) // loop over y-direction
     {
       for (i=mstart; i<mstart+m; i++) // loop over x-direction
@@ -319,7 +376,7 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
           {
             case CONVECTIVE:
             case DIRICHLET:
-              bc1x[0][j][i] += coeffMinus*qx[-1][j][i];
+              bc1x[0][j][i] += ((scaleByMHat) ? MHatx[0][j][i] : 1.0)*coeffMinus*qx[-1][j][i];
               break;
             default:
               break;
@@ -331,7 +388,7 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
           {
             case CONVECTIVE:
             case DIRICHLET:
-              bc1x[P-1][j][i] += coeffPlus*qx[P][j][i];
+              bc1x[P-1][j][i] += ((scaleByMHat) ? MHatx[P-1][j][i] : 1.0)*coeffPlus*qx[P][j][i];
               break;
             default:
               break;
@@ -341,11 +398,14 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
     }
   }
   ierr = DMDAVecRestoreArray(uda, bc1xGlobal, &bc1x); CHKERRQ(ierr);
+  ierr = DMDAVecRestoreArrayRead(uda, MHatxGlobal, &MHatx); CHKERRQ(ierr);
   ierr = DMDAVecRestoreArray(uda, qxLocal, &qx); CHKERRQ(ierr);
   
   // fluxes in y-direction
   PetscReal ***bc1y;
   ierr = DMDAVecGetArray(vda, bc1yGlobal, &bc1y); CHKERRQ(ierr);
+  PetscReal ***MHaty;
+  ierr = DMDAVecGetArrayRead(vda, MHatyGlobal, &MHaty); CHKERRQ(ierr);
   PetscReal ***qy;
   ierr = DMDAVecGetArray(vda, qyLocal, &qy); CHKERRQ(ierr);
   ierr = DMDAGetCorners(vda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
@@ -355,6 +415,7 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
   {
     coeffMinus = alpha*nu * 2.0/(0.5*dx[0])/(0.5*dx[0]+0.5*(dx[0]+dx[1]));
     coeffPlus = alpha*nu * 2.0/(0.5*dx[nx-1])/(0.5*(dx[nx-2]+dx[nx-1])+0.5*dx[nx-1]);
+#pragma omp parallel for private(j)
     for (k=pstart; k<pstart+p; k++) // loop over z-direction
     {
       for (j=nstart; j<nstart+n; j++) // loop over y-direction
@@ -365,7 +426,7 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
           {
             case CONVECTIVE:
             case DIRICHLET:
-              bc1y[k][j][0] += coeffMinus*qy[k][j][-1];
+              bc1y[k][j][0] += ((scaleByMHat) ? MHaty[k][j][0] : 1.0)*coeffMinus*qy[k][j][-1];
               break;
             default:
               break;
@@ -377,7 +438,7 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
           {
             case CONVECTIVE:
             case DIRICHLET:
-              bc1y[k][j][M-1] += coeffPlus*qy[k][j][M];
+              bc1y[k][j][M-1] += ((scaleByMHat) ? MHaty[k][j][M-1] : 1.0)*coeffPlus*qy[k][j][M];
               break;
             default:
               break;
@@ -391,6 +452,7 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
   {
     coeffMinus = alpha*nu * 2.0/dy[0]/(dy[0]+dy[1]);
     coeffPlus = alpha*nu * 2.0/dy[ny-1]/(dy[ny-2]+dy[ny-1]);
+#pragma omp parallel for private(i)
     for (k=pstart; k<pstart+p; k++) // loop over z-direction
     {
       for (i=mstart; i<mstart+m; i++) // loop over x-direction
@@ -401,7 +463,7 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
           {
             case CONVECTIVE:
             case DIRICHLET:
-              bc1y[k][0][i] += coeffMinus*qy[k][-1][i]/(dx[i]*dz[k]);
+              bc1y[k][0][i] += ((scaleByMHat) ? MHaty[k][0][i] : 1.0)*coeffMinus*qy[k][-1][i]/(dx[i]*dz[k]);
               break;
             default:
               break;
@@ -413,7 +475,7 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
           {
             case CONVECTIVE:
             case DIRICHLET:
-              bc1y[k][N-1][i] += coeffPlus*qy[k][N][i]/(dx[i]*dz[k]);
+              bc1y[k][N-1][i] += ((scaleByMHat) ? MHaty[k][N-1][i] : 1.0)*coeffPlus*qy[k][N][i]/(dx[i]*dz[k]);
               break;
             default:
               break;
@@ -427,6 +489,7 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
   {
     coeffMinus = alpha*nu * 2.0/(0.5*dz[0])/(0.5*dz[0]+0.5*(dz[0]+dz[1]));
     coeffPlus = alpha*nu * 2.0/(0.5*dz[nz-1])/(0.5*(dz[nz-2]+dz[nz-1])+0.5*dz[nz-1]);
+#pragma omp parallel for private(i)
     for (j=nstart; j<nstart+n; j++) // loop over y-direction
     {
       for (i=mstart; i<mstart+m; i++) // loop over x-direction
@@ -437,7 +500,7 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
           {
             case CONVECTIVE:
             case DIRICHLET:
-              bc1y[0][j][i] += coeffMinus*qy[-1][j][i];
+              bc1y[0][j][i] += ((scaleByMHat) ? MHaty[0][j][i] : 1.0)*coeffMinus*qy[-1][j][i];
               break;
             default:
               break;
@@ -449,7 +512,7 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
           {
             case CONVECTIVE:
             case DIRICHLET:
-              bc1y[P-1][j][i] += coeffPlus*qy[P][j][i];
+              bc1y[P-1][j][i] += ((scaleByMHat) ? MHaty[P-1][j][i] : 1.0)*coeffPlus*qy[P][j][i];
               break;
             default:
               break;
@@ -459,11 +522,14 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
     }
   }
   ierr = DMDAVecRestoreArray(vda, bc1yGlobal, &bc1y); CHKERRQ(ierr);
+  ierr = DMDAVecRestoreArrayRead(vda, MHatyGlobal, &MHaty); CHKERRQ(ierr);
   ierr = DMDAVecRestoreArray(vda, qyLocal, &qy); CHKERRQ(ierr);
 
   // fluxes in z-direction
   PetscReal ***bc1z;
   ierr = DMDAVecGetArray(wda, bc1zGlobal, &bc1z); CHKERRQ(ierr);
+  PetscReal ***MHatz;
+  ierr = DMDAVecGetArrayRead(wda, MHatzGlobal, &MHatz); CHKERRQ(ierr);
   PetscReal ***qz;
   ierr = DMDAVecGetArray(wda, qzLocal, &qz); CHKERRQ(ierr);
   ierr = DMDAGetCorners(wda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
@@ -473,6 +539,7 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
   {
     coeffMinus = alpha*nu * 2.0/(0.5*dx[0])/(0.5*dx[0]+0.5*(dx[0]+dx[1]));
     coeffPlus = alpha*nu * 2.0/(0.5*dx[nx-1])/(0.5*(dx[nx-2]+dx[nx-1])+0.5*dx[nx-1]);
+#pragma omp parallel for private(j)
     for (k=pstart; k<pstart+p; k++) // loop over z-direction
     {
       for (j=nstart; j<nstart+n; j++) // loop over y-direction
@@ -483,7 +550,7 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
           {
             case CONVECTIVE:
             case DIRICHLET:
-              bc1z[k][j][0] += coeffMinus*qz[k][j][-1];
+              bc1z[k][j][0] += ((scaleByMHat) ? MHatz[k][j][0] : 1.0)*coeffMinus*qz[k][j][-1];
               break;
             default:
               break;
@@ -495,7 +562,7 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
           {
             case CONVECTIVE:
             case DIRICHLET:
-              bc1z[k][j][M-1] += coeffPlus*qz[k][j][M];
+              bc1z[k][j][M-1] += ((scaleByMHat) ? MHatz[k][j][M-1] : 1.0)*coeffPlus*qz[k][j][M];
               break;
             default:
               break;
@@ -509,6 +576,7 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
   {
     coeffMinus = alpha*nu * 2.0/(0.5*dy[0])/(0.5*dy[0]+0.5*(dy[0]+dy[1]));
     coeffPlus = alpha*nu * 2.0/(0.5*dy[ny-1])/(0.5*(dy[ny-2]+dy[ny-1])+0.5*dy[ny-1]);
+#pragma omp parallel for private(i)
     for (k=pstart; k<pstart+p; k++) // loop over z-direction
     {
       for (i=mstart; i<mstart+m; i++) // loop over x-direction
@@ -519,7 +587,7 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
           {
             case CONVECTIVE:
             case DIRICHLET:
-              bc1z[k][0][i] += coeffMinus*qz[k][-1][i];
+              bc1z[k][0][i] += ((scaleByMHat) ? MHatz[k][0][i] : 1.0)*coeffMinus*qz[k][-1][i];
               break;
             default:
               break;
@@ -531,7 +599,7 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
           {
             case CONVECTIVE:
             case DIRICHLET:
-              bc1z[k][N-1][i] += coeffPlus*qz[k][N][i];
+              bc1z[k][N-1][i] += ((scaleByMHat) ? MHatz[k][N-1][i] : 1.0)*coeffPlus*qz[k][N][i];
               break;
             default:
               break;
@@ -545,6 +613,7 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
   {
     coeffMinus = alpha*nu * 2.0/dz[0]/(dz[0]+dz[1]);
     coeffPlus = alpha*nu * 2.0/dz[nz-1]/(dz[nz-2]+dz[nz-1]);
+#pragma omp parallel for private(i)
     for (j=nstart; j<nstart+n; j++) // loop over y-direction
     {
       for (i=mstart; i<mstart+m; i++) // loop over x-direction
@@ -555,7 +624,7 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
           {
             case CONVECTIVE:
             case DIRICHLET:
-              bc1z[0][j][i] += coeffMinus*qz[-1][j][i]/(dx[i]*dy[j]);
+              bc1z[0][j][i] += ((scaleByMHat) ? MHatz[0][j][i] : 1.0)*coeffMinus*qz[-1][j][i]/(dx[i]*dy[j]);
               break;
             default:
               break;
@@ -567,7 +636,7 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
           {
             case CONVECTIVE:
             case DIRICHLET:
-              bc1z[P-1][j][i] += coeffPlus*qz[P][j][i]/(dx[i]*dy[j]);
+              bc1z[P-1][j][i] += ((scaleByMHat) ? MHatz[P-1][j][i] : 1.0)*coeffPlus*qz[P][j][i]/(dx[i]*dy[j]);
               break;
             default:
               break;
@@ -577,11 +646,24 @@ PetscErrorCode NavierStokesSolver<3>::generateBC1()
     }
   }
   ierr = DMDAVecRestoreArray(wda, bc1zGlobal, &bc1z); CHKERRQ(ierr);
+  ierr = DMDAVecRestoreArrayRead(wda, MHatzGlobal, &MHatz); CHKERRQ(ierr);
   ierr = DMDAVecRestoreArray(wda, qzLocal, &qz); CHKERRQ(ierr);
 
-  ierr = DMCompositeRestoreAccess(qPack, bc1, &bc1xGlobal, &bc1yGlobal, &bc1zGlobal); CHKERRQ(ierr);
+  ierr = DMCompositeRestoreAccess(qPack, b, &bc1xGlobal, &bc1yGlobal, &bc1zGlobal); CHKERRQ(ierr);
+  ierr = DMCompositeRestoreAccess(qPack, MHat, &MHatxGlobal, &MHatyGlobal, &MHatzGlobal); CHKERRQ(ierr);
 
-  ierr = PetscObjectViewFromOptions((PetscObject) bc1, NULL, "-bc1_vec_view"); CHKERRQ(ierr);
+  {
+    // up to 4 operations and 4 values moved per boundary point
+    DM das[3] = {uda, vda, wda};
+    PetscInt numPoints = 0, numComponentPoints;
+    for (PetscInt c=0; c<3; c++)
+    {
+      ierr = countBoundaryPoints(das[c], numComponentPoints); CHKERRQ(ierr);
+      numPoints += numComponentPoints;
+    }
+    ierr = kernelLog.log(eventGenerateBC1, 4.0*numPoints, 4*sizeof(PetscReal)*numPoints); CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(eventGenerateBC1, 0, 0, 0, 0); CHKERRQ(ierr);
 
   return 0;
 } // generateBC1
\ No newline at end of file
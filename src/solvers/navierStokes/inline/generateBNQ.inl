@@ -49,31 +49,35 @@ PetscErrorCode NavierStokesSolver<2>::generateBNQ()
   ierr = DMDAVecGetArray(pda, pMapping, &pMappingArray); CHKERRQ(ierr);
 
   // determine nnz in matrix BNQ row by row
-  localIdx = 0;
+  PetscInt rowOffset = 0;
   // rows corresponding to fluxes in x-direction
   ierr = DMDAGetCorners(uda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
+#pragma omp parallel for private(i, localIdx, cols)
   for (j=nstart; j<nstart+n; j++)
   {
     for (i=mstart; i<mstart+m; i++)
     {
+      localIdx = rowOffset + (j-nstart)*m + (i-mstart);
       cols[0] = pMappingArray[j][i];
       cols[1] = pMappingArray[j][i+1];
       countNumNonZeros(cols, 2, lambdaStart, lambdaEnd, d_nnz[localIdx], o_nnz[localIdx]);
-      localIdx++;
     }
   }
+  rowOffset += m*n;
   // rows corresponding to fluxes in y-direction
   ierr = DMDAGetCorners(vda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
+#pragma omp parallel for private(i, localIdx, cols)
   for (j=nstart; j<nstart+n; j++)
   {
     for (i=mstart; i<mstart+m; i++)
     {
+      localIdx = rowOffset + (j-nstart)*m + (i-mstart);
       cols[0] = pMappingArray[j][i];
       cols[1] = pMappingArray[j+1][i];
       countNumNonZeros(cols, 2, lambdaStart, lambdaEnd, d_nnz[localIdx], o_nnz[localIdx]);
-      localIdx++;
     }
   }
+  rowOffset += m*n;
   
   // allocate memory for matrix BNQ
   ierr = MatCreate(PETSC_COMM_WORLD, &BNQ); CHKERRQ(ierr);
@@ -166,52 +170,58 @@ PetscErrorCode NavierStokesSolver<3>::generateBNQ()
   ierr = DMDAVecGetArray(pda, pMapping, &pMappingArray); CHKERRQ(ierr);
 
   // determine nnz in BNQ row by row
-  localIdx = 0;
+  PetscInt rowOffset = 0;
   // rows corresponding to fluxes in x-direction
   ierr = DMDAGetCorners(uda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
+#pragma omp parallel for private(i, j, localIdx, cols)
   for (k=pstart; k<pstart+p; k++)
   {
     for (j=nstart; j<nstart+n; j++)
     {
       for (i=mstart; i<mstart+m; i++)
       {
+        localIdx = rowOffset + ((k-pstart)*n + (j-nstart))*m + (i-mstart);
         cols[0] = pMappingArray[k][j][i];
         cols[1] = pMappingArray[k][j][i+1];
         countNumNonZeros(cols, 2, lambdaStart, lambdaEnd, d_nnz[localIdx], o_nnz[localIdx]);
-        localIdx++;
       }
     }
   }
+  rowOffset += m*n*p;
   // rows corresponding to fluxes in y-direction
   ierr = DMDAGetCorners(vda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
+#pragma omp parallel for private(i, j, localIdx, cols)
   for (k=pstart; k<pstart+p; k++)
   {
     for (j=nstart; j<nstart+n; j++)
     {
       for (i=mstart; i<mstart+m; i++)
       {
+        localIdx = rowOffset + ((k-pstart)*n + (j-nstart))*m + (i-mstart);
         cols[0] = pMappingArray[k][j][i];
         cols[1] = pMappingArray[k][j+1][i];
         countNumNonZeros(cols, 2, lambdaStart, lambdaEnd, d_nnz[localIdx], o_nnz[localIdx]);
-        localIdx++;
       }
     }
   }
+  rowOffset += m*n*p;
   // rows corresponding to fluxes in z-direction
   ierr = DMDAGetCorners(wda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
+#pragma omp parallel for private(i, j, localIdx, cols)
   for (k=pstart; k<pstart+p; k++)
   {
     for (j=nstart; j<nstart+n; j++)
     {
       for (i=mstart; i<mstart+m; i++)
       {
+        localIdx = rowOffset + ((k-pstart)*n + (j-nstart))*m + (i-mstart);
         cols[0] = pMappingArray[k][j][i];
         cols[1] = pMappingArray[k+1][j][i];
         countNumNonZeros(cols, 2, lambdaStart, lambdaEnd, d_nnz[localIdx], o_nnz[localIdx]);
-        localIdx++;
       }
     }
   }
+  rowOffset += m*n*p;
   
   // allocate memory for matrix BNQ
   ierr = MatCreate(PETSC_COMM_WORLD, &BNQ); CHKERRQ(ierr);
@@ -48,6 +48,7 @@ PetscErrorCode NavierStokesSolver<2>::generateDiagonalMatrices()
   PetscReal **BNx;
   ierr = DMDAVecGetArray(uda, BNxGlobal, &BNx); CHKERRQ(ierr);
   ierr = DMDAGetCorners(uda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
+#pragma omp parallel for private(i)
   for (j=nstart; j<nstart+n; j++)
   {
     for (i=mstart; i<mstart+m; i++)
@@ -69,6 +70,7 @@ PetscErrorCode NavierStokesSolver<2>::generateDiagonalMatrices()
   PetscReal **BNy;
   ierr = DMDAVecGetArray(vda, BNyGlobal, &BNy); CHKERRQ(ierr);
   ierr = DMDAGetCorners(vda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
+#pragma omp parallel for private(i)
   for (j=nstart; j<nstart+n; j++)
   {
     for (i=mstart; i<mstart+m; i++)
@@ -119,6 +121,7 @@ PetscErrorCode NavierStokesSolver<3>::generateDiagonalMatrices()
   PetscReal ***BNx;
   ierr = DMDAVecGetArray(uda, BNxGlobal, &BNx); CHKERRQ(ierr);
   ierr = DMDAGetCorners(uda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
+#pragma omp parallel for private(i, j)
   for (k=pstart; k<pstart+p; k++)
   {
     for (j=nstart; j<nstart+n; j++)
@@ -143,6 +146,7 @@ PetscErrorCode NavierStokesSolver<3>::generateDiagonalMatrices()
   PetscReal ***BNy;
   ierr = DMDAVecGetArray(vda, BNyGlobal, &BNy); CHKERRQ(ierr);
   ierr = DMDAGetCorners(vda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
+#pragma omp parallel for private(i, j)
   for (k=pstart; k<pstart+p; k++)
   {
     for (j=nstart; j<nstart+n; j++)
@@ -167,6 +171,7 @@ PetscErrorCode NavierStokesSolver<3>::generateDiagonalMatrices()
   PetscReal ***BNz;
   ierr = DMDAVecGetArray(wda, BNzGlobal, &BNz); CHKERRQ(ierr);
   ierr = DMDAGetCorners(wda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
+#pragma omp parallel for private(i, j)
   for (k=pstart; k<pstart+p; k++)
   {
     for (j=nstart; j<nstart+n; j++)
@@ -0,0 +1,145 @@
+/***************************************************************************//**
+ * \file generateMetrics.inl
+ * \brief Implementation of the methods `generateMetrics` and
+ *        `generateLaplacianStencils` of the class `NavierStokesSolver`.
+ */
+
+
+/**
+ * \brief Read-only access to a metric of the grid along one direction.
+ *
+ * The specialization for a uniform direction stores a single value, so that
+ * the metric becomes a constant of the loops in which it is used. A direction
+ * is uniform only when its cell-widths are exactly equal
+ * (`CartesianMesh::detectUniformity`), so that this value is the one of every
+ * entry the loops read.
+ */
+template <PetscBool uniform>
+struct GridMetric
+{
+  const PetscReal *values;
+
+  GridMetric(const std::vector<PetscReal> &v, PetscInt offset=0) : values(&v[offset]) { }
+  PetscReal operator[](PetscInt i) const { return values[i]; }
+}; // GridMetric
+
+
+template <>
+struct GridMetric<PETSC_TRUE>
+{
+  PetscReal value;
+
+  // entries next to a non-periodic boundary may differ, the middle one does not
+  GridMetric(const std::vector<PetscReal> &v, PetscInt offset=0) : value(v[v.size()/2]) { }
+  PetscReal operator[](PetscInt) const { return value; }
+}; // GridMetric
+
+
+/**
+ * \brief Computes the metrics of the grid used by the stencil kernels.
+ *
+ * The reciprocals of the cell-widths are stored with their periodic images
+ * at both ends (index -1 and n, after an offset of one), so that the kernels
+ * can access the neighbors of the first and last cells without branching.
+ * The staggered widths \f$ \frac{1}{2}(h_i + h_{i+1}) \f$ (wrapping around at
+ * the last cell) are the entries of \f$ \hat{M} \f$ and the denominators of the
+ * derivatives along the staggered direction of each flux component.
+ *
+ * The kernels of `calculateExplicitTerms` and `multA` are selected here,
+ * once, according to the uniformity of the grid along x.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::generateMetrics()
+{
+  PetscErrorCode ierr;
+
+  std::vector<PetscReal> *widths[3] = {&mesh->dx, &mesh->dy, &mesh->dz};
+
+  for (PetscInt d=0; d<dim; d++)
+  {
+    const std::vector<PetscReal> &h = *widths[d];
+    PetscInt n = h.size();
+    invWidths[d].resize(n+2);
+    staggeredWidths[d].resize(n);
+    invStaggeredWidths[d].resize(n);
+    for (PetscInt i=0; i<n; i++)
+    {
+      invWidths[d][i+1] = 1.0/h[i];
+      staggeredWidths[d][i] = 0.5*(h[i] + h[(i+1)%n]);
+      invStaggeredWidths[d][i] = 1.0/staggeredWidths[d][i];
+    }
+    invWidths[d][0] = 1.0/h[n-1];
+    invWidths[d][n+1] = 1.0/h[0];
+  }
+
+  ierr = generateLaplacianStencils(); CHKERRQ(ierr);
+
+  if (mesh->uniform[0])
+  {
+    selectedExplicitTermsKernel = &NavierStokesSolver<dim>::template calculateExplicitTermsKernel<PETSC_TRUE>;
+    selectedMultAKernel = &NavierStokesSolver<dim>::template multAKernel<PETSC_TRUE>;
+  }
+  else
+  {
+    selectedExplicitTermsKernel = &NavierStokesSolver<dim>::template calculateExplicitTermsKernel<PETSC_FALSE>;
+    selectedMultAKernel = &NavierStokesSolver<dim>::template multAKernel<PETSC_FALSE>;
+  }
+
+  return 0;
+} // generateMetrics
+
+
+/**
+ * \brief Computes the coefficients of the one-dimensional second-derivative
+ *        stencils used by the matrix-free operator \f$ A \f$.
+ *
+ * For each flux component and each direction, the coefficients of the minus
+ * neighbor, of the center and of the plus neighbor are stored in arrays
+ * indexed by the global index of the flux along that direction.
+ * The grid-spacings are the same as the ones used in `generateA` and
+ * `calculateExplicitTerms`.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::generateLaplacianStencils()
+{
+  PetscErrorCode ierr;
+
+  std::vector<PetscReal> *widths[3] = {&mesh->dx, &mesh->dy, &mesh->dz};
+  BoundaryLocation minusLocations[3] = {XMINUS, YMINUS, ZMINUS};
+  DM das[3] = {uda, vda, wda};
+
+  for (PetscInt c=0; c<dim; c++) // flux component
+  {
+    PetscInt numPoints[3];
+    ierr = DMDAGetInfo(das[c], NULL, &numPoints[0], &numPoints[1], &numPoints[2], NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
+    for (PetscInt d=0; d<dim; d++) // direction
+    {
+      const std::vector<PetscReal> &h = *widths[d];
+      PetscInt n = h.size(),
+               M = numPoints[d];
+      PetscBool periodic = (flow->boundaries[minusLocations[d]][0].type == PERIODIC) ? PETSC_TRUE : PETSC_FALSE;
+      LMinus[c][d].resize(M);
+      LCenter[c][d].resize(M);
+      LPlus[c][d].resize(M);
+      PetscReal hMinus, hPlus;
+      for (PetscInt i=0; i<M; i++)
+      {
+        if (c == d)
+        {
+          hMinus = h[i];
+          hPlus = (i == M-1 && periodic) ? h[0] : h[i+1];
+        }
+        else
+        {
+          hMinus = (i > 0) ? 0.5*(h[i-1] + h[i]) : (periodic) ? 0.5*(h[n-1] + h[i]) : 0.5*h[i];
+          hPlus = (i < M-1) ? 0.5*(h[i] + h[i+1]) : (periodic) ? 0.5*(h[i] + h[0]) : 0.5*h[i];
+        }
+        LMinus[c][d][i] = 2.0/hMinus/(hMinus + hPlus);
+        LCenter[c][d][i] = -2.0/hMinus/hPlus;
+        LPlus[c][d][i] = 2.0/ hPlus/(hMinus + hPlus);
+      }
+    }
+  }
+
+  return 0;
+} // generateLaplacianStencils
@@ -22,6 +22,8 @@ PetscErrorCode NavierStokesSolver<2>::generateR2()
 {
   PetscErrorCode ierr;
 
+  ierr = PetscLogEventBegin(eventGenerateR2, 0, 0, 0, 0); CHKERRQ(ierr);
+
   PetscInt i, j,           // loop indices
            m, n,           // local number of nodes along each direction
            mstart, nstart; // starting indices
@@ -40,6 +42,7 @@ PetscErrorCode NavierStokesSolver<2>::generateR2()
   // left and right boundaries
   if (flow->boundaries[XPLUS][0].type != PERIODIC) // do not update if x-periodic
   {
+#pragma omp parallel for
     for (j=nstart; j<nstart+n; j++) // loop over y-direction
     {
       if (mstart == 0) // left boundary on current process
@@ -55,6 +58,7 @@ PetscErrorCode NavierStokesSolver<2>::generateR2()
   // bottom and top boundaries
   if (flow->boundaries[YPLUS][1].type != PERIODIC) // do not update if y-periodic
   {
+#pragma omp parallel for
     for (i=mstart; i<mstart+m; i++) // loop over x-direction
     {
       if (nstart == 0) // bottom boundary on current process
@@ -76,6 +80,15 @@ PetscErrorCode NavierStokesSolver<2>::generateR2()
 
   ierr = PetscObjectViewFromOptions((PetscObject) r2, NULL, "-r2_vec_view"); CHKERRQ(ierr);
 
+  {
+    // one operation and 3 values moved per boundary point, after zeroing r2
+    PetscInt numPoints, r2LocalSize;
+    ierr = countBoundaryPoints(pda, numPoints); CHKERRQ(ierr);
+    ierr = VecGetLocalSize(r2, &r2LocalSize); CHKERRQ(ierr);
+    ierr = kernelLog.log(eventGenerateR2, numPoints, (3*numPoints + r2LocalSize)*sizeof(PetscReal)); CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(eventGenerateR2, 0, 0, 0, 0); CHKERRQ(ierr);
+
   return 0;
 } // generateR2
 
@@ -86,6 +99,8 @@ PetscErrorCode NavierStokesSolver<3>::generateR2()
 {
   PetscErrorCode ierr;
 
+  ierr = PetscLogEventBegin(eventGenerateR2, 0, 0, 0, 0); CHKERRQ(ierr);
+
   PetscInt i, j, k,                // loop indices
            m, n, p,                // local number of nodes along each direction
            mstart, nstart, pstart; // starting indices
@@ -105,6 +120,7 @@ PetscErrorCode NavierStokesSolver<3>::generateR2()
   // left and right boundaries
   if (flow->boundaries[XPLUS][0].type != PERIODIC) // do not update if x-periodic
   {
+#pragma omp parallel for private(j)
     for (k=pstart; k<pstart+p; k++) // loop over z-direction
     {
       for (j=nstart; j<nstart+n; j++) // loop over y-direction
@@ -123,6 +139,7 @@ PetscErrorCode NavierStokesSolver<3>::generateR2()
   // bottom and top boundaries
   if (flow->boundaries[YPLUS][1].type != PERIODIC) // do not update if y-periodic
   {
+#pragma omp parallel for private(i)
     for (k=pstart; k<pstart+p; k++) // loop over z-direction
     {
       for (i=mstart; i<mstart+m; i++) // loop over x-direction
@@ -141,6 +158,7 @@ PetscErrorCode NavierStokesSolver<3>::generateR2()
   // back and front boundaries
   if (flow->boundaries[ZPLUS][2].type != PERIODIC) // do not update if z-periodic
   {
+#pragma omp parallel for private(i)
     for (j=nstart; j<nstart+n; j++) // loop over y-direction
     {
       for (i=mstart; i<mstart+m; i++) // loop over x-direction
@@ -166,5 +184,14 @@ PetscErrorCode NavierStokesSolver<3>::generateR2()
 
   ierr = PetscObjectViewFromOptions((PetscObject) r2, NULL, "-r2_vec_view"); CHKERRQ(ierr);
 
+  {
+    // one operation and 3 values moved per boundary point, after zeroing r2
+    PetscInt numPoints, r2LocalSize;
+    ierr = countBoundaryPoints(pda, numPoints); CHKERRQ(ierr);
+    ierr = VecGetLocalSize(r2, &r2LocalSize); CHKERRQ(ierr);
+    ierr = kernelLog.log(eventGenerateR2, numPoints, (3*numPoints + r2LocalSize)*sizeof(PetscReal)); CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(eventGenerateR2, 0, 0, 0, 0); CHKERRQ(ierr);
+
   return 0;
 } // generateR2
\ No newline at end of file
@@ -27,6 +27,7 @@ PetscErrorCode NavierStokesSolver<dim>::readData()
   std::stringstream ss;
   ss << parameters->directory << "/" << std::setfill('0') << std::setw(7) << timeStep;
   std::string solutionDirectory = ss.str();
+  ierr = openSolutionFile(solutionDirectory, FILE_MODE_READ); CHKERRQ(ierr);
 
   if (parameters->outputFlux)
   {
@@ -41,6 +42,7 @@ PetscErrorCode NavierStokesSolver<dim>::readData()
   {
     ierr = readConvectiveTerms(solutionDirectory); CHKERRQ(ierr);
   }
+  ierr = closeSolutionFile(); CHKERRQ(ierr);
 
   ierr = PetscPrintf(PETSC_COMM_WORLD, "done\n"); CHKERRQ(ierr);
 
@@ -58,24 +60,9 @@ PetscErrorCode NavierStokesSolver<dim>::readFluxes(std::string directory)
 {
   PetscErrorCode ierr;
   Vec qxGlobal, qyGlobal, qzGlobal;
-  PetscViewer viewer;
-  PetscViewerType viewerType;
-  std::string filePath, fileExtension;
 
   PetscFunctionBeginUser;
 
-  // get type of viewer depending on output format prescribed
-  if (parameters->outputFormat == "hdf5")
-  {
-    viewerType = PETSCVIEWERHDF5;
-    fileExtension = "h5";
-  }
-  else if (parameters->outputFormat == "binary")
-  {
-    viewerType = PETSCVIEWERBINARY;
-    fileExtension = "dat";
-  }
-
   if (dim == 2)
   {
     ierr = DMCompositeGetAccess(qPack, q, &qxGlobal, &qyGlobal); CHKERRQ(ierr);
@@ -86,34 +73,13 @@ PetscErrorCode NavierStokesSolver<dim>::readFluxes(std::string directory)
   }
   
   // read fluxes in x-direction
-  filePath = directory + "/qx." + fileExtension;
-  ierr = PetscObjectSetName((PetscObject) qxGlobal, "qx"); CHKERRQ(ierr);
-  ierr = PetscViewerCreate(PETSC_COMM_WORLD, &viewer); CHKERRQ(ierr); 
-  ierr = PetscViewerSetType(viewer, viewerType); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetMode(viewer, FILE_MODE_READ); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetName(viewer, filePath.c_str()); CHKERRQ(ierr);
-  ierr = VecLoad(qxGlobal, viewer); CHKERRQ(ierr);
-  ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+  ierr = loadField(qxGlobal, "qx", directory); CHKERRQ(ierr);
   // read fluxes in y-direction
-  filePath = directory + "/qy." + fileExtension;
-  ierr = PetscObjectSetName((PetscObject) qyGlobal, "qy"); CHKERRQ(ierr);
-  ierr = PetscViewerCreate(PETSC_COMM_WORLD, &viewer); CHKERRQ(ierr); 
-  ierr = PetscViewerSetType(viewer, viewerType); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetMode(viewer, FILE_MODE_READ); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetName(viewer, filePath.c_str()); CHKERRQ(ierr);
-  ierr = VecLoad(qyGlobal, viewer); CHKERRQ(ierr);
-  ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+  ierr = loadField(qyGlobal, "qy", directory); CHKERRQ(ierr);
   if (dim == 3)
   {
     // read fluxes in z-direction
-    filePath = directory + "/qz." + fileExtension;
-    ierr = PetscObjectSetName((PetscObject) qzGlobal, "qz"); CHKERRQ(ierr);
-    ierr = PetscViewerCreate(PETSC_COMM_WORLD, &viewer); CHKERRQ(ierr); 
-    ierr = PetscViewerSetType(viewer, viewerType); CHKERRQ(ierr);
-    ierr = PetscViewerFileSetMode(viewer, FILE_MODE_READ); CHKERRQ(ierr);
-    ierr = PetscViewerFileSetName(viewer, filePath.c_str()); CHKERRQ(ierr);
-    ierr = VecLoad(qzGlobal, viewer); CHKERRQ(ierr);
-    ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+    ierr = loadField(qzGlobal, "qz", directory); CHKERRQ(ierr);
   }
 
   if (dim == 2)
@@ -139,24 +105,9 @@ PetscErrorCode NavierStokesSolver<dim>::readVelocities(std::string directory)
 {
   PetscErrorCode ierr;
   Vec u, uxGlobal, uyGlobal, uzGlobal;
-  PetscViewer viewer;
-  PetscViewerType viewerType;
-  std::string filePath, fileExtension;
 
   PetscFunctionBeginUser;
 
-  // define the type of viewer and the file extension
-  if (parameters->outputFormat == "hdf5")
-  {
-    viewerType = PETSCVIEWERHDF5;
-    fileExtension = "h5";
-  }
-  else if (parameters->outputFormat == "binary")
-  {
-    viewerType = PETSCVIEWERBINARY;
-    fileExtension = "dat";
-  }
-
   ierr = VecDuplicate(q, &u); CHKERRQ(ierr);
   if (dim == 2)
   {
@@ -168,34 +119,13 @@ PetscErrorCode NavierStokesSolver<dim>::readVelocities(std::string directory)
   }
   
   // read x-component of the velocity
-  filePath = directory + "/ux." + fileExtension;
-  ierr = PetscObjectSetName((PetscObject) uxGlobal, "ux"); CHKERRQ(ierr);
-  ierr = PetscViewerCreate(PETSC_COMM_WORLD, &viewer); CHKERRQ(ierr); 
-  ierr = PetscViewerSetType(viewer, viewerType); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetMode(viewer, FILE_MODE_READ); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetName(viewer, filePath.c_str()); CHKERRQ(ierr);
-  ierr = VecLoad(uxGlobal, viewer); CHKERRQ(ierr);
-  ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+  ierr = loadField(uxGlobal, "ux", directory); CHKERRQ(ierr);
   // read y-component of the velocity
-  filePath = directory + "/uy." + fileExtension;
-  ierr = PetscObjectSetName((PetscObject) uyGlobal, "uy"); CHKERRQ(ierr);
-  ierr = PetscViewerCreate(PETSC_COMM_WORLD, &viewer); CHKERRQ(ierr); 
-  ierr = PetscViewerSetType(viewer, viewerType); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetMode(viewer, FILE_MODE_READ); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetName(viewer, filePath.c_str()); CHKERRQ(ierr);
-  ierr = VecLoad(uyGlobal, viewer); CHKERRQ(ierr);
-  ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+  ierr = loadField(uyGlobal, "uy", directory); CHKERRQ(ierr);
   if (dim == 3)
   {
     // read z-component of the velocity
-    filePath = directory + "/uz." + fileExtension;
-    ierr = PetscObjectSetName((PetscObject) uzGlobal, "uz"); CHKERRQ(ierr);
-    ierr = PetscViewerCreate(PETSC_COMM_WORLD, &viewer); CHKERRQ(ierr); 
-    ierr = PetscViewerSetType(viewer, viewerType); CHKERRQ(ierr);
-    ierr = PetscViewerFileSetMode(viewer, FILE_MODE_READ); CHKERRQ(ierr);
-    ierr = PetscViewerFileSetName(viewer, filePath.c_str()); CHKERRQ(ierr);
-    ierr = VecLoad(uzGlobal, viewer); CHKERRQ(ierr);
-    ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+    ierr = loadField(uzGlobal, "uz", directory); CHKERRQ(ierr);
   }
 
   if (dim == 2)
@@ -226,24 +156,9 @@ PetscErrorCode NavierStokesSolver<dim>::readConvectiveTerms(std::string director
 {
   PetscErrorCode ierr;
   Vec HxGlobal, HyGlobal, HzGlobal;
-  PetscViewer viewer;
-  PetscViewerType viewerType;
-  std::string filePath, fileExtension;
 
   PetscFunctionBeginUser;
 
-  // get type of viewer depending on output format prescribed
-  if (parameters->outputFormat == "hdf5")
-  {
-    viewerType = PETSCVIEWERHDF5;
-    fileExtension = "h5";
-  }
-  else if (parameters->outputFormat == "binary")
-  {
-    viewerType = PETSCVIEWERBINARY;
-    fileExtension = "dat";
-  }
-
   if (dim == 2)
   {
     ierr = DMCompositeGetAccess(qPack, H, &HxGlobal, &HyGlobal); CHKERRQ(ierr);
@@ -254,34 +169,13 @@ PetscErrorCode NavierStokesSolver<dim>::readConvectiveTerms(std::string director
   }
   
   // read convective terms in x-direction
-  filePath = directory + "/Hx." + fileExtension;
-  ierr = PetscObjectSetName((PetscObject) HxGlobal, "Hx"); CHKERRQ(ierr);
-  ierr = PetscViewerCreate(PETSC_COMM_WORLD, &viewer); CHKERRQ(ierr); 
-  ierr = PetscViewerSetType(viewer, viewerType); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetMode(viewer, FILE_MODE_READ); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetName(viewer, filePath.c_str()); CHKERRQ(ierr);
-  ierr = VecLoad(HxGlobal, viewer); CHKERRQ(ierr);
-  ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+  ierr = loadField(HxGlobal, "Hx", directory); CHKERRQ(ierr);
   // read convective terms in y-direction
-  filePath = directory + "/Hy." + fileExtension;
-  ierr = PetscObjectSetName((PetscObject) HyGlobal, "Hy"); CHKERRQ(ierr);
-  ierr = PetscViewerCreate(PETSC_COMM_WORLD, &viewer); CHKERRQ(ierr); 
-  ierr = PetscViewerSetType(viewer, viewerType); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetMode(viewer, FILE_MODE_READ); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetName(viewer, filePath.c_str()); CHKERRQ(ierr);
-  ierr = VecLoad(HyGlobal, viewer); CHKERRQ(ierr);
-  ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+  ierr = loadField(HyGlobal, "Hy", directory); CHKERRQ(ierr);
   if (dim == 3)
   {
     // read convective terms in z-direction
-    filePath = directory + "/Hz." + fileExtension;
-    ierr = PetscObjectSetName((PetscObject) HzGlobal, "Hz"); CHKERRQ(ierr);
-    ierr = PetscViewerCreate(PETSC_COMM_WORLD, &viewer); CHKERRQ(ierr); 
-    ierr = PetscViewerSetType(viewer, viewerType); CHKERRQ(ierr);
-    ierr = PetscViewerFileSetMode(viewer, FILE_MODE_READ); CHKERRQ(ierr);
-    ierr = PetscViewerFileSetName(viewer, filePath.c_str()); CHKERRQ(ierr);
-    ierr = VecLoad(HzGlobal, viewer); CHKERRQ(ierr);
-    ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+    ierr = loadField(HzGlobal, "Hz", directory); CHKERRQ(ierr);
   }
 
   if (dim == 2)
@@ -307,35 +201,13 @@ PetscErrorCode NavierStokesSolver<dim>::readLambda(std::string directory)
 {
   PetscErrorCode ierr;
   Vec phi;
-  PetscViewer viewer;
-  PetscViewerType viewerType;
-  std::string filePath, fileExtension;
 
   PetscFunctionBeginUser;
 
-  // define the type of viewer and the file extension
-  if (parameters->outputFormat == "hdf5")
-  {
-    viewerType = PETSCVIEWERHDF5;
-    fileExtension = "h5";
-  }
-  else if (parameters->outputFormat == "binary")
-  {
-    viewerType = PETSCVIEWERBINARY;
-    fileExtension = "dat";
-  }
-
   ierr = DMCompositeGetAccess(lambdaPack, lambda, &phi); CHKERRQ(ierr);
 
   // read pressure field
-  filePath = directory + "/phi." + fileExtension;
-  ierr = PetscObjectSetName((PetscObject) phi, "phi"); CHKERRQ(ierr);
-  ierr = PetscViewerCreate(PETSC_COMM_WORLD, &viewer); CHKERRQ(ierr); 
-  ierr = PetscViewerSetType(viewer, viewerType); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetMode(viewer, FILE_MODE_READ); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetName(viewer, filePath.c_str()); CHKERRQ(ierr);
-  ierr = VecLoad(phi, viewer); CHKERRQ(ierr);
-  ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+  ierr = loadField(phi, "phi", directory); CHKERRQ(ierr);
 
   ierr = DMCompositeRestoreAccess(lambdaPack, lambda, &phi); CHKERRQ(ierr);
 
@@ -353,9 +225,7 @@ PetscErrorCode NavierStokesSolver<dim>::writeData()
 
   PetscFunctionBeginUser;
 
-  ierr = PetscLogStagePush(stageWriteData); CHKERRQ(ierr);
-
-  ierr = writeIterationCounts(); CHKERRQ(ierr);
+  ierr = tracer.pushStage(stageWriteData); CHKERRQ(ierr);
 
   if (timeStep%parameters->nsave == 0 || timeStep%parameters->nrestart == 0)
   {
@@ -368,6 +238,7 @@ PetscErrorCode NavierStokesSolver<dim>::writeData()
     ss << parameters->directory << "/" << std::setfill('0') << std::setw(7) << timeStep;
     std::string solutionDirectory = ss.str();
     mkdir(solutionDirectory.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+    ierr = openSolutionFile(solutionDirectory, FILE_MODE_WRITE); CHKERRQ(ierr);
 
     if (parameters->outputFlux)
     {
@@ -382,10 +253,18 @@ PetscErrorCode NavierStokesSolver<dim>::writeData()
     {
       ierr = writeConvectiveTerms(solutionDirectory); CHKERRQ(ierr);
     }
+    ierr = closeSolutionFile(); CHKERRQ(ierr);
+    // the staged fields are written in the background
+    ierr = asyncWriter.commit(); CHKERRQ(ierr);
+    // the fields written in HDF5 files are added to the XDMF files
+    ierr = xdmf.writeSnapshot(timeStep, timeStep*parameters->dt); CHKERRQ(ierr);
 
     ierr = PetscPrintf(PETSC_COMM_WORLD, "done\n"); CHKERRQ(ierr);
   }
-  ierr = PetscLogStagePop(); CHKERRQ(ierr);
+  ierr = tracer.popStage(); CHKERRQ(ierr);
+
+  ierr = writeProbes(); CHKERRQ(ierr);
+  ierr = writeTimeSeries(); CHKERRQ(ierr);
 
   PetscFunctionReturn(0);
 } // writeData
@@ -393,7 +272,8 @@ PetscErrorCode NavierStokesSolver<dim>::writeData()
 
 #ifdef PETSC_HAVE_HDF5
 /**
- * \brief Writes grid stations of the different field variables in HDF5 files.
+ * \brief Writes grid stations of the different field variables in HDF5 files
+ *        and starts the XDMF file of each grid.
  */
 template <PetscInt dim>
 PetscErrorCode NavierStokesSolver<dim>::writeGrids()
@@ -419,6 +299,31 @@ PetscErrorCode NavierStokesSolver<dim>::writeGrids()
   filePath = gridsDirectory + "/cell-centered.h5";
   ierr = mesh->write(filePath, CELL_CENTERED, PERIODIC); CHKERRQ(ierr);
 
+  // time series of the fields of each grid, `<grid>.xmf`, completed by writeData()
+  const std::string gridNames[4] = {"staggered-x", "staggered-y", "staggered-z", "cell-centered"};
+  const StaggeredMode modes[4] = {STAGGERED_MODE_X, STAGGERED_MODE_Y, STAGGERED_MODE_Z, CELL_CENTERED};
+  const BoundaryType types[4] = {flow->boundaries[XMINUS][0].type,
+                                 flow->boundaries[YMINUS][0].type,
+                                 (dim == 3) ? flow->boundaries[ZMINUS][0].type : PERIODIC,
+                                 PERIODIC};
+  for (PetscInt g=0; g<4; g++)
+  {
+    if (g == 2 && dim == 2)
+      continue;
+    std::vector<PetscInt> sizes(dim);
+    for (PetscInt d=0; d<dim; d++)
+      sizes[d] = mesh->getNumStations(modes[g], types[g], d);
+    xdmf.addGrid(gridNames[g], "grids/" + gridNames[g] + ".h5", sizes);
+  }
+  const char *fields[3][3] = {{"qx", "ux", "Hx"}, {"qy", "uy", "Hy"}, {"qz", "uz", "Hz"}};
+  for (PetscInt d=0; d<dim; d++)
+  {
+    for (PetscInt f=0; f<3; f++)
+      xdmf.addField(fields[d][f], gridNames[d]);
+  }
+  xdmf.addField("phi", "cell-centered");
+  ierr = xdmf.initialize(parameters->directory, parameters->startStep); CHKERRQ(ierr);
+
   PetscFunctionReturn(0);
 } // writeGrids
 #endif
@@ -434,24 +339,9 @@ PetscErrorCode NavierStokesSolver<dim>::writeFluxes(std::string directory)
 {
   PetscErrorCode ierr;
   Vec qxGlobal, qyGlobal, qzGlobal;
-  PetscViewer viewer;
-  PetscViewerType viewerType;
-  std::string filePath, fileExtension;
 
   PetscFunctionBeginUser;
 
-  // define the type of viewer and the file extension
-  if (parameters->outputFormat == "hdf5")
-  {
-    viewerType = PETSCVIEWERHDF5;
-    fileExtension = "h5";
-  }
-  else if (parameters->outputFormat == "binary")
-  {
-    viewerType = PETSCVIEWERBINARY;
-    fileExtension = "dat";
-  }
-
   if (dim == 2)
   {
     ierr = DMCompositeGetAccess(qPack, q, &qxGlobal, &qyGlobal); CHKERRQ(ierr);
@@ -462,34 +352,13 @@ PetscErrorCode NavierStokesSolver<dim>::writeFluxes(std::string directory)
   }
 
   // write fluxes in x-direction
-  filePath = directory + "/qx." + fileExtension;
-  ierr = PetscObjectSetName((PetscObject) qxGlobal, "qx"); CHKERRQ(ierr);
-  ierr = PetscViewerCreate(PETSC_COMM_WORLD, &viewer); CHKERRQ(ierr); 
-  ierr = PetscViewerSetType(viewer, viewerType); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetMode(viewer, FILE_MODE_WRITE); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetName(viewer, filePath.c_str()); CHKERRQ(ierr);
-  ierr = VecView(qxGlobal, viewer); CHKERRQ(ierr);
-  ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+  ierr = viewField(qxGlobal, "qx", directory); CHKERRQ(ierr);
   // write fluxes in y-direction
-  filePath = directory + "/qy." + fileExtension;
-  ierr = PetscObjectSetName((PetscObject) qyGlobal, "qy"); CHKERRQ(ierr);
-  ierr = PetscViewerCreate(PETSC_COMM_WORLD, &viewer); CHKERRQ(ierr); 
-  ierr = PetscViewerSetType(viewer, viewerType); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetMode(viewer, FILE_MODE_WRITE); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetName(viewer, filePath.c_str()); CHKERRQ(ierr);
-  ierr = VecView(qyGlobal, viewer); CHKERRQ(ierr);
-  ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+  ierr = viewField(qyGlobal, "qy", directory); CHKERRQ(ierr);
   if (dim == 3)
   {
     // write fluxes in z-direction
-    filePath = directory + "/qz." + fileExtension;
-    ierr = PetscObjectSetName((PetscObject) qzGlobal, "qz"); CHKERRQ(ierr);
-    ierr = PetscViewerCreate(PETSC_COMM_WORLD, &viewer); CHKERRQ(ierr); 
-    ierr = PetscViewerSetType(viewer, viewerType); CHKERRQ(ierr);
-    ierr = PetscViewerFileSetMode(viewer, FILE_MODE_WRITE); CHKERRQ(ierr);
-    ierr = PetscViewerFileSetName(viewer, filePath.c_str()); CHKERRQ(ierr);
-    ierr = VecView(qzGlobal, viewer); CHKERRQ(ierr);
-    ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+    ierr = viewField(qzGlobal, "qz", directory); CHKERRQ(ierr);
   }
 
   if (dim == 2)
@@ -515,24 +384,9 @@ PetscErrorCode NavierStokesSolver<dim>::writeVelocities(std::string directory)
 {
   PetscErrorCode ierr;
   Vec u, uxGlobal, uyGlobal, uzGlobal;
-  PetscViewer viewer;
-  PetscViewerType viewerType;
-  std::string filePath, fileExtension;
 
   PetscFunctionBeginUser;
 
-  // define the type of viewer and the file extension
-  if (parameters->outputFormat == "hdf5")
-  {
-    viewerType = PETSCVIEWERHDF5;
-    fileExtension = "h5";
-  }
-  else if (parameters->outputFormat == "binary")
-  {
-    viewerType = PETSCVIEWERBINARY;
-    fileExtension = "dat";
-  }
-
   // convert flux into velocity
   ierr = VecDuplicate(q, &u);
   ierr = VecPointwiseMult(u, q, RInv); CHKERRQ(ierr);
@@ -547,34 +401,13 @@ PetscErrorCode NavierStokesSolver<dim>::writeVelocities(std::string directory)
   }
 
   // write x-component of the velocity
-  filePath = directory + "/ux." + fileExtension;
-  ierr = PetscObjectSetName((PetscObject) uxGlobal, "ux"); CHKERRQ(ierr);
-  ierr = PetscViewerCreate(PETSC_COMM_WORLD, &viewer); CHKERRQ(ierr); 
-  ierr = PetscViewerSetType(viewer, viewerType); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetMode(viewer, FILE_MODE_WRITE); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetName(viewer, filePath.c_str()); CHKERRQ(ierr);
-  ierr = VecView(uxGlobal, viewer); CHKERRQ(ierr);
-  ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+  ierr = viewField(uxGlobal, "ux", directory); CHKERRQ(ierr);
   // write y-component of the velocity
-  filePath = directory + "/uy." + fileExtension;
-  ierr = PetscObjectSetName((PetscObject) uyGlobal, "uy"); CHKERRQ(ierr);
-  ierr = PetscViewerCreate(PETSC_COMM_WORLD, &viewer); CHKERRQ(ierr); 
-  ierr = PetscViewerSetType(viewer, viewerType); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetMode(viewer, FILE_MODE_WRITE); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetName(viewer, filePath.c_str()); CHKERRQ(ierr);
-  ierr = VecView(uyGlobal, viewer); CHKERRQ(ierr);
-  ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+  ierr = viewField(uyGlobal, "uy", directory); CHKERRQ(ierr);
   if (dim == 3)
   {
     // write z-component of the velocity
-    filePath = directory + "/uz." + fileExtension;
-    ierr = PetscObjectSetName((PetscObject) uzGlobal, "uz"); CHKERRQ(ierr);
-    ierr = PetscViewerCreate(PETSC_COMM_WORLD, &viewer); CHKERRQ(ierr); 
-    ierr = PetscViewerSetType(viewer, viewerType); CHKERRQ(ierr);
-    ierr = PetscViewerFileSetMode(viewer, FILE_MODE_WRITE); CHKERRQ(ierr);
-    ierr = PetscViewerFileSetName(viewer, filePath.c_str()); CHKERRQ(ierr);
-    ierr = VecView(uzGlobal, viewer); CHKERRQ(ierr);
-    ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+    ierr = viewField(uzGlobal, "uz", directory); CHKERRQ(ierr);
   }
 
   if (dim == 2)
@@ -602,24 +435,9 @@ PetscErrorCode NavierStokesSolver<dim>::writeConvectiveTerms(std::string directo
 {
   PetscErrorCode ierr;
   Vec HxGlobal, HyGlobal, HzGlobal;
-  PetscViewer viewer;
-  PetscViewerType viewerType;
-  std::string filePath, fileExtension;
 
   PetscFunctionBeginUser;
 
-  // define the type of viewer and the file extension
-  if (parameters->outputFormat == "hdf5")
-  {
-    viewerType = PETSCVIEWERHDF5;
-    fileExtension = "h5";
-  }
-  else if (parameters->outputFormat == "binary")
-  {
-    viewerType = PETSCVIEWERBINARY;
-    fileExtension = "dat";
-  }
-
   if (dim == 2)
   {
     ierr = DMCompositeGetAccess(qPack, H, &HxGlobal, &HyGlobal); CHKERRQ(ierr);
@@ -630,34 +448,13 @@ PetscErrorCode NavierStokesSolver<dim>::writeConvectiveTerms(std::string directo
   }
 
   // convective terms in x-direction
-  filePath = directory + "/Hx." + fileExtension;
-  ierr = PetscObjectSetName((PetscObject) HxGlobal, "Hx"); CHKERRQ(ierr);
-  ierr = PetscViewerCreate(PETSC_COMM_WORLD, &viewer); CHKERRQ(ierr); 
-  ierr = PetscViewerSetType(viewer, viewerType); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetMode(viewer, FILE_MODE_WRITE); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetName(viewer, filePath.c_str()); CHKERRQ(ierr);
-  ierr = VecView(HxGlobal, viewer); CHKERRQ(ierr);
-  ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+  ierr = viewField(HxGlobal, "Hx", directory); CHKERRQ(ierr);
   // convective terms in y-direction
-  filePath = directory + "/Hy." + fileExtension;
-  ierr = PetscObjectSetName((PetscObject) HyGlobal, "Hy"); CHKERRQ(ierr);
-  ierr = PetscViewerCreate(PETSC_COMM_WORLD, &viewer); CHKERRQ(ierr); 
-  ierr = PetscViewerSetType(viewer, viewerType); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetMode(viewer, FILE_MODE_WRITE); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetName(viewer, filePath.c_str()); CHKERRQ(ierr);
-  ierr = VecView(HyGlobal, viewer); CHKERRQ(ierr);
-  ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+  ierr = viewField(HyGlobal, "Hy", directory); CHKERRQ(ierr);
   if (dim == 3)
   {
     // convective terms in z-direction
-    filePath = directory + "/Hz." + fileExtension;
-    ierr = PetscObjectSetName((PetscObject) HzGlobal, "Hz"); CHKERRQ(ierr);
-    ierr = PetscViewerCreate(PETSC_COMM_WORLD, &viewer); CHKERRQ(ierr); 
-    ierr = PetscViewerSetType(viewer, viewerType); CHKERRQ(ierr);
-    ierr = PetscViewerFileSetMode(viewer, FILE_MODE_WRITE); CHKERRQ(ierr);
-    ierr = PetscViewerFileSetName(viewer, filePath.c_str()); CHKERRQ(ierr);
-    ierr = VecView(HzGlobal, viewer); CHKERRQ(ierr);
-    ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+    ierr = viewField(HzGlobal, "Hz", directory); CHKERRQ(ierr);
   }
 
   if (dim == 2)
@@ -683,9 +480,198 @@ PetscErrorCode NavierStokesSolver<dim>::writeLambda(std::string directory)
 {
   PetscErrorCode ierr;
   Vec phi;
+
+  PetscFunctionBeginUser;
+
+  ierr = DMCompositeGetAccess(lambdaPack, lambda, &phi); CHKERRQ(ierr);
+
+  // write pressure field
+  ierr = viewField(phi, "phi", directory); CHKERRQ(ierr);
+
+  ierr = DMCompositeRestoreAccess(lambdaPack, lambda, &phi); CHKERRQ(ierr);
+
+  PetscFunctionReturn(0);
+} // writeLambda
+
+
+/**
+ * \brief Opens, when all the fields of a time step go into one HDF5 file
+ *        (`outputSingleFile: true`), the file `solution.h5` of the directory.
+ *
+ * The viewer stays open while the fields are written or read, and PETSc writes
+ * each field with collective hyperslab transfers into a dataset chunked by
+ * subdomain. A new file also holds the grid stations of each field, in the
+ * groups `grid-staggered-x`, `grid-staggered-y`, `grid-staggered-z` and
+ * `grid-cell-centered`. When reading from a directory without `solution.h5`
+ * (saved with one file per field), the fields are read from their own files.
+ *
+ * \param directory Directory of the numerical solution at the time step
+ * \param mode `FILE_MODE_WRITE` or `FILE_MODE_READ`
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::openSolutionFile(std::string directory, PetscFileMode mode)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  if (!parameters->outputSingleFile)
+    PetscFunctionReturn(0);
+
+#ifdef PETSC_HAVE_HDF5
+  std::string filePath = directory + "/solution.h5";
+  if (mode == FILE_MODE_READ)
+  {
+    PetscBool found;
+    ierr = PetscTestFile(filePath.c_str(), 'r', &found); CHKERRQ(ierr);
+    if (!found)
+      PetscFunctionReturn(0);
+  }
+  ierr = PetscViewerHDF5Open(PETSC_COMM_WORLD, filePath.c_str(), mode, &solutionViewer); CHKERRQ(ierr);
+  if (mode == FILE_MODE_WRITE)
+  {
+    ierr = PetscViewerHDF5PushGroup(solutionViewer, "/grid-staggered-x"); CHKERRQ(ierr);
+    ierr = mesh->write(solutionViewer, STAGGERED_MODE_X, flow->boundaries[XMINUS][0].type); CHKERRQ(ierr);
+    ierr = PetscViewerHDF5PopGroup(solutionViewer); CHKERRQ(ierr);
+    ierr = PetscViewerHDF5PushGroup(solutionViewer, "/grid-staggered-y"); CHKERRQ(ierr);
+    ierr = mesh->write(solutionViewer, STAGGERED_MODE_Y, flow->boundaries[YMINUS][0].type); CHKERRQ(ierr);
+    ierr = PetscViewerHDF5PopGroup(solutionViewer); CHKERRQ(ierr);
+    if (dim == 3)
+    {
+      ierr = PetscViewerHDF5PushGroup(solutionViewer, "/grid-staggered-z"); CHKERRQ(ierr);
+      ierr = mesh->write(solutionViewer, STAGGERED_MODE_Z, flow->boundaries[ZMINUS][0].type); CHKERRQ(ierr);
+      ierr = PetscViewerHDF5PopGroup(solutionViewer); CHKERRQ(ierr);
+    }
+    ierr = PetscViewerHDF5PushGroup(solutionViewer, "/grid-cell-centered"); CHKERRQ(ierr);
+    ierr = mesh->write(solutionViewer, CELL_CENTERED, PERIODIC); CHKERRQ(ierr);
+    ierr = PetscViewerHDF5PopGroup(solutionViewer); CHKERRQ(ierr);
+  }
+#endif
+
+  PetscFunctionReturn(0);
+} // openSolutionFile
+
+
+/**
+ * \brief Closes the file of the numerical solution, if open.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::closeSolutionFile()
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  if (solutionViewer != PETSC_NULL)
+  {
+    ierr = PetscViewerDestroy(&solutionViewer); CHKERRQ(ierr);
+  }
+
+  PetscFunctionReturn(0);
+} // closeSolutionFile
+
+
+/**
+ * \brief Writes a field into the open file of the numerical solution or,
+ *        without one, into its own file `<name>.h5` or `<name>.dat`.
+ *
+ * With `outputAsync: true` or output servers, the field is staged and
+ * written into `<name>.dat` after `AsyncWriter::commit`. With
+ * `outputCompression`, the HDF5 dataset is compressed (`viewCompressed`).
+ * The HDF5 datasets are recorded for the XDMF files of the grids.
+ *
+ * \param v The field
+ * \param name Name of the field (name of the dataset and of the file)
+ * \param directory Directory where to write the field
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::viewField(Vec v, std::string name, std::string directory)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  ierr = PetscObjectSetName((PetscObject) v, name.c_str()); CHKERRQ(ierr);
+  if (asyncWriter.isActive())
+  {
+    ierr = asyncWriter.stage(v, directory + "/" + name + ".dat"); CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  PetscViewer viewer = solutionViewer;
+  if (solutionViewer == PETSC_NULL)
+  {
+    ierr = openFieldViewer(name, directory, FILE_MODE_WRITE, viewer); CHKERRQ(ierr);
+  }
+#ifdef PETSC_HAVE_HDF5
+  if (parameters->outputCompression.type != "none")
+  {
+    // the fields read at restart have their own tolerance at restart time-steps
+    SimulationParameters::OutputCompression::Tolerance tolerance
+      = parameters->outputCompression.getTolerance(name, (timeStep%parameters->nrestart == 0) ? PETSC_TRUE : PETSC_FALSE);
+    ierr = viewCompressed(v, viewer, parameters->outputCompression.level,
+                          tolerance.value, tolerance.relative); CHKERRQ(ierr);
+  }
+  else
+#endif
+  {
+    ierr = VecView(v, viewer); CHKERRQ(ierr);
+  }
+  if (viewer != solutionViewer)
+  {
+    ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+  }
+  if (parameters->outputFormat == "hdf5")
+  {
+    // dataset relative to the simulation directory
+    std::string file = (solutionViewer != PETSC_NULL) ? "solution.h5" : name + ".h5";
+    xdmf.recordField(name, directory.substr(parameters->directory.size()+1) + "/" + file + ":/" + name);
+  }
+
+  PetscFunctionReturn(0);
+} // viewField
+
+
+/**
+ * \brief Reads a field from the open file of the numerical solution or,
+ *        without one, from its own file `<name>.h5` or `<name>.dat`.
+ *
+ * \param v The field
+ * \param name Name of the field (name of the dataset and of the file)
+ * \param directory Directory where to read the field
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::loadField(Vec v, std::string name, std::string directory)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  ierr = PetscObjectSetName((PetscObject) v, name.c_str()); CHKERRQ(ierr);
+  if (solutionViewer != PETSC_NULL)
+  {
+    ierr = VecLoad(v, solutionViewer); CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   PetscViewer viewer;
+  ierr = openFieldViewer(name, directory, FILE_MODE_READ, viewer); CHKERRQ(ierr);
+  ierr = VecLoad(v, viewer); CHKERRQ(ierr);
+  ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+
+  PetscFunctionReturn(0);
+} // loadField
+
+
+/**
+ * \brief Opens the file of a single field, with the type of viewer of the
+ *        output format.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::openFieldViewer(std::string name, std::string directory,
+                                                        PetscFileMode mode, PetscViewer &viewer)
+{
+  PetscErrorCode ierr;
   PetscViewerType viewerType;
-  std::string filePath, fileExtension;
+  std::string fileExtension;
 
   PetscFunctionBeginUser;
 
@@ -695,61 +681,194 @@ PetscErrorCode NavierStokesSolver<dim>::writeLambda(std::string directory)
     viewerType = PETSCVIEWERHDF5;
     fileExtension = "h5";
   }
-  else if (parameters->outputFormat == "binary")
+  else
   {
     viewerType = PETSCVIEWERBINARY;
     fileExtension = "dat";
   }
 
-  ierr = DMCompositeGetAccess(lambdaPack, lambda, &phi); CHKERRQ(ierr);
-
-  // write pressure field
-  filePath = directory + "/phi." + fileExtension;
-  ierr = PetscObjectSetName((PetscObject) phi, "phi"); CHKERRQ(ierr);
-  ierr = PetscViewerCreate(PETSC_COMM_WORLD, &viewer); CHKERRQ(ierr); 
+  std::string filePath = directory + "/" + name + "." + fileExtension;
+  ierr = PetscViewerCreate(PETSC_COMM_WORLD, &viewer); CHKERRQ(ierr);
   ierr = PetscViewerSetType(viewer, viewerType); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetMode(viewer, FILE_MODE_WRITE); CHKERRQ(ierr);
+  ierr = PetscViewerFileSetMode(viewer, mode); CHKERRQ(ierr);
   ierr = PetscViewerFileSetName(viewer, filePath.c_str()); CHKERRQ(ierr);
-  ierr = VecView(phi, viewer); CHKERRQ(ierr);
-  ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
 
-  ierr = DMCompositeRestoreAccess(lambdaPack, lambda, &phi); CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+} // openFieldViewer
+
+
+/**
+ * \brief Adds the columns of the quantities monitored at each time step to
+ *        the time series `timeSeries.csv`.
+ *
+ * The time series holds the time-step index, the time, the wall-time spent in
+ * each log stage during the time step (with `-log_stage_times`) and the
+ * iteration count and final residual norm of each solver; derived classes add
+ * their own columns.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::createTimeSeries()
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  ierr = timeSeries.initialize(parameters->directory + "/timeSeries.csv",
+                               (parameters->startStep > 0) ? PETSC_TRUE : PETSC_FALSE,
+                               parameters->nflush); CHKERRQ(ierr);
+  columnTimeStep = timeSeries.addColumn("timeStep");
+  columnTime = timeSeries.addColumn("time");
+  ierr = timeSeries.addStage("RHSVelocity", stageRHSVelocitySystem); CHKERRQ(ierr);
+  ierr = timeSeries.addStage("solveVelocity", stageSolveVelocitySystem); CHKERRQ(ierr);
+  ierr = timeSeries.addStage("RHSPoisson", stageRHSPoissonSystem); CHKERRQ(ierr);
+  ierr = timeSeries.addStage("solvePoisson", stageSolvePoissonSystem); CHKERRQ(ierr);
+  ierr = timeSeries.addStage("projectionStep", stageProjectionStep); CHKERRQ(ierr);
+  ierr = timeSeries.addStage("writeData", stageWriteData); CHKERRQ(ierr);
+  ierr = timeSeries.addSolver("velocity", velocity); CHKERRQ(ierr);
+  ierr = timeSeries.addSolver("poisson", poisson); CHKERRQ(ierr);
 
   PetscFunctionReturn(0);
-} // writeLambda
+} // createTimeSeries
+
+
+/**
+ * \brief Sets the values of the columns added by derived classes.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::recordTimeSeries()
+{
+  return 0;
+} // recordTimeSeries
+
+
+/**
+ * \brief Records the quantities monitored at the current time step.
+ *
+ * The records are buffered and written into the file every `nflush` time
+ * steps and when the numerical solution is saved.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::writeTimeSeries()
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  timeSeries.set(columnTimeStep, timeStep);
+  timeSeries.set(columnTime, timeStep*parameters->dt);
+  ierr = recordTimeSeries(); CHKERRQ(ierr);
+  ierr = timeSeries.record(); CHKERRQ(ierr);
+  if (timeStep%parameters->nsave == 0 || timeStep%parameters->nrestart == 0)
+  {
+    ierr = timeSeries.flush(); CHKERRQ(ierr);
+  }
+
+  PetscFunctionReturn(0);
+} // writeTimeSeries
+
+
+/**
+ * \brief Registers the velocity components (`velocity`: `ux`, `uy` and `uz`)
+ *        and the pressure (`pressure`: `phi`) with the probes and reads the
+ *        probes of the file `probes.yaml`, if present.
+ *
+ * The velocity components are sampled from the fluxes, scaled by `RInv`; the
+ * factors are folded into the interpolation weights by `Probes::initialize`,
+ * so the sub-vectors of `RInv` are restored right after.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::createProbes()
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  const StaggeredMode modes[3] = {STAGGERED_MODE_X, STAGGERED_MODE_Y, STAGGERED_MODE_Z};
+  const std::string names[3] = {"ux", "uy", "uz"};
+  DM das[3] = {uda, vda, wda};
+  Vec RInvGlobal[3];
+  std::vector<PetscReal> stations[3];
+
+  if (dim == 2)
+  {
+    ierr = DMCompositeGetAccess(qPack, RInv, &RInvGlobal[0], &RInvGlobal[1]); CHKERRQ(ierr);
+  }
+  else if (dim == 3)
+  {
+    ierr = DMCompositeGetAccess(qPack, RInv, &RInvGlobal[0], &RInvGlobal[1], &RInvGlobal[2]); CHKERRQ(ierr);
+  }
+
+  for (PetscInt c=0; c<dim; c++)
+  {
+    for (PetscInt d=0; d<dim; d++)
+      mesh->getStations(modes[c], flow->boundaries[2*c][0].type, d, stations[d]);
+    ierr = probes.addField(names[c], "velocity", das[c], stations, RInvGlobal[c]); CHKERRQ(ierr);
+  }
+  for (PetscInt d=0; d<dim; d++)
+    mesh->getStations(CELL_CENTERED, PERIODIC, d, stations[d]);
+  ierr = probes.addField("phi", "pressure", pda, stations, PETSC_NULL); CHKERRQ(ierr);
+  ierr = probes.initialize(parameters->directory + "/probes.yaml", parameters->directory,
+                           parameters->startStep, parameters->nflush); CHKERRQ(ierr);
+
+  if (dim == 2)
+  {
+    ierr = DMCompositeRestoreAccess(qPack, RInv, &RInvGlobal[0], &RInvGlobal[1]); CHKERRQ(ierr);
+  }
+  else if (dim == 3)
+  {
+    ierr = DMCompositeRestoreAccess(qPack, RInv, &RInvGlobal[0], &RInvGlobal[1], &RInvGlobal[2]); CHKERRQ(ierr);
+  }
+
+  PetscFunctionReturn(0);
+} // createProbes
 
 
 /**
- * \brief Writes the iteration count for each KSP solver into a file.
+ * \brief Samples the velocity and the pressure at the probes.
+ *
+ * The samples are written every `nflush` samples of a probe and when the
+ * numerical solution is saved.
  */
 template <PetscInt dim>
-PetscErrorCode NavierStokesSolver<dim>::writeIterationCounts()
+PetscErrorCode NavierStokesSolver<dim>::writeProbes()
 {
   PetscErrorCode ierr;
 
-  PetscMPIInt rank;
-  ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+  PetscFunctionBeginUser;
 
-  if (rank == 0)
+  if (probes.isSampling(timeStep))
   {
-    PetscInt countVelocitySolver,
-             countPoissonSolver;
-    std::string filePath = parameters->directory + "/iterationCounts.txt";
-    if (timeStep == 1)
+    Vec fluxes[3], phi;
+    const PetscInt pressureIndex = 0;
+    if (dim == 2)
+    {
+      ierr = DMCompositeGetAccess(qPack, q, &fluxes[0], &fluxes[1]); CHKERRQ(ierr);
+    }
+    else if (dim == 3)
+    {
+      ierr = DMCompositeGetAccess(qPack, q, &fluxes[0], &fluxes[1], &fluxes[2]); CHKERRQ(ierr);
+    }
+    ierr = DMCompositeGetAccessArray(lambdaPack, lambda, 1, &pressureIndex, &phi); CHKERRQ(ierr);
+
+    // fields in the order of registration
+    std::vector<Vec> vecs(fluxes, fluxes+dim);
+    vecs.push_back(phi);
+    ierr = probes.sample(timeStep, timeStep*parameters->dt, vecs); CHKERRQ(ierr);
+
+    ierr = DMCompositeRestoreAccessArray(lambdaPack, lambda, 1, &pressureIndex, &phi); CHKERRQ(ierr);
+    if (dim == 2)
     {
-      iterationCountsFile.open(filePath.c_str());
+      ierr = DMCompositeRestoreAccess(qPack, q, &fluxes[0], &fluxes[1]); CHKERRQ(ierr);
     }
-    else
+    else if (dim == 3)
     {
-      iterationCountsFile.open(filePath.c_str(), std::ios::out | std::ios::app);
+      ierr = DMCompositeRestoreAccess(qPack, q, &fluxes[0], &fluxes[1], &fluxes[2]); CHKERRQ(ierr);
     }
-    ierr = velocity->getIters(countVelocitySolver); CHKERRQ(ierr);
-    ierr = poisson->getIters(countPoissonSolver); CHKERRQ(ierr);
-    iterationCountsFile << timeStep << '\t' \
-                        << countVelocitySolver << '\t' \
-                        << countPoissonSolver << std::endl;
-    iterationCountsFile.close();
+  }
+  if (timeStep%parameters->nsave == 0 || timeStep%parameters->nrestart == 0)
+  {
+    ierr = probes.flush(); CHKERRQ(ierr);
   }
 
-  return 0;
-} // writeIterationCounts
+  PetscFunctionReturn(0);
+} // writeProbes
@@ -0,0 +1,82 @@
+/*! Implementation of the method `setMultigridDefaults` of the class `NavierStokesSolver`.
+ * \file setMultigridDefaults.inl
+ */
+
+
+/**
+ * \brief Prepares the pressure grid for geometric multigrid and sets default
+ *        options of PCMG for the Poisson solver.
+ *
+ * The pressure is cell-centered: the grid is coarsened by a factor 2 with
+ * piecewise-constant interpolation, as long as every direction has an even
+ * number of cells and at least 2 cells per process on the coarser grid.
+ * The coarse operators are Galerkin products of the Poisson matrix (which
+ * accounts for stretched grids); the singular coarse problem is solved
+ * redundantly with SVD. The defaults only apply with `-poisson_pc_type mg`
+ * and can be overridden on the command-line or in the options file.
+ *
+ * \param prefix Options prefix of the Poisson solver.
+ */
+template <PetscInt dim>
+PetscErrorCode NavierStokesSolver<dim>::setMultigridDefaults(std::string prefix)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  ierr = DMDASetInterpolationType(pda, DMDA_Q0); CHKERRQ(ierr);
+
+  PetscInt M[3] = {1, 1, 1},
+           procs[3] = {1, 1, 1};
+  ierr = DMDAGetInfo(pda, NULL, &M[0], &M[1], &M[2], &procs[0], &procs[1], &procs[2],
+                     NULL, NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
+
+  PetscInt numLevels = 1;
+  PetscBool coarsenable = PETSC_TRUE;
+  while (coarsenable)
+  {
+    for (PetscInt d=0; d<dim; d++)
+    {
+      if (M[d]%2 != 0 || M[d]/2 < 2*procs[d])
+        coarsenable = PETSC_FALSE;
+    }
+    if (coarsenable)
+    {
+      for (PetscInt d=0; d<dim; d++)
+        M[d] /= 2;
+      numLevels++;
+    }
+  }
+
+  // set the defaults unless given on the command-line
+  std::string levels = std::to_string(numLevels);
+  const char *defaults[][2] = {{"pc_mg_levels", levels.c_str()},
+                               {"pc_mg_galerkin", NULL},
+                               {"mg_coarse_pc_type", "redundant"},
+                               {"mg_coarse_redundant_pc_type", "svd"}};
+  for (size_t i=0; i<sizeof(defaults)/sizeof(defaults[0]); i++)
+  {
+    std::string name = "-" + prefix + defaults[i][0];
+    PetscBool set;
+    ierr = PetscOptionsHasName(NULL, NULL, name.c_str(), &set); CHKERRQ(ierr);
+    if (!set)
+    {
+      ierr = PetscOptionsSetValue(NULL, name.c_str(), defaults[i][1]); CHKERRQ(ierr);
+    }
+  }
+
+  if (dim == 2)
+  {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,
+                       "Poisson geometric multigrid: %D levels available (coarsest grid: %D x %D)\n",
+                       numLevels, M[0], M[1]); CHKERRQ(ierr);
+  }
+  else
+  {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,
+                       "Poisson geometric multigrid: %D levels available (coarsest grid: %D x %D x %D)\n",
+                       numLevels, M[0], M[1], M[2]); CHKERRQ(ierr);
+  }
+
+  PetscFunctionReturn(0);
+} // setMultigridDefaults
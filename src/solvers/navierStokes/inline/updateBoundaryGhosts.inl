@@ -43,6 +43,8 @@ template <>
 PetscErrorCode NavierStokesSolver<2>::updateBoundaryGhosts()
 {
   PetscErrorCode ierr;
+
+  ierr = PetscLogEventBegin(eventUpdateBoundaryGhosts, 0, 0, 0, 0); CHKERRQ(ierr);
   
   PetscInt i, j,           // loop indices
            M, N,           // global number of values in each direction
@@ -60,6 +62,7 @@ PetscErrorCode NavierStokesSolver<2>::updateBoundaryGhosts()
   // left and right boundaries
   if (flow->boundaries[XMINUS][0].type != PERIODIC) // do not update if x-periodic
   {
+#pragma omp parallel for private(beta)
     for (j=nstart; j<nstart+n; j++) // loop over y-direction
     {
       if (mstart == 0) // if left boundary on current process
@@ -107,6 +110,7 @@ PetscErrorCode NavierStokesSolver<2>::updateBoundaryGhosts()
   // bottom and top boundaries
   if (flow->boundaries[YMINUS][0].type != PERIODIC) // do not update if y-periodic
   {
+#pragma omp parallel for private(beta)
     for (i=mstart; i<mstart+m; i++) // loop over x-direction
     { 
       if (nstart == 0) // bottom boundary on current process
@@ -161,6 +165,7 @@ PetscErrorCode NavierStokesSolver<2>::updateBoundaryGhosts()
   // left and right boundaries
   if (flow->boundaries[XMINUS][1].type != PERIODIC) // do not update if x-periodic
   {
+#pragma omp parallel for private(beta)
     for (j=nstart; j<nstart+n; j++) // loop over y-direction
     {
       if (mstart == 0) // left boundary on current process
@@ -208,6 +213,7 @@ PetscErrorCode NavierStokesSolver<2>::updateBoundaryGhosts()
   // bottom and top boundaries
   if (flow->boundaries[YMINUS][1].type != PERIODIC) // do not update if y-periodic
   {
+#pragma omp parallel for private(beta)
     for (i=mstart; i<mstart+m; i++) // loop over x-direction
     { 
       if (nstart == 0) // bottom boundary on current process
@@ -254,6 +260,19 @@ PetscErrorCode NavierStokesSolver<2>::updateBoundaryGhosts()
   }
   ierr = DMDAVecRestoreArray(vda, qyLocal, &qy); CHKERRQ(ierr);
 
+  {
+    // up to 6 operations (convective condition) and 3 values moved per boundary point
+    DM das[2] = {uda, vda};
+    PetscInt numPoints = 0, numComponentPoints;
+    for (PetscInt c=0; c<2; c++)
+    {
+      ierr = countBoundaryPoints(das[c], numComponentPoints); CHKERRQ(ierr);
+      numPoints += numComponentPoints;
+    }
+    ierr = kernelLog.log(eventUpdateBoundaryGhosts, 6.0*numPoints, 3*sizeof(PetscReal)*numPoints); CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(eventUpdateBoundaryGhosts, 0, 0, 0, 0); CHKERRQ(ierr);
+
   return 0;
 } // updateBoundaryGhosts
 
@@ -264,6 +283,8 @@ PetscErrorCode NavierStokesSolver<3>::updateBoundaryGhosts()
 {
   PetscErrorCode ierr;
 
+  ierr = PetscLogEventBegin(eventUpdateBoundaryGhosts, 0, 0, 0, 0); CHKERRQ(ierr);
+
   PetscInt i, j, k,                // loop indices
            M, N, P,                // global number of values in each direction
            m, n, p,                // local number of values in each direction
@@ -281,6 +302,7 @@ PetscErrorCode NavierStokesSolver<3>::updateBoundaryGhosts()
   // left and right boundaries
   if (flow->boundaries[XMINUS][0].type != PERIODIC) // do not update if x-periodic
   {
+#pragma omp parallel for private(j, beta)
     for (k=pstart; k<pstart+p; k++) // loop over z-direction
     {
       for (j=nstart; j<nstart+n; j++) // loop over y-direction
@@ -331,6 +353,7 @@ PetscErrorCode NavierStokesSolver<3>::updateBoundaryGhosts()
   // bottom and top boundaries
   if (flow->boundaries[YMINUS][0].type != PERIODIC) // do not update if y-periodic
   {
+#pragma omp parallel for private(i, beta)
     for (k=pstart; k<pstart+p; k++) // loop over z-direction
     {
       for (i=mstart; i<mstart+m; i++) // loop over x-direction
@@ -381,6 +404,7 @@ PetscErrorCode NavierStokesSolver<3>::updateBoundaryGhosts()
   // back and front boundaries
   if (flow->boundaries[ZMINUS][0].type != PERIODIC) // do not update if z-periodic
   {
+#pragma omp parallel for private(i, beta)
     for (j=nstart; j<nstart+n; j++) // loop over y-direction
     {
       for (i=mstart; i<mstart+m; i++) // loop over x-direction
@@ -438,6 +462,7 @@ PetscErrorCode NavierStokesSolver<3>::updateBoundaryGhosts()
   // left and right boundaries
   if (flow->boundaries[XMINUS][1].type != PERIODIC) // do not update if x-periodic
   {
+#pragma omp parallel for private(j, beta)
     for (k=pstart; k<pstart+p; k++) // loop over z-direction
     {
       for (j=nstart; j<nstart+n; j++) // loop over y-direction
@@ -488,6 +513,7 @@ PetscErrorCode NavierStokesSolver<3>::updateBoundaryGhosts()
   // bottom and top boundaries
   if (flow->boundaries[YMINUS][1].type != PERIODIC) // do not update if y-periodic
   {
+#pragma omp parallel for private(i, beta)
     for (k=pstart; k<pstart+p; k++) // loop over z-direction
     {
       for (i=mstart; i<mstart+m; i++) // loop over x-direction
@@ -538,6 +564,7 @@ PetscErrorCode NavierStokesSolver<3>::updateBoundaryGhosts()
   // back and front boundaries
   if (flow->boundaries[ZMINUS][1].type != PERIODIC) // do not update if z-periodic
   {
+#pragma omp parallel for private(i, beta)
     for (j=nstart; j<nstart+n; j++) // loop over y-direction
     {
       for (i=mstart; i<mstart+m; i++) // loop over x-direction
@@ -595,6 +622,7 @@ PetscErrorCode NavierStokesSolver<3>::updateBoundaryGhosts()
   // left and right boundaries
   if (flow->boundaries[XMINUS][2].type != PERIODIC) // do not update if x-periodic
   {
+#pragma omp parallel for private(j, beta)
     for (k=pstart; k<pstart+p; k++) // loop over z-direction
     {
       for (j=nstart; j<nstart+n; j++) // loop over y-direction
@@ -645,6 +673,7 @@ PetscErrorCode NavierStokesSolver<3>::updateBoundaryGhosts()
   // bottom and top boundaries
   if (flow->boundaries[YMINUS][2].type != PERIODIC) // do not update if y-periodic
   {
+#pragma omp parallel for private(i, beta)
     for (k=pstart; k<pstart+p; k++) // loop over z-direction
     {
       for (i=mstart; i<mstart+m; i++) // loop over x-direction
@@ -695,6 +724,7 @@ PetscErrorCode NavierStokesSolver<3>::updateBoundaryGhosts()
   // back and front boundaries
   if (flow->boundaries[ZMINUS][2].type != PERIODIC) // do not update if z-periodic
   {
+#pragma omp parallel for private(i, beta)
     for (j=nstart; j<nstart+n; j++) // loop over y-direction
     {
       for (i=mstart; i<mstart+m; i++) // loop over x-direction
@@ -744,5 +774,18 @@ PetscErrorCode NavierStokesSolver<3>::updateBoundaryGhosts()
   }
   ierr = DMDAVecRestoreArray(wda, qzLocal, &qz); CHKERRQ(ierr);
 
+  {
+    // up to 6 operations (convective condition) and 3 values moved per boundary point
+    DM das[3] = {uda, vda, wda};
+    PetscInt numPoints = 0, numComponentPoints;
+    for (PetscInt c=0; c<3; c++)
+    {
+      ierr = countBoundaryPoints(das[c], numComponentPoints); CHKERRQ(ierr);
+      numPoints += numComponentPoints;
+    }
+    ierr = kernelLog.log(eventUpdateBoundaryGhosts, 6.0*numPoints, 3*sizeof(PetscReal)*numPoints); CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(eventUpdateBoundaryGhosts, 0, 0, 0, 0); CHKERRQ(ierr);
+
   return 0;
 } // updateBoundaryGhosts
\ No newline at end of file
@@ -31,6 +31,7 @@ TairaColoniusSolver<dim>::TairaColoniusSolver(CartesianMesh *cartesianMesh,
   bda = PETSC_NULL;
   nullSpaceVec = PETSC_NULL;
   PetscLogStageRegister("integrateForces", &stageIntegrateForces);
+  NavierStokesSolver<dim>::kernelLog.registerEvent("calculateForces", &eventCalculateForces);
 } // TairaColoniusSolver
 
 
@@ -44,7 +45,9 @@ PetscErrorCode TairaColoniusSolver<dim>::initialize()
 
   PetscFunctionBeginUser;
 
-  ierr = PetscLogStagePush(NavierStokesSolver<dim>::stageInitialize); CHKERRQ(ierr);
+  // timeline of the stages and events (with -timeline)
+  ierr = NavierStokesSolver<dim>::tracer.initialize(NavierStokesSolver<dim>::parameters->directory); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::tracer.pushStage(NavierStokesSolver<dim>::stageInitialize); CHKERRQ(ierr);
 
   ierr = initializeBodies(); CHKERRQ(ierr);
   ierr = createDMs(); CHKERRQ(ierr);
@@ -52,8 +55,10 @@ PetscErrorCode TairaColoniusSolver<dim>::initialize()
   ierr = createGlobalMappingBodies(); CHKERRQ(ierr);
 
   ierr = NavierStokesSolver<dim>::initializeCommon(); CHKERRQ(ierr);
+  ierr = createTimeSeries(); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::createProbes(); CHKERRQ(ierr);
 
-  ierr = PetscLogStagePop(); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::tracer.popStage(); CHKERRQ(ierr);
 
   PetscFunctionReturn(0);
 } // initialize
@@ -139,6 +144,7 @@ PetscErrorCode TairaColoniusSolver<dim>::registerLagPointsOnProcess()
   for (auto &body : bodies)
   {
     ierr = body.registerPointsOnProcess(box); CHKERRQ(ierr);
+    ierr = body.registerPointsInCells(NavierStokesSolver<dim>::mesh); CHKERRQ(ierr);
   }
 
   PetscFunctionReturn(0);
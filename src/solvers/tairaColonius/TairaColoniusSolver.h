@@ -27,9 +27,10 @@ public:
 
   Vec nullSpaceVec; ///< nullspace object to attach to the matrix QTBNQ
 
-  std::ofstream forcesFile; ///< stream the file containing the forces acting on each immersed boundary
+  PetscInt columnForces; ///< first column of the forces acting on the immersed boundaries in the time series
   
   PetscLogStage stageIntegrateForces;
+  PetscLogEvent eventCalculateForces;
 
   PetscErrorCode initializeBodies();
   PetscErrorCode getNumLagPoints(PetscInt &n);
@@ -46,7 +47,8 @@ public:
   PetscErrorCode readLambda(std::string directory);
   PetscErrorCode writeData();
   PetscErrorCode writeLambda(std::string directory);
-  PetscErrorCode writeForces();
+  PetscErrorCode createTimeSeries();
+  PetscErrorCode recordTimeSeries();
 
 public:
   // constructors
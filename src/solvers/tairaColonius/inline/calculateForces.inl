@@ -15,6 +15,8 @@ PetscErrorCode TairaColoniusSolver<dim>::calculateForces()
 
   PetscFunctionBeginUser;
 
+  ierr = PetscLogEventBegin(eventCalculateForces, 0, 0, 0, 0); CHKERRQ(ierr);
+
   // get access to the global body forces vector
   Vec fGlobal;
   ierr = DMCompositeGetAccess(NavierStokesSolver<dim>::lambdaPack, NavierStokesSolver<dim>::lambda, NULL, &fGlobal); CHKERRQ(ierr);
@@ -45,9 +47,15 @@ PetscErrorCode TairaColoniusSolver<dim>::calculateForces()
     ierr = MPI_Reduce(localForces, body.forces, dim, MPIU_REAL, MPI_SUM, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
     start = end;
   }
+  // one addition per local force component; the local forces are read once
+  // per body and direction
+  ierr = NavierStokesSolver<dim>::kernelLog.log(eventCalculateForces, dim*info.xm,
+                                                bodies.size()*dim*info.xm*sizeof(PetscReal)); CHKERRQ(ierr);
 
   ierr = DMDAVecRestoreArrayDOF(bda, fGlobal, &f); CHKERRQ(ierr);
   ierr = DMCompositeRestoreAccess(NavierStokesSolver<dim>::lambdaPack, NavierStokesSolver<dim>::lambda, NULL, &fGlobal); CHKERRQ(ierr);
 
+  ierr = PetscLogEventEnd(eventCalculateForces, 0, 0, 0, 0); CHKERRQ(ierr);
+
   PetscFunctionReturn(0);
 } // calculateForces
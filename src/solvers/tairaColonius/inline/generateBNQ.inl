@@ -24,12 +24,14 @@ PetscErrorCode TairaColoniusSolver<2>::generateBNQ()
 
   PetscFunctionBeginUser;
 
-  PetscInt i, j, l,        // loop indices
+  PetscInt i, j,           // loop indices
            m, n,           // local number of nodes along each direction
            mstart, nstart; // starting indices
   
   PetscInt localIdx, procIdx;
   PetscInt row, cols[2], BNQ_col, pointIdx;
+  std::vector<PetscInt> neighbors; // body points whose cell is in the support of the delta function
+  PetscInt numDeltas = 0; // number of evaluations of the delta function
   PetscReal values[2] = {-1.0, 1.0}; // gradient coefficients
   
   PetscReal value; // to hold the value of the discrete delta function
@@ -45,10 +47,6 @@ PetscErrorCode TairaColoniusSolver<2>::generateBNQ()
   BoundaryType bTypes[2] = {flow->boundaries[XPLUS][0].type,
                             flow->boundaries[YPLUS][0].type};
   
-  PetscLogEvent  GENERATE_BNQ;
-  ierr = PetscLogEventRegister("generateBNQ", 0, &GENERATE_BNQ); CHKERRQ(ierr);
-  ierr = PetscLogEventBegin(GENERATE_BNQ, 0, 0, 0, 0); CHKERRQ(ierr);
-  
   PetscMPIInt numProcs;
   ierr = MPI_Comm_size(PETSC_COMM_WORLD, &numProcs); CHKERRQ(ierr);
   
@@ -74,9 +72,12 @@ PetscErrorCode TairaColoniusSolver<2>::generateBNQ()
   ierr = DMDAVecGetArray(pda, pMapping, &pMappingArray); CHKERRQ(ierr);
 
   // determine nnz row by row
-  localIdx = 0;
+  PetscInt rowOffset = 0;
   // rows corresponding to fluxes in x-direction
   ierr = DMDAGetCorners(uda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
+  // set by the threads that fail to get the neighboring body points
+  int notFound = 0;
+#pragma omp parallel for private(i, localIdx, hx, hy, target, maxDisp, cols, neighbors, pointIdx, source, disp, BNQ_col) reduction(||:notFound)
   for (j=nstart; j<nstart+n; j++)
   {
     hy = mesh->dy[j];
@@ -84,6 +85,7 @@ PetscErrorCode TairaColoniusSolver<2>::generateBNQ()
     maxDisp[1] = 1.5*hy;
     for (i=mstart; i<mstart+m; i++)
     {
+      localIdx = rowOffset + (j-nstart)*m + (i-mstart);
       hx = mesh->dx[i];
       target[0] = mesh->x[i+1];
       maxDisp[0] = 1.5*hx;
@@ -94,7 +96,9 @@ PetscErrorCode TairaColoniusSolver<2>::generateBNQ()
       // ET portion
       for (auto &body : bodies)
       { 
-        for (l=0; l<body.numPoints; l++)
+        if (!body.findNeighborPoints(mesh, target, maxDisp, bTypes, neighbors))
+          notFound = 1;
+        for (auto l : neighbors)
         {
           pointIdx = body.idxPointsOnProcess[l];
           source[0] = body.X[pointIdx];
@@ -106,11 +110,17 @@ PetscErrorCode TairaColoniusSolver<2>::generateBNQ()
           }
         }
       }
-      localIdx++;
     }
   }
+  rowOffset += m*n;
+  if (notFound)
+  {
+    SETERRQ(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Cannot get the body points near the fluxes");
+  }
   // rows corresponding to fluxes in y-direction
   ierr = DMDAGetCorners(vda, &mstart, &nstart, NULL, &m, &n, NULL); CHKERRQ(ierr);
+  notFound = 0;
+#pragma omp parallel for private(i, localIdx, hx, hy, target, maxDisp, cols, neighbors, pointIdx, source, disp, BNQ_col) reduction(||:notFound)
   for (j=nstart; j<nstart+n; j++)
   {
     hy = mesh->dy[j];
@@ -118,6 +128,7 @@ PetscErrorCode TairaColoniusSolver<2>::generateBNQ()
     maxDisp[1] = 1.5*hy;
     for (i=mstart; i<mstart+m; i++)
     {
+      localIdx = rowOffset + (j-nstart)*m + (i-mstart);
       hx = mesh->dx[i];
       target[0] = 0.5*(mesh->x[i] + mesh->x[i+1]);
       maxDisp[0] = 1.5*hx;
@@ -128,7 +139,9 @@ PetscErrorCode TairaColoniusSolver<2>::generateBNQ()
       // ET portion
       for (auto &body : bodies)
       { 
-        for (l=0; l<body.numPoints; l++)
+        if (!body.findNeighborPoints(mesh, target, maxDisp, bTypes, neighbors))
+          notFound = 1;
+        for (auto l : neighbors)
         {
           pointIdx = body.idxPointsOnProcess[l];
           source[0] = body.X[pointIdx];
@@ -140,9 +153,13 @@ PetscErrorCode TairaColoniusSolver<2>::generateBNQ()
           }
         }
       }
-      localIdx++;
     }
   }
+  rowOffset += m*n;
+  if (notFound)
+  {
+    SETERRQ(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Cannot get the body points near the fluxes");
+  }
   
   // allocate memory for matrices
   // BNQ
@@ -180,7 +197,8 @@ PetscErrorCode TairaColoniusSolver<2>::generateBNQ()
       // ET portion
       for (auto &body : bodies)
       { 
-        for (l=0; l<body.numPoints; l++)
+        ierr = body.getNeighborPoints(mesh, target, maxDisp, bTypes, neighbors); CHKERRQ(ierr);
+        for (auto l : neighbors)
         {
           pointIdx = body.idxPointsOnProcess[l];
           source[0] = body.X[pointIdx];
@@ -189,6 +207,7 @@ PetscErrorCode TairaColoniusSolver<2>::generateBNQ()
           {
             BNQ_col = body.globalIdxPoints[l];
             value = hx*delta(disp[0], disp[1], hx, hy);
+            numDeltas++;
             ierr = MatSetValue(BNQ, row, BNQ_col, value, INSERT_VALUES); CHKERRQ(ierr);
           }
         }
@@ -216,7 +235,8 @@ PetscErrorCode TairaColoniusSolver<2>::generateBNQ()
       // ET portion
       for (auto &body : bodies)
       { 
-        for (l=0; l<body.numPoints; l++)
+        ierr = body.getNeighborPoints(mesh, target, maxDisp, bTypes, neighbors); CHKERRQ(ierr);
+        for (auto l : neighbors)
         {
           pointIdx = body.idxPointsOnProcess[l];
           source[0] = body.X[pointIdx];
@@ -225,6 +245,7 @@ PetscErrorCode TairaColoniusSolver<2>::generateBNQ()
           {
             BNQ_col = body.globalIdxPoints[l] + 1;
             value = hy*delta(disp[0], disp[1], hx, hy);
+            numDeltas++;
             ierr = MatSetValue(BNQ, row, BNQ_col, value, INSERT_VALUES); CHKERRQ(ierr);
           }
         }
@@ -245,7 +266,9 @@ PetscErrorCode TairaColoniusSolver<2>::generateBNQ()
   ierr = MatDiagonalScale(BNQ, BN, NULL); CHKERRQ(ierr);
   ierr = PetscObjectViewFromOptions((PetscObject) BNQ, NULL, "-BNQ_mat_view"); CHKERRQ(ierr);
   
-  ierr = PetscLogEventEnd(GENERATE_BNQ, 0, 0, 0, 0); CHKERRQ(ierr);
+  // evaluations of the delta function (the other operations and the bytes
+  // are logged with the event by `NavierStokesSolver::initializeCommon`)
+  ierr = kernelLog.log(eventGenerateBNQ, numDeltas*(2*dhRomaFlops+2), 0.0); CHKERRQ(ierr);
 
   PetscFunctionReturn(0);
 } // generateBNQ
@@ -257,12 +280,14 @@ PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
 {
   PetscErrorCode ierr;
 
-  PetscInt i, j, k, l,             // loop indices
+  PetscInt i, j, k,                // loop indices
            m, n, p,                // local number of nodes along each direction
            mstart, nstart, pstart; // starting indices
 
   PetscInt localIdx, procIdx;
   PetscInt row, cols[2], BNQ_col, pointIdx;
+  std::vector<PetscInt> neighbors; // body points whose cell is in the support of the delta function
+  PetscInt numDeltas = 0; // number of evaluations of the delta function
   PetscReal values[2] = {-1.0, 1.0}, value;
   
   PetscReal source[3], target[3];
@@ -276,10 +301,6 @@ PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
                             flow->boundaries[YPLUS][0].type,
                             flow->boundaries[ZPLUS][0].type};
   
-  PetscLogEvent  GENERATE_BNQ;
-  ierr = PetscLogEventRegister("generateBNQ", 0, &GENERATE_BNQ); CHKERRQ(ierr);
-  ierr = PetscLogEventBegin(GENERATE_BNQ, 0, 0, 0, 0); CHKERRQ(ierr);
-  
   PetscMPIInt numProcs;
   ierr = MPI_Comm_size(PETSC_COMM_WORLD, &numProcs); CHKERRQ(ierr);
   
@@ -305,9 +326,12 @@ PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
   ierr = DMDAVecGetArray(pda, pMapping, &pMappingArray); CHKERRQ(ierr);
 
   // determine nnz row by row
-  localIdx = 0;
+  PetscInt rowOffset = 0;
   // rows corresponding to fluxes in x-direction
   ierr = DMDAGetCorners(uda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
+  // set by the threads that fail to get the neighboring body points
+  int notFound = 0;
+#pragma omp parallel for private(i, j, localIdx, hx, hy, hz, target, maxDisp, cols, neighbors, pointIdx, source, disp, BNQ_col) reduction(||:notFound)
   for (k=pstart; k<pstart+p; k++)
   {
     hz = mesh->dz[k];
@@ -320,6 +344,7 @@ PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
       maxDisp[1] = 1.5*hy;
       for (i=mstart; i<mstart+m; i++)
       {
+        localIdx = rowOffset + ((k-pstart)*n + (j-nstart))*m + (i-mstart);
         hx = mesh->dx[i];
         target[0] = mesh->x[i+1];
         maxDisp[0] = 1.5*hx;
@@ -330,7 +355,9 @@ PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
         // ET portion
         for (auto &body : bodies)
         { 
-          for (l=0; l<body.numPoints; l++)
+          if (!body.findNeighborPoints(mesh, target, maxDisp, bTypes, neighbors))
+            notFound = 1;
+          for (auto l : neighbors)
           {
             pointIdx = body.idxPointsOnProcess[l];
             source[0] = body.X[pointIdx];
@@ -343,12 +370,18 @@ PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
             }
           }
         }
-        localIdx++;
       }
     }
   }
+  rowOffset += m*n*p;
+  if (notFound)
+  {
+    SETERRQ(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Cannot get the body points near the fluxes");
+  }
   // rows corresponding to fluxes in y-direction
   ierr = DMDAGetCorners(vda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
+  notFound = 0;
+#pragma omp parallel for private(i, j, localIdx, hx, hy, hz, target, maxDisp, cols, neighbors, pointIdx, source, disp, BNQ_col) reduction(||:notFound)
   for (k=pstart; k<pstart+p; k++)
   {
     hz = mesh->dz[k];
@@ -361,6 +394,7 @@ PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
       maxDisp[1] = 1.5*hy;
       for (i=mstart; i<mstart+m; i++)
       {
+        localIdx = rowOffset + ((k-pstart)*n + (j-nstart))*m + (i-mstart);
         hx = mesh->dx[i];
         target[0] = 0.5*(mesh->x[i] + mesh->x[i+1]);
         maxDisp[0] = 1.5*hx;
@@ -371,7 +405,9 @@ PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
         // ET portion
         for (auto &body : bodies)
         { 
-          for (l=0; l<body.numPoints; l++)
+          if (!body.findNeighborPoints(mesh, target, maxDisp, bTypes, neighbors))
+            notFound = 1;
+          for (auto l : neighbors)
           {
             pointIdx = body.idxPointsOnProcess[l];
             source[0] = body.X[pointIdx];
@@ -384,12 +420,18 @@ PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
             }
           }
         }
-        localIdx++;
       }
     }
   }
+  rowOffset += m*n*p;
+  if (notFound)
+  {
+    SETERRQ(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Cannot get the body points near the fluxes");
+  }
   // rows corresponding to fluxes in z-direction
   ierr = DMDAGetCorners(wda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
+  notFound = 0;
+#pragma omp parallel for private(i, j, localIdx, hx, hy, hz, target, maxDisp, cols, neighbors, pointIdx, source, disp, BNQ_col) reduction(||:notFound)
   for (k=pstart; k<pstart+p; k++)
   {
     hz = mesh->dz[k];
@@ -402,6 +444,7 @@ PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
       maxDisp[1] = 1.5*hy;
       for (i=mstart; i<mstart+m; i++)
       {
+        localIdx = rowOffset + ((k-pstart)*n + (j-nstart))*m + (i-mstart);
         hx = mesh->dx[i];
         target[0] = 0.5*(mesh->x[i] + mesh->x[i+1]);
         maxDisp[0] = 1.5*hx;
@@ -412,7 +455,9 @@ PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
         // ET portion
         for (auto &body : bodies)
         { 
-          for (l=0; l<body.numPoints; l++)
+          if (!body.findNeighborPoints(mesh, target, maxDisp, bTypes, neighbors))
+            notFound = 1;
+          for (auto l : neighbors)
           {
             pointIdx = body.idxPointsOnProcess[l];
             source[0] = body.X[pointIdx];
@@ -425,10 +470,14 @@ PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
             }
           }
         }
-        localIdx++;
       }
     }
   }
+  rowOffset += m*n*p;
+  if (notFound)
+  {
+    SETERRQ(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Cannot get the body points near the fluxes");
+  }
   
   // allocate memory for matrices
   // BNQ
@@ -471,7 +520,8 @@ PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
         // ET portion
         for (auto &body : bodies)
         { 
-          for (l=0; l<body.numPoints; l++)
+          ierr = body.getNeighborPoints(mesh, target, maxDisp, bTypes, neighbors); CHKERRQ(ierr);
+          for (auto l : neighbors)
           {
             pointIdx = body.idxPointsOnProcess[l];
             source[0] = body.X[pointIdx];
@@ -481,6 +531,7 @@ PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
             {
               BNQ_col = body.globalIdxPoints[l];
               value= hx*delta(disp[0], disp[1], disp[2], hx, hy, hz);
+              numDeltas++;
               ierr = MatSetValue(BNQ, row, BNQ_col, value, INSERT_VALUES); CHKERRQ(ierr);
             }
           }
@@ -514,7 +565,8 @@ PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
         // ET portion
         for (auto &body : bodies)
         { 
-          for (l=0; l<body.numPoints; l++)
+          ierr = body.getNeighborPoints(mesh, target, maxDisp, bTypes, neighbors); CHKERRQ(ierr);
+          for (auto l : neighbors)
           {
             pointIdx = body.idxPointsOnProcess[l];
             source[0] = body.X[pointIdx];
@@ -524,6 +576,7 @@ PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
             {
               BNQ_col = body.globalIdxPoints[l] + 1;
               value= hy*delta(disp[0], disp[1], disp[2], hx, hy, hz);
+              numDeltas++;
               ierr = MatSetValue(BNQ, row, BNQ_col, value, INSERT_VALUES); CHKERRQ(ierr);
             }
           }
@@ -557,7 +610,8 @@ PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
         // ET portion
         for (auto &body : bodies)
         { 
-          for (l=0; l<body.numPoints; l++)
+          ierr = body.getNeighborPoints(mesh, target, maxDisp, bTypes, neighbors); CHKERRQ(ierr);
+          for (auto l : neighbors)
           {
             pointIdx = body.idxPointsOnProcess[l];
             source[0] = body.X[pointIdx];
@@ -567,6 +621,7 @@ PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
             {
               BNQ_col = body.globalIdxPoints[l] + 2;
               value= hz*delta(disp[0], disp[1], disp[2], hx, hy, hz);
+              numDeltas++;
               ierr = MatSetValue(BNQ, row, BNQ_col, value, INSERT_VALUES); CHKERRQ(ierr);
             }
           }
@@ -588,7 +643,9 @@ PetscErrorCode TairaColoniusSolver<3>::generateBNQ()
   ierr = MatDiagonalScale(BNQ, BN, NULL); CHKERRQ(ierr);
   ierr = PetscObjectViewFromOptions((PetscObject) BNQ, NULL, "-BNQ_mat_view"); CHKERRQ(ierr);
 
-  ierr = PetscLogEventEnd(GENERATE_BNQ, 0, 0, 0, 0); CHKERRQ(ierr);
+  // evaluations of the delta function (the other operations and the bytes
+  // are logged with the event by `NavierStokesSolver::initializeCommon`)
+  ierr = kernelLog.log(eventGenerateBNQ, numDeltas*(3*dhRomaFlops+3), 0.0); CHKERRQ(ierr);
 
   return 0;
 } // generateBNQ
@@ -15,46 +15,17 @@ PetscErrorCode TairaColoniusSolver<dim>::readLambda(std::string directory)
 {
   PetscErrorCode ierr;
   Vec phi, fTilde;
-  PetscViewer viewer;
-  PetscViewerType viewerType;
-  std::string filePath, fileExtension;
 
   PetscFunctionBeginUser;
 
-  // define the type of viewer and the file extension
-  if (NavierStokesSolver<dim>::parameters->outputFormat == "hdf5")
-  {
-    viewerType = PETSCVIEWERHDF5;
-    fileExtension = "h5";
-  }
-  else if (NavierStokesSolver<dim>::parameters->outputFormat == "binary")
-  {
-    viewerType = PETSCVIEWERBINARY;
-    fileExtension = "dat";
-  }
-  
   ierr = DMCompositeGetAccess(NavierStokesSolver<dim>::lambdaPack, NavierStokesSolver<dim>::lambda, &phi, &fTilde); CHKERRQ(ierr);
 
   // read pressure field
-  filePath = directory + "/phi." + fileExtension;
-  ierr = PetscObjectSetName((PetscObject) phi, "phi"); CHKERRQ(ierr);
-  ierr = PetscViewerCreate(PETSC_COMM_WORLD, &viewer); CHKERRQ(ierr); 
-  ierr = PetscViewerSetType(viewer, viewerType); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetMode(viewer, FILE_MODE_READ); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetName(viewer, filePath.c_str()); CHKERRQ(ierr);
-  ierr = VecLoad(phi, viewer); CHKERRQ(ierr);
-  ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::loadField(phi, "phi", directory); CHKERRQ(ierr);
   // read body forces if restarting the simulation
   if (NavierStokesSolver<dim>::timeStep > 0)
   {
-    filePath = directory + "/fTilde." + fileExtension;
-    ierr = PetscObjectSetName((PetscObject) fTilde, "fTilde"); CHKERRQ(ierr);
-    ierr = PetscViewerCreate(PETSC_COMM_WORLD, &viewer); CHKERRQ(ierr); 
-    ierr = PetscViewerSetType(viewer, viewerType); CHKERRQ(ierr);
-    ierr = PetscViewerFileSetMode(viewer, FILE_MODE_READ); CHKERRQ(ierr);
-    ierr = PetscViewerFileSetName(viewer, filePath.c_str()); CHKERRQ(ierr);
-    ierr = VecLoad(fTilde, viewer); CHKERRQ(ierr);
-    ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+    ierr = NavierStokesSolver<dim>::loadField(fTilde, "fTilde", directory); CHKERRQ(ierr);
   }
 
   ierr = DMCompositeRestoreAccess(NavierStokesSolver<dim>::lambdaPack, NavierStokesSolver<dim>::lambda, &phi, &fTilde); CHKERRQ(ierr);
@@ -73,13 +44,10 @@ PetscErrorCode TairaColoniusSolver<dim>::writeData()
 
   PetscFunctionBeginUser;
 
-  ierr = PetscLogStagePush(stageIntegrateForces); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::tracer.pushStage(stageIntegrateForces); CHKERRQ(ierr);
   ierr = calculateForces(); CHKERRQ(ierr);
-  ierr = PetscLogStagePop(); CHKERRQ(ierr);
-  ierr = PetscLogStagePush(NavierStokesSolver<dim>::stageWriteData); CHKERRQ(ierr);
-  ierr = writeForces(); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::tracer.popStage(); CHKERRQ(ierr);
   ierr = NavierStokesSolver<dim>::writeData(); CHKERRQ(ierr);
-  ierr = PetscLogStagePop(); CHKERRQ(ierr);
 
   PetscFunctionReturn(0);
 } // writeData
@@ -95,43 +63,15 @@ PetscErrorCode TairaColoniusSolver<dim>::writeLambda(std::string directory)
 {
   PetscErrorCode ierr;
   Vec phi, fTilde;
-  PetscViewer viewer;
-  PetscViewerType viewerType;
-  std::string filePath, fileExtension;
 
   PetscFunctionBeginUser;
 
-  if (NavierStokesSolver<dim>::parameters->outputFormat == "hdf5")
-  {
-    viewerType = PETSCVIEWERHDF5;
-    fileExtension = "h5";
-  }
-  else if (NavierStokesSolver<dim>::parameters->outputFormat == "binary")
-  {
-    viewerType = PETSCVIEWERBINARY;
-    fileExtension = "dat";
-  }
-
   ierr = DMCompositeGetAccess(NavierStokesSolver<dim>::lambdaPack, NavierStokesSolver<dim>::lambda, &phi, &fTilde); CHKERRQ(ierr);
 
   // write pressure field
-  filePath = directory + "/phi." + fileExtension;
-  ierr = PetscObjectSetName((PetscObject) phi, "phi"); CHKERRQ(ierr);
-  ierr = PetscViewerCreate(PETSC_COMM_WORLD, &viewer); CHKERRQ(ierr); 
-  ierr = PetscViewerSetType(viewer, viewerType); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetMode(viewer, FILE_MODE_WRITE); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetName(viewer, filePath.c_str()); CHKERRQ(ierr);
-  ierr = VecView(phi, viewer); CHKERRQ(ierr);
-  ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::viewField(phi, "phi", directory); CHKERRQ(ierr);
   // write body forces
-  filePath = directory + "/fTilde." + fileExtension;
-  ierr = PetscObjectSetName((PetscObject) fTilde, "fTilde"); CHKERRQ(ierr);
-  ierr = PetscViewerCreate(PETSC_COMM_WORLD, &viewer); CHKERRQ(ierr); 
-  ierr = PetscViewerSetType(viewer, viewerType); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetMode(viewer, FILE_MODE_WRITE); CHKERRQ(ierr);
-  ierr = PetscViewerFileSetName(viewer, filePath.c_str()); CHKERRQ(ierr);
-  ierr = VecView(fTilde, viewer); CHKERRQ(ierr);
-  ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
+  ierr = NavierStokesSolver<dim>::viewField(fTilde, "fTilde", directory); CHKERRQ(ierr);
 
   ierr = DMCompositeRestoreAccess(NavierStokesSolver<dim>::lambdaPack, NavierStokesSolver<dim>::lambda, &phi, &fTilde); CHKERRQ(ierr);
 
@@ -140,40 +80,52 @@ PetscErrorCode TairaColoniusSolver<dim>::writeLambda(std::string directory)
 
 
 /*!
- * \brief Writes force in each direction acting on the body.
+ * \brief Adds the columns of the time series specific to the immersed
+ *        boundaries: the wall-time of the stage `integrateForces` and the
+ *        force in each direction acting on each body.
  */
 template <PetscInt dim>
-PetscErrorCode TairaColoniusSolver<dim>::writeForces()
+PetscErrorCode TairaColoniusSolver<dim>::createTimeSeries()
 {
   PetscErrorCode ierr;
 
   PetscFunctionBeginUser;
 
-  PetscMPIInt rank;
-  ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
-
-  if (rank == 0)
+  ierr = NavierStokesSolver<dim>::createTimeSeries(); CHKERRQ(ierr);
+  TimeSeries &timeSeries = NavierStokesSolver<dim>::timeSeries;
+  ierr = timeSeries.addStage("integrateForces", stageIntegrateForces); CHKERRQ(ierr);
+  const char *directions[3] = {"x", "y", "z"};
+  for (PetscInt bIdx=0; bIdx<numBodies; bIdx++)
   {
-    std::string filePath = NavierStokesSolver<dim>::parameters->directory + "/forces.txt";
-    if (NavierStokesSolver<dim>::timeStep == 1)
-    {
-      forcesFile.open(filePath.c_str());
-    }
-    else
+    for (PetscInt d=0; d<dim; d++)
     {
-      forcesFile.open(filePath.c_str(), std::ios::out | std::ios::app);
+      std::stringstream ss;
+      ss << "body" << bIdx << "_f" << directions[d];
+      PetscInt column = timeSeries.addColumn(ss.str());
+      if (bIdx == 0 && d == 0)
+        columnForces = column;
     }
-    forcesFile << NavierStokesSolver<dim>::timeStep*NavierStokesSolver<dim>::parameters->dt;
-    for (PetscInt bIdx=0; bIdx<numBodies; bIdx++)
+  }
+
+  PetscFunctionReturn(0);
+} // createTimeSeries
+
+
+/*!
+ * \brief Sets the force in each direction acting on each body.
+ */
+template <PetscInt dim>
+PetscErrorCode TairaColoniusSolver<dim>::recordTimeSeries()
+{
+  PetscFunctionBeginUser;
+
+  for (PetscInt bIdx=0; bIdx<numBodies; bIdx++)
+  {
+    for (PetscInt d=0; d<dim; d++)
     {
-      for (PetscInt d=0; d<dim; d++)
-      {
-        forcesFile << '\t' << bodies[bIdx].forces[d];
-      }
+      NavierStokesSolver<dim>::timeSeries.set(columnForces + bIdx*dim + d, bodies[bIdx].forces[d]);
     }
-    forcesFile << std::endl;
-    forcesFile.close();
   }
 
   PetscFunctionReturn(0);
-} // writeForces
+} // recordTimeSeries
@@ -0,0 +1,666 @@
+/*! Implementation of the methods of the class `AsyncWriter`.
+ * \file AsyncWriter.cpp
+ */
+
+
+#include "AsyncWriter.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <petscdmda.h>
+
+
+// tags of the messages between the compute processes and the output servers
+static const int tagSnapshot = 4201,
+                 tagDone = 4202,
+                 tagAcknowledge = 4203;
+
+
+/*!
+ * \brief Appends an integer to a message.
+ */
+static void appendInteger(std::vector<char> &message, int64_t value)
+{
+  const char *bytes = reinterpret_cast<const char*>(&value);
+  message.insert(message.end(), bytes, bytes+sizeof(value));
+} // appendInteger
+
+
+/*!
+ * \brief Reads an integer from a message and moves past it.
+ */
+static int64_t extractInteger(const char *&position)
+{
+  int64_t value;
+  memcpy(&value, position, sizeof(value));
+  position += sizeof(value);
+  return value;
+} // extractInteger
+
+
+/*!
+ * \brief Constructor -- the thread starts at `initialize`.
+ */
+AsyncWriter::AsyncWriter()
+{
+  active = PETSC_FALSE;
+  current = -1;
+  stop = PETSC_FALSE;
+  rank = 0;
+  server = -1;
+  numCommitted = 0;
+  eventWait = 0;
+} // AsyncWriter
+
+
+/*!
+ * \brief Destructor -- writes the snapshots handed to the thread and stops it
+ *        (a snapshot being staged is discarded).
+ */
+AsyncWriter::~AsyncWriter()
+{
+  if (writer.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop = PETSC_TRUE;
+    }
+    queued.notify_one();
+    writer.join();
+  }
+} // ~AsyncWriter
+
+
+/*!
+ * \brief Sets aside the last processes of `MPI_COMM_WORLD` as output servers
+ *        (option `-io_servers <n>`) and restricts `PETSC_COMM_WORLD` to the
+ *        other processes.
+ *
+ * Must be called after `MPI_Init` and before `PetscInitialize`; the options
+ * are read from the command-line.
+ *
+ * \param argc Number of arguments of the command-line
+ * \param argv Arguments of the command-line
+ * \param numServers Number of output servers (0 if none)
+ * \param isServer Is the process an output server?
+ */
+int AsyncWriter::splitServers(int argc, char **argv, PetscMPIInt &numServers, PetscBool &isServer)
+{
+  int ierr;
+
+  numServers = 0;
+  isServer = PETSC_FALSE;
+  for (int i=1; i<argc-1; i++)
+  {
+    if (strcmp(argv[i], "-io_servers") == 0)
+      numServers = atoi(argv[i+1]);
+  }
+  if (numServers <= 0)
+  {
+    numServers = 0;
+    return 0;
+  }
+
+  int worldRank, worldSize;
+  ierr = MPI_Comm_rank(MPI_COMM_WORLD, &worldRank); if (ierr) return ierr;
+  ierr = MPI_Comm_size(MPI_COMM_WORLD, &worldSize); if (ierr) return ierr;
+  if (numServers >= worldSize)
+  {
+    if (worldRank == 0)
+      fprintf(stderr, "\nERROR: -io_servers %d leaves no compute process (%d processes)\n",
+              numServers, worldSize);
+    return 1;
+  }
+  isServer = (worldRank >= worldSize-numServers) ? PETSC_TRUE : PETSC_FALSE;
+  MPI_Comm comm;
+  ierr = MPI_Comm_split(MPI_COMM_WORLD, (isServer) ? 1 : 0, worldRank, &comm); if (ierr) return ierr;
+  if (isServer)
+  {
+    ierr = MPI_Comm_free(&comm); if (ierr) return ierr;
+  }
+  else
+    PETSC_COMM_WORLD = comm;
+
+  return 0;
+} // splitServers
+
+
+/*!
+ * \brief Are there output servers (processes of `MPI_COMM_WORLD` outside of
+ *        `PETSC_COMM_WORLD`)?
+ */
+PetscBool AsyncWriter::hasServers()
+{
+  PetscMPIInt worldSize, size;
+  MPI_Comm_size(MPI_COMM_WORLD, &worldSize);
+  MPI_Comm_size(PETSC_COMM_WORLD, &size);
+  return (worldSize > size) ? PETSC_TRUE : PETSC_FALSE;
+} // hasServers
+
+
+/*!
+ * \brief Allocates the buffers and starts the writing thread or, with output
+ *        servers, connects the process to its server (the writer is then
+ *        always active).
+ *
+ * \param useThread Write the vectors from a background thread?
+ * \param numBuffers Number of snapshots staged or being written at the same time
+ */
+PetscErrorCode AsyncWriter::initialize(PetscBool useThread, PetscInt numBuffers)
+{
+  PetscErrorCode ierr;
+
+  PetscBool servers = hasServers();
+  if (!useThread && !servers)
+    return 0;
+  if (numBuffers < 1)
+  {
+    SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_ARG_OUTOFRANGE, "The asynchronous output needs at least one buffer");
+  }
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("asyncOutputWait", 0, &eventWait); CHKERRQ(ierr);
+
+  buffers.resize(numBuffers);
+  states.assign(numBuffers, FREE);
+  numFiles.assign(numBuffers, 0);
+  if (servers)
+  {
+    // the compute processes are the first ones of MPI_COMM_WORLD
+    PetscMPIInt worldSize, size;
+    ierr = MPI_Comm_size(MPI_COMM_WORLD, &worldSize); CHKERRQ(ierr);
+    ierr = MPI_Comm_size(PETSC_COMM_WORLD, &size); CHKERRQ(ierr);
+    server = size + (PetscMPIInt) (((PetscInt64) rank*(worldSize-size))/size);
+    messages.resize(numBuffers);
+    requests.assign(numBuffers, MPI_REQUEST_NULL);
+  }
+  else
+    writer = std::thread(&AsyncWriter::run, this);
+  active = PETSC_TRUE;
+
+  return 0;
+} // initialize
+
+
+/*!
+ * \brief Waits for a free buffer (back-pressure when the thread or the server
+ *        falls behind) and makes it the current snapshot.
+ */
+PetscErrorCode AsyncWriter::acquireBuffer()
+{
+  PetscErrorCode ierr;
+
+  ierr = PetscLogEventBegin(eventWait, 0, 0, 0, 0); CHKERRQ(ierr);
+  if (server >= 0)
+  {
+    // the buffers are sent in turn
+    current = numCommitted%buffers.size();
+    ierr = MPI_Wait(&requests[current], MPI_STATUS_IGNORE); CHKERRQ(ierr);
+  }
+  else
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    size_t b = 0;
+    written.wait(lock, [&]
+    {
+      for (b=0; b<states.size(); b++)
+        if (states[b] == FREE)
+          return true;
+      return false;
+    });
+    states[b] = STAGING;
+    current = b;
+  }
+  ierr = PetscLogEventEnd(eventWait, 0, 0, 0, 0); CHKERRQ(ierr);
+  numFiles[current] = 0;
+
+  return 0;
+} // acquireBuffer
+
+
+/*!
+ * \brief Copies the part of a vector owned by the process into the current
+ *        snapshot (started if needed), with the layout of the PETSc binary file.
+ *
+ * The file holds a header (class id and global size) and the values in the
+ * natural ordering of the DMDA of the vector (in the global ordering for a
+ * vector without DMDA), big-endian. Collective.
+ *
+ * \param v The vector
+ * \param filePath Path of the file to write
+ */
+PetscErrorCode AsyncWriter::stage(Vec v, std::string filePath)
+{
+  PetscErrorCode ierr;
+
+  if (!active)
+  {
+    SETERRQ(PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "The asynchronous output is not active");
+  }
+  ierr = checkError(); CHKERRQ(ierr);
+  if (current < 0)
+  {
+    ierr = acquireBuffer(); CHKERRQ(ierr);
+  }
+  std::vector<StagedFile> &snapshot = buffers[current];
+  if (numFiles[current] == snapshot.size())
+    snapshot.resize(numFiles[current]+1);
+  StagedFile &file = snapshot[numFiles[current]++];
+  file.path = filePath;
+  file.length = 0;
+  file.offsets.clear();
+  file.sizes.clear();
+
+  PetscInt size, localSize;
+  ierr = VecGetSize(v, &size); CHKERRQ(ierr);
+  ierr = VecGetLocalSize(v, &localSize); CHKERRQ(ierr);
+  off_t headerSize = 2*sizeof(PetscInt);
+  file.bytes.resize(((rank == 0) ? headerSize : 0) + localSize*sizeof(PetscScalar));
+  char *bytes = &file.bytes[0];
+
+  if (rank == 0)
+  {
+    PetscInt header[2] = {VEC_FILE_CLASSID, size};
+#if !defined(PETSC_WORDS_BIGENDIAN)
+    ierr = PetscByteSwap(header, PETSC_INT, 2); CHKERRQ(ierr);
+#endif
+    memcpy(bytes, header, headerSize);
+    // the process of rank 0 cuts what remains of an older, longer file
+    file.length = headerSize + size*sizeof(PetscScalar);
+    file.offsets.push_back(0);
+    file.sizes.push_back(headerSize);
+    bytes += headerSize;
+  }
+
+  const PetscScalar *array;
+  ierr = VecGetArrayRead(v, &array); CHKERRQ(ierr);
+  memcpy(bytes, array, localSize*sizeof(PetscScalar));
+  ierr = VecRestoreArrayRead(v, &array); CHKERRQ(ierr);
+#if !defined(PETSC_WORDS_BIGENDIAN)
+  ierr = PetscByteSwap(bytes, PETSC_SCALAR, localSize); CHKERRQ(ierr);
+#endif
+
+  DM da;
+  PetscBool isDA = PETSC_FALSE;
+  ierr = VecGetDM(v, &da); CHKERRQ(ierr);
+  if (da)
+  {
+    ierr = PetscObjectTypeCompare((PetscObject) da, DMDA, &isDA); CHKERRQ(ierr);
+  }
+  if (isDA)
+  {
+    // one segment per row of the sub-domain along x
+    PetscInt M, N, dof, xs, ys, zs, m, n, p;
+    ierr = DMDAGetInfo(da, NULL, &M, &N, NULL, NULL, NULL, NULL, &dof,
+                       NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
+    ierr = DMDAGetCorners(da, &xs, &ys, &zs, &m, &n, &p); CHKERRQ(ierr);
+    for (PetscInt k=zs; k<zs+p; k++)
+    {
+      for (PetscInt j=ys; j<ys+n; j++)
+      {
+        file.offsets.push_back(headerSize + (((k*N + j)*M + xs)*dof)*sizeof(PetscScalar));
+        file.sizes.push_back(m*dof*sizeof(PetscScalar));
+      }
+    }
+  }
+  else
+  {
+    PetscInt start;
+    ierr = VecGetOwnershipRange(v, &start, NULL); CHKERRQ(ierr);
+    file.offsets.push_back(headerSize + start*sizeof(PetscScalar));
+    file.sizes.push_back(localSize*sizeof(PetscScalar));
+  }
+
+  return 0;
+} // stage
+
+
+/*!
+ * \brief Hands the current snapshot to the writing thread or sends it to the
+ *        output server (non-blocking).
+ */
+PetscErrorCode AsyncWriter::commit()
+{
+  PetscErrorCode ierr;
+
+  ierr = checkError(); CHKERRQ(ierr);
+  if (current < 0)
+    return 0;
+  if (server >= 0)
+  {
+    std::vector<char> &message = messages[current];
+    message.clear();
+    appendInteger(message, numFiles[current]);
+    for (size_t f=0; f<numFiles[current]; f++)
+      pack(buffers[current][f], message);
+    if (message.size() > INT_MAX)
+    {
+      SETERRQ(PETSC_COMM_SELF, PETSC_ERR_SUP, "The snapshot of the process is too large to be sent to the output server (2 GB)");
+    }
+    ierr = MPI_Isend(&message[0], (int) message.size(), MPI_BYTE, server, tagSnapshot,
+                     MPI_COMM_WORLD, &requests[current]); CHKERRQ(ierr);
+    numCommitted++;
+    current = -1;
+    return 0;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    states[current] = QUEUED;
+    queue.push_back(current);
+  }
+  queued.notify_one();
+  current = -1;
+
+  return 0;
+} // commit
+
+
+/*!
+ * \brief Waits until the snapshots handed to the thread are written
+ *        (a snapshot being staged is committed first). Collective.
+ *
+ * With output servers, the writer is closed: the server acknowledges once
+ * it has written the snapshots of all its compute processes.
+ */
+PetscErrorCode AsyncWriter::flush()
+{
+  PetscErrorCode ierr;
+
+  if (!active)
+    return 0;
+  ierr = commit(); CHKERRQ(ierr);
+  if (server >= 0)
+  {
+    ierr = MPI_Waitall(requests.size(), &requests[0], MPI_STATUSES_IGNORE); CHKERRQ(ierr);
+    ierr = MPI_Send(NULL, 0, MPI_BYTE, server, tagDone, MPI_COMM_WORLD); CHKERRQ(ierr);
+    MPI_Status status;
+    int length;
+    ierr = MPI_Probe(server, tagAcknowledge, MPI_COMM_WORLD, &status); CHKERRQ(ierr);
+    ierr = MPI_Get_count(&status, MPI_CHAR, &length); CHKERRQ(ierr);
+    std::vector<char> message(length+1, '\0');
+    ierr = MPI_Recv(&message[0], length, MPI_CHAR, server, tagAcknowledge,
+                    MPI_COMM_WORLD, MPI_STATUS_IGNORE); CHKERRQ(ierr);
+    active = PETSC_FALSE;
+    if (length > 0)
+    {
+      SETERRQ2(PETSC_COMM_SELF, PETSC_ERR_FILE_WRITE, "Output server %d: %s", server, &message[0]);
+    }
+  }
+  else
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    written.wait(lock, [&]
+    {
+      for (size_t b=0; b<states.size(); b++)
+        if (states[b] != FREE)
+          return false;
+      return true;
+    });
+  }
+  ierr = checkError(); CHKERRQ(ierr);
+  // the files of all processes are complete
+  ierr = MPI_Barrier(PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+  return 0;
+} // flush
+
+
+/*!
+ * \brief Reports the first error of the writing thread.
+ */
+PetscErrorCode AsyncWriter::checkError()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!error.empty())
+  {
+    SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_FILE_WRITE, "Asynchronous output: %s", error.c_str());
+  }
+
+  return 0;
+} // checkError
+
+
+/*!
+ * \brief Loop of the writing thread: writes the queued snapshots, oldest
+ *        first, and frees their buffers.
+ */
+void AsyncWriter::run()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true)
+  {
+    queued.wait(lock, [&]{ return stop || !queue.empty(); });
+    if (queue.empty())
+      break;
+    PetscInt b = queue.front();
+    lock.unlock();
+    std::string message = writeSnapshot(b);
+    lock.lock();
+    if (!message.empty() && error.empty())
+      error = message;
+    queue.pop_front();
+    states[b] = FREE;
+    written.notify_all();
+  }
+} // run
+
+
+/*!
+ * \brief Writes the files of a snapshot.
+ *
+ * \return An error message (empty on success)
+ */
+std::string AsyncWriter::writeSnapshot(PetscInt b)
+{
+  for (size_t f=0; f<numFiles[b]; f++)
+  {
+    std::string message = writeFile(buffers[b][f]);
+    if (!message.empty())
+      return message;
+  }
+
+  return "";
+} // writeSnapshot
+
+
+/*!
+ * \brief Writes the segments of a file, in the order of their offsets, with
+ *        the segments that follow each other merged into one write.
+ *
+ * \return An error message (empty on success)
+ */
+std::string AsyncWriter::writeFile(const StagedFile &file)
+{
+  size_t numSegments = file.offsets.size();
+  std::vector<size_t> positions(numSegments), order(numSegments);
+  for (size_t s=0, position=0; s<numSegments; position+=file.sizes[s], s++)
+  {
+    positions[s] = position;
+    order[s] = s;
+  }
+  std::sort(order.begin(), order.end(),
+            [&](size_t a, size_t b){ return file.offsets[a] < file.offsets[b]; });
+
+  int fd = open(file.path.c_str(), O_WRONLY | O_CREAT, 0644);
+  if (fd < 0)
+    return "cannot open " + file.path + " (" + strerror(errno) + ")";
+  std::vector<char> run;
+  for (size_t first=0, last; first<numSegments; first=last)
+  {
+    off_t offset = file.offsets[order[first]],
+          end = offset + file.sizes[order[first]];
+    for (last=first+1; last<numSegments && file.offsets[order[last]] == end; last++)
+      end += file.sizes[order[last]];
+    const char *bytes = &file.bytes[positions[order[first]]];
+    if (last > first+1)
+    {
+      run.resize(end - offset);
+      for (size_t s=first, position=0; s<last; position+=file.sizes[order[s]], s++)
+        memcpy(&run[position], &file.bytes[positions[order[s]]], file.sizes[order[s]]);
+      bytes = &run[0];
+    }
+    size_t size = end - offset, done = 0;
+    while (done < size)
+    {
+      ssize_t count = pwrite(fd, bytes + done, size - done, offset + done);
+      if (count < 0)
+      {
+        std::string message = "cannot write " + file.path + " (" + strerror(errno) + ")";
+        close(fd);
+        return message;
+      }
+      done += count;
+    }
+  }
+  if (file.length > 0 && ftruncate(fd, file.length) != 0)
+  {
+    std::string message = "cannot truncate " + file.path + " (" + strerror(errno) + ")";
+    close(fd);
+    return message;
+  }
+  if (close(fd) != 0)
+    return "cannot close " + file.path + " (" + strerror(errno) + ")";
+
+  return "";
+} // writeFile
+
+
+/*!
+ * \brief Appends a file to a message: length of the path, path, length of the
+ *        file, number of segments, offsets, sizes and segments.
+ */
+void AsyncWriter::pack(const StagedFile &file, std::vector<char> &message)
+{
+  appendInteger(message, file.path.size());
+  message.insert(message.end(), file.path.begin(), file.path.end());
+  appendInteger(message, file.length);
+  appendInteger(message, file.offsets.size());
+  for (size_t s=0; s<file.offsets.size(); s++)
+    appendInteger(message, file.offsets[s]);
+  for (size_t s=0; s<file.sizes.size(); s++)
+    appendInteger(message, file.sizes[s]);
+  message.insert(message.end(), file.bytes.begin(), file.bytes.end());
+} // pack
+
+
+/*!
+ * \brief Reads a file from a message.
+ *
+ * \return The position in the message after the file
+ */
+const char *AsyncWriter::unpack(const char *message, StagedFile &file)
+{
+  size_t pathLength = extractInteger(message);
+  file.path.assign(message, pathLength);
+  message += pathLength;
+  file.length = extractInteger(message);
+  size_t numSegments = extractInteger(message), numBytes = 0;
+  file.offsets.resize(numSegments);
+  file.sizes.resize(numSegments);
+  for (size_t s=0; s<numSegments; s++)
+    file.offsets[s] = extractInteger(message);
+  for (size_t s=0; s<numSegments; s++)
+  {
+    file.sizes[s] = extractInteger(message);
+    numBytes += file.sizes[s];
+  }
+  file.bytes.assign(message, message+numBytes);
+
+  return message + numBytes;
+} // unpack
+
+
+/*!
+ * \brief Loop of an output server: receives the snapshots of its compute
+ *        processes and, once the snapshot of a time step has arrived from all
+ *        of them, writes its files; acknowledges when all compute processes
+ *        are done. Makes no PETSc call.
+ *
+ * \param numServers Number of output servers
+ */
+int AsyncWriter::serve(PetscMPIInt numServers)
+{
+  int ierr;
+
+  int worldRank, worldSize;
+  ierr = MPI_Comm_rank(MPI_COMM_WORLD, &worldRank); if (ierr) return ierr;
+  ierr = MPI_Comm_size(MPI_COMM_WORLD, &worldSize); if (ierr) return ierr;
+  int numCompute = worldSize - numServers;
+  std::vector<int> clients;
+  for (int c=0; c<numCompute; c++)
+  {
+    if (numCompute + (int) (((PetscInt64) c*numServers)/numCompute) == worldRank)
+      clients.push_back(c);
+  }
+
+  // files of the snapshots not yet received from all clients, by time step
+  std::map<PetscInt, std::map<std::string, StagedFile> > pending;
+  std::map<PetscInt, size_t> numArrived;
+  std::vector<PetscInt> numReceived(numCompute, 0);
+  std::vector<char> message;
+  std::string error;
+  size_t numDone = 0;
+  while (numDone < clients.size())
+  {
+    MPI_Status status;
+    int length;
+    ierr = MPI_Probe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &status); if (ierr) return ierr;
+    ierr = MPI_Get_count(&status, MPI_BYTE, &length); if (ierr) return ierr;
+    message.resize(std::max(length, 1));
+    ierr = MPI_Recv(&message[0], length, MPI_BYTE, status.MPI_SOURCE, status.MPI_TAG,
+                    MPI_COMM_WORLD, MPI_STATUS_IGNORE); if (ierr) return ierr;
+    if (status.MPI_TAG == tagDone)
+    {
+      numDone++;
+      continue;
+    }
+
+    // the messages of a client arrive in order
+    PetscInt step = numReceived[status.MPI_SOURCE]++;
+    std::map<std::string, StagedFile> &files = pending[step];
+    const char *position = &message[0];
+    int64_t numFiles = extractInteger(position);
+    for (int64_t f=0; f<numFiles; f++)
+    {
+      StagedFile part;
+      position = unpack(position, part);
+      if (files.count(part.path) == 0)
+      {
+        files[part.path] = std::move(part);
+        continue;
+      }
+      StagedFile &file = files[part.path];
+      file.length = std::max(file.length, part.length);
+      file.offsets.insert(file.offsets.end(), part.offsets.begin(), part.offsets.end());
+      file.sizes.insert(file.sizes.end(), part.sizes.begin(), part.sizes.end());
+      file.bytes.insert(file.bytes.end(), part.bytes.begin(), part.bytes.end());
+    }
+    if (++numArrived[step] < clients.size())
+      continue;
+    for (std::map<std::string, StagedFile>::iterator it=files.begin(); it!=files.end(); it++)
+    {
+      std::string fileError = writeFile(it->second);
+      if (!fileError.empty() && error.empty())
+        error = fileError;
+    }
+    pending.erase(step);
+    numArrived.erase(step);
+  }
+
+  // all the snapshots of the clients are written
+  for (size_t c=0; c<clients.size(); c++)
+  {
+    ierr = MPI_Send(error.c_str(), error.size(), MPI_CHAR, clients[c], tagAcknowledge,
+                    MPI_COMM_WORLD); if (ierr) return ierr;
+  }
+
+  return 0;
+} // serve
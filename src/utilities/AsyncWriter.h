@@ -0,0 +1,123 @@
+/*! Definition of the class `AsyncWriter`.
+ * \file AsyncWriter.h
+ */
+
+
+#if !defined(ASYNC_WRITER_H)
+#define ASYNC_WRITER_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/types.h>
+
+#include <petscvec.h>
+#include <petsclog.h>
+
+
+/**
+ * \class AsyncWriter
+ * \brief Writes vectors into PETSc binary files from a background thread or
+ *        from output servers.
+ *
+ * The vectors of a time step are staged (copied, in the byte order of the
+ * PETSc binary format) into a snapshot and the solver goes on. Without output
+ * servers, a thread of the process writes the snapshot into the files with
+ * `pwrite`, each process writing its own part of the vector at its offset in
+ * the natural ordering of the DMDA, so that the files can be read with
+ * `VecLoad`; the thread makes no MPI or PETSc call. The snapshots are taken
+ * from a pool of `numBuffers` buffers (double buffering by default): when all
+ * of them are still being written, staging waits for the oldest one (event
+ * `asyncOutputWait`). `flush` waits until all snapshots are written.
+ *
+ * With the option `-io_servers <n>`, the last `n` processes of
+ * `MPI_COMM_WORLD` are set aside before PETSc is initialized
+ * (`splitServers`) and do not take part in the computation
+ * (`PETSC_COMM_WORLD` holds the other processes). Each compute process sends
+ * its snapshots to one server with a non-blocking send (the buffer is reused
+ * once the send is complete); a server gathers the snapshot of a time step
+ * from all its compute processes and writes each file with the segments that
+ * follow each other merged into contiguous writes (`serve`). `flush`, at the
+ * end of the run, waits for the servers to write everything.
+ */
+class AsyncWriter
+{
+public:
+  // constructors
+  AsyncWriter();
+  // destructor
+  ~AsyncWriter();
+
+  // start the writing thread or connect to the output server
+  PetscErrorCode initialize(PetscBool useThread, PetscInt numBuffers);
+  // are the vectors written through the writer?
+  PetscBool isActive() { return active; }
+  // copy a vector into the current snapshot
+  PetscErrorCode stage(Vec v, std::string filePath);
+  // hand the current snapshot to the writing thread or to the output server
+  PetscErrorCode commit();
+  // wait until all snapshots are written
+  PetscErrorCode flush();
+
+  // set aside the output servers (option -io_servers), before PetscInitialize
+  static int splitServers(int argc, char **argv, PetscMPIInt &numServers, PetscBool &isServer);
+  // are there output servers?
+  static PetscBool hasServers();
+  // receive and write the snapshots of the compute processes (output server)
+  static int serve(PetscMPIInt numServers);
+
+private:
+  /// part of a file to write
+  struct StagedFile
+  {
+    std::string path;               ///< path of the file
+    off_t length;                   ///< length of the file (0 if not known)
+    std::vector<off_t> offsets;     ///< offset of each segment in the file
+    std::vector<size_t> sizes;      ///< size in bytes of each segment
+    std::vector<char> bytes;        ///< segments, one after the other
+  };
+  /// state of a buffer
+  enum BufferState {FREE, STAGING, QUEUED};
+
+  PetscBool active;                 ///< are the vectors written through the writer?
+  std::vector<std::vector<StagedFile> > buffers; ///< snapshots
+  std::vector<BufferState> states;  ///< state of each buffer
+  std::vector<size_t> numFiles;     ///< number of files staged in each buffer
+  PetscInt current;                 ///< buffer being staged (-1 if none)
+  std::deque<PetscInt> queue;       ///< buffers to write, oldest first
+  std::string error;                ///< first error of the thread
+  PetscBool stop;                   ///< should the thread stop?
+  std::thread writer;               ///< writing thread
+  std::mutex mutex;                 ///< protects the states, the queue and the error
+  std::condition_variable queued,   ///< signals a snapshot to write
+                          written;  ///< signals a snapshot written
+  PetscMPIInt rank;                 ///< rank of the process
+  PetscMPIInt server;               ///< rank of the output server in MPI_COMM_WORLD (-1 if none)
+  PetscInt numCommitted;            ///< number of snapshots sent to the server
+  std::vector<std::vector<char> > messages; ///< snapshots packed for the server
+  std::vector<MPI_Request> requests; ///< sends of the packed snapshots
+  PetscLogEvent eventWait;          ///< staging waiting for a free buffer
+
+  // wait for a free buffer and start a snapshot
+  PetscErrorCode acquireBuffer();
+  // write the snapshots handed to the thread
+  void run();
+  // write the files of a snapshot, returns an error message
+  std::string writeSnapshot(PetscInt b);
+  // report the error of the thread
+  PetscErrorCode checkError();
+
+  // write the segments of a file, merging those that follow each other
+  static std::string writeFile(const StagedFile &file);
+  // append a file to a message
+  static void pack(const StagedFile &file, std::vector<char> &message);
+  // read a file from a message
+  static const char *unpack(const char *message, StagedFile &file);
+
+}; // AsyncWriter
+
+#endif
@@ -5,7 +5,9 @@
 
 #include "Body.h"
 
+#include <algorithm>
 #include <fstream>
+#include <new>
 
 #include "yaml-cpp/yaml.h"
 
@@ -288,6 +290,189 @@ PetscErrorCode Body<dim>::registerGlobalIdxPoints(PetscInt &globalIdx)
 } // registerGlobalIdxPoints
 
 
+/*!
+ * \brief Gets the indices of the cells intersecting a given interval.
+ *
+ * The interval is wrapped around the domain when the direction is periodic.
+ * The range is widened by one cell on each side to be safe from round-off;
+ * the caller still has to check if a point is actually influenced.
+ *
+ * \param x Stations of the nodes along the direction
+ * \param n Number of cells along the direction
+ * \param lo Lower bound of the interval
+ * \param hi Upper bound of the interval
+ * \param bType Type of boundary condition along the direction
+ * \param cells Sorted and unique indices of the cells (output)
+ */
+static void getCellsInInterval(const std::vector<PetscReal> &x, PetscInt n,
+                               PetscReal lo, PetscReal hi, BoundaryType bType,
+                               std::vector<PetscInt> &cells)
+{
+  PetscReal width = x[n] - x[0];
+  std::vector<std::pair<PetscReal, PetscReal> > intervals;
+  intervals.push_back(std::make_pair(std::max(lo, x[0]), std::min(hi, x[n])));
+  if (bType == PERIODIC)
+  {
+    if (lo < x[0])
+      intervals.push_back(std::make_pair(lo + width, x[n]));
+    if (hi > x[n])
+      intervals.push_back(std::make_pair(x[0], hi - width));
+  }
+
+  cells.clear();
+  for (auto &interval : intervals)
+  {
+    if (interval.first > interval.second)
+      continue;
+    // first cell whose right node is not located on the left of the interval
+    PetscInt start = std::lower_bound(x.begin()+1, x.begin()+n+1, interval.first) - (x.begin()+1);
+    // first cell whose left node is located on the right of the interval
+    PetscInt end = std::upper_bound(x.begin(), x.begin()+n, interval.second) - x.begin();
+    for (PetscInt c=start-1; c<=end; c++)
+    {
+      if (bType == PERIODIC)
+        cells.push_back((c+n)%n);
+      else if (c >= 0 && c < n)
+        cells.push_back(c);
+    }
+  }
+  std::sort(cells.begin(), cells.end());
+  cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+} // getCellsInInterval
+
+
+/*!
+ * \brief Buckets the body points by Eulerian cell owner.
+ *
+ * Each body point gets the key of its owning cell (I, J, K), and the points are
+ * sorted by key so that the points owned by a cell can be found by bisection.
+ * Points are referred to by their index in process ordering
+ * (the one used by `idxPointsOnProcess` and `globalIdxPoints`).
+ * Must be called after `registerCellOwners` and `registerPointsOnProcess`.
+ *
+ * \param mesh Contains the information about the Cartesian grid
+ */
+template <PetscInt dim>
+PetscErrorCode Body<dim>::registerPointsInCells(CartesianMesh *mesh)
+{
+  PetscFunctionBeginUser;
+
+  std::vector<std::pair<PetscInt, PetscInt> > keys(numPoints);
+  for (PetscInt l=0; l<numPoints; l++)
+  {
+    PetscInt pointIdx = idxPointsOnProcess[l];
+    PetscInt key = I[pointIdx] + mesh->nx*J[pointIdx];
+    if (dim == 3)
+      key += mesh->nx*mesh->ny*K[pointIdx];
+    keys[l] = std::make_pair(key, l);
+  }
+  std::sort(keys.begin(), keys.end());
+
+  cellKeys.resize(numPoints);
+  idxPointsInCells.resize(numPoints);
+  for (PetscInt l=0; l<numPoints; l++)
+  {
+    cellKeys[l] = keys[l].first;
+    idxPointsInCells[l] = keys[l].second;
+  }
+
+  PetscFunctionReturn(0);
+} // registerPointsInCells
+
+
+/*!
+ * \brief Gets the body points owned by the cells intersecting the support
+ *        of a discrete delta function centered at a given target.
+ *
+ * The returned list is a superset of the points influencing the target;
+ * it is meant to be filtered with `isInfluenced`.
+ * The function makes no PETSc call: it can be called from threaded loops,
+ * the caller raising the error once the loop is over.
+ *
+ * \param mesh Contains the information about the Cartesian grid
+ * \param target Coordinates of the target point
+ * \param maxDisp Half-widths of the support
+ * \param bTypes Types of boundary conditions
+ * \param neighbors Indices (in process ordering) of the body points (output)
+ *
+ * \return PETSC_FALSE if the points are not bucketed by cell or if the lists
+ *         cannot be allocated
+ */
+template <PetscInt dim>
+PetscBool Body<dim>::findNeighborPoints(CartesianMesh *mesh,
+                                        PetscReal (&target)[dim], PetscReal (&maxDisp)[dim],
+                                        BoundaryType (&bTypes)[dim],
+                                        std::vector<PetscInt> &neighbors) const
+{
+  neighbors.clear();
+  if (cellKeys.size() != idxPointsInCells.size())
+    return PETSC_FALSE;
+  if (cellKeys.empty())
+    return PETSC_TRUE;
+
+  try
+  {
+    std::vector<PetscInt> cells[3];
+    getCellsInInterval(mesh->x, mesh->nx, target[0]-maxDisp[0], target[0]+maxDisp[0], bTypes[0], cells[0]);
+    getCellsInInterval(mesh->y, mesh->ny, target[1]-maxDisp[1], target[1]+maxDisp[1], bTypes[1], cells[1]);
+    if (dim == 3)
+      getCellsInInterval(mesh->z, mesh->nz, target[2]-maxDisp[2], target[2]+maxDisp[2], bTypes[2], cells[2]);
+    else
+      cells[2].push_back(0);
+
+    for (auto k : cells[2])
+    {
+      for (auto j : cells[1])
+      {
+        for (auto i : cells[0])
+        {
+          PetscInt key = i + mesh->nx*(j + mesh->ny*k);
+          auto range = std::equal_range(cellKeys.begin(), cellKeys.end(), key);
+          for (auto it=range.first; it!=range.second; ++it)
+            neighbors.push_back(idxPointsInCells[it - cellKeys.begin()]);
+        }
+      }
+    }
+  }
+  catch (std::bad_alloc &)
+  {
+    // an exception must not leave a threaded region
+    neighbors.clear();
+    return PETSC_FALSE;
+  }
+
+  return PETSC_TRUE;
+} // findNeighborPoints
+
+
+/*!
+ * \brief Gets the body points owned by the cells intersecting the support
+ *        of a discrete delta function centered at a given target
+ *        (see `findNeighborPoints`).
+ *
+ * \param mesh Contains the information about the Cartesian grid
+ * \param target Coordinates of the target point
+ * \param maxDisp Half-widths of the support
+ * \param bTypes Types of boundary conditions
+ * \param neighbors Indices (in process ordering) of the body points (output)
+ */
+template <PetscInt dim>
+PetscErrorCode Body<dim>::getNeighborPoints(CartesianMesh *mesh,
+                                            PetscReal (&target)[dim], PetscReal (&maxDisp)[dim],
+                                            BoundaryType (&bTypes)[dim],
+                                            std::vector<PetscInt> &neighbors)
+{
+  PetscFunctionBeginUser;
+
+  if (!findNeighborPoints(mesh, target, maxDisp, bTypes, neighbors))
+  {
+    SETERRQ(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Cannot get the body points near a target (are the points bucketed by cell?)");
+  }
+
+  PetscFunctionReturn(0);
+} // getNeighborPoints
+
+
 // dimensions specialization
 template class Body<2>;
 template class Body<3>;
@@ -33,6 +33,8 @@ public:
   std::vector<PetscInt> numPointsOnProcess; ///< number of body points on each process
   std::vector<PetscInt> idxPointsOnProcess; ///< index of body points per process
   std::vector<PetscInt> globalIdxPoints; ///< local-to-global mapping
+  std::vector<PetscInt> cellKeys; ///< sorted keys of the Eulerian cells owning the body points
+  std::vector<PetscInt> idxPointsInCells; ///< indices in process ordering of the body points sorted by cell key
 
   // constructors
   Body(){ };
@@ -50,6 +52,18 @@ public:
   PetscErrorCode registerPointsOnProcess(PetscReal (&box)[2*dim]);
   // register the local-to-global mapping
   PetscErrorCode registerGlobalIdxPoints(PetscInt &offset);
+  // bucket the body points by Eulerian cell owner
+  PetscErrorCode registerPointsInCells(CartesianMesh *mesh);
+  // get the body points owned by cells intersecting a given support (no PETSc call)
+  PetscBool findNeighborPoints(CartesianMesh *mesh,
+                               PetscReal (&target)[dim], PetscReal (&maxDisp)[dim],
+                               BoundaryType (&bTypes)[dim],
+                               std::vector<PetscInt> &neighbors) const;
+  // get the body points owned by cells intersecting a given support
+  PetscErrorCode getNeighborPoints(CartesianMesh *mesh,
+                                   PetscReal (&target)[dim], PetscReal (&maxDisp)[dim],
+                                   BoundaryType (&bTypes)[dim],
+                                   std::vector<PetscInt> &neighbors);
 
 }; // Body
 
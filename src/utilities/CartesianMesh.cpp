@@ -7,6 +7,7 @@
 
 #include "CartesianMesh.h"
 
+#include <algorithm>
 #include <fstream>
 #include <iomanip>
 
@@ -20,6 +21,7 @@
  */
 CartesianMesh::CartesianMesh()
 {
+  uniform[0] = uniform[1] = uniform[2] = PETSC_FALSE;
 } // CartesianMesh
 
 
@@ -180,11 +182,47 @@ void CartesianMesh::initialize(std::string filePath)
 
   }
 
+  detectUniformity();
+
   PetscPrintf(PETSC_COMM_WORLD, "done.\n");
 
 } // initialize
 
 
+/**
+ * \brief Checks whether the cell-widths are constant along each direction.
+ *
+ * A direction is uniform only when its cell-widths are exactly equal, so that
+ * the kernels in which the grid-spacing is a constant use the same value as
+ * the widths themselves. The widths of the subdomains with a unit stretching
+ * ratio are all equal; those of a grid read from a file are differences of
+ * coordinates and usually differ by round-off, which gives a stretched
+ * direction.
+ * The solvers use the flags to select kernels in which the grid-spacing
+ * is a constant.
+ */
+void CartesianMesh::detectUniformity()
+{
+  std::vector<PetscReal> *widths[3] = {&dx, &dy, &dz};
+  for (int d=0; d<3; d++)
+  {
+    const std::vector<PetscReal> &h = *widths[d];
+    uniform[d] = PETSC_FALSE;
+    if (h.empty())
+      continue;
+    uniform[d] = PETSC_TRUE;
+    for (size_t i=1; i<h.size(); i++)
+    {
+      if (h[i] != h[0])
+      {
+        uniform[d] = PETSC_FALSE;
+        break;
+      }
+    }
+  }
+} // detectUniformity
+
+
 /**
  * \brief Reads grid points from file.
  *
@@ -212,7 +250,7 @@ PetscErrorCode CartesianMesh::read(std::string filePath)
   else
     nz = 0;
   x.reserve(nx+1);
-  dx.reserve(nx);
+  dx.resize(nx);
   for (unsigned int i=0; i<nx+1; i++)
   {
     infile >> val;
@@ -221,7 +259,7 @@ PetscErrorCode CartesianMesh::read(std::string filePath)
   for (unsigned int i=0; i<nx; i++)
     dx[i] = x[i+1] - x[i];
   y.reserve(ny+1);
-  dy.reserve(ny);
+  dy.resize(ny);
   for (unsigned int i=0; i<ny+1; i++)
   {
     infile >> val;
@@ -232,7 +270,7 @@ PetscErrorCode CartesianMesh::read(std::string filePath)
   if (nz > 0)
   {
     z.reserve(nz+1);
-    dz.reserve(nz);
+    dz.resize(nz);
     for (unsigned int i=0; i<nz+1; i++)
     {
       infile >> val;
@@ -388,9 +426,89 @@ PetscErrorCode CartesianMesh::write(std::string filePath, StaggeredMode mode, Bo
 
   return 0;
 } // write
+
+
+/**
+ * \brief Writes the grid stations into the current group of a HDF5 viewer
+ *        opened on all processes (datasets `x`, `y` and `z`).
+ *
+ * The stations are held by process 0; the call is collective.
+ *
+ * \param viewer HDF5 viewer on `PETSC_COMM_WORLD`
+ * \param mode Staggered mode to define locations of a variable points
+ * \param bType Type of boundary on the minus side of the staggered direction
+ */
+PetscErrorCode CartesianMesh::write(PetscViewer viewer, StaggeredMode mode, BoundaryType bType)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt rank;
+
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+
+  const char *names[3] = {"x", "y", "z"};
+  PetscInt numDirections = (nz > 0) ? 3 : 2;
+  for (PetscInt d=0; d<numDirections; d++)
+  {
+    std::vector<PetscReal> stations;
+    getStations(mode, bType, d, stations);
+    PetscInt n = stations.size();
+    Vec vs;
+    ierr = VecCreateMPI(PETSC_COMM_WORLD, (rank == 0) ? n : 0, n, &vs); CHKERRQ(ierr);
+    if (rank == 0)
+    {
+      PetscReal *array;
+      ierr = VecGetArray(vs, &array); CHKERRQ(ierr);
+      std::copy(stations.begin(), stations.end(), array);
+      ierr = VecRestoreArray(vs, &array); CHKERRQ(ierr);
+    }
+    ierr = PetscObjectSetName((PetscObject) vs, names[d]); CHKERRQ(ierr);
+    ierr = VecView(vs, viewer); CHKERRQ(ierr);
+    ierr = VecDestroy(&vs); CHKERRQ(ierr);
+  }
+
+  return 0;
+} // write
 #endif
 
 
+/**
+ * \brief Gets the stations of a variable along a direction: the nodes along the
+ *        staggered direction (the first one excluded, the last one too unless
+ *        the boundary is periodic), the cell-centers along the others.
+ */
+void CartesianMesh::getStations(StaggeredMode mode, BoundaryType bType, PetscInt direction,
+                                std::vector<PetscReal> &stations)
+{
+  const std::vector<PetscReal> *nodes[3] = {&x, &y, &z};
+  const StaggeredMode staggered[3] = {STAGGERED_MODE_X, STAGGERED_MODE_Y, STAGGERED_MODE_Z};
+  const std::vector<PetscReal> &s = *nodes[direction];
+  PetscInt numCells = s.size()-1;
+  stations.clear();
+  if (mode == staggered[direction])
+  {
+    PetscInt n = (bType == PERIODIC) ? numCells : numCells-1;
+    for (PetscInt i=0; i<n; i++)
+      stations.push_back(s[i+1]);
+  }
+  else
+  {
+    for (PetscInt i=0; i<numCells; i++)
+      stations.push_back(0.5*(s[i] + s[i+1]));
+  }
+} // getStations
+
+
+/**
+ * \brief Gets the number of stations of a variable along a direction.
+ */
+PetscInt CartesianMesh::getNumStations(StaggeredMode mode, BoundaryType bType, PetscInt direction)
+{
+  std::vector<PetscReal> stations;
+  getStations(mode, bType, direction, stations);
+  return stations.size();
+} // getNumStations
+
+
 /**
  * \brief Prints information about the Cartesian mesh.
  */
@@ -408,6 +526,12 @@ PetscErrorCode CartesianMesh::printInfo()
   {
     ierr = PetscPrintf(PETSC_COMM_WORLD, "number of cells: %d x %d\n", nx, ny); CHKERRQ(ierr);
   }
+  ierr = PetscPrintf(PETSC_COMM_WORLD, "uniform cell-widths: x (%s), y (%s)", (uniform[0]) ? "yes" : "no", (uniform[1]) ? "yes" : "no"); CHKERRQ(ierr);
+  if (nz > 0)
+  {
+    ierr = PetscPrintf(PETSC_COMM_WORLD, ", z (%s)", (uniform[2]) ? "yes" : "no"); CHKERRQ(ierr);
+  }
+  ierr = PetscPrintf(PETSC_COMM_WORLD, "\n"); CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD, "---------------------------------------\n"); CHKERRQ(ierr);
 
   return 0;
@@ -14,6 +14,7 @@
 #include <vector>
 
 #include <petscsys.h>
+#include <petscviewer.h>
 
 
 /**
@@ -34,6 +35,8 @@ public:
                          dy, ///< cell-widths along the y-direction 
                          dz; ///< cell-widths along the z-direction
 
+  PetscBool uniform[3]; ///< whether the cells have the same width along each direction
+
   // constructors
   CartesianMesh();
   CartesianMesh(std::string filePath);
@@ -47,10 +50,20 @@ public:
   PetscErrorCode write(std::string filePath);
 #ifdef PETSC_HAVE_HDF5
   PetscErrorCode write(std::string filePath, StaggeredMode mode, BoundaryType type);
+  // write grid stations into the current group of an open HDF5 viewer
+  PetscErrorCode write(PetscViewer viewer, StaggeredMode mode, BoundaryType type);
 #endif
+  // get the number of stations of a variable along a direction
+  PetscInt getNumStations(StaggeredMode mode, BoundaryType type, PetscInt direction);
+  // get the stations of a variable along a direction
+  void getStations(StaggeredMode mode, BoundaryType type, PetscInt direction, std::vector<PetscReal> &stations);
   // print information about Cartesian mesh
   PetscErrorCode printInfo();
 
+private:
+  // check whether the cell-widths are constant along each direction
+  void detectUniformity();
+
 }; // CartesianMesh
 
 #endif
\ No newline at end of file
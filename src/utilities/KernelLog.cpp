@@ -0,0 +1,198 @@
+/*! Implementation of the methods of the class `KernelLog`.
+ * \file KernelLog.cpp
+ */
+
+
+#include "KernelLog.h"
+
+#include <utility>
+
+#include <petsctime.h>
+
+
+/*!
+ * \brief Registers an event.
+ *
+ * \param name Name of the event in `-log_view` and in the summary
+ * \param event The event registered
+ */
+PetscErrorCode KernelLog::registerEvent(std::string name, PetscLogEvent *event)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  ierr = PetscLogEventRegister(name.c_str(), 0, event); CHKERRQ(ierr);
+  indices[*event] = events.size();
+  names.push_back(name);
+  events.push_back(*event);
+  bytes.push_back(0.0);
+
+  PetscFunctionReturn(0);
+} // registerEvent
+
+
+/*!
+ * \brief Logs the floating-point operations and the bytes moved on the
+ *        process by an execution of an event.
+ *
+ * The operations are attributed by PETSc to the active events; the call
+ * should be made between `PetscLogEventBegin` and `PetscLogEventEnd`.
+ *
+ * \param event The event
+ * \param flops Number of floating-point operations
+ * \param bytes Estimate of the bytes read from and written to memory
+ */
+PetscErrorCode KernelLog::log(PetscLogEvent event, PetscLogDouble flops, PetscLogDouble bytes)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  ierr = PetscLogFlops(flops); CHKERRQ(ierr);
+  this->bytes[indices[event]] += bytes;
+
+  PetscFunctionReturn(0);
+} // log
+
+
+/*!
+ * \brief Gets the number of calls, the time and the floating-point operations
+ *        of an event on the process, summed over the stages (0 without logging).
+ */
+PetscErrorCode KernelLog::getEventPerfInfo(PetscLogEvent event,
+                                           PetscLogDouble &count, PetscLogDouble &time, PetscLogDouble &flops)
+{
+  PetscFunctionBeginUser;
+
+  count = 0.0;
+  time = 0.0;
+  flops = 0.0;
+#if defined(PETSC_USE_LOG)
+  PetscErrorCode ierr;
+  PetscStageLog stageLog;
+  ierr = PetscLogGetStageLog(&stageLog); CHKERRQ(ierr);
+  for (int s=0; s<stageLog->numStages; s++)
+  {
+    PetscEventPerfLog eventLog = stageLog->stageInfo[s].eventLog;
+    if (event < eventLog->numEvents)
+    {
+      count += eventLog->eventInfo[event].count;
+      time += eventLog->eventInfo[event].time;
+      flops += eventLog->eventInfo[event].flops;
+    }
+  }
+#endif
+
+  PetscFunctionReturn(0);
+} // getEventPerfInfo
+
+
+/*!
+ * \brief Measures the aggregate bandwidth of the STREAM triad
+ *        `a[i] = b[i] + s*c[i]`, run on all processes at the same time.
+ *
+ * The best of 10 repetitions is kept; the triad moves 3 arrays per repetition
+ * (the write-allocate traffic is not counted, as in STREAM).
+ *
+ * \param size Length of the arrays on each process
+ * \param bandwidth Bandwidth in bytes per second
+ */
+PetscErrorCode KernelLog::measureStreamBandwidth(PetscInt size, PetscLogDouble &bandwidth)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  PetscMPIInt numProcs;
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD, &numProcs); CHKERRQ(ierr);
+
+  std::vector<PetscReal> a(size, 1.0), b(size, 2.0), c(size, 0.5);
+  const PetscReal s = 3.0;
+  PetscLogDouble best = 0.0;
+  for (PetscInt repetition=0; repetition<10; repetition++)
+  {
+    PetscLogDouble start, end, elapsed;
+    ierr = MPI_Barrier(PETSC_COMM_WORLD); CHKERRQ(ierr);
+    ierr = PetscTime(&start); CHKERRQ(ierr);
+    PetscReal *pa = &a[0];
+    const PetscReal *pb = &b[0], *pc = &c[0];
+#pragma omp parallel for
+    for (PetscInt i=0; i<size; i++)
+      pa[i] = pb[i] + s*pc[i];
+    ierr = PetscTime(&end); CHKERRQ(ierr);
+    elapsed = end - start;
+    // the slowest process sets the time of the repetition
+    ierr = MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPIU_PETSCLOGDOUBLE, MPI_MAX, PETSC_COMM_WORLD); CHKERRQ(ierr);
+    if (repetition == 0 || elapsed < best)
+      best = elapsed;
+    // the input of the next repetition depends on the output
+    std::swap(a, b);
+  }
+  bandwidth = (best > 0.0) ? numProcs*3.0*size*sizeof(PetscReal)/best : 0.0;
+
+  PetscFunctionReturn(0);
+} // measureStreamBandwidth
+
+
+/*!
+ * \brief Prints, when the option `-log_kernels` is set, the time, the rate of
+ *        floating-point operations, the bandwidth and the arithmetic intensity
+ *        of each event, with the bandwidth as a fraction of the STREAM triad.
+ *
+ * The operations and the bytes are summed over the processes and divided by
+ * the maximum time over the processes. The baseline is measured with arrays of
+ * `-log_kernels_stream_size` entries per process (default 2,000,000) unless
+ * it is given in GB/s with `-log_kernels_stream`.
+ */
+PetscErrorCode KernelLog::view()
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  PetscBool found;
+  ierr = PetscOptionsHasName(NULL, NULL, "-log_kernels", &found); CHKERRQ(ierr);
+  if (!found || events.empty())
+    PetscFunctionReturn(0);
+
+  PetscReal stream = 0.0;
+  ierr = PetscOptionsGetReal(NULL, NULL, "-log_kernels_stream", &stream, &found); CHKERRQ(ierr);
+  PetscLogDouble streamBandwidth = stream*1.0E+09;
+  if (!found)
+  {
+    PetscInt size = 2000000;
+    ierr = PetscOptionsGetInt(NULL, NULL, "-log_kernels_stream_size", &size, NULL); CHKERRQ(ierr);
+    ierr = measureStreamBandwidth(size, streamBandwidth); CHKERRQ(ierr);
+  }
+
+  PetscMPIInt numEvents = events.size();
+  std::vector<PetscLogDouble> counts(numEvents), times(numEvents), flops(numEvents),
+                              totalBytes(numEvents);
+  for (PetscMPIInt e=0; e<numEvents; e++)
+  {
+    ierr = getEventPerfInfo(events[e], counts[e], times[e], flops[e]); CHKERRQ(ierr);
+  }
+  ierr = MPI_Allreduce(MPI_IN_PLACE, &counts[0], numEvents, MPIU_PETSCLOGDOUBLE, MPI_MAX, PETSC_COMM_WORLD); CHKERRQ(ierr);
+  ierr = MPI_Allreduce(MPI_IN_PLACE, &times[0], numEvents, MPIU_PETSCLOGDOUBLE, MPI_MAX, PETSC_COMM_WORLD); CHKERRQ(ierr);
+  ierr = MPI_Allreduce(MPI_IN_PLACE, &flops[0], numEvents, MPIU_PETSCLOGDOUBLE, MPI_SUM, PETSC_COMM_WORLD); CHKERRQ(ierr);
+  ierr = MPI_Allreduce(&bytes[0], &totalBytes[0], numEvents, MPIU_PETSCLOGDOUBLE, MPI_SUM, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+  ierr = PetscPrintf(PETSC_COMM_WORLD, "\nKernels (STREAM triad: %.2f GB/s on all processes%s)\n",
+                     streamBandwidth*1.0E-09, (found) ? ", given" : ""); CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD, "%-24s %8s %11s %9s %9s %8s %10s\n",
+                     "event", "count", "time (s)", "GFlop/s", "GB/s", "%STREAM", "flop/byte"); CHKERRQ(ierr);
+  for (PetscMPIInt e=0; e<numEvents; e++)
+  {
+    PetscLogDouble time = times[e],
+                   flopRate = (time > 0.0) ? flops[e]/time : 0.0,
+                   bandwidth = (time > 0.0) ? totalBytes[e]/time : 0.0,
+                   fraction = (streamBandwidth > 0.0) ? 100.0*bandwidth/streamBandwidth : 0.0,
+                   intensity = (totalBytes[e] > 0.0) ? flops[e]/totalBytes[e] : 0.0;
+    ierr = PetscPrintf(PETSC_COMM_WORLD, "%-24s %8.0f %11.4e %9.3f %9.3f %8.1f %10.3f\n",
+                       names[e].c_str(), counts[e], time, flopRate*1.0E-09, bandwidth*1.0E-09,
+                       fraction, intensity); CHKERRQ(ierr);
+  }
+
+  PetscFunctionReturn(0);
+} // view
@@ -0,0 +1,59 @@
+/*! Definition of the class `KernelLog`.
+ * \file KernelLog.h
+ */
+
+
+#if !defined(KERNEL_LOG_H)
+#define KERNEL_LOG_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <petscsys.h>
+#include <petsclog.h>
+
+
+/**
+ * \class KernelLog
+ * \brief Log events of the computational kernels with their floating-point
+ *        operations and an estimate of the bytes they move.
+ *
+ * The floating-point operations are passed to `PetscLogFlops` (and reported
+ * by `-log_view`); PETSc does not log memory traffic, so the bytes are
+ * accumulated here. With the option `-log_kernels`, `view` prints for each
+ * event the achieved rates and the fraction of the bandwidth measured by a
+ * STREAM triad run on all processes at the same time (or given in GB/s with
+ * `-log_kernels_stream`), to tell the kernels at the memory roofline from the
+ * others.
+ */
+class KernelLog
+{
+public:
+  // constructors
+  KernelLog(){ };
+  // destructor
+  ~KernelLog(){ };
+
+  // register an event
+  PetscErrorCode registerEvent(std::string name, PetscLogEvent *event);
+  // log the operations and the bytes moved by an execution of an event
+  PetscErrorCode log(PetscLogEvent event, PetscLogDouble flops, PetscLogDouble bytes);
+  // print the rates of the events compared with the STREAM bandwidth
+  PetscErrorCode view();
+
+private:
+  std::vector<std::string> names;      ///< names of the events
+  std::vector<PetscLogEvent> events;   ///< registered events
+  std::vector<PetscLogDouble> bytes;   ///< bytes moved by each event on the process
+  std::map<PetscLogEvent, size_t> indices; ///< index of each event
+
+  // get the number of calls, the time and the operations of an event over all stages
+  PetscErrorCode getEventPerfInfo(PetscLogEvent event,
+                                  PetscLogDouble &count, PetscLogDouble &time, PetscLogDouble &flops);
+  // measure the bandwidth of the STREAM triad on all processes
+  PetscErrorCode measureStreamBandwidth(PetscInt size, PetscLogDouble &bandwidth);
+
+}; // KernelLog
+
+#endif
@@ -0,0 +1,492 @@
+/*! Implementation of the methods of the class `Probes`.
+ * \file Probes.cpp
+ */
+
+
+#include "Probes.h"
+
+#include <algorithm>
+#include <sstream>
+#include <sys/stat.h>
+
+#include "yaml-cpp/yaml.h"
+
+
+/*!
+ * \brief Reads the coordinates of a point from a YAML sequence.
+ *
+ * \param node The sequence
+ * \param dimension Number of coordinates
+ * \param name Name of the probe (for the error message)
+ * \param point The coordinates
+ */
+static PetscErrorCode readPoint(const YAML::Node &node, PetscInt dimension, std::string name, PetscReal *point)
+{
+  PetscFunctionBeginUser;
+
+  if (!node || node.size() < (size_t) dimension)
+  {
+    SETERRQ2(PETSC_COMM_WORLD, PETSC_ERR_USER, "The points of the probe %s need %d coordinates", name.c_str(), dimension);
+  }
+  for (PetscInt d=0; d<dimension; d++)
+    point[d] = node[d].as<PetscReal>();
+
+  PetscFunctionReturn(0);
+} // readPoint
+
+
+/*!
+ * \brief Gets the points of a probe: `location` (type `point`), `n` points
+ *        evenly spaced from `start` to `end` (type `line`), or `n: [n1, n2]`
+ *        points evenly spaced over the rectangle of corners `start` and `end`
+ *        (type `plane`, the corners differing along two directions).
+ *
+ * \param node YAML node of the probe
+ * \param dimension Number of coordinates of a point
+ * \param name Name of the probe (for the error messages)
+ * \param points Coordinates of the points, one point after the other
+ */
+static PetscErrorCode getPoints(const YAML::Node &node, PetscInt dimension, std::string name,
+                                std::vector<PetscReal> &points)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  std::string type = node["type"].as<std::string>("point");
+  PetscReal start[3] = {0.0, 0.0, 0.0},
+            end[3] = {0.0, 0.0, 0.0};
+  points.clear();
+  if (type == "point")
+  {
+    ierr = readPoint(node["location"], dimension, name, start); CHKERRQ(ierr);
+    points.assign(start, start+dimension);
+    PetscFunctionReturn(0);
+  }
+  if (type != "line" && type != "plane")
+  {
+    SETERRQ2(PETSC_COMM_WORLD, PETSC_ERR_USER, "Unknown type %s of the probe %s (point, line or plane)",
+             type.c_str(), name.c_str());
+  }
+  ierr = readPoint(node["start"], dimension, name, start); CHKERRQ(ierr);
+  ierr = readPoint(node["end"], dimension, name, end); CHKERRQ(ierr);
+
+  // number of points along the line, or along the two directions of the plane
+  PetscInt directions[2] = {-1, -1},
+           sizes[2] = {1, 1};
+  if (type == "line")
+    sizes[0] = node["n"].as<PetscInt>(2);
+  else
+  {
+    PetscInt numDirections = 0;
+    for (PetscInt d=0; d<dimension; d++)
+    {
+      if (start[d] != end[d] && numDirections++ < 2)
+        directions[numDirections-1] = d;
+    }
+    if (numDirections != 2)
+    {
+      SETERRQ1(PETSC_COMM_WORLD, PETSC_ERR_USER, "The corners of the plane probe %s must differ along two directions", name.c_str());
+    }
+    const YAML::Node &n = node["n"];
+    if (!n || n.size() < 2)
+    {
+      SETERRQ1(PETSC_COMM_WORLD, PETSC_ERR_USER, "The plane probe %s needs its numbers of points `n: [n1, n2]`", name.c_str());
+    }
+    sizes[0] = n[0].as<PetscInt>();
+    sizes[1] = n[1].as<PetscInt>();
+  }
+  if (sizes[0] < 1 || sizes[1] < 1)
+  {
+    SETERRQ1(PETSC_COMM_WORLD, PETSC_ERR_USER, "The probe %s needs at least one point", name.c_str());
+  }
+
+  for (PetscInt b=0; b<sizes[1]; b++)
+  {
+    PetscReal tb = (sizes[1] > 1) ? (PetscReal) b/(sizes[1]-1) : 0.0;
+    for (PetscInt a=0; a<sizes[0]; a++)
+    {
+      PetscReal ta = (sizes[0] > 1) ? (PetscReal) a/(sizes[0]-1) : 0.0;
+      for (PetscInt d=0; d<dimension; d++)
+      {
+        PetscReal t = (type == "line" || d == directions[0]) ? ta : (d == directions[1]) ? tb : 0.0;
+        points.push_back(start[d] + t*(end[d]-start[d]));
+      }
+    }
+  }
+
+  PetscFunctionReturn(0);
+} // getPoints
+
+
+/*!
+ * \brief Locates a coordinate among the stations: index of the station below
+ *        and weight of the station above (the nearest station is used
+ *        outside of the stations).
+ */
+static void locate(const std::vector<PetscReal> &stations, PetscReal x, PetscInt &lower, PetscReal &weight)
+{
+  PetscInt n = stations.size();
+  lower = 0;
+  weight = 0.0;
+  if (n < 2 || x <= stations[0])
+    return;
+  if (x >= stations[n-1])
+  {
+    lower = n-1;
+    return;
+  }
+  lower = std::upper_bound(stations.begin(), stations.end(), x) - stations.begin() - 1;
+  weight = (x - stations[lower])/(stations[lower+1] - stations[lower]);
+} // locate
+
+
+/*!
+ * \brief Constructor.
+ */
+Probes::Probes()
+{
+  active = PETSC_FALSE;
+  dimension = 2;
+  flushInterval = 1;
+  eventSample = 0;
+} // Probes
+
+
+/*!
+ * \brief Destructor.
+ */
+Probes::~Probes()
+{
+} // ~Probes
+
+
+/*!
+ * \brief Registers a field that can be sampled (before `initialize`).
+ *
+ * \param name Name of the field, prefix of its columns
+ * \param group Group of the field, to select several fields at once
+ * \param da DMDA of the field
+ * \param stations Stations of the field along x, y (and z)
+ * \param scale Vector of factors applied to the values (`PETSC_NULL` if none),
+ *        read by `initialize` and not referenced afterwards (it only needs to
+ *        be valid until `initialize` returns)
+ */
+PetscErrorCode Probes::addField(std::string name, std::string group, DM da,
+                                const std::vector<PetscReal> (&stations)[3], Vec scale)
+{
+  Field field;
+  field.name = name;
+  field.group = group;
+  field.da = da;
+  for (PetscInt d=0; d<3; d++)
+    field.stations[d] = stations[d];
+  field.scale = scale;
+  fieldList.push_back(field);
+
+  return 0;
+} // addField
+
+
+/*!
+ * \brief Reads the probes, computes their interpolation weights and starts
+ *        their files; nothing is done if the file of the probes does not exist.
+ *
+ * Each probe of the YAML file has a `name`, a `type` (`point`, `line` or
+ * `plane`, see `getPoints`), the `fields` it samples (names or groups, all
+ * the fields by default) and the number of time steps between two samples
+ * (`nsample`, 1 by default).
+ *
+ * \param filePath Path of the YAML file of the probes
+ * \param directory Directory of the simulation
+ * \param startStep Starting time step (the files are appended when restarting)
+ * \param interval Number of samples of a probe summed and written at once
+ */
+PetscErrorCode Probes::initialize(std::string filePath, std::string directory,
+                                  PetscInt startStep, PetscInt interval)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  PetscBool found;
+  ierr = PetscTestFile(filePath.c_str(), 'r', &found); CHKERRQ(ierr);
+  if (!found || fieldList.empty())
+  {
+    for (size_t f=0; f<fieldList.size(); f++)
+      fieldList[f].scale = PETSC_NULL;
+    PetscFunctionReturn(0);
+  }
+
+  ierr = PetscPrintf(PETSC_COMM_WORLD, "\nParsing file %s... ", filePath.c_str()); CHKERRQ(ierr);
+
+  ierr = PetscLogEventRegister("sampleProbes", 0, &eventSample); CHKERRQ(ierr);
+  ierr = DMDAGetInfo(fieldList[0].da, &dimension, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+                     NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
+  flushInterval = (interval > 0) ? interval : 1;
+  std::string probesDirectory = directory + "/probes";
+  mkdir(probesDirectory.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+
+  YAML::Node nodes = YAML::LoadFile(filePath);
+  probes.resize(nodes.size());
+  for (size_t i=0; i<nodes.size(); i++)
+  {
+    const YAML::Node &node = nodes[i];
+    Probe &probe = probes[i];
+    std::stringstream ss;
+    ss << "probe" << i;
+    probe.name = node["name"].as<std::string>(ss.str());
+    probe.interval = node["nsample"].as<PetscInt>(1);
+    if (probe.interval < 1)
+    {
+      SETERRQ1(PETSC_COMM_WORLD, PETSC_ERR_USER, "The probe %s needs `nsample` of at least 1", probe.name.c_str());
+    }
+
+    // fields sampled, by name or by group
+    std::vector<std::string> requested;
+    const YAML::Node &fields = node["fields"];
+    for (size_t j=0; j<fields.size(); j++)
+      requested.push_back(fields[j].as<std::string>());
+    for (size_t f=0; f<fieldList.size(); f++)
+    {
+      if (requested.empty() ||
+          std::find(requested.begin(), requested.end(), fieldList[f].name) != requested.end() ||
+          std::find(requested.begin(), requested.end(), fieldList[f].group) != requested.end())
+        probe.fields.push_back(f);
+    }
+    if (probe.fields.empty())
+    {
+      SETERRQ1(PETSC_COMM_WORLD, PETSC_ERR_USER, "The probe %s samples no known field", probe.name.c_str());
+    }
+
+    std::vector<PetscReal> points;
+    ierr = getPoints(node, dimension, probe.name, points); CHKERRQ(ierr);
+    ierr = addContributions(probe, points); CHKERRQ(ierr);
+
+    // columns: time-step index, time and value of each field at each point
+    std::string path = probesDirectory + "/" + probe.name + ".csv";
+    PetscBool exists;
+    ierr = PetscTestFile(path.c_str(), 'r', &exists); CHKERRQ(ierr);
+    probe.series.reset(new TimeSeries());
+    ierr = probe.series->initialize(path, (startStep > 0 && exists) ? PETSC_TRUE : PETSC_FALSE,
+                                    flushInterval); CHKERRQ(ierr);
+    probe.series->addColumn("timeStep");
+    probe.series->addColumn("time");
+    PetscInt numPoints = points.size()/dimension;
+    for (PetscInt p=0; p<numPoints; p++)
+    {
+      for (size_t f=0; f<probe.fields.size(); f++)
+      {
+        std::stringstream column;
+        column << fieldList[probe.fields[f]].name;
+        if (numPoints > 1)
+          column << "_" << p;
+        probe.series->addColumn(column.str());
+      }
+    }
+  }
+  active = (probes.empty()) ? PETSC_FALSE : PETSC_TRUE;
+
+  // the factors are folded into the weights; the vectors may not outlive the call
+  for (size_t f=0; f<fieldList.size(); f++)
+    fieldList[f].scale = PETSC_NULL;
+
+  ierr = PetscPrintf(PETSC_COMM_WORLD, "done.\n"); CHKERRQ(ierr);
+
+  PetscFunctionReturn(0);
+} // initialize
+
+
+/*!
+ * \brief Computes the interpolation weights of a probe, keeping those of the
+ *        stations owned by the process.
+ *
+ * \param probe The probe (with its fields)
+ * \param points Coordinates of its points, one point after the other
+ */
+PetscErrorCode Probes::addContributions(Probe &probe, const std::vector<PetscReal> &points)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  PetscInt numPoints = points.size()/dimension,
+           numFields = probe.fields.size();
+  probe.numValues = numPoints*numFields;
+  for (PetscInt f=0; f<numFields; f++)
+  {
+    Field &field = fieldList[probe.fields[f]];
+    PetscInt start[3] = {0, 0, 0},
+             size[3] = {1, 1, 1};
+    ierr = DMDAGetCorners(field.da, &start[0], &start[1], &start[2], &size[0], &size[1], &size[2]); CHKERRQ(ierr);
+    const PetscScalar *scale = NULL;
+    if (field.scale)
+    {
+      ierr = VecGetArrayRead(field.scale, &scale); CHKERRQ(ierr);
+    }
+    for (PetscInt p=0; p<numPoints; p++)
+    {
+      PetscInt lower[3] = {0, 0, 0};
+      PetscReal upperWeights[3] = {0.0, 0.0, 0.0};
+      for (PetscInt d=0; d<dimension; d++)
+        locate(field.stations[d], points[p*dimension+d], lower[d], upperWeights[d]);
+      // corners of the cell that holds the point
+      for (PetscInt c=0; c<(1<<dimension); c++)
+      {
+        PetscInt index[3] = {0, 0, 0};
+        PetscReal weight = 1.0;
+        PetscBool owned = PETSC_TRUE;
+        for (PetscInt d=0; d<dimension; d++)
+        {
+          PetscInt upper = (c >> d) & 1;
+          index[d] = lower[d] + upper;
+          weight *= (upper) ? upperWeights[d] : 1.0-upperWeights[d];
+          if (index[d] < start[d] || index[d] >= start[d]+size[d])
+            owned = PETSC_FALSE;
+        }
+        if (weight == 0.0 || !owned)
+          continue;
+        PetscInt offset = ((index[2]-start[2])*size[1] + index[1]-start[1])*size[0] + index[0]-start[0];
+        probe.entries.push_back(probe.fields[f]);
+        probe.offsets.push_back(offset);
+        probe.targets.push_back(p*numFields + f);
+        probe.weights.push_back((scale) ? weight*scale[offset] : weight);
+      }
+    }
+    if (field.scale)
+    {
+      ierr = VecRestoreArrayRead(field.scale, &scale); CHKERRQ(ierr);
+    }
+  }
+
+  PetscFunctionReturn(0);
+} // addContributions
+
+
+/*!
+ * \brief Does a probe sample the fields at a time step?
+ */
+PetscBool Probes::isSampling(PetscInt timeStep)
+{
+  if (!active)
+    return PETSC_FALSE;
+  for (size_t i=0; i<probes.size(); i++)
+  {
+    if (timeStep%probes[i].interval == 0)
+      return PETSC_TRUE;
+  }
+  return PETSC_FALSE;
+} // isSampling
+
+
+/*!
+ * \brief Adds the contributions of the process to the samples of the probes
+ *        at a time step; the samples of a probe are summed and written every
+ *        `flushInterval` samples. Collective.
+ *
+ * \param timeStep The time step
+ * \param time The time
+ * \param vecs Global vectors of the fields, in the order of registration
+ */
+PetscErrorCode Probes::sample(PetscInt timeStep, PetscReal time, const std::vector<Vec> &vecs)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  if (!isSampling(timeStep))
+    PetscFunctionReturn(0);
+
+  ierr = PetscLogEventBegin(eventSample, 0, 0, 0, 0); CHKERRQ(ierr);
+  std::vector<const PetscScalar*> arrays(fieldList.size(), NULL);
+  for (size_t f=0; f<fieldList.size(); f++)
+  {
+    ierr = VecGetArrayRead(vecs[f], &arrays[f]); CHKERRQ(ierr);
+  }
+  for (size_t i=0; i<probes.size(); i++)
+  {
+    Probe &probe = probes[i];
+    if (timeStep%probe.interval != 0)
+      continue;
+    size_t first = probe.sums.size();
+    probe.sums.resize(first + probe.numValues, 0.0);
+    PetscReal *sums = &probe.sums[first];
+    for (size_t e=0; e<probe.weights.size(); e++)
+      sums[probe.targets[e]] += probe.weights[e]*arrays[probe.entries[e]][probe.offsets[e]];
+    probe.steps.push_back(timeStep);
+    probe.times.push_back(time);
+  }
+  for (size_t f=0; f<fieldList.size(); f++)
+  {
+    ierr = VecRestoreArrayRead(vecs[f], &arrays[f]); CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(eventSample, 0, 0, 0, 0); CHKERRQ(ierr);
+
+  for (size_t i=0; i<probes.size(); i++)
+  {
+    if ((PetscInt) probes[i].steps.size() >= flushInterval)
+    {
+      ierr = reduce(probes[i]); CHKERRQ(ierr);
+    }
+  }
+
+  PetscFunctionReturn(0);
+} // sample
+
+
+/*!
+ * \brief Sums the buffered samples of a probe on process 0 (one reduction)
+ *        and appends them to its file. Collective.
+ */
+PetscErrorCode Probes::reduce(Probe &probe)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  if (probe.steps.empty())
+    PetscFunctionReturn(0);
+
+  ierr = PetscLogEventBegin(eventSample, 0, 0, 0, 0); CHKERRQ(ierr);
+  PetscMPIInt rank;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+  std::vector<PetscReal> values(probe.sums.size());
+  ierr = MPI_Reduce(&probe.sums[0], &values[0], probe.sums.size(), MPIU_REAL, MPIU_SUM, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+  if (rank == 0)
+  {
+    for (size_t s=0; s<probe.steps.size(); s++)
+    {
+      probe.series->set(0, probe.steps[s]);
+      probe.series->set(1, probe.times[s]);
+      for (PetscInt v=0; v<probe.numValues; v++)
+        probe.series->set(2+v, values[s*probe.numValues+v]);
+      ierr = probe.series->record(); CHKERRQ(ierr);
+    }
+    ierr = probe.series->flush(); CHKERRQ(ierr);
+  }
+  probe.steps.clear();
+  probe.times.clear();
+  probe.sums.clear();
+  ierr = PetscLogEventEnd(eventSample, 0, 0, 0, 0); CHKERRQ(ierr);
+
+  PetscFunctionReturn(0);
+} // reduce
+
+
+/*!
+ * \brief Sums the buffered samples of all probes on process 0 and writes
+ *        them. Collective.
+ */
+PetscErrorCode Probes::flush()
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  for (size_t i=0; i<probes.size(); i++)
+  {
+    ierr = reduce(probes[i]); CHKERRQ(ierr);
+  }
+
+  PetscFunctionReturn(0);
+} // flush
@@ -0,0 +1,98 @@
+/*! Definition of the class `Probes`.
+ * \file Probes.h
+ */
+
+
+#if !defined(PROBES_H)
+#define PROBES_H
+
+#include "TimeSeries.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <petscdmda.h>
+#include <petsclog.h>
+#include <petscvec.h>
+
+
+/**
+ * \class Probes
+ * \brief Samples fields at points, along lines and over planes every few time
+ *        steps, into one CSV time series per probe.
+ *
+ * The probes are read from a YAML file (`probes.yaml`); each one samples some
+ * of the fields registered with `addField` (DMDA vectors whose stations are
+ * known) every `nsample` time steps. The value at a point is interpolated
+ * (multi-linear) from the stations that surround it; the weights are computed
+ * once, and each process keeps only those of the stations it owns, so that a
+ * sample is the sum of the contributions of the processes, read from the
+ * arrays of the global vectors without ghost exchange. The contributions are
+ * buffered and summed on process 0 once every `nflush` samples of a probe (a
+ * single reduction per block of samples), then appended to the file
+ * `probes/<name>.csv` of the probe (class `TimeSeries`).
+ */
+class Probes
+{
+public:
+  // constructors
+  Probes();
+  // destructor
+  ~Probes();
+
+  // register a field that can be sampled
+  PetscErrorCode addField(std::string name, std::string group, DM da,
+                          const std::vector<PetscReal> (&stations)[3], Vec scale);
+  // read the probes and compute their interpolation weights
+  PetscErrorCode initialize(std::string filePath, std::string directory,
+                            PetscInt startStep, PetscInt interval);
+  // does a probe sample the fields at a time step?
+  PetscBool isSampling(PetscInt timeStep);
+  // add the contributions of the process to the samples of a time step
+  PetscErrorCode sample(PetscInt timeStep, PetscReal time, const std::vector<Vec> &vecs);
+  // sum the buffered samples on process 0 and write them
+  PetscErrorCode flush();
+
+private:
+  /// field that can be sampled
+  struct Field
+  {
+    std::string name,                  ///< name of the field (column prefix)
+                group;                 ///< group of fields (`velocity`, `pressure`)
+    DM da;                             ///< DMDA of the field
+    std::vector<PetscReal> stations[3]; ///< stations along x, y and z
+    Vec scale;                         ///< factor applied to the values (NULL: none, or after `initialize`)
+  };
+  /// probe and its buffered samples
+  struct Probe
+  {
+    std::string name;                  ///< name of the probe (and of its file)
+    PetscInt interval;                 ///< number of time steps between samples
+    std::vector<PetscInt> fields;      ///< fields sampled
+    PetscInt numValues;                ///< number of values of a sample
+    std::vector<PetscInt> entries,     ///< field of each contribution
+                          offsets,     ///< its index in the array of the field
+                          targets;     ///< index of the value it contributes to
+    std::vector<PetscReal> weights;    ///< its interpolation weight
+    std::vector<PetscInt> steps;       ///< time steps of the buffered samples
+    std::vector<PetscReal> times,      ///< times of the buffered samples
+                           sums;       ///< contributions of the process, by sample
+    std::unique_ptr<TimeSeries> series; ///< CSV time series of the probe
+  };
+
+  PetscBool active;                 ///< are there probes?
+  PetscInt dimension;               ///< number of dimensions of the fields
+  PetscInt flushInterval;           ///< number of samples per reduction
+  std::vector<Field> fieldList;     ///< fields that can be sampled
+  std::vector<Probe> probes;        ///< probes
+  PetscLogEvent eventSample;        ///< sampling and reductions
+
+  // compute the interpolation weights of the points owned by the process
+  PetscErrorCode addContributions(Probe &probe, const std::vector<PetscReal> &points);
+  // sum the buffered samples of a probe on process 0 and write them
+  PetscErrorCode reduce(Probe &probe);
+
+}; // Probes
+
+#endif
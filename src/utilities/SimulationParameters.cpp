@@ -12,6 +12,24 @@
 #include "yaml-cpp/yaml.h"
 
 
+/**
+ * \brief Parses the error bound of a field: `{absolute: <value>}` or
+ *        `{relative: <value>}` (relative to the maximum absolute value).
+ */
+static SimulationParameters::OutputCompression::Tolerance parseTolerance(const YAML::Node &node)
+{
+  SimulationParameters::OutputCompression::Tolerance tolerance = {0.0, PETSC_FALSE};
+  if (node["relative"])
+  {
+    tolerance.value = node["relative"].as<PetscReal>();
+    tolerance.relative = PETSC_TRUE;
+  }
+  else if (node["absolute"])
+    tolerance.value = node["absolute"].as<PetscReal>();
+  return tolerance;
+} // parseTolerance
+
+
 /**
  * \brief Constructor.
  */
@@ -67,10 +85,33 @@ void SimulationParameters::initialize(std::string filePath)
   nt = node["nt"].as<PetscInt>();
   nsave = node["nsave"].as<PetscInt>(nt);
   nrestart = node["nrestart"].as<PetscInt>(nt);
+  nflush = node["nflush"].as<PetscInt>(100);
   
   vSolveType = stringToExecuteType(node["vSolveType"].as<std::string>("CPU"));
   pSolveType = stringToExecuteType(node["pSolveType"].as<std::string>("CPU"));
 
+  vMatrixFree = (node["vMatrixFree"].as<bool>(false)) ? PETSC_TRUE : PETSC_FALSE;
+  if (vMatrixFree && vSolveType == GPU)
+  {
+    PetscPrintf(PETSC_COMM_WORLD,
+                "\nERROR: the GPU velocity solver requires an assembled matrix; "
+                "you cannot use `vMatrixFree: true` with `vSolveType: GPU`\n");
+    MPI_Barrier(PETSC_COMM_WORLD);
+    exit(1);
+  }
+
+  vComponentSolve = stringToComponentSolve(node["vComponentSolve"].as<std::string>("MONOLITHIC"));
+  if (vComponentSolve != MONOLITHIC && (vMatrixFree || vSolveType == GPU))
+  {
+    PetscPrintf(PETSC_COMM_WORLD,
+                "\nERROR: solving the velocity components separately requires "
+                "an assembled matrix and PETSc KSPs; you cannot use `vComponentSolve: %s` "
+                "with `vMatrixFree: true` or `vSolveType: GPU`\n",
+                node["vComponentSolve"].as<std::string>().c_str());
+    MPI_Barrier(PETSC_COMM_WORLD);
+    exit(1);
+  }
+
   outputFormat = node["outputFormat"].as<std::string>("binary");
 #ifndef PETSC_HAVE_HDF5
   if (outputFormat == "hdf5")
@@ -84,9 +125,119 @@ void SimulationParameters::initialize(std::string filePath)
 #endif
   outputFlux = (node["outputFlux"].as<bool>(true)) ? PETSC_TRUE : PETSC_FALSE;
   outputVelocity = (node["outputVelocity"].as<bool>(false)) ? PETSC_TRUE : PETSC_FALSE;
+  outputSingleFile = (node["outputSingleFile"].as<bool>(false)) ? PETSC_TRUE : PETSC_FALSE;
+  if (outputSingleFile && outputFormat != "hdf5")
+  {
+    PetscPrintf(PETSC_COMM_WORLD,
+                "\nERROR: `outputSingleFile: true` requires `outputFormat: hdf5`\n");
+    MPI_Barrier(PETSC_COMM_WORLD);
+    exit(1);
+  }
+  outputAsync = (node["outputAsync"].as<bool>(false)) ? PETSC_TRUE : PETSC_FALSE;
+  if (outputAsync && outputFormat != "binary")
+  {
+    PetscPrintf(PETSC_COMM_WORLD,
+                "\nERROR: `outputAsync: true` requires `outputFormat: binary`\n");
+    MPI_Barrier(PETSC_COMM_WORLD);
+    exit(1);
+  }
+  outputAsyncBuffers = node["outputAsyncBuffers"].as<PetscInt>(2);
+
+  // compression of the fields written in HDF5 files
+  const SimulationParameters::OutputCompression::Tolerance lossless = {0.0, PETSC_FALSE};
+  outputCompression.type = "none";
+  outputCompression.level = 1;
+  outputCompression.visualization = lossless;
+  outputCompression.restart = lossless;
+  const char *restartFields[] = {"qx", "qy", "qz", "Hx", "Hy", "Hz", "phi", "fTilde"};
+  outputCompression.restartFields.insert(restartFields, restartFields+8);
+  if (!outputFlux)
+  {
+    // the velocities are read at restart instead of the fluxes
+    const char *velocities[] = {"ux", "uy", "uz"};
+    outputCompression.restartFields.insert(velocities, velocities+3);
+  }
+  if (node["outputCompression"])
+  {
+    const YAML::Node &compression = node["outputCompression"];
+    outputCompression.type = compression["type"].as<std::string>("lossless");
+    outputCompression.level = compression["level"].as<PetscInt>(1);
+    if (outputCompression.type != "none" && outputCompression.type != "lossless" && outputCompression.type != "lossy")
+    {
+      PetscPrintf(PETSC_COMM_WORLD,
+                  "\nERROR: unknown type of compression `%s` (`none`, `lossless` or `lossy`)\n",
+                  outputCompression.type.c_str());
+      MPI_Barrier(PETSC_COMM_WORLD);
+      exit(1);
+    }
+    if (outputCompression.type != "none" && outputFormat != "hdf5")
+    {
+      PetscPrintf(PETSC_COMM_WORLD,
+                  "\nERROR: `outputCompression` requires `outputFormat: hdf5`\n");
+      MPI_Barrier(PETSC_COMM_WORLD);
+      exit(1);
+    }
+    if (outputCompression.type == "lossy")
+    {
+      if (compression["visualization"])
+        outputCompression.visualization = parseTolerance(compression["visualization"]);
+      if (compression["restart"])
+        outputCompression.restart = parseTolerance(compression["restart"]);
+      if (compression["fields"])
+      {
+        const YAML::Node &fields = compression["fields"];
+        for (YAML::const_iterator it=fields.begin(); it!=fields.end(); it++)
+          outputCompression.fields[it->first.as<std::string>()] = parseTolerance(it->second);
+      }
+    }
+  }
 
   ibm = stringToIBMethod(node["ibm"].as<std::string>("NONE"));
 
+  if (vSolveType == FFT)
+  {
+    PetscPrintf(PETSC_COMM_WORLD,
+                "\nERROR: the FFT solver only applies to the Poisson system; "
+                "you cannot use `vSolveType: FFT`\n");
+    MPI_Barrier(PETSC_COMM_WORLD);
+    exit(1);
+  }
+  if (vSolveType == MIXED)
+  {
+    PetscPrintf(PETSC_COMM_WORLD,
+                "\nERROR: the mixed-precision solver only applies to the Poisson system; "
+                "you cannot use `vSolveType: MIXED`\n");
+    MPI_Barrier(PETSC_COMM_WORLD);
+    exit(1);
+  }
+  if (vSolveType == AGGLOMERATED)
+  {
+    PetscPrintf(PETSC_COMM_WORLD,
+                "\nERROR: the agglomerated solver only applies to the Poisson system; "
+                "you cannot use `vSolveType: AGGLOMERATED`\n");
+    MPI_Barrier(PETSC_COMM_WORLD);
+    exit(1);
+  }
+  if (pSolveType == FFT && ibm != NAVIER_STOKES)
+  {
+    PetscPrintf(PETSC_COMM_WORLD,
+                "\nERROR: the FFT solver only handles the pressure system "
+                "without immersed boundary; you cannot use `pSolveType: FFT` with `ibm: %s`\n",
+                node["ibm"].as<std::string>().c_str());
+    MPI_Barrier(PETSC_COMM_WORLD);
+    exit(1);
+  }
+#ifndef PETSC_HAVE_FFTW
+  if (pSolveType == FFT)
+  {
+    PetscPrintf(PETSC_COMM_WORLD,
+                "\nERROR: PETSc has not been built with FFTW available; "
+                "you cannot use `pSolveType: FFT`\n");
+    MPI_Barrier(PETSC_COMM_WORLD);
+    exit(1);
+  }
+#endif
+
   convection.scheme = stringToTimeScheme(node["convection"].as<std::string>("EULER_EXPLICIT"));
   diffusion.scheme = stringToTimeScheme(node["diffusion"].as<std::string>("EULER_IMPLICIT"));
   // set time-stepping coefficients for convective terms
@@ -187,12 +338,56 @@ PetscErrorCode SimulationParameters::printInfo()
   ierr = PetscPrintf(PETSC_COMM_WORLD, "number of time-steps: %d\n", nt); CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD, "saving-interval: %d\n", nsave); CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD, "restart-interval: %d\n", nrestart); CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD, "time-series writing interval: %d\n", nflush); CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD, "velocity solver type: %s\n", stringFromExecuteType(vSolveType).c_str()); CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD, "Poisson solver type: %s\n", stringFromExecuteType(pSolveType).c_str()); CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD, "matrix-free velocity operator: %D\n", vMatrixFree); CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD, "velocity components: %s\n", stringFromComponentSolve(vComponentSolve).c_str()); CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD, "output format: %s\n", outputFormat.c_str()); CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD, "output flux: %D\n", outputFlux); CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD, "output velocity: %D\n", outputVelocity); CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD, "output single file: %D\n", outputSingleFile); CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD, "output async: %D\n", outputAsync); CHKERRQ(ierr);
+  if (outputAsync)
+  {
+    ierr = PetscPrintf(PETSC_COMM_WORLD, "output async buffers: %D\n", outputAsyncBuffers); CHKERRQ(ierr);
+  }
+  ierr = PetscPrintf(PETSC_COMM_WORLD, "output compression: %s\n", outputCompression.type.c_str()); CHKERRQ(ierr);
+  if (outputCompression.type == "lossy")
+  {
+    ierr = PetscPrintf(PETSC_COMM_WORLD, "output compression tolerance: %g (%s), restart: %g (%s)\n",
+                       outputCompression.visualization.value,
+                       (outputCompression.visualization.relative) ? "relative" : "absolute",
+                       outputCompression.restart.value,
+                       (outputCompression.restart.relative) ? "relative" : "absolute"); CHKERRQ(ierr);
+  }
   ierr = PetscPrintf(PETSC_COMM_WORLD, "---------------------------------------\n"); CHKERRQ(ierr);
 
   return 0;
-} // printInfo
\ No newline at end of file
+} // printInfo
+
+
+/**
+ * \brief Gets the error bound of a field.
+ *
+ * At restart time-steps, the fields read at restart have the tolerance
+ * `restart`; the others have their own tolerance or `visualization`.
+ * Without lossy compression, the tolerance is zero.
+ *
+ * \param name Name of the field
+ * \param isRestartStep Is the field written at a restart time-step?
+ */
+SimulationParameters::OutputCompression::Tolerance SimulationParameters::OutputCompression::getTolerance(std::string name, PetscBool isRestartStep)
+{
+  if (type != "lossy")
+  {
+    Tolerance lossless = {0.0, PETSC_FALSE};
+    return lossless;
+  }
+  if (isRestartStep && restartFields.count(name) > 0)
+    return restart;
+  std::map<std::string, Tolerance>::iterator it = fields.find(name);
+  if (it != fields.end())
+    return it->second;
+  return visualization;
+} // getTolerance
@@ -11,6 +11,8 @@
 #include "types.h"
 
 #include <iostream>
+#include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -35,6 +37,32 @@ public:
     std::vector<PetscReal> coefficients; ///< coefficients of integration
   }; // TimeIntegration
 
+  /**
+   * \class OutputCompression
+   * \brief Stores the compression of the fields written in HDF5 files.
+   */
+  class OutputCompression
+  {
+  public:
+    /**
+     * \struct Tolerance
+     * \brief Error bound of the lossy compression of a field.
+     */
+    struct Tolerance
+    {
+      PetscReal value;    ///< bound of the error (0: lossless)
+      PetscBool relative; ///< is the bound relative to the maximum absolute value of the field?
+    };
+    std::string type; ///< `none`, `lossless` or `lossy`
+    PetscInt level;   ///< level of the deflate filter
+    Tolerance visualization, ///< tolerance of the fields
+              restart;       ///< tolerance of the fields read at restart, at restart time-steps
+    std::map<std::string, Tolerance> fields; ///< tolerances of some fields (instead of `visualization`)
+    std::set<std::string> restartFields;     ///< fields read at restart
+    // get the tolerance of a field
+    Tolerance getTolerance(std::string name, PetscBool isRestartStep);
+  }; // OutputCompression
+
   std::string directory; ///< directory of the simulation
 
   PetscReal dt; ///< time-increment
@@ -42,11 +70,16 @@ public:
   PetscInt startStep, ///< initial time-step 
            nt,        ///< number of time steps
            nsave,     ///< data-saving interval
-           nrestart;  ///< data-saving interval for the convective terms
+           nrestart,  ///< data-saving interval for the convective terms
+           nflush;    ///< writing interval of the time series
   
   std::string outputFormat;  ///< output format to use
   PetscBool outputFlux,     ///< boolean to output the flux components
-            outputVelocity; ///< boolean to output the velocity components
+            outputVelocity, ///< boolean to output the velocity components
+            outputSingleFile, ///< boolean to write the fields of a time step into one HDF5 file
+            outputAsync;    ///< boolean to write the fields from a background thread
+  PetscInt outputAsyncBuffers; ///< number of time steps staged for the background thread
+  OutputCompression outputCompression; ///< compression of the HDF5 output
 
   IBMethod ibm; ///< type of system to be solved
   
@@ -64,6 +97,10 @@ public:
   ExecuteType vSolveType, ///< hardware to use for the velocity solver
               pSolveType; ///< hardware to use for the Poisson solver
 
+  PetscBool vMatrixFree; ///< boolean to apply the velocity operator matrix-free
+
+  ComponentSolve vComponentSolve; ///< solve the velocity components as one or several systems
+
   // constructors
   SimulationParameters();
   SimulationParameters(std::string dir, std::string filePath);
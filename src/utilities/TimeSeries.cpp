@@ -0,0 +1,280 @@
+/*! Implementation of the methods of the class `TimeSeries`.
+ * \file TimeSeries.cpp
+ */
+
+
+#include "TimeSeries.h"
+
+#include <cstdio>
+#include <fstream>
+#include <set>
+
+
+// time series flushed when PETSc finalizes (also on early exits)
+static std::set<TimeSeries*> openTimeSeries;
+
+
+/*!
+ * \brief Writes the buffered records of all time series.
+ */
+static PetscErrorCode flushOpenTimeSeries()
+{
+  PetscErrorCode ierr;
+
+  for (std::set<TimeSeries*>::iterator it=openTimeSeries.begin(); it!=openTimeSeries.end(); it++)
+  {
+    ierr = (*it)->flush(); CHKERRQ(ierr);
+  }
+  openTimeSeries.clear();
+
+  return 0;
+} // flushOpenTimeSeries
+
+
+/*!
+ * \brief Constructor.
+ */
+TimeSeries::TimeSeries()
+{
+  rank = 0;
+  logStages = PETSC_FALSE;
+  headerWritten = PETSC_FALSE;
+  flushInterval = 1;
+  numBuffered = 0;
+} // TimeSeries
+
+
+/*!
+ * \brief Destructor -- the records still in the buffer are lost
+ *        (`flush` should be called before).
+ */
+TimeSeries::~TimeSeries()
+{
+  openTimeSeries.erase(this);
+} // ~TimeSeries
+
+
+/*!
+ * \brief Sets the file and the number of records per write.
+ *
+ * \param path Path of the CSV file
+ * \param append Append the records to an existing file (restart), without header line
+ * \param interval Number of records buffered before being written
+ */
+PetscErrorCode TimeSeries::initialize(std::string path, PetscBool append, PetscInt interval)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+  filePath = path;
+  headerWritten = append;
+  flushInterval = (interval > 0) ? interval : 1;
+  if (rank == 0 && !append)
+  {
+    std::ofstream file(filePath.c_str());
+  }
+  ierr = PetscOptionsHasName(NULL, NULL, "-log_stage_times", &logStages); CHKERRQ(ierr);
+  if (openTimeSeries.empty())
+  {
+    ierr = PetscRegisterFinalize(flushOpenTimeSeries); CHKERRQ(ierr);
+  }
+  openTimeSeries.insert(this);
+
+  PetscFunctionReturn(0);
+} // initialize
+
+
+/*!
+ * \brief Adds a column and returns its index.
+ *
+ * \param name Name of the column in the header line
+ */
+PetscInt TimeSeries::addColumn(std::string name)
+{
+  names.push_back(name);
+  values.push_back(0.0);
+  return names.size()-1;
+} // addColumn
+
+
+/*!
+ * \brief Adds a column with the wall-time (in seconds, maximum over the
+ *        processes) spent in a log stage since the previous record.
+ *
+ * The column is added only when the option `-log_stage_times` is given; the
+ * default PETSc logging, which collects the stage times, is then started if
+ * it is not already.
+ *
+ * \param name Name of the column in the header line
+ * \param stage Log stage
+ */
+PetscErrorCode TimeSeries::addStage(std::string name, PetscLogStage stage)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  if (!logStages)
+    PetscFunctionReturn(0);
+
+#if defined(PETSC_USE_LOG)
+  if (!PetscLogPLB)
+  {
+    ierr = PetscLogDefaultBegin(); CHKERRQ(ierr);
+  }
+#endif
+  PetscLogDouble time;
+  ierr = getStageTime(stage, time); CHKERRQ(ierr);
+  stages.push_back(stage);
+  stageColumns.push_back(addColumn(name));
+  stageTimes.push_back(time);
+
+  PetscFunctionReturn(0);
+} // addStage
+
+
+/*!
+ * \brief Adds the columns `<name>Iters` and `<name>Residual` with the
+ *        iteration count and the residual norm of the last solve (and
+ *        `<name>SavedIters` when the solver recycles).
+ *
+ * The solver must be created.
+ * \param name Prefix of the columns
+ * \param solver Iterative solver
+ */
+PetscErrorCode TimeSeries::addSolver(std::string name, Solver *solver)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  PetscInt saved;
+  ierr = solver->getSavedIters(saved); CHKERRQ(ierr);
+  solvers.push_back(solver);
+  solverColumns.push_back(addColumn(name + "Iters"));
+  addColumn(name + "Residual");
+  solverSaved.push_back((saved >= 0) ? PETSC_TRUE : PETSC_FALSE);
+  if (saved >= 0)
+    addColumn(name + "SavedIters");
+
+  PetscFunctionReturn(0);
+} // addSolver
+
+
+/*!
+ * \brief Gets the wall-time spent so far by the process in a stage
+ *        (0 without logging).
+ *
+ * The time of a stage is updated when the stage is popped; the stages should
+ * not be active when a record is completed.
+ */
+PetscErrorCode TimeSeries::getStageTime(PetscLogStage stage, PetscLogDouble &time)
+{
+  PetscFunctionBeginUser;
+
+  time = 0.0;
+#if defined(PETSC_USE_LOG)
+  PetscErrorCode ierr;
+  PetscStageLog stageLog;
+  ierr = PetscLogGetStageLog(&stageLog); CHKERRQ(ierr);
+  time = stageLog->stageInfo[stage].perfInfo.time;
+#endif
+
+  PetscFunctionReturn(0);
+} // getStageTime
+
+
+/*!
+ * \brief Completes the current record; the buffer is written into the file
+ *        every `flushInterval` records.
+ *
+ * Collective when there are stage columns: their wall-times are reduced
+ * (maximum over the processes) on process 0. The values of the columns are
+ * kept for the next record.
+ */
+PetscErrorCode TimeSeries::record()
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  if (!stages.empty())
+  {
+    std::vector<PetscLogDouble> elapsed(stages.size()),
+                                maxElapsed(stages.size());
+    for (size_t i=0; i<stages.size(); i++)
+    {
+      PetscLogDouble time;
+      ierr = getStageTime(stages[i], time); CHKERRQ(ierr);
+      elapsed[i] = time - stageTimes[i];
+      stageTimes[i] = time;
+    }
+    ierr = MPI_Reduce(&elapsed[0], &maxElapsed[0], (PetscMPIInt) stages.size(),
+                      MPI_DOUBLE, MPI_MAX, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+    for (size_t i=0; i<stages.size(); i++)
+      values[stageColumns[i]] = maxElapsed[i];
+  }
+
+  if (rank != 0)
+    PetscFunctionReturn(0);
+
+  for (size_t i=0; i<solvers.size(); i++)
+  {
+    PetscInt iters;
+    PetscReal residual;
+    ierr = solvers[i]->getIters(iters); CHKERRQ(ierr);
+    ierr = solvers[i]->getResidualNorm(residual); CHKERRQ(ierr);
+    values[solverColumns[i]] = iters;
+    values[solverColumns[i]+1] = residual;
+    if (solverSaved[i])
+    {
+      ierr = solvers[i]->getSavedIters(iters); CHKERRQ(ierr);
+      values[solverColumns[i]+2] = iters;
+    }
+  }
+
+  char value[32];
+  for (size_t i=0; i<values.size(); i++)
+  {
+    snprintf(value, sizeof(value), (i == 0) ? "%.10g" : ",%.10g", (double) values[i]);
+    buffer += value;
+  }
+  buffer += '\n';
+  numBuffered++;
+
+  if (numBuffered >= flushInterval)
+  {
+    ierr = flush(); CHKERRQ(ierr);
+  }
+
+  PetscFunctionReturn(0);
+} // record
+
+
+/*!
+ * \brief Appends the buffered records to the file.
+ */
+PetscErrorCode TimeSeries::flush()
+{
+  PetscFunctionBeginUser;
+
+  if (rank != 0 || (numBuffered == 0 && headerWritten))
+    PetscFunctionReturn(0);
+
+  std::ofstream file(filePath.c_str(), std::ios::out | std::ios::app);
+  if (!headerWritten)
+  {
+    for (size_t i=0; i<names.size(); i++)
+      file << ((i == 0) ? "" : ",") << names[i];
+    file << '\n';
+    headerWritten = PETSC_TRUE;
+  }
+  file << buffer;
+  file.close();
+  buffer.clear();
+  numBuffered = 0;
+
+  PetscFunctionReturn(0);
+} // flush
@@ -0,0 +1,75 @@
+/*! Definition of the class `TimeSeries`.
+ * \file TimeSeries.h
+ */
+
+
+#if !defined(TIME_SERIES_H)
+#define TIME_SERIES_H
+
+#include "solvers/solver.h"
+
+#include <string>
+#include <vector>
+
+#include <petscsys.h>
+#include <petsclog.h>
+
+
+/**
+ * \class TimeSeries
+ * \brief Buffered writer of the quantities monitored at each time step.
+ *
+ * The columns (scalar quantities, wall-times of log stages and statistics of
+ * iterative solvers) are added before the first record; the wall-times of the
+ * stages are recorded only with the option `-log_stage_times`. Each record appends
+ * one line to a buffer held by process 0; the buffer is appended to a CSV file
+ * (with a header line) every `flushInterval` records, when `flush` is called
+ * and when PETSc finalizes, so that the file is opened once per block of time
+ * steps.
+ */
+class TimeSeries
+{
+public:
+  // constructors
+  TimeSeries();
+  // destructor
+  ~TimeSeries();
+
+  // set the file and the number of records per write
+  PetscErrorCode initialize(std::string filePath, PetscBool append, PetscInt interval);
+  // add a column, returns its index
+  PetscInt addColumn(std::string name);
+  // add a column with the wall-time spent in a log stage since the previous record
+  PetscErrorCode addStage(std::string name, PetscLogStage stage);
+  // add the columns with the iteration count and the residual of a solver
+  PetscErrorCode addSolver(std::string name, Solver *solver);
+  // set the value of a column for the current record
+  void set(PetscInt column, PetscReal value) { values[column] = value; };
+  // complete the current record (collective with stage columns)
+  PetscErrorCode record();
+  // write the buffered records into the file
+  PetscErrorCode flush();
+
+private:
+  std::string filePath;             ///< path of the CSV file
+  PetscMPIInt rank;                 ///< rank of the process (only process 0 writes)
+  PetscBool logStages;              ///< record the wall-times of the stages?
+  PetscBool headerWritten;          ///< was the header line written?
+  PetscInt flushInterval,           ///< number of records per write
+           numBuffered;             ///< number of records in the buffer
+  std::vector<std::string> names;   ///< names of the columns
+  std::vector<PetscReal> values;    ///< values of the current record
+  std::vector<PetscLogStage> stages;      ///< stages with a wall-time column
+  std::vector<PetscInt> stageColumns;     ///< column of each stage
+  std::vector<PetscLogDouble> stageTimes; ///< wall-time of each stage at the previous record
+  std::vector<Solver*> solvers;     ///< solvers with columns
+  std::vector<PetscInt> solverColumns;    ///< first column of each solver
+  std::vector<PetscBool> solverSaved;     ///< does the solver report saved iterations?
+  std::string buffer;               ///< records not yet written
+
+  // get the wall-time spent so far in a stage
+  PetscErrorCode getStageTime(PetscLogStage stage, PetscLogDouble &time);
+
+}; // TimeSeries
+
+#endif
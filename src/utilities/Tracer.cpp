@@ -0,0 +1,409 @@
+/*! Implementation of the methods of the class `Tracer`.
+ * \file Tracer.cpp
+ */
+
+
+#include "Tracer.h"
+
+#include <cstdio>
+
+#include <petsctime.h>
+
+
+#if defined(PETSC_USE_LOG)
+// tracer receiving the events, and handlers of the PETSc log it chains to
+static Tracer *activeTracer = NULL;
+static PetscErrorCode (*previousEventBegin)(PetscLogEvent, int, PetscObject, PetscObject, PetscObject, PetscObject) = NULL;
+static PetscErrorCode (*previousEventEnd)(PetscLogEvent, int, PetscObject, PetscObject, PetscObject, PetscObject) = NULL;
+
+
+/*!
+ * \brief Handler of the beginning of an event: calls the previous handler,
+ *        then records the time.
+ */
+static PetscErrorCode traceEventBegin(PetscLogEvent event, int t,
+                                      PetscObject o1, PetscObject o2, PetscObject o3, PetscObject o4)
+{
+  PetscErrorCode ierr;
+
+  if (previousEventBegin)
+  {
+    ierr = (*previousEventBegin)(event, t, o1, o2, o3, o4); CHKERRQ(ierr);
+  }
+  PetscLogDouble time;
+  ierr = PetscTime(&time); CHKERRQ(ierr);
+  activeTracer->beginEvent(event, time);
+
+  return 0;
+} // traceEventBegin
+
+
+/*!
+ * \brief Handler of the end of an event: records the time,
+ *        then calls the previous handler.
+ */
+static PetscErrorCode traceEventEnd(PetscLogEvent event, int t,
+                                    PetscObject o1, PetscObject o2, PetscObject o3, PetscObject o4)
+{
+  PetscErrorCode ierr;
+
+  PetscLogDouble time;
+  ierr = PetscTime(&time); CHKERRQ(ierr);
+  ierr = activeTracer->endEvent(event, time); CHKERRQ(ierr);
+  if (previousEventEnd)
+  {
+    ierr = (*previousEventEnd)(event, t, o1, o2, o3, o4); CHKERRQ(ierr);
+  }
+
+  return 0;
+} // traceEventEnd
+#endif
+
+
+/*!
+ * \brief Constructor -- tracing is disabled until `initialize` is called.
+ */
+Tracer::Tracer()
+{
+  active = PETSC_FALSE;
+  origin = 0.0;
+  capacity = 0;
+  head = 0;
+  numRecorded = 0;
+} // Tracer
+
+
+/*!
+ * \brief Destructor -- gives the events back to the previous handlers.
+ */
+Tracer::~Tracer()
+{
+#if defined(PETSC_USE_LOG)
+  if (activeTracer == this)
+  {
+    PetscLogSet(previousEventBegin, previousEventEnd);
+    activeTracer = NULL;
+  }
+#endif
+} // ~Tracer
+
+
+/*!
+ * \brief Reads the options `-timeline` and `-timeline_size` and, if tracing is
+ *        enabled, installs the event handlers and sets the origin of the times.
+ *
+ * Collective: all processes synchronize on a barrier.
+ *
+ * \param directory Directory of the simulation (location of the default file `timeline.json`)
+ */
+PetscErrorCode Tracer::initialize(std::string directory)
+{
+  PetscErrorCode ierr;
+
+  char path[PETSC_MAX_PATH_LEN] = "";
+  ierr = PetscOptionsGetString(NULL, NULL, "-timeline", path, sizeof(path), &active); CHKERRQ(ierr);
+  if (!active)
+    return 0;
+  filePath = (path[0] != '\0') ? std::string(path) : directory + "/timeline.json";
+
+  PetscInt size = 100000;
+  ierr = PetscOptionsGetInt(NULL, NULL, "-timeline_size", &size, NULL); CHKERRQ(ierr);
+  if (size <= 0)
+  {
+    SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_ARG_OUTOFRANGE, "-timeline_size should be positive");
+  }
+  capacity = size;
+  intervals.resize(4*capacity);
+
+#if defined(PETSC_USE_LOG)
+  if (activeTracer)
+  {
+    SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_ARG_WRONGSTATE, "A timeline is already being traced");
+  }
+  activeTracer = this;
+  // the default log (installed if no log is running) keeps collecting the
+  // events behind the tracer, for the stage times and -log_kernels
+  if (!PetscLogPLB)
+  {
+    ierr = PetscLogDefaultBegin(); CHKERRQ(ierr);
+  }
+  previousEventBegin = PetscLogPLB;
+  previousEventEnd = PetscLogPLE;
+  ierr = PetscLogSet(traceEventBegin, traceEventEnd); CHKERRQ(ierr);
+#endif
+
+  ierr = MPI_Barrier(PETSC_COMM_WORLD); CHKERRQ(ierr);
+  ierr = PetscTime(&origin); CHKERRQ(ierr);
+
+  return 0;
+} // initialize
+
+
+/*!
+ * \brief Pushes a log stage and records the time it begins.
+ */
+PetscErrorCode Tracer::pushStage(PetscLogStage stage)
+{
+  PetscErrorCode ierr;
+
+  ierr = PetscLogStagePush(stage); CHKERRQ(ierr);
+  if (active)
+  {
+    PetscLogDouble time;
+    ierr = PetscTime(&time); CHKERRQ(ierr);
+    openStages.push_back(std::make_pair(stage, time));
+  }
+
+  return 0;
+} // pushStage
+
+
+/*!
+ * \brief Records the interval of the current log stage and pops it.
+ */
+PetscErrorCode Tracer::popStage()
+{
+  PetscErrorCode ierr;
+
+  if (active && !openStages.empty())
+  {
+    PetscLogDouble time;
+    ierr = PetscTime(&time); CHKERRQ(ierr);
+    record(STAGE, openStages.back().first, openStages.back().second, time);
+    openStages.pop_back();
+  }
+  ierr = PetscLogStagePop(); CHKERRQ(ierr);
+
+  return 0;
+} // popStage
+
+
+/*!
+ * \brief Records the time an event begins.
+ */
+void Tracer::beginEvent(PetscLogEvent event, PetscLogDouble time)
+{
+  openEvents.push_back(std::make_pair(event, time));
+} // beginEvent
+
+
+/*!
+ * \brief Records the interval of an event that ends (the last one begun with
+ *        the same index); an event that was not begun is an error.
+ */
+PetscErrorCode Tracer::endEvent(PetscLogEvent event, PetscLogDouble time)
+{
+  for (size_t i=openEvents.size(); i>0; i--)
+  {
+    if (openEvents[i-1].first == event)
+    {
+      record(EVENT, event, openEvents[i-1].second, time);
+      openEvents.erase(openEvents.begin()+(i-1));
+      return 0;
+    }
+  }
+  SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_PLIB, "The log event %d ends but was not begun", (int) event);
+} // endEvent
+
+
+/*!
+ * \brief Adds an interval to the ring buffer (over the oldest one when the
+ *        buffer is full) and its duration to the time of the stage or event.
+ */
+void Tracer::record(IntervalKind kind, PetscInt index, PetscLogDouble begin, PetscLogDouble end)
+{
+  std::vector<PetscLogDouble> &times = (kind == STAGE) ? stageTimes : eventTimes;
+  if ((size_t) index >= times.size())
+    times.resize(index+1, 0.0);
+  times[index] += end - begin;
+
+  PetscLogDouble *interval = &intervals[4*head];
+  interval[0] = kind;
+  interval[1] = index;
+  interval[2] = begin - origin;
+  interval[3] = end - origin;
+  head = (head+1)%capacity;
+  numRecorded++;
+} // record
+
+
+/*!
+ * \brief Writes the timeline of all processes and prints the imbalance of the
+ *        stages and events; the events go back to the previous handlers.
+ *
+ * Collective; does nothing when tracing is disabled.
+ */
+PetscErrorCode Tracer::finalize()
+{
+  PetscErrorCode ierr;
+
+  if (!active)
+    return 0;
+
+#if defined(PETSC_USE_LOG)
+  ierr = PetscLogSet(previousEventBegin, previousEventEnd); CHKERRQ(ierr);
+  activeTracer = NULL;
+#endif
+  active = PETSC_FALSE;
+
+  ierr = writeTimeline(); CHKERRQ(ierr);
+  ierr = viewImbalance(STAGE, stageTimes); CHKERRQ(ierr);
+  ierr = viewImbalance(EVENT, eventTimes); CHKERRQ(ierr);
+
+  return 0;
+} // finalize
+
+
+/*!
+ * \brief Sends the intervals of the ring buffers to process 0, which writes
+ *        them, oldest first, as the complete events of a Chrome trace
+ *        (times in microseconds, stages and events on two tracks of each process).
+ */
+PetscErrorCode Tracer::writeTimeline()
+{
+  PetscErrorCode ierr;
+
+  PetscMPIInt rank, size;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD, &size); CHKERRQ(ierr);
+
+  // intervals in the buffer, oldest first
+  PetscInt numIntervals = (numRecorded < capacity) ? numRecorded : capacity;
+  size_t first = (numRecorded < capacity) ? 0 : head;
+  std::vector<PetscLogDouble> ordered(4*numIntervals);
+  for (PetscInt i=0; i<numIntervals; i++)
+  {
+    for (PetscInt j=0; j<4; j++)
+      ordered[4*i+j] = intervals[4*((first+i)%capacity)+j];
+  }
+
+  PetscInt numDropped = numRecorded - numIntervals;
+  ierr = MPI_Allreduce(MPI_IN_PLACE, &numDropped, 1, MPIU_INT, MPI_SUM, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+  if (rank != 0)
+  {
+    ierr = MPI_Send(&numIntervals, 1, MPIU_INT, 0, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+    ierr = MPI_Send((numIntervals > 0) ? &ordered[0] : NULL, 4*numIntervals,
+                    MPIU_PETSCLOGDOUBLE, 0, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+    return 0;
+  }
+
+  FILE *file = fopen(filePath.c_str(), "w");
+  if (!file)
+  {
+    SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_FILE_OPEN, "Unable to open the file %s", filePath.c_str());
+  }
+  fprintf(file, "{\"displayTimeUnit\": \"ms\",\n\"traceEvents\": [\n");
+  const char *trackNames[2] = {"stages", "events"};
+  for (PetscMPIInt r=0; r<size; r++)
+  {
+    if (r > 0)
+    {
+      ierr = MPI_Recv(&numIntervals, 1, MPIU_INT, r, 0, PETSC_COMM_WORLD, MPI_STATUS_IGNORE); CHKERRQ(ierr);
+      ordered.resize(4*numIntervals);
+      ierr = MPI_Recv((numIntervals > 0) ? &ordered[0] : NULL, 4*numIntervals,
+                      MPIU_PETSCLOGDOUBLE, r, 0, PETSC_COMM_WORLD, MPI_STATUS_IGNORE); CHKERRQ(ierr);
+    }
+    fprintf(file, "%s{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": %d, \"args\": {\"name\": \"rank %d\"}}",
+            (r > 0) ? ",\n" : "", r, r);
+    for (PetscInt track=0; track<2; track++)
+    {
+      fprintf(file, ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": %d, \"tid\": %d, \"args\": {\"name\": \"%s\"}}",
+              r, (int) track, trackNames[track]);
+    }
+    for (PetscInt i=0; i<numIntervals; i++)
+    {
+      const PetscLogDouble *interval = &ordered[4*i];
+      IntervalKind kind = (interval[0] == STAGE) ? STAGE : EVENT;
+      fprintf(file, ",\n{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"pid\": %d, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f}",
+              getName(kind, (PetscInt) interval[1]).c_str(), (kind == STAGE) ? "stage" : "event",
+              r, (int) kind, interval[2]*1.0E+06, (interval[3] - interval[2])*1.0E+06);
+    }
+  }
+  fprintf(file, "\n]}\n");
+  fclose(file);
+
+  ierr = PetscPrintf(PETSC_COMM_SELF, "\nTimeline written in %s", filePath.c_str()); CHKERRQ(ierr);
+  if (numDropped > 0)
+  {
+    ierr = PetscPrintf(PETSC_COMM_SELF, " (%D oldest intervals dropped, see -timeline_size)", numDropped); CHKERRQ(ierr);
+  }
+  ierr = PetscPrintf(PETSC_COMM_SELF, "\n"); CHKERRQ(ierr);
+
+  return 0;
+} // writeTimeline
+
+
+/*!
+ * \brief Prints the minimum, the average and the maximum over the processes of
+ *        the time spent in each stage (nested stages included) or event, with
+ *        the ratio of the maximum to the average and the slowest process.
+ *
+ * The time the other processes spend waiting for the slowest one, in the
+ * reductions and the exchanges of the next stage or event, is about the
+ * difference between the maximum and their time.
+ */
+PetscErrorCode Tracer::viewImbalance(IntervalKind kind, std::vector<PetscLogDouble> &times)
+{
+  PetscErrorCode ierr;
+
+  PetscMPIInt rank, size;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD, &size); CHKERRQ(ierr);
+
+  PetscInt n = times.size();
+  ierr = MPI_Allreduce(MPI_IN_PLACE, &n, 1, MPIU_INT, MPI_MAX, PETSC_COMM_WORLD); CHKERRQ(ierr);
+  if (n == 0)
+    return 0;
+  times.resize(n, 0.0);
+
+  // time and rank, for the location of the maximum
+  struct TimeRank {double time; int rank;};
+  std::vector<PetscLogDouble> minimum(n), sum(n);
+  std::vector<TimeRank> local(n), maximum(n);
+  for (PetscInt i=0; i<n; i++)
+  {
+    local[i].time = times[i];
+    local[i].rank = rank;
+  }
+  ierr = MPI_Allreduce(&times[0], &minimum[0], n, MPIU_PETSCLOGDOUBLE, MPI_MIN, PETSC_COMM_WORLD); CHKERRQ(ierr);
+  ierr = MPI_Allreduce(&times[0], &sum[0], n, MPIU_PETSCLOGDOUBLE, MPI_SUM, PETSC_COMM_WORLD); CHKERRQ(ierr);
+  ierr = MPI_Allreduce(&local[0], &maximum[0], n, MPI_DOUBLE_INT, MPI_MAXLOC, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+  ierr = PetscPrintf(PETSC_COMM_WORLD, "\nImbalance of the %s over %d processes (time in s)\n",
+                     (kind == STAGE) ? "stages" : "events", size); CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD, "%-24s %11s %11s %11s %8s %8s\n",
+                     "name", "min", "avg", "max", "max/avg", "max rank"); CHKERRQ(ierr);
+  for (PetscInt i=0; i<n; i++)
+  {
+    if (maximum[i].time <= 0.0)
+      continue;
+    PetscLogDouble average = sum[i]/size;
+    ierr = PetscPrintf(PETSC_COMM_WORLD, "%-24s %11.4e %11.4e %11.4e %8.2f %8d\n",
+                       getName(kind, i).c_str(), minimum[i], average, maximum[i].time,
+                       maximum[i].time/average, maximum[i].rank); CHKERRQ(ierr);
+  }
+
+  return 0;
+} // viewImbalance
+
+
+/*!
+ * \brief Gets the name of a stage or an event from the PETSc log.
+ */
+std::string Tracer::getName(IntervalKind kind, PetscInt index)
+{
+#if defined(PETSC_USE_LOG)
+  PetscStageLog stageLog;
+  if (!PetscLogGetStageLog(&stageLog))
+  {
+    if (kind == STAGE && index < stageLog->numStages)
+      return stageLog->stageInfo[index].name;
+    if (kind == EVENT && index < stageLog->eventLog->numEvents)
+      return stageLog->eventLog->eventInfo[index].name;
+  }
+#endif
+  char name[32];
+  snprintf(name, sizeof(name), "%s%d", (kind == STAGE) ? "stage" : "event", (int) index);
+  return name;
+} // getName
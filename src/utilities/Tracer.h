@@ -0,0 +1,82 @@
+/*! Definition of the class `Tracer`.
+ * \file Tracer.h
+ */
+
+
+#if !defined(TRACER_H)
+#define TRACER_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <petscsys.h>
+#include <petsclog.h>
+
+
+/**
+ * \class Tracer
+ * \brief Timeline of the log stages and events on every process.
+ *
+ * Enabled with the option `-timeline [<file>]`. The begin and end times of
+ * the stages pushed through `pushStage` and of all log events (those of PETSc
+ * included, through the event handlers of the PETSc log) are recorded by each
+ * process in a ring buffer of `-timeline_size` intervals (default 100,000),
+ * which keeps the last intervals of long runs. At `finalize`, the buffers are
+ * sent to process 0 and written as a Chrome trace (JSON, one track per
+ * process, readable by Perfetto or `chrome://tracing`), and the minimum,
+ * average and maximum over the processes of the time spent in each stage and
+ * event are printed. The clocks are aligned on a barrier at `initialize`.
+ * The handlers of the tracer chain to those of the PETSc log, which is started
+ * with the default handlers when no log is running, so that the stage and
+ * event times of PETSc stay available.
+ */
+class Tracer
+{
+public:
+  // constructors
+  Tracer();
+  // destructor
+  ~Tracer();
+
+  // read the options and start tracing
+  PetscErrorCode initialize(std::string directory);
+  // push a log stage
+  PetscErrorCode pushStage(PetscLogStage stage);
+  // pop the current log stage
+  PetscErrorCode popStage();
+  // write the timeline and print the imbalance of the stages and events
+  PetscErrorCode finalize();
+
+  // record the beginning and the end of an event
+  void beginEvent(PetscLogEvent event, PetscLogDouble time);
+  PetscErrorCode endEvent(PetscLogEvent event, PetscLogDouble time);
+
+private:
+  /// kind of interval
+  enum IntervalKind {STAGE, EVENT};
+
+  PetscBool active;                 ///< is tracing enabled?
+  std::string filePath;             ///< path of the JSON file
+  PetscLogDouble origin;            ///< time of the barrier at initialization
+  size_t capacity,                  ///< number of intervals in the ring buffer
+         head,                      ///< position of the next interval
+         numRecorded;               ///< number of intervals recorded so far
+  std::vector<PetscLogDouble> intervals; ///< ring buffer: kind, index, begin, end
+  std::vector<std::pair<PetscLogStage, PetscLogDouble> > openStages; ///< stages pushed and their begin time
+  std::vector<std::pair<PetscLogEvent, PetscLogDouble> > openEvents; ///< events begun and their begin time
+  std::vector<PetscLogDouble> stageTimes, ///< time spent in each stage
+                              eventTimes; ///< time spent in each event
+
+  // add an interval to the ring buffer and to the total time
+  void record(IntervalKind kind, PetscInt index, PetscLogDouble begin, PetscLogDouble end);
+  // gather the intervals on process 0 and write the JSON file
+  PetscErrorCode writeTimeline();
+  // print the minimum, average and maximum over the processes of the times
+  PetscErrorCode viewImbalance(IntervalKind kind, std::vector<PetscLogDouble> &times);
+  // get the name of a stage or an event
+  std::string getName(IntervalKind kind, PetscInt index);
+
+}; // Tracer
+
+#endif
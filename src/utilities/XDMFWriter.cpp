@@ -0,0 +1,229 @@
+/*! Implementation of the methods of the class `XDMFWriter`.
+ * \file XDMFWriter.cpp
+ */
+
+
+#include "XDMFWriter.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+
+// opening and closing tags of the files
+static const std::string header = "<?xml version=\"1.0\"?>\n"
+                                  "<Xdmf Version=\"2.2\">\n"
+                                  "  <Domain>\n"
+                                  "    <Grid Name=\"TimeSeries\" GridType=\"Collection\" CollectionType=\"Temporal\">\n",
+                         footer = "    </Grid>\n"
+                                  "  </Domain>\n"
+                                  "</Xdmf>\n";
+// first characters of the line that opens the block of a time step
+static const std::string blockStart = "      <Grid Name=\"";
+
+
+/*!
+ * \brief Constructor.
+ */
+XDMFWriter::XDMFWriter()
+{
+  active = PETSC_FALSE;
+  rank = 0;
+} // XDMFWriter
+
+
+/*!
+ * \brief Destructor.
+ */
+XDMFWriter::~XDMFWriter()
+{
+} // ~XDMFWriter
+
+
+/*!
+ * \brief Adds a grid.
+ *
+ * \param name Name of the grid and of its XDMF file
+ * \param gridFile HDF5 file of the stations, relative to the simulation directory
+ * \param sizes Number of stations along x, y (and z)
+ */
+void XDMFWriter::addGrid(std::string name, std::string gridFile, std::vector<PetscInt> sizes)
+{
+  Grid grid;
+  grid.name = name;
+  grid.gridFile = gridFile;
+  grid.sizes = sizes;
+  grids.push_back(grid);
+} // addGrid
+
+
+/*!
+ * \brief Attaches a field to a grid: the datasets of the field recorded are
+ *        listed in the XDMF file of the grid.
+ */
+void XDMFWriter::addField(std::string field, std::string grid)
+{
+  for (size_t g=0; g<grids.size(); g++)
+  {
+    if (grids[g].name == grid)
+      fieldGrids[field] = g;
+  }
+} // addField
+
+
+/*!
+ * \brief Starts the XDMF files of the grids, keeping the blocks of the time
+ *        steps up to the starting one when restarting.
+ *
+ * \param dir Directory of the simulation
+ * \param startStep Starting time step
+ */
+PetscErrorCode XDMFWriter::initialize(std::string dir, PetscInt startStep)
+{
+  PetscErrorCode ierr;
+
+  directory = dir;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+  active = PETSC_TRUE;
+  if (rank != 0)
+    return 0;
+
+  for (size_t g=0; g<grids.size(); g++)
+  {
+    std::string filePath = getFilePath(grids[g]),
+                blocks;
+    if (startStep > 0)
+    {
+      // blocks of the previous run, up to the starting time step
+      std::ifstream infile(filePath.c_str());
+      std::string line;
+      PetscBool keep = PETSC_FALSE;
+      while (std::getline(infile, line))
+      {
+        if (line.compare(0, blockStart.size(), blockStart) == 0)
+          keep = (atol(line.c_str() + blockStart.size()) <= startStep) ? PETSC_TRUE : PETSC_FALSE;
+        else if (line == footer.substr(0, footer.find('\n')))
+          break;
+        else if (line.compare(0, 6, "      ") != 0)
+          continue;
+        if (keep)
+          blocks += line + "\n";
+      }
+    }
+    FILE *file = fopen(filePath.c_str(), "w");
+    if (!file)
+    {
+      SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_FILE_OPEN, "Cannot open the file %s", filePath.c_str());
+    }
+    fputs(header.c_str(), file);
+    fputs(blocks.c_str(), file);
+    fputs(footer.c_str(), file);
+    fclose(file);
+  }
+
+  return 0;
+} // initialize
+
+
+/*!
+ * \brief Records a dataset of a field written at the current time step (fields
+ *        without grid are ignored).
+ *
+ * \param field Name of the field
+ * \param dataset Dataset, `<file>:/<name>` with the file relative to the
+ *        simulation directory
+ */
+void XDMFWriter::recordField(std::string field, std::string dataset)
+{
+  std::map<std::string, size_t>::iterator it = fieldGrids.find(field);
+  if (!active || it == fieldGrids.end())
+    return;
+  grids[it->second].fields.push_back(field);
+  grids[it->second].datasets.push_back(dataset);
+} // recordField
+
+
+/*!
+ * \brief Appends the block of the time step to the XDMF file of each grid
+ *        with fields recorded, and clears the records.
+ *
+ * \param timeStep The time step
+ * \param time The time
+ */
+PetscErrorCode XDMFWriter::writeSnapshot(PetscInt timeStep, PetscReal time)
+{
+  for (size_t g=0; g<grids.size(); g++)
+  {
+    Grid &grid = grids[g];
+    if (rank == 0 && !grid.fields.empty())
+    {
+      std::string filePath = getFilePath(grid);
+      FILE *file = fopen(filePath.c_str(), "r+");
+      if (!file)
+      {
+        SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_FILE_OPEN, "Cannot open the file %s", filePath.c_str());
+      }
+      // the block replaces the closing tags, written again after it
+      fseek(file, -((long) footer.size()), SEEK_END);
+      fputs(getBlock(grid, timeStep, time).c_str(), file);
+      fputs(footer.c_str(), file);
+      if (fclose(file) != 0)
+      {
+        SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_FILE_WRITE, "Cannot write the file %s", filePath.c_str());
+      }
+    }
+    grid.fields.clear();
+    grid.datasets.clear();
+  }
+
+  return 0;
+} // writeSnapshot
+
+
+/*!
+ * \brief Gets the path of the XDMF file of a grid.
+ */
+std::string XDMFWriter::getFilePath(const Grid &grid)
+{
+  return directory + "/" + grid.name + ".xmf";
+} // getFilePath
+
+
+/*!
+ * \brief Gets the block of a grid at a time step: the rectilinear mesh and one
+ *        node-centered attribute per field recorded.
+ */
+std::string XDMFWriter::getBlock(const Grid &grid, PetscInt timeStep, PetscReal time)
+{
+  const char *names[3] = {"x", "y", "z"};
+  PetscInt numDirections = grid.sizes.size();
+  std::stringstream dimensions;
+  for (PetscInt d=numDirections-1; d>=0; d--)
+    dimensions << grid.sizes[d] << ((d > 0) ? " " : "");
+  const std::string item = "NumberType=\"Float\" Precision=\"" + std::to_string(sizeof(PetscReal)) + "\" Format=\"HDF\"";
+
+  std::stringstream block;
+  block << blockStart << std::setfill('0') << std::setw(7) << timeStep << "\" GridType=\"Uniform\">\n";
+  block << "        <Time Value=\"" << std::setprecision(16) << time << "\"/>\n";
+  block << "        <Topology TopologyType=\"" << numDirections << "DRectMesh\" NumberOfElements=\""
+        << dimensions.str() << "\"/>\n";
+  block << "        <Geometry GeometryType=\"" << ((numDirections == 3) ? "VXVYVZ" : "VXVY") << "\">\n";
+  for (PetscInt d=0; d<numDirections; d++)
+  {
+    block << "          <DataItem Dimensions=\"" << grid.sizes[d] << "\" " << item << ">"
+          << grid.gridFile << ":/" << names[d] << "</DataItem>\n";
+  }
+  block << "        </Geometry>\n";
+  for (size_t f=0; f<grid.fields.size(); f++)
+  {
+    block << "        <Attribute Name=\"" << grid.fields[f] << "\" AttributeType=\"Scalar\" Center=\"Node\">\n";
+    block << "          <DataItem Dimensions=\"" << dimensions.str() << "\" " << item << ">"
+          << grid.datasets[f] << "</DataItem>\n";
+    block << "        </Attribute>\n";
+  }
+  block << "      </Grid>\n";
+
+  return block.str();
+} // getBlock
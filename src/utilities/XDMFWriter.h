@@ -0,0 +1,73 @@
+/*! Definition of the class `XDMFWriter`.
+ * \file XDMFWriter.h
+ */
+
+
+#if !defined(XDMF_WRITER_H)
+#define XDMF_WRITER_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <petscsys.h>
+
+
+/**
+ * \class XDMFWriter
+ * \brief Temporal collections of the fields written in HDF5 files, readable
+ *        by VisIt and ParaView while the simulation runs.
+ *
+ * Each grid (a rectilinear mesh whose stations are the datasets `x`, `y` and
+ * `z` of an HDF5 file) has its own XDMF file `<grid>.xmf` in the simulation
+ * directory, with one block per saved time step that holds the fields of the
+ * grid written at that time step. Process 0 appends the block of a time step
+ * by overwriting the closing tags at the end of the file, so that the cost of
+ * an update does not grow with the number of time steps. At restart, the
+ * blocks up to the starting time step are kept. The paths are relative to the
+ * simulation directory.
+ */
+class XDMFWriter
+{
+public:
+  // constructors
+  XDMFWriter();
+  // destructor
+  ~XDMFWriter();
+
+  // add a grid, with the number of stations along each direction
+  void addGrid(std::string name, std::string gridFile, std::vector<PetscInt> sizes);
+  // attach a field to a grid
+  void addField(std::string field, std::string grid);
+  // start the files of the grids
+  PetscErrorCode initialize(std::string directory, PetscInt startStep);
+  // record a dataset of a field written at the current time step
+  void recordField(std::string field, std::string dataset);
+  // append the fields recorded to the files of their grids
+  PetscErrorCode writeSnapshot(PetscInt timeStep, PetscReal time);
+
+private:
+  /// rectilinear grid and its fields
+  struct Grid
+  {
+    std::string name,                ///< name of the grid (and of its XDMF file)
+                gridFile;            ///< HDF5 file of the stations
+    std::vector<PetscInt> sizes;     ///< number of stations along x, y and z
+    std::vector<std::string> fields, ///< fields recorded at the current time step
+                             datasets; ///< their datasets (`<file>:/<name>`)
+  };
+
+  PetscBool active;                 ///< were the files started?
+  PetscMPIInt rank;                 ///< rank of the process (only process 0 writes)
+  std::string directory;            ///< directory of the simulation
+  std::vector<Grid> grids;          ///< grids
+  std::map<std::string, size_t> fieldGrids; ///< grid of each field
+
+  // get the path of the XDMF file of a grid
+  std::string getFilePath(const Grid &grid);
+  // get the block of a grid at a time step
+  std::string getBlock(const Grid &grid, PetscInt timeStep, PetscReal time);
+
+}; // XDMFWriter
+
+#endif
@@ -0,0 +1,190 @@
+/*! Implementation of the functions that write compressed fields.
+ * \file compression.cpp
+ */
+
+
+#include "compression.h"
+
+#include <cmath>
+#include <vector>
+
+#include <petscdmda.h>
+#ifdef PETSC_HAVE_HDF5
+#include <petscviewerhdf5.h>
+#endif
+
+
+/*!
+ * \brief Rounds the values to the nearest multiple of the largest power of two
+ *        that is not larger than twice the tolerance.
+ *
+ * The error is at most the tolerance and the trailing bits of the mantissa of
+ * the values are zero, which the shuffle and deflate filters compress well.
+ *
+ * \param values The values
+ * \param size Number of values
+ * \param tolerance Absolute tolerance (nothing is done if not positive)
+ */
+PetscErrorCode quantize(PetscScalar *values, PetscInt size, PetscReal tolerance)
+{
+  PetscFunctionBeginUser;
+
+  if (tolerance <= 0.0)
+    PetscFunctionReturn(0);
+  PetscReal step = std::ldexp(1.0, (int) std::floor(std::log2(2.0*tolerance))),
+            inverse = 1.0/step;
+  for (PetscInt i=0; i<size; i++)
+    values[i] = std::nearbyint(values[i]*inverse)*step;
+
+  PetscFunctionReturn(0);
+} // quantize
+
+
+#ifdef PETSC_HAVE_HDF5
+/*!
+ * \brief Writes a DMDA vector into the current group of an HDF5 viewer as a
+ *        chunked dataset with the shuffle and deflate filters.
+ *
+ * The dataset has the name and the layout of those written by `VecView`
+ * (z, y, x and the degrees of freedom if more than one), so that it is read
+ * back by `VecLoad`; the chunks are the size of the largest sub-domain. With a
+ * positive tolerance, the values are first quantized (`quantize`), the
+ * tolerance being relative to the maximum absolute value of the vector if
+ * `relative` is set. The parallel writes of filtered datasets require HDF5
+ * 1.10.2 or later. Collective.
+ *
+ * \param v The vector (named)
+ * \param viewer The HDF5 viewer
+ * \param level Level of the deflate filter (1: fastest, 9: smallest)
+ * \param tolerance Error bound of the values (0: lossless)
+ * \param relative Is the tolerance relative to the maximum absolute value?
+ */
+PetscErrorCode viewCompressed(Vec v, PetscViewer viewer, PetscInt level,
+                              PetscReal tolerance, PetscBool relative)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+
+  DM da;
+  PetscBool isDA = PETSC_FALSE;
+  ierr = VecGetDM(v, &da); CHKERRQ(ierr);
+  if (da)
+  {
+    ierr = PetscObjectTypeCompare((PetscObject) da, DMDA, &isDA); CHKERRQ(ierr);
+  }
+  if (!isDA)
+  {
+    SETERRQ(PetscObjectComm((PetscObject) v), PETSC_ERR_ARG_WRONG, "Compressed output requires a DMDA vector");
+  }
+  MPI_Comm comm = PetscObjectComm((PetscObject) v);
+#if defined(H5_HAVE_PARALLEL) && !H5_VERSION_GE(1, 10, 2)
+  PetscMPIInt size;
+  ierr = MPI_Comm_size(comm, &size); CHKERRQ(ierr);
+  if (size > 1)
+  {
+    SETERRQ(comm, PETSC_ERR_SUP, "Compressed parallel HDF5 output requires HDF5 1.10.2 or later");
+  }
+#endif
+  if (!H5Zfilter_avail(H5Z_FILTER_DEFLATE) || !H5Zfilter_avail(H5Z_FILTER_SHUFFLE))
+  {
+    SETERRQ(comm, PETSC_ERR_SUP, "HDF5 has not been built with the deflate and shuffle filters");
+  }
+
+  // layout of VecView: slowest dimension first
+  PetscInt dimension, M, N, P, dof, xs, ys, zs, m, n, p;
+  ierr = DMDAGetInfo(da, &dimension, &M, &N, &P, NULL, NULL, NULL, &dof,
+                     NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
+  ierr = DMDAGetCorners(da, &xs, &ys, &zs, &m, &n, &p); CHKERRQ(ierr);
+  hsize_t dims[4], offset[4], count[4], chunk[4];
+  PetscInt numDims = 0;
+  if (dimension == 3)
+  {
+    dims[numDims] = P; offset[numDims] = zs; count[numDims++] = p;
+  }
+  if (dimension > 1)
+  {
+    dims[numDims] = N; offset[numDims] = ys; count[numDims++] = n;
+  }
+  dims[numDims] = M; offset[numDims] = xs; count[numDims++] = m;
+  if (dof > 1)
+  {
+    dims[numDims] = dof; offset[numDims] = 0; count[numDims++] = dof;
+  }
+  // chunks of the size of the largest sub-domain
+  PetscInt localCounts[4], maxCounts[4];
+  for (PetscInt d=0; d<numDims; d++)
+    localCounts[d] = count[d];
+  ierr = MPI_Allreduce(localCounts, maxCounts, numDims, MPIU_INT, MPI_MAX, comm); CHKERRQ(ierr);
+  for (PetscInt d=0; d<numDims; d++)
+    chunk[d] = PetscMax(1, maxCounts[d]);
+
+  // values of the sub-domain, quantized
+  PetscInt localSize;
+  ierr = VecGetLocalSize(v, &localSize); CHKERRQ(ierr);
+  std::vector<PetscScalar> values(PetscMax(1, localSize));
+  const PetscScalar *array;
+  ierr = VecGetArrayRead(v, &array); CHKERRQ(ierr);
+  ierr = PetscMemcpy(&values[0], array, localSize*sizeof(PetscScalar)); CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(v, &array); CHKERRQ(ierr);
+  if (tolerance > 0.0 && relative)
+  {
+    PetscReal maximum;
+    ierr = VecNorm(v, NORM_INFINITY, &maximum); CHKERRQ(ierr);
+    tolerance *= maximum;
+  }
+  ierr = quantize(&values[0], localSize, tolerance); CHKERRQ(ierr);
+
+#if defined(PETSC_USE_REAL_SINGLE)
+  hid_t type = H5T_NATIVE_FLOAT;
+#else
+  hid_t type = H5T_NATIVE_DOUBLE;
+#endif
+  const char *name;
+  ierr = PetscObjectGetName((PetscObject) v, &name); CHKERRQ(ierr);
+  hid_t fileId, groupId;
+  ierr = PetscViewerHDF5OpenGroup(viewer, &fileId, &groupId); CHKERRQ(ierr);
+
+  hid_t fileSpace = H5Screate_simple(numDims, dims, NULL),
+        properties = H5Pcreate(H5P_DATASET_CREATE);
+  if (H5Pset_chunk(properties, numDims, chunk) < 0 ||
+      H5Pset_shuffle(properties) < 0 ||
+      H5Pset_deflate(properties, level) < 0)
+  {
+    SETERRQ1(comm, PETSC_ERR_LIB, "Cannot set the filters of the dataset %s", name);
+  }
+  hid_t dataset = H5Dcreate2(groupId, name, type, fileSpace, H5P_DEFAULT, properties, H5P_DEFAULT);
+  if (dataset < 0)
+  {
+    SETERRQ1(comm, PETSC_ERR_LIB, "Cannot create the dataset %s", name);
+  }
+  hid_t memorySpace = H5Screate_simple(numDims, count, NULL);
+  if (localSize > 0)
+    H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, offset, NULL, count, NULL);
+  else
+  {
+    H5Sselect_none(fileSpace);
+    H5Sselect_none(memorySpace);
+  }
+  hid_t transfer = H5Pcreate(H5P_DATASET_XFER);
+#if defined(H5_HAVE_PARALLEL)
+  // the filters require collective writes
+  H5Pset_dxpl_mpio(transfer, H5FD_MPIO_COLLECTIVE);
+#endif
+  herr_t status = H5Dwrite(dataset, type, memorySpace, fileSpace, transfer, &values[0]);
+
+  H5Pclose(transfer);
+  H5Sclose(memorySpace);
+  H5Dclose(dataset);
+  H5Pclose(properties);
+  H5Sclose(fileSpace);
+  if (groupId != fileId)
+    H5Gclose(groupId);
+  if (status < 0)
+  {
+    SETERRQ1(comm, PETSC_ERR_FILE_WRITE, "Cannot write the dataset %s", name);
+  }
+
+  PetscFunctionReturn(0);
+} // viewCompressed
+#endif
@@ -0,0 +1,25 @@
+/*! Definition of the functions that write compressed fields.
+ * \file compression.h
+ */
+
+
+#if !defined(COMPRESSION_H)
+#define COMPRESSION_H
+
+#include <petscvec.h>
+#include <petscviewer.h>
+
+
+// Rounds values to multiples of a power of two that keep the error below
+// an absolute tolerance.
+PetscErrorCode quantize(PetscScalar *values, PetscInt size, PetscReal tolerance);
+
+#ifdef PETSC_HAVE_HDF5
+// Writes a DMDA vector into the current group of an HDF5 viewer as a dataset
+// chunked by sub-domain, with the shuffle and deflate filters, after an
+// error-bounded quantization when the tolerance is positive.
+PetscErrorCode viewCompressed(Vec v, PetscViewer viewer, PetscInt level,
+                              PetscReal tolerance, PetscBool relative);
+#endif
+
+#endif
@@ -14,6 +14,9 @@
 // Returns the value of the discrete Delta function from Roma et al. (1999).
 PetscReal dhRoma(PetscReal x, PetscReal h);
 
+// Floating-point operations of an evaluation of `dhRoma` (upper estimate).
+const PetscLogDouble dhRomaFlops = 14.0;
+
 // Two-dimensional discrete delta function from Roma et al. (1999).
 PetscReal delta(PetscReal x, PetscReal y, PetscReal hx, PetscReal hy);
 
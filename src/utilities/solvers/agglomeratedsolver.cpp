@@ -0,0 +1,286 @@
+/*! Implementation of the methods of the class `AgglomeratedSolver`.
+ * \file agglomeratedsolver.cpp
+ */
+
+#include "agglomeratedsolver.h"
+
+
+/*!
+ * \brief Destroys the KSP, the scatter and the communicator of the solver processes.
+ */
+AgglomeratedSolver::~AgglomeratedSolver()
+{
+  KSPDestroy(&ksp);
+  VecScatterDestroy(&scatter);
+  VecDestroy(&xGather);
+  VecDestroy(&bGather);
+  VecDestroy(&xSolver);
+  VecDestroy(&bSolver);
+  if (subcomm != MPI_COMM_NULL)
+    MPI_Comm_free(&subcomm);
+} // ~AgglomeratedSolver
+
+
+/*!
+ * \brief Redistributes the matrix on the solver processes and creates the KSP.
+ */
+PetscErrorCode AgglomeratedSolver::create(const Mat &A)
+{
+  PetscErrorCode ierr;
+
+  ierr = PetscOptionsInsertFile(PETSC_COMM_WORLD, NULL,
+                                options.c_str(), PETSC_FALSE); CHKERRQ(ierr);
+
+  PetscInt numSolver, numRows;
+  std::vector<PetscInt> groupRows;
+  ierr = MatGetSize(A, &numRows, NULL); CHKERRQ(ierr);
+  ierr = createGroups(A, groupRows); CHKERRQ(ierr);
+  numSolver = groupRows.size();
+
+  // gathered vectors: each solver process owns the rows of the processes of
+  // its group, in the order of their ranks in the group
+  IS isGroup;
+  ierr = ISCreateGeneral(PETSC_COMM_WORLD, numSolver, (numSolver > 0) ? &groupRows[0] : NULL,
+                         PETSC_COPY_VALUES, &isGroup); CHKERRQ(ierr);
+  ierr = VecCreateMPI(PETSC_COMM_WORLD, numSolver, numRows, &xGather); CHKERRQ(ierr);
+  ierr = VecDuplicate(xGather, &bGather); CHKERRQ(ierr);
+  PetscInt start;
+  ierr = VecGetOwnershipRange(xGather, &start, NULL); CHKERRQ(ierr);
+  IS is;
+  ierr = ISCreateStride(PETSC_COMM_WORLD, numSolver, start, 1, &is); CHKERRQ(ierr);
+  Vec v;
+  ierr = MatCreateVecs(A, &v, NULL); CHKERRQ(ierr);
+  ierr = VecScatterCreate(v, isGroup, xGather, is, &scatter); CHKERRQ(ierr);
+  ierr = VecDestroy(&v); CHKERRQ(ierr);
+  ierr = ISDestroy(&is); CHKERRQ(ierr);
+
+  // the matrix in the order of the gathered vectors, then the rows of the
+  // solver process (all columns), gathered once
+  Mat AGroup;
+  ierr = MatGetSubMatrix(A, isGroup, isGroup, MAT_INITIAL_MATRIX, &AGroup); CHKERRQ(ierr);
+  ierr = ISDestroy(&isGroup); CHKERRQ(ierr);
+  IS isRows, isCols;
+  Mat *rows;
+  ierr = ISCreateStride(PETSC_COMM_SELF, numSolver, start, 1, &isRows); CHKERRQ(ierr);
+  ierr = ISCreateStride(PETSC_COMM_SELF, numRows, 0, 1, &isCols); CHKERRQ(ierr);
+  ierr = MatGetSubMatrices(AGroup, 1, &isRows, &isCols, MAT_INITIAL_MATRIX, &rows); CHKERRQ(ierr);
+  ierr = ISDestroy(&isRows); CHKERRQ(ierr);
+  ierr = ISDestroy(&isCols); CHKERRQ(ierr);
+  ierr = MatDestroy(&AGroup); CHKERRQ(ierr);
+
+  Mat ASolver = NULL;
+  if (subcomm != MPI_COMM_NULL)
+  {
+    ierr = MatCreateMPIMatConcatenateSeqMat(subcomm, rows[0], numSolver, MAT_INITIAL_MATRIX, &ASolver); CHKERRQ(ierr);
+    ierr = VecCreateMPIWithArray(subcomm, 1, numSolver, numRows, NULL, &xSolver); CHKERRQ(ierr);
+    ierr = VecDuplicate(xSolver, &bSolver); CHKERRQ(ierr);
+  }
+  ierr = MatDestroyMatrices(1, &rows); CHKERRQ(ierr);
+  ierr = redistributeNullSpace(A, ASolver); CHKERRQ(ierr);
+
+  if (subcomm != MPI_COMM_NULL)
+  {
+    ierr = KSPCreate(subcomm, &ksp); CHKERRQ(ierr);
+    ierr = KSPSetOptionsPrefix(ksp, prefix.c_str()); CHKERRQ(ierr);
+    ierr = KSPSetOperators(ksp, ASolver, ASolver); CHKERRQ(ierr);
+    ierr = KSPSetInitialGuessNonzero(ksp, PETSC_TRUE); CHKERRQ(ierr);
+    ierr = KSPSetType(ksp, KSPCG); CHKERRQ(ierr);
+    ierr = KSPSetReusePreconditioner(ksp, PETSC_TRUE); CHKERRQ(ierr);
+    ierr = KSPSetFromOptions(ksp); CHKERRQ(ierr);
+    ierr = KSPSetUp(ksp); CHKERRQ(ierr);
+    ierr = MatDestroy(&ASolver); CHKERRQ(ierr);
+  }
+
+  return 0;
+} // create
+
+
+/*!
+ * \brief Groups the processes and creates the communicator of the solver processes.
+ *
+ * The first process of a group (lowest rank) is its solver process, so the
+ * process 0 always solves. The rows owned by the processes of a group are
+ * listed through the communicator of the group, so that they are gathered
+ * within the group whatever the placement of the ranks on the nodes.
+ *
+ * \param A Matrix of the system
+ * \param groupRows Returns the rows gathered on the process (empty outside the solver processes)
+ */
+PetscErrorCode AgglomeratedSolver::createGroups(Mat A, std::vector<PetscInt> &groupRows)
+{
+  PetscErrorCode ierr;
+
+  PetscInt ranksPerSolver = 0;
+  ierr = PetscOptionsGetInt(NULL, prefix.c_str(), "-agglomerate_ranks", &ranksPerSolver, NULL); CHKERRQ(ierr);
+  if (ranksPerSolver < 0)
+  {
+    SETERRQ1(PETSC_COMM_WORLD, PETSC_ERR_ARG_OUTOFRANGE,
+             "-%sagglomerate_ranks should be positive (or 0 for one solver process per node)", prefix.c_str());
+  }
+
+  PetscMPIInt rank, size, groupRank;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD, &size); CHKERRQ(ierr);
+  MPI_Comm group;
+  if (ranksPerSolver > 0)
+  {
+    ierr = MPI_Comm_split(PETSC_COMM_WORLD, rank/ranksPerSolver, rank, &group); CHKERRQ(ierr);
+  }
+  else
+  {
+    // processes sharing memory
+    ierr = MPI_Comm_split_type(PETSC_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &group); CHKERRQ(ierr);
+  }
+  ierr = MPI_Comm_rank(group, &groupRank); CHKERRQ(ierr);
+
+  // ownership ranges of the processes of the group
+  PetscMPIInt groupSize;
+  PetscInt range[2];
+  ierr = MPI_Comm_size(group, &groupSize); CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A, &range[0], &range[1]); CHKERRQ(ierr);
+  std::vector<PetscInt> ranges((groupRank == 0) ? 2*groupSize : 0);
+  ierr = MPI_Gather(range, 2, MPIU_INT, (groupRank == 0) ? &ranges[0] : NULL, 2, MPIU_INT, 0, group); CHKERRQ(ierr);
+  ierr = MPI_Comm_free(&group); CHKERRQ(ierr);
+  groupRows.clear();
+  for (PetscMPIInt i=0; i<(PetscMPIInt) ranges.size()/2; i++)
+  {
+    for (PetscInt row=ranges[2*i]; row<ranges[2*i+1]; row++)
+      groupRows.push_back(row);
+  }
+
+  PetscMPIInt isSolver = (groupRank == 0) ? 1 : 0,
+              numSolvers;
+  ierr = MPI_Comm_split(PETSC_COMM_WORLD, (isSolver) ? 0 : MPI_UNDEFINED, rank, &subcomm); CHKERRQ(ierr);
+  ierr = MPI_Allreduce(&isSolver, &numSolvers, 1, MPI_INT, MPI_SUM, PETSC_COMM_WORLD); CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD, "The %s solver runs on %d of %d processes\n",
+                     prefix.substr(0, prefix.size()-1).c_str(), numSolvers, size); CHKERRQ(ierr);
+
+  return 0;
+} // createGroups
+
+
+/*!
+ * \brief Gathers the null space of the matrix on the solver processes.
+ *
+ * \param A Matrix of the system
+ * \param ASolver Matrix of the solver processes (NULL on the other processes)
+ */
+PetscErrorCode AgglomeratedSolver::redistributeNullSpace(Mat A, Mat ASolver)
+{
+  PetscErrorCode ierr;
+
+  MatNullSpace nsp;
+  ierr = MatGetNullSpace(A, &nsp); CHKERRQ(ierr);
+  if (!nsp)
+    return 0;
+
+  PetscBool hasConstant;
+  PetscInt numVecs;
+  const Vec *vecs;
+  ierr = MatNullSpaceGetVecs(nsp, &hasConstant, &numVecs, &vecs); CHKERRQ(ierr);
+  std::vector<Vec> vecsSolver(numVecs, (Vec) NULL);
+  for (PetscInt i=0; i<numVecs; i++)
+  {
+    ierr = VecScatterBegin(scatter, vecs[i], xGather, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+    ierr = VecScatterEnd(scatter, vecs[i], xGather, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+    if (ASolver)
+    {
+      PetscScalar *array;
+      ierr = VecGetArray(xGather, &array); CHKERRQ(ierr);
+      ierr = VecPlaceArray(xSolver, array); CHKERRQ(ierr);
+      ierr = VecDuplicate(xSolver, &vecsSolver[i]); CHKERRQ(ierr);
+      ierr = VecCopy(xSolver, vecsSolver[i]); CHKERRQ(ierr);
+      ierr = VecResetArray(xSolver); CHKERRQ(ierr);
+      ierr = VecRestoreArray(xGather, &array); CHKERRQ(ierr);
+    }
+  }
+  if (ASolver)
+  {
+    MatNullSpace nspSolver;
+    ierr = MatNullSpaceCreate(subcomm, hasConstant, numVecs,
+                              (numVecs > 0) ? &vecsSolver[0] : NULL, &nspSolver); CHKERRQ(ierr);
+    ierr = MatSetNullSpace(ASolver, nspSolver); CHKERRQ(ierr);
+    ierr = MatNullSpaceDestroy(&nspSolver); CHKERRQ(ierr);
+    for (PetscInt i=0; i<numVecs; i++)
+    {
+      ierr = VecDestroy(&vecsSolver[i]); CHKERRQ(ierr);
+    }
+  }
+
+  return 0;
+} // redistributeNullSpace
+
+
+/*!
+ * \brief Solves the system on the solver processes.
+ */
+PetscErrorCode AgglomeratedSolver::solve(Vec &x, Vec &b)
+{
+  PetscErrorCode ierr;
+
+  ierr = VecScatterBegin(scatter, b, bGather, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecScatterEnd(scatter, b, bGather, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecScatterBegin(scatter, x, xGather, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecScatterEnd(scatter, x, xGather, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+
+  // iterations, reason and residual norm of the solver processes,
+  // known by all processes
+  PetscInt info[2] = {0, 0};
+  if (subcomm != MPI_COMM_NULL)
+  {
+    PetscScalar *xArray, *bArray;
+    ierr = VecGetArray(xGather, &xArray); CHKERRQ(ierr);
+    ierr = VecGetArray(bGather, &bArray); CHKERRQ(ierr);
+    ierr = VecPlaceArray(xSolver, xArray); CHKERRQ(ierr);
+    ierr = VecPlaceArray(bSolver, bArray); CHKERRQ(ierr);
+    ierr = KSPSolve(ksp, bSolver, xSolver); CHKERRQ(ierr);
+    ierr = VecResetArray(xSolver); CHKERRQ(ierr);
+    ierr = VecResetArray(bSolver); CHKERRQ(ierr);
+    ierr = VecRestoreArray(xGather, &xArray); CHKERRQ(ierr);
+    ierr = VecRestoreArray(bGather, &bArray); CHKERRQ(ierr);
+    KSPConvergedReason reason;
+    ierr = KSPGetConvergedReason(ksp, &reason); CHKERRQ(ierr);
+    ierr = KSPGetIterationNumber(ksp, &iters); CHKERRQ(ierr);
+    ierr = KSPGetResidualNorm(ksp, &residualNorm); CHKERRQ(ierr);
+    info[0] = iters;
+    info[1] = reason;
+  }
+  ierr = MPI_Bcast(info, 2, MPIU_INT, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+  ierr = MPI_Bcast(&residualNorm, 1, MPIU_REAL, 0, PETSC_COMM_WORLD); CHKERRQ(ierr);
+  iters = info[0];
+  if (info[1] < 0)
+  {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,
+            "\nERROR: %s solver diverged due to reason: %d\n",
+            prefix.substr(0, prefix.size()-1).c_str(), (int) info[1]); CHKERRQ(ierr);
+    ierr = PetscFinalize(); CHKERRQ(ierr);
+    exit(1);
+  }
+
+  ierr = VecScatterBegin(scatter, xGather, x, INSERT_VALUES, SCATTER_REVERSE); CHKERRQ(ierr);
+  ierr = VecScatterEnd(scatter, xGather, x, INSERT_VALUES, SCATTER_REVERSE); CHKERRQ(ierr);
+
+  return 0;
+} // solve
+
+
+/*!
+ * \brief Get the number of iterations performed.
+ */
+PetscErrorCode AgglomeratedSolver::getIters(PetscInt &its)
+{
+  its = iters;
+
+  return 0;
+} // getIters
+
+
+/*!
+ * \brief Get the residual norm at the end of the last solve.
+ */
+PetscErrorCode AgglomeratedSolver::getResidualNorm(PetscReal &norm)
+{
+  norm = residualNorm;
+
+  return 0;
+} // getResidualNorm
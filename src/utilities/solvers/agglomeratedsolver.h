@@ -0,0 +1,59 @@
+/*! Implementation of the class `AgglomeratedSolver`.
+ * \file agglomeratedsolver.h
+ */
+
+#if !defined(AGGLOMERATEDSOLVER_H)
+#define AGGLOMERATEDSOLVER_H
+
+#include "solver.h"
+
+#include <petscksp.h>
+
+#include <string>
+#include <vector>
+
+
+/*!
+ * \class AgglomeratedSolver
+ * \brief Iterative solver using PETSc KSP on a subset of the processes.
+ *
+ * The processes are gathered in groups, one group per compute node by default
+ * or `-<prefix>agglomerate_ranks <n>` consecutive processes; the first process
+ * of each group solves the system for the rows of the whole group (gathered
+ * from the processes of the group, renumbered group after group), with a KSP
+ * created on the communicator of the solver processes (options with the prefix
+ * of the solver). The matrix and its null space are redistributed once, when
+ * the solver is created; at each solve, the right-hand side and the initial
+ * guess are gathered on the solver processes and the solution is scattered
+ * back, with the same vector scatter.
+ */
+class AgglomeratedSolver : public Solver
+{
+public:
+  AgglomeratedSolver(std::string p, std::string f)
+    : prefix(p), options(f), ksp(NULL), subcomm(MPI_COMM_NULL), scatter(NULL),
+      xGather(NULL), bGather(NULL), xSolver(NULL), bSolver(NULL), iters(0), residualNorm(0.0) { };
+  virtual ~AgglomeratedSolver();
+
+  PetscErrorCode create(const Mat &A);
+  PetscErrorCode solve(Vec &x, Vec &b);
+  PetscErrorCode getIters(PetscInt &iters);
+  PetscErrorCode getResidualNorm(PetscReal &norm);
+
+private:
+  std::string prefix;
+  std::string options;
+  KSP ksp;                   // KSP of the solver processes
+  MPI_Comm subcomm;          // solver processes (MPI_COMM_NULL on the others)
+  VecScatter scatter;        // from the layout of the system to the solver processes
+  Vec xGather, bGather;      // gathered vectors (no entry outside the solver processes)
+  Vec xSolver, bSolver;      // the same entries, on the communicator of the solver processes
+  PetscInt iters;            // iterations of the last solve
+  PetscReal residualNorm;    // residual norm at the end of the last solve
+
+  PetscErrorCode createGroups(Mat A, std::vector<PetscInt> &groupRows);
+  PetscErrorCode redistributeNullSpace(Mat A, Mat ASolver);
+
+}; // AgglomeratedSolver
+
+#endif
@@ -0,0 +1,308 @@
+/*! Implementation of the methods of the class `Autotuner`.
+ * \file autotuner.cpp
+ */
+
+#include "autotuner.h"
+
+#include <cctype>
+#include <fstream>
+#include <sstream>
+
+
+/*!
+ * \brief Reads the tuning parameters and the candidates.
+ *
+ * If the file of the selected options already exists, its options are
+ * inserted and the tuning is disabled.
+ *
+ * \param defaultFile Default path of the file of the selected options
+ * \param haveDM Whether a grid is attached to the solver (geometric multigrid candidate)
+ */
+PetscErrorCode Autotuner::setFromOptions(std::string defaultFile, PetscBool haveDM)
+{
+  PetscErrorCode ierr;
+
+  ierr = PetscOptionsGetBool(NULL, prefix.c_str(), "-autotune", &enabled, NULL); CHKERRQ(ierr);
+  if (!enabled)
+    return 0;
+
+  std::string name = prefix.substr(0, prefix.size()-1);
+  char path[PETSC_MAX_PATH_LEN];
+  PetscBool found;
+  ierr = PetscOptionsGetString(NULL, prefix.c_str(), "-autotune_file", path, sizeof(path), &found); CHKERRQ(ierr);
+  file = (found) ? std::string(path) : defaultFile;
+  ierr = PetscOptionsGetInt(NULL, prefix.c_str(), "-autotune_solves", &numSolves, NULL); CHKERRQ(ierr);
+  if (numSolves < 1)
+  {
+    SETERRQ1(PETSC_COMM_WORLD, PETSC_ERR_ARG_OUTOFRANGE,
+             "-%sautotune_solves should be positive", prefix.c_str());
+  }
+
+  // options selected by a previous run
+  PetscBool exists;
+  ierr = PetscTestFile(file.c_str(), 'r', &exists); CHKERRQ(ierr);
+  if (exists)
+  {
+    ierr = PetscOptionsInsertFile(PETSC_COMM_WORLD, NULL, file.c_str(), PETSC_TRUE); CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD, "Autotune of the %s solver: options read from %s\n",
+                       name.c_str(), file.c_str()); CHKERRQ(ierr);
+    enabled = PETSC_FALSE;
+    return 0;
+  }
+
+  // the first candidate is the configuration of the options file
+  candidates.assign(1, "");
+  ierr = PetscOptionsGetString(NULL, prefix.c_str(), "-autotune_candidates", path, sizeof(path), &found); CHKERRQ(ierr);
+  if (found)
+  {
+    std::ifstream infile(path);
+    if (!infile)
+    {
+      SETERRQ1(PETSC_COMM_WORLD, PETSC_ERR_FILE_OPEN, "Unable to open the autotune candidates %s", path);
+    }
+    std::string line;
+    while (std::getline(infile, line))
+    {
+      line = line.substr(0, line.find('#'));
+      if (line.find_first_not_of(" \t\r") != std::string::npos)
+        candidates.push_back(line);
+    }
+  }
+  else
+  {
+    candidates.push_back("-ksp_type cg -pc_type jacobi");
+    candidates.push_back("-ksp_type cg -pc_type bjacobi -sub_pc_type icc");
+    candidates.push_back("-ksp_type cg -pc_type gamg -pc_gamg_type agg -pc_gamg_agg_nsmooths 1");
+    if (haveDM)
+      candidates.push_back("-ksp_type cg -pc_type mg");
+#ifdef PETSC_HAVE_HYPRE
+    candidates.push_back("-ksp_type cg -pc_type hypre -pc_hypre_type boomeramg");
+#endif
+  }
+  // check the syntax of the candidates before the first solve
+  for (size_t c=0; c<candidates.size(); c++)
+  {
+    std::vector<std::string> names, values;
+    ierr = parse(candidates[c], names, values); CHKERRQ(ierr);
+  }
+  setupTimes.assign(candidates.size(), 0.0);
+  solveTimes.assign(candidates.size(), 0.0);
+  iterations.assign(candidates.size(), 0);
+  converged.assign(candidates.size(), PETSC_FALSE);
+
+  ierr = PetscPrintf(PETSC_COMM_WORLD, "Autotune of the %s solver: %D candidates, %D solves each\n",
+                     name.c_str(), (PetscInt) candidates.size(), numSolves); CHKERRQ(ierr);
+
+  return 0;
+} // setFromOptions
+
+
+/*!
+ * \brief Splits a candidate into option names (without the dash) and values
+ *        (empty for a flag).
+ */
+PetscErrorCode Autotuner::parse(std::string candidate,
+                                std::vector<std::string> &names, std::vector<std::string> &values)
+{
+  std::istringstream stream(candidate);
+  std::string token;
+  while (stream >> token)
+  {
+    if (token.size() > 1 && token[0] == '-' && std::isalpha(token[1]))
+    {
+      names.push_back(token.substr(1));
+      values.push_back("");
+    }
+    else if (!names.empty() && values.back().empty())
+    {
+      values.back() = token;
+    }
+    else
+    {
+      SETERRQ1(PETSC_COMM_WORLD, PETSC_ERR_ARG_WRONG,
+               "Invalid autotune candidate: %s", candidate.c_str());
+    }
+  }
+
+  return 0;
+} // parse
+
+
+/*!
+ * \brief Sets the options of the current candidate under the prefix of the
+ *        solver, saving the values they replace.
+ */
+PetscErrorCode Autotuner::pushOptions()
+{
+  PetscErrorCode ierr;
+
+  std::vector<std::string> names, values;
+  ierr = parse(candidates[current], names, values); CHKERRQ(ierr);
+  pushedNames.clear();
+  savedValues.clear();
+  savedSet.clear();
+  for (size_t i=0; i<names.size(); i++)
+  {
+    std::string name = "-" + prefix + names[i];
+    char value[PETSC_MAX_PATH_LEN];
+    PetscBool set;
+    ierr = PetscOptionsGetString(NULL, NULL, name.c_str(), value, sizeof(value), &set); CHKERRQ(ierr);
+    pushedNames.push_back(name);
+    savedValues.push_back((set) ? std::string(value) : "");
+    savedSet.push_back(set);
+    ierr = PetscOptionsSetValue(NULL, name.c_str(),
+                                (values[i].empty()) ? NULL : values[i].c_str()); CHKERRQ(ierr);
+  }
+
+  return 0;
+} // pushOptions
+
+
+/*!
+ * \brief Restores the options replaced by `pushOptions`.
+ */
+PetscErrorCode Autotuner::popOptions()
+{
+  PetscErrorCode ierr;
+
+  for (size_t i=0; i<pushedNames.size(); i++)
+  {
+    if (savedSet[i])
+    {
+      ierr = PetscOptionsSetValue(NULL, pushedNames[i].c_str(),
+                                  (savedValues[i].empty()) ? NULL : savedValues[i].c_str()); CHKERRQ(ierr);
+    }
+    else
+    {
+      ierr = PetscOptionsClearValue(NULL, pushedNames[i].c_str()); CHKERRQ(ierr);
+    }
+  }
+  pushedNames.clear();
+
+  return 0;
+} // popOptions
+
+
+/*!
+ * \brief Records a converged timed solve of the current candidate.
+ *
+ * The times are the maximum over the processes, so that all processes select
+ * the same candidate.
+ *
+ * \param setupTime Time to set up the KSP (first timed solve of the candidate only)
+ * \param solveTime Time of the solve
+ * \param its Number of iterations of the solve
+ * \param done Returns whether the candidate is complete
+ * \param better Returns whether the complete candidate is the fastest so far
+ */
+PetscErrorCode Autotuner::record(PetscLogDouble setupTime, PetscLogDouble solveTime, PetscInt its,
+                                 PetscBool &done, PetscBool &better)
+{
+  PetscErrorCode ierr;
+
+  PetscLogDouble times[2] = {setupTime, solveTime},
+                 maxTimes[2];
+  ierr = MPI_Allreduce(times, maxTimes, 2, MPI_DOUBLE, MPI_MAX, PETSC_COMM_WORLD); CHKERRQ(ierr);
+  setupTimes[current] += maxTimes[0];
+  solveTimes[current] += maxTimes[1];
+  iterations[current] += its;
+  count++;
+
+  done = PETSC_FALSE;
+  better = PETSC_FALSE;
+  if (count < numSolves)
+    return 0;
+
+  done = PETSC_TRUE;
+  converged[current] = PETSC_TRUE;
+  if (best < 0 || solveTimes[current] < solveTimes[best])
+  {
+    best = current;
+    better = PETSC_TRUE;
+  }
+  ierr = next(); CHKERRQ(ierr);
+
+  return 0;
+} // record
+
+
+/*!
+ * \brief Discards the current candidate (diverged solve).
+ */
+PetscErrorCode Autotuner::reject()
+{
+  PetscErrorCode ierr;
+
+  converged[current] = PETSC_FALSE;
+  ierr = next(); CHKERRQ(ierr);
+
+  return 0;
+} // reject
+
+
+/*!
+ * \brief Moves to the next candidate; writes the selection after the last one.
+ */
+PetscErrorCode Autotuner::next()
+{
+  PetscErrorCode ierr;
+
+  current++;
+  count = 0;
+  if (current == (PetscInt) candidates.size())
+  {
+    ierr = writeSelection(); CHKERRQ(ierr);
+  }
+
+  return 0;
+} // next
+
+
+/*!
+ * \brief Prints the timings of the candidates and writes the options of the
+ *        selected one (with the prefix of the solver).
+ *
+ * The file only holds comments when the configuration of the options file is
+ * the fastest.
+ */
+PetscErrorCode Autotuner::writeSelection()
+{
+  PetscErrorCode ierr;
+
+  std::ostringstream summary;
+  summary << "# autotune of the " << prefix.substr(0, prefix.size()-1) << " solver (same system, "
+          << "1 warm-up solve and " << numSolves << " timed solves per candidate)\n"
+          << "# candidate: setup time (s), mean solve time (s), mean iterations\n";
+  for (size_t c=0; c<candidates.size(); c++)
+  {
+    summary << "# " << ((c == 0) ? "options file" : candidates[c]) << ": ";
+    if (converged[c])
+      summary << setupTimes[c] << ", " << solveTimes[c]/numSolves << ", "
+              << ((PetscReal) iterations[c])/numSolves << "\n";
+    else
+      summary << "diverged\n";
+  }
+  if (best < 0)
+  {
+    summary << "# no candidate converged\n";
+    best = 0;
+  }
+  summary << "# selected: " << ((best == 0) ? "options file" : candidates[best]) << "\n";
+  std::vector<std::string> names, values;
+  ierr = parse(candidates[best], names, values); CHKERRQ(ierr);
+  for (size_t i=0; i<names.size(); i++)
+    summary << "-" << prefix << names[i] << ((values[i].empty()) ? "" : " " + values[i]) << "\n";
+
+  ierr = PetscPrintf(PETSC_COMM_WORLD, "%s", summary.str().c_str()); CHKERRQ(ierr);
+
+  PetscMPIInt rank;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+  if (rank == 0)
+  {
+    std::ofstream outfile(file.c_str());
+    outfile << summary.str();
+    outfile.close();
+  }
+
+  return 0;
+} // writeSelection
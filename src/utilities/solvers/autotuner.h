@@ -0,0 +1,77 @@
+/*! Implementation of the class `Autotuner`.
+ * \file autotuner.h
+ */
+
+#if !defined(AUTOTUNER_H)
+#define AUTOTUNER_H
+
+#include <petscsys.h>
+#include <petsctime.h>
+
+#include <string>
+#include <vector>
+
+
+/*!
+ * \class Autotuner
+ * \brief Selects, at the first solve, the fastest of a set of KSP/PC
+ *        configurations of a solver.
+ *
+ * The candidates are tried in turn on the system of the first solve, from the
+ * same initial guess: after a warm-up solve, which is not timed, each one is
+ * timed over `-<prefix>autotune_solves` solves (default 3); the first
+ * candidate is the configuration of the options file. A candidate is a list
+ * of options without the prefix (for example, `-ksp_type cg -pc_type gamg`),
+ * set under the prefix of the solver while its KSP is created and set up.
+ * The candidate with the smallest mean solve time (the preconditioner is set
+ * up once) is kept, and its options are written, after the times and the
+ * iteration counts of all candidates, to a file that replaces the tuning at
+ * the next run.
+ *
+ * Options (with the prefix of the solver):
+ * - `-autotune`: enables the tuning;
+ * - `-autotune_candidates <file>`: file with one candidate per line (`#` starts a comment);
+ *   without it, a built-in set based on Jacobi, block-Jacobi/ICC, GAMG (and
+ *   geometric multigrid when a grid is attached, BoomerAMG with hypre) is used;
+ * - `-autotune_solves <n>`: number of timed solves per candidate;
+ * - `-autotune_file <file>`: file of the selected options.
+ */
+class Autotuner
+{
+public:
+  Autotuner(std::string p)
+    : prefix(p), enabled(PETSC_FALSE), numSolves(3), current(0), count(0), best(-1) { };
+
+  PetscErrorCode setFromOptions(std::string defaultFile, PetscBool haveDM);
+  PetscBool tuning() { return (enabled && current < (PetscInt) candidates.size()) ? PETSC_TRUE : PETSC_FALSE; };
+  PetscInt candidate() { return current; };
+  PetscErrorCode pushOptions();
+  PetscErrorCode popOptions();
+  PetscErrorCode record(PetscLogDouble setupTime, PetscLogDouble solveTime, PetscInt its,
+                        PetscBool &done, PetscBool &better);
+  PetscErrorCode reject();
+
+private:
+  std::string prefix;
+  std::string file;   // selected options
+  PetscBool enabled;
+  PetscInt numSolves, // timed solves per candidate (after the warm-up solve)
+           current,   // candidate being tried
+           count,     // timed solves done with the current candidate
+           best;      // fastest candidate so far (-1 if none)
+  std::vector<std::string> candidates;
+  std::vector<PetscLogDouble> setupTimes, solveTimes; // max over the processes
+  std::vector<PetscInt> iterations;
+  std::vector<PetscBool> converged;
+  // options replaced while a candidate is set up, and their previous values
+  std::vector<std::string> pushedNames, savedValues;
+  std::vector<PetscBool> savedSet;
+
+  PetscErrorCode parse(std::string candidate,
+                       std::vector<std::string> &names, std::vector<std::string> &values);
+  PetscErrorCode next();
+  PetscErrorCode writeSelection();
+
+}; // Autotuner
+
+#endif
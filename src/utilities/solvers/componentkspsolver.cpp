@@ -0,0 +1,330 @@
+/*! Implementation of the methods of the class `ComponentKSPSolver`.
+ * \file componentkspsolver.cpp
+ */
+
+#include "componentkspsolver.h"
+
+
+/*!
+ * \brief Destroys the solvers, blocks and communication structures.
+ */
+ComponentKSPSolver::~ComponentKSPSolver()
+{
+  for (size_t c=0; c<ksps.size(); c++)
+  {
+    KSPDestroy(&ksps[c]);
+    MatDestroy(&subMats[c]);
+  }
+  for (size_t c=0; c<scatters.size(); c++)
+  {
+    VecScatterDestroy(&scatters[c]);
+    VecDestroy(&xGroup[c]);
+    VecDestroy(&bGroup[c]);
+    VecDestroy(&xSub[c]);
+    VecDestroy(&bSub[c]);
+  }
+  if (isComponents)
+  {
+    for (PetscInt c=0; c<numComponents; c++)
+      ISDestroy(&isComponents[c]);
+    PetscFree(isComponents);
+  }
+  if (subComm != MPI_COMM_NULL)
+    MPI_Comm_free(&subComm);
+} // ~ComponentKSPSolver
+
+
+/*!
+ * \brief Extracts the diagonal blocks of the matrix and creates one KSP per block.
+ *
+ * In concurrent mode, the processes are split into contiguous groups and
+ * each block is moved to the group in charge of it.
+ */
+PetscErrorCode ComponentKSPSolver::create(const Mat &M)
+{
+  PetscErrorCode ierr;
+
+  ierr = PetscOptionsInsertFile(PETSC_COMM_WORLD, NULL,
+                                options.c_str(), PETSC_FALSE); CHKERRQ(ierr);
+  ierr = guess.setFromOptions(); CHKERRQ(ierr);
+  A = M;
+
+  ierr = DMCompositeGetNumberDM(dmPack, &numComponents); CHKERRQ(ierr);
+  ierr = DMCompositeGetGlobalISs(dmPack, &isComponents); CHKERRQ(ierr);
+
+  PetscMPIInt rank, size;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD, &size); CHKERRQ(ierr);
+  if (concurrent)
+  {
+    numGroups = PetscMin(size, (PetscMPIInt) numComponents);
+    group = (rank*numGroups)/size;
+    ierr = MPI_Comm_split(PETSC_COMM_WORLD, group, rank, &subComm); CHKERRQ(ierr);
+    scatters.assign(numComponents, NULL);
+    xGroup.assign(numComponents, NULL);
+    bGroup.assign(numComponents, NULL);
+    xSub.assign(numComponents, NULL);
+    bSub.assign(numComponents, NULL);
+  }
+  ksps.assign(numComponents, NULL);
+  subMats.assign(numComponents, NULL);
+
+  for (PetscInt c=0; c<numComponents; c++)
+  {
+    Mat Ac;
+    ierr = MatGetSubMatrix(A, isComponents[c], isComponents[c], MAT_INITIAL_MATRIX, &Ac); CHKERRQ(ierr);
+    if (concurrent)
+    {
+      ierr = redistributeBlock(Ac, c); CHKERRQ(ierr);
+      ierr = MatDestroy(&Ac); CHKERRQ(ierr);
+    }
+    else
+    {
+      subMats[c] = Ac;
+      ierr = createKSP(PETSC_COMM_WORLD, subMats[c], c); CHKERRQ(ierr);
+    }
+  }
+
+  return 0;
+} // create
+
+
+/*!
+ * \brief Creates the KSP of a block.
+ *
+ * The options with the prefix of the solver apply to all blocks;
+ * they are overridden by the options with the prefix of the block
+ * (for example, `-velocity_x_pc_type`).
+ */
+PetscErrorCode ComponentKSPSolver::createKSP(MPI_Comm comm, Mat M, PetscInt component)
+{
+  PetscErrorCode ierr;
+
+  const char *componentPrefixes[3] = {"x_", "y_", "z_"};
+
+  ierr = KSPCreate(comm, &ksps[component]); CHKERRQ(ierr);
+  ierr = KSPSetOptionsPrefix(ksps[component], prefix.c_str()); CHKERRQ(ierr);
+  ierr = KSPSetOperators(ksps[component], M, M); CHKERRQ(ierr);
+  ierr = KSPSetType(ksps[component], KSPCG); CHKERRQ(ierr);
+  ierr = KSPSetReusePreconditioner(ksps[component], PETSC_TRUE); CHKERRQ(ierr);
+  ierr = KSPSetInitialGuessNonzero(ksps[component], guess.nonzero()); CHKERRQ(ierr);
+  ierr = KSPSetFromOptions(ksps[component]); CHKERRQ(ierr);
+  ierr = KSPAppendOptionsPrefix(ksps[component], componentPrefixes[component]); CHKERRQ(ierr);
+  ierr = KSPSetFromOptions(ksps[component]); CHKERRQ(ierr);
+
+  return 0;
+} // createKSP
+
+
+/*!
+ * \brief Moves a diagonal block to the group of processes in charge of it.
+ *
+ * The rows of the block are split evenly among the processes of the group;
+ * the block is then copied into a matrix living on the sub-communicator of the
+ * group (the groups are contiguous in rank, so the ownership ranges agree).
+ */
+PetscErrorCode ComponentKSPSolver::redistributeBlock(Mat Ac, PetscInt component)
+{
+  PetscErrorCode ierr;
+
+  PetscInt N;
+  ierr = MatGetSize(Ac, &N, NULL); CHKERRQ(ierr);
+
+  // rows owned by the process in the redistributed block
+  PetscInt n = 0, start = 0;
+  PetscBool inCharge = (component%numGroups == group) ? PETSC_TRUE : PETSC_FALSE;
+  if (inCharge)
+  {
+    PetscMPIInt subRank, subSize;
+    ierr = MPI_Comm_rank(subComm, &subRank); CHKERRQ(ierr);
+    ierr = MPI_Comm_size(subComm, &subSize); CHKERRQ(ierr);
+    n = N/subSize + ((subRank < N%subSize) ? 1 : 0);
+    start = subRank*(N/subSize) + PetscMin((PetscInt) subRank, N%subSize);
+  }
+  IS isGroup;
+  ierr = ISCreateStride(PETSC_COMM_WORLD, n, start, 1, &isGroup); CHKERRQ(ierr);
+
+  Mat AGroup;
+  ierr = MatGetSubMatrix(Ac, isGroup, isGroup, MAT_INITIAL_MATRIX, &AGroup); CHKERRQ(ierr);
+
+  // scatter from the component of a packed vector to the group
+  Vec xc;
+  ierr = MatCreateVecs(Ac, &xc, NULL); CHKERRQ(ierr);
+  ierr = VecCreateMPI(PETSC_COMM_WORLD, n, N, &xGroup[component]); CHKERRQ(ierr);
+  ierr = VecDuplicate(xGroup[component], &bGroup[component]); CHKERRQ(ierr);
+  ierr = VecScatterCreate(xc, isGroup, xGroup[component], isGroup, &scatters[component]); CHKERRQ(ierr);
+  ierr = VecDestroy(&xc); CHKERRQ(ierr);
+  ierr = ISDestroy(&isGroup); CHKERRQ(ierr);
+
+  if (inCharge)
+  {
+    // copy the rows into a matrix on the sub-communicator
+    PetscInt i, ncols;
+    const PetscInt *cols;
+    const PetscScalar *values;
+    std::vector<PetscInt> d_nnz(n, 0), o_nnz(n, 0);
+    for (i=0; i<n; i++)
+    {
+      ierr = MatGetRow(AGroup, start+i, &ncols, &cols, NULL); CHKERRQ(ierr);
+      for (PetscInt k=0; k<ncols; k++)
+      {
+        if (cols[k] >= start && cols[k] < start+n)
+          d_nnz[i]++;
+        else
+          o_nnz[i]++;
+      }
+      ierr = MatRestoreRow(AGroup, start+i, &ncols, &cols, NULL); CHKERRQ(ierr);
+    }
+    Mat M;
+    ierr = MatCreate(subComm, &M); CHKERRQ(ierr);
+    ierr = MatSetSizes(M, n, n, N, N); CHKERRQ(ierr);
+    ierr = MatSetType(M, MATAIJ); CHKERRQ(ierr);
+    ierr = MatSeqAIJSetPreallocation(M, 0, d_nnz.data()); CHKERRQ(ierr);
+    ierr = MatMPIAIJSetPreallocation(M, 0, d_nnz.data(), 0, o_nnz.data()); CHKERRQ(ierr);
+    for (i=0; i<n; i++)
+    {
+      PetscInt row = start+i;
+      ierr = MatGetRow(AGroup, row, &ncols, &cols, &values); CHKERRQ(ierr);
+      ierr = MatSetValues(M, 1, &row, ncols, cols, values, INSERT_VALUES); CHKERRQ(ierr);
+      ierr = MatRestoreRow(AGroup, row, &ncols, &cols, &values); CHKERRQ(ierr);
+    }
+    ierr = MatAssemblyBegin(M, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(M, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+    subMats[component] = M;
+
+    ierr = VecCreateMPIWithArray(subComm, 1, n, N, NULL, &xSub[component]); CHKERRQ(ierr);
+    ierr = VecCreateMPIWithArray(subComm, 1, n, N, NULL, &bSub[component]); CHKERRQ(ierr);
+    ierr = createKSP(subComm, subMats[component], component); CHKERRQ(ierr);
+  }
+  ierr = MatDestroy(&AGroup); CHKERRQ(ierr);
+
+  return 0;
+} // redistributeBlock
+
+
+/*!
+ * \brief Solves the system block by block.
+ */
+PetscErrorCode ComponentKSPSolver::solve(Vec &x, Vec &b)
+{
+  PetscErrorCode ierr;
+
+  PetscInt c;
+  Vec xc, bc;
+
+  ierr = guess.build(A, x, b); CHKERRQ(ierr);
+
+  if (concurrent)
+  {
+    // send each component (and its initial guess) to its group
+    for (c=0; c<numComponents; c++)
+    {
+      ierr = VecGetSubVector(x, isComponents[c], &xc); CHKERRQ(ierr);
+      ierr = VecGetSubVector(b, isComponents[c], &bc); CHKERRQ(ierr);
+      ierr = VecScatterBegin(scatters[c], xc, xGroup[c], INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+      ierr = VecScatterBegin(scatters[c], bc, bGroup[c], INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+      ierr = VecScatterEnd(scatters[c], xc, xGroup[c], INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+      ierr = VecScatterEnd(scatters[c], bc, bGroup[c], INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+      ierr = VecRestoreSubVector(b, isComponents[c], &bc); CHKERRQ(ierr);
+      ierr = VecRestoreSubVector(x, isComponents[c], &xc); CHKERRQ(ierr);
+    }
+  }
+
+  std::vector<PetscInt> localIters(numComponents, 0), componentIters(numComponents, 0);
+  std::vector<PetscInt> localReasons(numComponents, 0), reasons(numComponents, 0);
+  KSPConvergedReason reason;
+  for (c=0; c<numComponents; c++)
+  {
+    if (!ksps[c])
+      continue;
+    if (concurrent)
+    {
+      PetscScalar *xArray, *bArray;
+      ierr = VecGetArray(xGroup[c], &xArray); CHKERRQ(ierr);
+      ierr = VecGetArray(bGroup[c], &bArray); CHKERRQ(ierr);
+      ierr = VecPlaceArray(xSub[c], xArray); CHKERRQ(ierr);
+      ierr = VecPlaceArray(bSub[c], bArray); CHKERRQ(ierr);
+      ierr = KSPSolve(ksps[c], bSub[c], xSub[c]); CHKERRQ(ierr);
+      ierr = VecResetArray(bSub[c]); CHKERRQ(ierr);
+      ierr = VecResetArray(xSub[c]); CHKERRQ(ierr);
+      ierr = VecRestoreArray(bGroup[c], &bArray); CHKERRQ(ierr);
+      ierr = VecRestoreArray(xGroup[c], &xArray); CHKERRQ(ierr);
+    }
+    else
+    {
+      ierr = VecGetSubVector(x, isComponents[c], &xc); CHKERRQ(ierr);
+      ierr = VecGetSubVector(b, isComponents[c], &bc); CHKERRQ(ierr);
+      ierr = KSPSolve(ksps[c], bc, xc); CHKERRQ(ierr);
+      ierr = VecRestoreSubVector(b, isComponents[c], &bc); CHKERRQ(ierr);
+      ierr = VecRestoreSubVector(x, isComponents[c], &xc); CHKERRQ(ierr);
+    }
+    ierr = KSPGetIterationNumber(ksps[c], &localIters[c]); CHKERRQ(ierr);
+    ierr = KSPGetConvergedReason(ksps[c], &reason); CHKERRQ(ierr);
+    localReasons[c] = (PetscInt) reason;
+  }
+
+  if (concurrent)
+  {
+    // bring the solution back into the packed vector
+    for (c=0; c<numComponents; c++)
+    {
+      ierr = VecGetSubVector(x, isComponents[c], &xc); CHKERRQ(ierr);
+      ierr = VecScatterBegin(scatters[c], xGroup[c], xc, INSERT_VALUES, SCATTER_REVERSE); CHKERRQ(ierr);
+      ierr = VecScatterEnd(scatters[c], xGroup[c], xc, INSERT_VALUES, SCATTER_REVERSE); CHKERRQ(ierr);
+      ierr = VecRestoreSubVector(x, isComponents[c], &xc); CHKERRQ(ierr);
+    }
+    // only the processes of the group in charge know the outcome of a solve
+    ierr = MPI_Allreduce(&localIters[0], &componentIters[0], numComponents, MPIU_INT, MPI_MAX, PETSC_COMM_WORLD); CHKERRQ(ierr);
+    ierr = MPI_Allreduce(&localReasons[0], &reasons[0], numComponents, MPIU_INT, MPI_MIN, PETSC_COMM_WORLD); CHKERRQ(ierr);
+  }
+  else
+  {
+    componentIters = localIters;
+    reasons = localReasons;
+  }
+
+  totalIters = 0;
+  for (c=0; c<numComponents; c++)
+  {
+    totalIters += componentIters[c];
+    if (reasons[c] < 0)
+    {
+      ierr = PetscPrintf(PETSC_COMM_WORLD,
+              "\nERROR: %s solver diverged for component %D due to reason: %D\n",
+              prefix.substr(0, prefix.size()-1).c_str(), c, reasons[c]); CHKERRQ(ierr);
+      ierr = PetscFinalize(); CHKERRQ(ierr);
+      exit(1);
+    }
+  }
+  ierr = guess.update(A, x); CHKERRQ(ierr);
+
+  return 0;
+} // solve
+
+
+/*!
+ * \brief Get the number of iterations performed, summed over the components.
+ */
+PetscErrorCode ComponentKSPSolver::getIters(PetscInt &iters)
+{
+  iters = totalIters;
+
+  return 0;
+} // getIters
+
+
+/*!
+ * \brief Selects the history of previous solutions used to build the initial
+ *        guess of the next solves, and where their solutions are stored.
+ *
+ * \param index Index of the history (0 by default); negative to start from the
+ *        given solution vector without storing the solution
+ */
+PetscErrorCode ComponentKSPSolver::setHistory(PetscInt index)
+{
+  PetscErrorCode ierr;
+
+  ierr = guess.select(index); CHKERRQ(ierr);
+
+  return 0;
+} // setHistory
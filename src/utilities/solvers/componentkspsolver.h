@@ -0,0 +1,69 @@
+/*! Implementation of the class `ComponentKSPSolver`.
+ * \file componentkspsolver.h
+ */
+
+#if !defined(COMPONENTKSPSOLVER_H)
+#define COMPONENTKSPSOLVER_H
+
+#include "solver.h"
+#include "initialguess.h"
+
+#include <petscdmcomposite.h>
+#include <petscksp.h>
+
+#include <string>
+#include <vector>
+
+
+/*!
+ * \class ComponentKSPSolver
+ * \brief Solves a block-diagonal system with one PETSc KSP per block.
+ *
+ * The blocks are the sub-DMs of a DMComposite (the velocity components of
+ * `qPack`). The blocks are either solved one after another on all processes,
+ * or at the same time on groups of processes (one group per block).
+ */
+class ComponentKSPSolver : public Solver
+{
+public:
+  ComponentKSPSolver(std::string p, std::string f, DM pack, PetscBool c)
+    : prefix(p), options(f), dmPack(pack), concurrent(c),
+      numComponents(0), isComponents(NULL),
+      subComm(MPI_COMM_NULL), group(0), numGroups(1), totalIters(0),
+      A(NULL), guess(p) { };
+  virtual ~ComponentKSPSolver();
+
+  PetscErrorCode create(const Mat &A);
+  PetscErrorCode solve(Vec &x, Vec &b);
+  PetscErrorCode getIters(PetscInt &iters);
+  PetscErrorCode setHistory(PetscInt index);
+
+private:
+  std::string prefix;
+  std::string options;
+  DM dmPack;
+  PetscBool concurrent;
+
+  PetscInt numComponents;
+  IS *isComponents;             // indices of each component in the packed vector
+
+  MPI_Comm subComm;             // processes of the group (concurrent solves)
+  PetscMPIInt group,            // group of the process
+              numGroups;        // number of groups of processes
+  std::vector<KSP> ksps;        // NULL if the component is solved by another group
+  std::vector<Mat> subMats;     // diagonal blocks of the matrix
+  std::vector<VecScatter> scatters; // component to its group of processes
+  std::vector<Vec> xGroup, bGroup,  // components distributed over their group
+                   xSub, bSub;      // same values seen from the sub-communicator
+
+  PetscInt totalIters;          // iterations summed over the components
+
+  Mat A;                        // operator of the whole system
+  InitialGuess guess;           // built from the previous solutions (all components)
+
+  PetscErrorCode createKSP(MPI_Comm comm, Mat M, PetscInt component);
+  PetscErrorCode redistributeBlock(Mat Ac, PetscInt component);
+
+}; // ComponentKSPSolver
+
+#endif
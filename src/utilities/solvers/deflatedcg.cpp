@@ -0,0 +1,501 @@
+/*! Implementation of the methods of the class `DeflatedCG`.
+ * \file deflatedcg.cpp
+ */
+
+#include "deflatedcg.h"
+
+#include <petscblaslapack.h>
+
+
+/*!
+ * \brief Destroys the deflation space, the harvested vectors, the stored
+ *        directions and the work vectors.
+ */
+DeflatedCG::~DeflatedCG()
+{
+  for (size_t i=0; i<W.size(); i++)
+  {
+    VecDestroy(&W[i]);
+    VecDestroy(&AW[i]);
+    VecDestroy(&MW[i]);
+    VecDestroy(&V[i]);
+    VecDestroy(&AV[i]);
+    VecDestroy(&MV[i]);
+    VecDestroy(&T[i]);
+    VecDestroy(&AT[i]);
+    VecDestroy(&MT[i]);
+  }
+  for (size_t i=0; i<P.size(); i++)
+  {
+    VecDestroy(&P[i]);
+    VecDestroy(&AP[i]);
+    VecDestroy(&MP[i]);
+  }
+  VecDestroy(&r);
+  VecDestroy(&z);
+  VecDestroy(&p);
+  VecDestroy(&q);
+  VecDestroy(&Mp);
+} // ~DeflatedCG
+
+
+/*!
+ * \brief Reads the size of the deflation space, the harvest parameters and
+ *        the baseline iteration count.
+ */
+PetscErrorCode DeflatedCG::setFromOptions()
+{
+  PetscErrorCode ierr;
+
+  ierr = PetscOptionsGetInt(NULL, prefix.c_str(), "-recycle_size", &size, NULL); CHKERRQ(ierr);
+  harvestSize = size;
+  ierr = PetscOptionsGetInt(NULL, prefix.c_str(), "-recycle_harvest", &harvestSize, NULL); CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL, prefix.c_str(), "-recycle_interval", &interval, NULL); CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL, prefix.c_str(), "-recycle_baseline_its", &baselineIters, &fixedBaseline); CHKERRQ(ierr);
+  if (size < 0 || (size > 0 && harvestSize < 1) || interval < 1)
+  {
+    SETERRQ1(PETSC_COMM_WORLD, PETSC_ERR_ARG_OUTOFRANGE,
+             "invalid recycling parameters for the solver with prefix %s", prefix.c_str());
+  }
+
+  return 0;
+} // setFromOptions
+
+
+/*!
+ * \brief Creates the work vectors, the storage of the deflation space, of the
+ *        harvested vectors and of the search directions.
+ */
+PetscErrorCode DeflatedCG::allocate(Vec x)
+{
+  PetscErrorCode ierr;
+
+  if (r)
+    return 0;
+
+  ierr = VecDuplicate(x, &r); CHKERRQ(ierr);
+  ierr = VecDuplicate(x, &z); CHKERRQ(ierr);
+  ierr = VecDuplicate(x, &p); CHKERRQ(ierr);
+  ierr = VecDuplicate(x, &q); CHKERRQ(ierr);
+  ierr = VecDuplicate(x, &Mp); CHKERRQ(ierr);
+  std::vector<Vec> *spaces[] = {&W, &AW, &MW, &V, &AV, &MV, &T, &AT, &MT};
+  for (size_t s=0; s<9; s++)
+  {
+    spaces[s]->assign(size, NULL);
+    for (PetscInt i=0; i<size; i++)
+    {
+      ierr = VecDuplicate(x, &(*spaces[s])[i]); CHKERRQ(ierr);
+    }
+  }
+  P.assign(harvestSize, NULL);
+  AP.assign(harvestSize, NULL);
+  MP.assign(harvestSize, NULL);
+  for (PetscInt i=0; i<harvestSize; i++)
+  {
+    ierr = VecDuplicate(x, &P[i]); CHKERRQ(ierr);
+    ierr = VecDuplicate(x, &AP[i]); CHKERRQ(ierr);
+    ierr = VecDuplicate(x, &MP[i]); CHKERRQ(ierr);
+  }
+
+  return 0;
+} // allocate
+
+
+/*!
+ * \brief Solves \f$ (W^T A W) \mu = c \f$ in place.
+ */
+PetscErrorCode DeflatedCG::applyEInverse(std::vector<PetscScalar> &mu)
+{
+  PetscErrorCode ierr;
+
+  PetscBLASInt n, one = 1, info;
+  ierr = PetscBLASIntCast(numDeflation, &n); CHKERRQ(ierr);
+  LAPACKpotrs_("L", &n, &one, &choleskyE[0], &n, &mu[0], &n, &info);
+  if (info != 0)
+  {
+    SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_LIB, "LAPACK potrs failed with info %d", (int) info);
+  }
+
+  return 0;
+} // applyEInverse
+
+
+/*!
+ * \brief Computes the norm of a vector of the type used by the KSP.
+ *
+ * \param normType Norm type of the KSP
+ * \param v Vector
+ * \param Bv Preconditioned vector
+ * \param vBv Dot product of the vector and of the preconditioned vector
+ * \param norm Returns the norm
+ */
+PetscErrorCode DeflatedCG::computeNorm(KSPNormType normType, Vec v, Vec Bv, PetscScalar vBv, PetscReal &norm)
+{
+  PetscErrorCode ierr;
+
+  switch (normType)
+  {
+    case KSP_NORM_PRECONDITIONED:
+      ierr = VecNorm(Bv, NORM_2, &norm); CHKERRQ(ierr);
+      break;
+    case KSP_NORM_UNPRECONDITIONED:
+      ierr = VecNorm(v, NORM_2, &norm); CHKERRQ(ierr);
+      break;
+    case KSP_NORM_NATURAL:
+      norm = PetscSqrtReal(PetscAbsScalar(vBv));
+      break;
+    default:
+      SETERRQ1(PETSC_COMM_WORLD, PETSC_ERR_SUP,
+               "the deflated CG of the solver with prefix %s needs a residual norm", prefix.c_str());
+  }
+
+  return 0;
+} // computeNorm
+
+
+/*!
+ * \brief Tests the convergence of the iterations as `KSPConvergedDefault`.
+ *
+ * The residual norm is compared with the relative tolerance times the norm
+ * (of the same type) of the right-hand side, with the absolute tolerance, and
+ * with the divergence tolerance times the norm of the right-hand side.
+ *
+ * \param ksp Krylov solver providing the tolerances
+ * \param its Number of iterations performed
+ * \param rNorm Residual norm
+ * \param bNorm Norm of the right-hand side
+ * \param reason Returns the reason (`KSP_CONVERGED_ITERATING` to go on)
+ */
+void DeflatedCG::testConvergence(KSP ksp, PetscInt its, PetscReal rNorm, PetscReal bNorm,
+                                 KSPConvergedReason &reason)
+{
+  PetscReal rtol, atol, dtol;
+  PetscInt maxits;
+  KSPGetTolerances(ksp, &rtol, &atol, &dtol, &maxits);
+
+  reason = KSP_CONVERGED_ITERATING;
+  if (PetscIsInfOrNanReal(rNorm))
+    reason = KSP_DIVERGED_NANORINF;
+  else if (rNorm <= PetscMax(rtol*bNorm, atol))
+    reason = (rNorm < atol) ? KSP_CONVERGED_ATOL : KSP_CONVERGED_RTOL;
+  else if (rNorm >= dtol*bNorm)
+    reason = KSP_DIVERGED_DTOL;
+  else if (its >= maxits)
+    reason = KSP_DIVERGED_ITS;
+} // testConvergence
+
+
+/*!
+ * \brief Solves the system with the deflated preconditioned conjugate gradient.
+ *
+ * The initial guess is corrected so that the residual is orthogonal to the
+ * deflation space; the search directions are then kept A-orthogonal to it.
+ * During a harvesting solve (one every `interval` solves), the search
+ * directions (and their products with A and M) are stored, and a Rayleigh-Ritz
+ * procedure updates the harvested vectors every `harvestSize` directions; they
+ * replace the deflation space at the end of the solve. The residual norm is
+ * that of the norm type of the KSP (preconditioned by default); it is passed
+ * to the monitors of the KSP and tested as by `KSPConvergedDefault`, with
+ * the relative, absolute and divergence tolerances of the KSP (a convergence
+ * test set with `KSPSetConvergenceTest` is not used).
+ *
+ * \param ksp Krylov solver providing the operator, the preconditioner and the tolerances
+ * \param x Solution vector (and initial guess if the KSP uses a nonzero initial guess)
+ * \param b Right-hand side
+ * \param reason Returns the reason for convergence or divergence
+ */
+PetscErrorCode DeflatedCG::solve(KSP ksp, Vec x, Vec b, KSPConvergedReason &reason)
+{
+  PetscErrorCode ierr;
+
+  Mat A;
+  PC pc;
+  MatNullSpace nullsp;
+  KSPNormType normType;
+  PetscBool nonzero;
+  ierr = KSPGetOperators(ksp, &A, NULL); CHKERRQ(ierr);
+  ierr = KSPGetPC(ksp, &pc); CHKERRQ(ierr);
+  ierr = KSPGetNormType(ksp, &normType); CHKERRQ(ierr);
+  ierr = KSPGetInitialGuessNonzero(ksp, &nonzero); CHKERRQ(ierr);
+  ierr = MatGetNullSpace(A, &nullsp); CHKERRQ(ierr);
+  ierr = KSPSetUp(ksp); CHKERRQ(ierr);
+  ierr = allocate(x); CHKERRQ(ierr);
+
+  // norm of the right-hand side, of the type of the residual norm
+  PetscReal bNorm;
+  PetscScalar bz = 0.0;
+  if (normType != KSP_NORM_UNPRECONDITIONED)
+  {
+    ierr = PCApply(pc, b, z); CHKERRQ(ierr);
+    ierr = VecDot(b, z, &bz); CHKERRQ(ierr);
+  }
+  ierr = computeNorm(normType, b, z, bz, bNorm); CHKERRQ(ierr);
+
+  // initial residual, orthogonal to the deflation space
+  if (!nonzero)
+  {
+    ierr = VecSet(x, 0.0); CHKERRQ(ierr);
+  }
+  ierr = MatMult(A, x, r); CHKERRQ(ierr);
+  ierr = VecAYPX(r, -1.0, b); CHKERRQ(ierr);
+  if (nullsp)
+  {
+    ierr = MatNullSpaceRemove(nullsp, r); CHKERRQ(ierr);
+  }
+  std::vector<PetscScalar> mu(PetscMax(numDeflation, 1));
+  if (numDeflation > 0)
+  {
+    ierr = VecMDot(r, numDeflation, &W[0], &mu[0]); CHKERRQ(ierr);
+    ierr = applyEInverse(mu); CHKERRQ(ierr);
+    ierr = VecMAXPY(x, numDeflation, &mu[0], &W[0]); CHKERRQ(ierr);
+    for (PetscInt i=0; i<numDeflation; i++)
+      mu[i] = -mu[i];
+    ierr = VecMAXPY(r, numDeflation, &mu[0], &AW[0]); CHKERRQ(ierr);
+  }
+
+  // the harvest starts from the current deflation space
+  PetscBool harvesting = (numSolves%interval == 0) ? PETSC_TRUE : PETSC_FALSE;
+  numStored = 0;
+  numHarvested = 0;
+  if (harvesting)
+  {
+    for (PetscInt i=0; i<numDeflation; i++)
+    {
+      ierr = VecCopy(W[i], V[i]); CHKERRQ(ierr);
+      ierr = VecCopy(AW[i], AV[i]); CHKERRQ(ierr);
+      ierr = VecCopy(MW[i], MV[i]); CHKERRQ(ierr);
+    }
+    numHarvested = numDeflation;
+  }
+
+  PetscInt its = 0;
+  PetscReal rNorm;
+  PetscScalar rz, rzNew, pq, alpha, beta;
+  ierr = PCApply(pc, r, z); CHKERRQ(ierr);
+  if (nullsp)
+  {
+    ierr = MatNullSpaceRemove(nullsp, z); CHKERRQ(ierr);
+  }
+  ierr = VecDot(r, z, &rz); CHKERRQ(ierr);
+  ierr = computeNorm(normType, r, z, rz, rNorm); CHKERRQ(ierr);
+  ierr = KSPMonitor(ksp, its, rNorm); CHKERRQ(ierr);
+  testConvergence(ksp, its, rNorm, bNorm, reason);
+  ierr = VecCopy(z, p); CHKERRQ(ierr);
+  ierr = VecCopy(r, Mp); CHKERRQ(ierr);
+  while (!reason)
+  {
+    // remove the components of the direction along the deflation space
+    if (numDeflation > 0)
+    {
+      ierr = VecMDot(z, numDeflation, &AW[0], &mu[0]); CHKERRQ(ierr);
+      ierr = applyEInverse(mu); CHKERRQ(ierr);
+      for (PetscInt i=0; i<numDeflation; i++)
+        mu[i] = -mu[i];
+      ierr = VecMAXPY(p, numDeflation, &mu[0], &W[0]); CHKERRQ(ierr);
+      if (harvesting)
+      {
+        ierr = VecMAXPY(Mp, numDeflation, &mu[0], &MW[0]); CHKERRQ(ierr);
+      }
+    }
+
+    ierr = MatMult(A, p, q); CHKERRQ(ierr);
+    if (harvesting)
+    {
+      ierr = VecCopy(p, P[numStored]); CHKERRQ(ierr);
+      ierr = VecCopy(q, AP[numStored]); CHKERRQ(ierr);
+      ierr = VecCopy(Mp, MP[numStored]); CHKERRQ(ierr);
+      numStored++;
+      if (numStored == harvestSize)
+      {
+        ierr = rayleighRitz(); CHKERRQ(ierr);
+        numStored = 0;
+      }
+    }
+    ierr = VecDot(p, q, &pq); CHKERRQ(ierr);
+    if (PetscRealPart(pq) <= 0.0)
+    {
+      reason = KSP_DIVERGED_INDEFINITE_MAT;
+      break;
+    }
+    alpha = rz/pq;
+    ierr = VecAXPY(x, alpha, p); CHKERRQ(ierr);
+    ierr = VecAXPY(r, -alpha, q); CHKERRQ(ierr);
+    its++;
+
+    ierr = PCApply(pc, r, z); CHKERRQ(ierr);
+    if (nullsp)
+    {
+      ierr = MatNullSpaceRemove(nullsp, z); CHKERRQ(ierr);
+    }
+    ierr = VecDot(r, z, &rzNew); CHKERRQ(ierr);
+    ierr = computeNorm(normType, r, z, rzNew, rNorm); CHKERRQ(ierr);
+    ierr = KSPMonitor(ksp, its, rNorm); CHKERRQ(ierr);
+    testConvergence(ksp, its, rNorm, bNorm, reason);
+    if (reason)
+      break;
+
+    beta = rzNew/rz;
+    rz = rzNew;
+    ierr = VecAYPX(p, beta, z); CHKERRQ(ierr);
+    if (harvesting)
+    {
+      ierr = VecAYPX(Mp, beta, r); CHKERRQ(ierr);
+    }
+  }
+
+  iters = its;
+  residualNorm = rNorm;
+  if (!fixedBaseline && numDeflation == 0)
+    baselineIters = its;
+
+  if (harvesting)
+  {
+    ierr = updateDeflationSpace(); CHKERRQ(ierr);
+  }
+  numSolves++;
+
+  return 0;
+} // solve
+
+
+/*!
+ * \brief Replaces the harvested vectors by the Ritz vectors with the smallest
+ *        Ritz values of the preconditioned operator.
+ *
+ * With \f$ Y \f$ the harvested vectors and the stored directions, solves
+ * \f$ Y^T A Y s = \theta Y^T M Y s \f$ and keeps the vectors \f$ Y s \f$ of the
+ * smallest \f$ \theta \f$. The harvested vectors are left unchanged if the
+ * problem is ill-conditioned.
+ */
+PetscErrorCode DeflatedCG::rayleighRitz()
+{
+  PetscErrorCode ierr;
+
+  std::vector<Vec> Y(V.begin(), V.begin()+numHarvested),
+                   AY(AV.begin(), AV.begin()+numHarvested),
+                   MY(MV.begin(), MV.begin()+numHarvested);
+  Y.insert(Y.end(), P.begin(), P.begin()+numStored);
+  AY.insert(AY.end(), AP.begin(), AP.begin()+numStored);
+  MY.insert(MY.end(), MP.begin(), MP.begin()+numStored);
+  PetscInt n = Y.size();
+
+  std::vector<PetscScalar> G(n*n), H(n*n);
+  for (PetscInt j=0; j<n; j++)
+  {
+    ierr = VecMDot(AY[j], n, &Y[0], &G[j*n]); CHKERRQ(ierr);
+    ierr = VecMDot(MY[j], n, &Y[0], &H[j*n]); CHKERRQ(ierr);
+  }
+  for (PetscInt j=0; j<n; j++)
+  {
+    for (PetscInt i=j+1; i<n; i++)
+    {
+      G[j*n+i] = G[i*n+j] = 0.5*(G[j*n+i] + G[i*n+j]);
+      H[j*n+i] = H[i*n+j] = 0.5*(H[j*n+i] + H[i*n+j]);
+    }
+  }
+
+  PetscBLASInt bn, itype = 1, lwork, info;
+  ierr = PetscBLASIntCast(n, &bn); CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(3*n, &lwork); CHKERRQ(ierr);
+  std::vector<PetscReal> theta(n);
+  std::vector<PetscScalar> work(3*n);
+  LAPACKsygv_(&itype, "V", "L", &bn, &G[0], &bn, &H[0], &bn, &theta[0], &work[0], &lwork, &info);
+  if (info != 0)
+  {
+    ierr = PetscInfo1(NULL, "Rayleigh-Ritz skipped (LAPACK sygv info %d)\n", (int) info); CHKERRQ(ierr);
+    return 0;
+  }
+
+  // Ritz vectors of the smallest Ritz values (ascending order)
+  PetscInt k = PetscMin(size, n);
+  for (PetscInt l=0; l<k; l++)
+  {
+    ierr = VecSet(T[l], 0.0); CHKERRQ(ierr);
+    ierr = VecSet(AT[l], 0.0); CHKERRQ(ierr);
+    ierr = VecSet(MT[l], 0.0); CHKERRQ(ierr);
+    ierr = VecMAXPY(T[l], n, &G[l*n], &Y[0]); CHKERRQ(ierr);
+    ierr = VecMAXPY(AT[l], n, &G[l*n], &AY[0]); CHKERRQ(ierr);
+    ierr = VecMAXPY(MT[l], n, &G[l*n], &MY[0]); CHKERRQ(ierr);
+  }
+  V.swap(T);
+  AV.swap(AT);
+  MV.swap(MT);
+  numHarvested = k;
+
+  return 0;
+} // rayleighRitz
+
+
+/*!
+ * \brief Replaces the deflation space by the harvested vectors and factorizes
+ *        \f$ E = W^T A W \f$.
+ *
+ * The deflation space is dropped if \f$ E \f$ is not positive definite.
+ */
+PetscErrorCode DeflatedCG::updateDeflationSpace()
+{
+  PetscErrorCode ierr;
+
+  if (numHarvested == 0)
+    return 0;
+
+  W.swap(V);
+  AW.swap(AV);
+  MW.swap(MV);
+  numDeflation = numHarvested;
+  numHarvested = 0;
+
+  PetscInt k = numDeflation;
+  PetscBLASInt bk, info;
+  choleskyE.assign(k*k, 0.0);
+  for (PetscInt j=0; j<k; j++)
+  {
+    ierr = VecMDot(AW[j], k, &W[0], &choleskyE[j*k]); CHKERRQ(ierr);
+  }
+  ierr = PetscBLASIntCast(k, &bk); CHKERRQ(ierr);
+  LAPACKpotrf_("L", &bk, &choleskyE[0], &bk, &info);
+  if (info != 0)
+  {
+    ierr = PetscInfo1(NULL, "Deflation space dropped (LAPACK potrf info %d)\n", (int) info); CHKERRQ(ierr);
+    numDeflation = 0;
+  }
+
+  return 0;
+} // updateDeflationSpace
+
+
+/*!
+ * \brief Get the number of iterations of the last solve.
+ */
+PetscErrorCode DeflatedCG::getIters(PetscInt &its)
+{
+  its = iters;
+
+  return 0;
+} // getIters
+
+
+/*!
+ * \brief Get the number of iterations saved by the last solve, compared with
+ *        the baseline (0 while the baseline is not known).
+ *
+ * The baseline is the iteration count given with `-recycle_baseline_its` or,
+ * by default, that of the last solve done without deflation space.
+ */
+PetscErrorCode DeflatedCG::getSavedIters(PetscInt &its)
+{
+  its = (baselineIters < 0) ? 0 : baselineIters - iters;
+
+  return 0;
+} // getSavedIters
+
+
+/*!
+ * \brief Get the residual norm (norm type of the KSP) at the end of the last solve.
+ */
+PetscErrorCode DeflatedCG::getResidualNorm(PetscReal &norm)
+{
+  norm = residualNorm;
+
+  return 0;
+} // getResidualNorm
@@ -0,0 +1,87 @@
+/*! Implementation of the class `DeflatedCG`.
+ * \file deflatedcg.h
+ */
+
+#if !defined(DEFLATEDCG_H)
+#define DEFLATEDCG_H
+
+#include <petscksp.h>
+
+#include <string>
+#include <vector>
+
+
+/*!
+ * \class DeflatedCG
+ * \brief Preconditioned conjugate gradient with a deflation space recycled
+ *        across solves.
+ *
+ * The deflation space \f$ W \f$ holds approximations of the eigenvectors of
+ * the preconditioned operator with the smallest eigenvalues (the slowest
+ * modes); the CG iterations are kept A-orthogonal to it (Saad et al., 2000).
+ * During a harvesting solve, every `m` search directions, a Rayleigh-Ritz
+ * procedure on the span of the harvested vectors and of these directions
+ * updates the harvested vectors (as in the recycled CG of Wang et al., 2007);
+ * they become the deflation space of the following solves. The
+ * preconditioner, the tolerances and the maximum number of iterations are
+ * those of the KSP; so are the norm type of the residual (preconditioned,
+ * unpreconditioned or natural), the monitors and the convergence test
+ * (that of `KSPConvergedDefault`, with the divergence tolerance). The operator should
+ * be symmetric positive (semi-)definite.
+ *
+ * Options (with the prefix of the solver):
+ * - `-recycle_size <k>`: number of vectors of the deflation space (0, the default, disables recycling);
+ * - `-recycle_harvest <m>`: number of search directions per Rayleigh-Ritz procedure (default `k`);
+ * - `-recycle_interval <n>`: harvest during one solve every n solves (default 10);
+ * - `-recycle_baseline_its <n>`: iterations of a solve without recycling, to
+ *   which the iterations of each solve are compared (by default, those of the
+ *   last solve done without deflation space).
+ */
+class DeflatedCG
+{
+public:
+  DeflatedCG(std::string p)
+    : prefix(p), size(0), harvestSize(0), interval(10),
+      numSolves(0), numDeflation(0), numHarvested(0), numStored(0),
+      baselineIters(-1), fixedBaseline(PETSC_FALSE), iters(0), residualNorm(0.0),
+      r(NULL), z(NULL), p(NULL), q(NULL), Mp(NULL) { };
+  ~DeflatedCG();
+
+  PetscErrorCode setFromOptions();
+  PetscBool active() { return (size > 0) ? PETSC_TRUE : PETSC_FALSE; };
+  PetscErrorCode solve(KSP ksp, Vec x, Vec b, KSPConvergedReason &reason);
+  PetscErrorCode getIters(PetscInt &its);
+  PetscErrorCode getSavedIters(PetscInt &its);
+  PetscErrorCode getResidualNorm(PetscReal &norm);
+
+private:
+  std::string prefix;
+  PetscInt size,           // maximum number of vectors in the deflation space
+           harvestSize,    // number of search directions per Rayleigh-Ritz procedure
+           interval;       // number of solves between two harvests
+  PetscInt numSolves,
+           numDeflation,   // number of vectors in the deflation space
+           numHarvested,   // number of vectors harvested during the solve
+           numStored;      // number of search directions stored since the last Rayleigh-Ritz
+  PetscInt baselineIters;  // iterations without recycling (negative: not known yet)
+  PetscBool fixedBaseline; // is the baseline given by the user?
+  PetscInt iters;          // iterations of the last solve
+  PetscReal residualNorm;  // residual norm (norm type of the KSP) at the end of the last solve
+
+  std::vector<Vec> W, AW, MW;          // deflation space, and its products with A and M
+  std::vector<Vec> V, AV, MV;          // harvested vectors
+  std::vector<Vec> T, AT, MT;          // work space of the Rayleigh-Ritz procedure
+  std::vector<Vec> P, AP, MP;          // search directions since the last Rayleigh-Ritz
+  std::vector<PetscScalar> choleskyE;  // Cholesky factor of W^T A W
+  Vec r, z, p, q, Mp;                  // work vectors of the iterations
+
+  PetscErrorCode allocate(Vec x);
+  PetscErrorCode applyEInverse(std::vector<PetscScalar> &mu);
+  PetscErrorCode computeNorm(KSPNormType normType, Vec v, Vec Bv, PetscScalar vBv, PetscReal &norm);
+  void testConvergence(KSP ksp, PetscInt its, PetscReal rNorm, PetscReal bNorm, KSPConvergedReason &reason);
+  PetscErrorCode rayleighRitz();
+  PetscErrorCode updateDeflationSpace();
+
+}; // DeflatedCG
+
+#endif
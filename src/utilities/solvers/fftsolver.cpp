@@ -0,0 +1,517 @@
+/*! Implementation of the methods of the class `FFTSolver`.
+ * \file fftsolver.cpp
+ */
+
+#include <petscsys.h>
+
+#ifdef PETSC_HAVE_FFTW
+
+#include "fftsolver.h"
+
+#include <algorithm>
+
+
+/*!
+ * \brief Constructor -- Stores the grid of the pressure.
+ *
+ * \param pda DMDA of the pressure
+ * \param w Cell-widths along each direction
+ * \param u Whether the cell-widths are constant along each direction
+ * \param p Whether each direction is periodic
+ * \param s Factor of the operator (the time-step)
+ */
+FFTSolver::FFTSolver(DM pda, const std::vector<PetscReal> *w, const PetscBool *u,
+                     const PetscBool *p, PetscReal s)
+  : da(pda), scale(s), normalization(1.0), solution(NULL), bLine(NULL), xLine(NULL)
+{
+  DMDAGetInfo(da, &dim, &n[0], &n[1], &n[2], NULL, NULL, NULL,
+              NULL, NULL, NULL, NULL, NULL, NULL);
+  for (PetscInt d=0; d<3; d++)
+  {
+    if (d >= dim)
+      n[d] = 1;
+    widths[d] = (d < dim) ? w[d] : std::vector<PetscReal>(1, 1.0);
+    uniform[d] = (d < dim) ? u[d] : PETSC_TRUE;
+    periodic[d] = (d < dim) ? p[d] : PETSC_FALSE;
+  }
+} // FFTSolver
+
+
+/*!
+ * \brief Destroys the plans, factors and layouts.
+ */
+FFTSolver::~FFTSolver()
+{
+  for (size_t k=0; k<forwardPlans.size(); k++)
+  {
+    if (forwardPlans[k])
+      fftw_destroy_plan(forwardPlans[k]);
+    if (backwardPlans[k])
+      fftw_destroy_plan(backwardPlans[k]);
+  }
+  for (size_t k=0; k<pencils.size(); k++)
+  {
+    VecScatterDestroy(&scatters[k]);
+    VecDestroy(&pencils[k]);
+  }
+  for (size_t l=0; l<factors.size(); l++)
+    MatDestroy(&factors[l]);
+  VecDestroy(&solution);
+  VecDestroy(&bLine);
+  VecDestroy(&xLine);
+} // ~FFTSolver
+
+
+/*!
+ * \brief Creates the pencil layouts, the scatters between them, the plans of
+ *        the transforms and the factorizations of the remaining problems.
+ *
+ * The matrix is only used to check the size of the system: the operator
+ * is rebuilt from the cell-widths. The immersed-boundary methods, whose
+ * systems are not separable, are rejected when the simulation parameters are
+ * read.
+ */
+PetscErrorCode FFTSolver::create(const Mat &A)
+{
+  PetscErrorCode ierr;
+
+  PetscInt N;
+  ierr = MatGetSize(A, &N, NULL); CHKERRQ(ierr);
+  if (N != n[0]*n[1]*n[2])
+  {
+    SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_ARG_SIZ,
+            "the FFT solver only handles the pressure system (no immersed boundary)");
+  }
+
+  for (PetscInt d=0; d<dim; d++)
+  {
+    if (uniform[d])
+      transformed.push_back(d);
+    else
+      remaining.push_back(d);
+  }
+  if (transformed.empty())
+  {
+    SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_SUP,
+            "the FFT solver requires at least one direction with uniform cell-widths");
+  }
+
+  // one pencil per transformed direction, then one for the remaining directions
+  for (size_t k=0; k<transformed.size(); k++)
+    pencilDirections.push_back(std::vector<PetscInt>(1, transformed[k]));
+  if (!remaining.empty())
+    pencilDirections.push_back(remaining);
+  pencils.assign(pencilDirections.size(), NULL);
+  scatters.assign(pencilDirections.size(), NULL);
+
+  AO ao;
+  ierr = DMDAGetAO(da, &ao); CHKERRQ(ierr);
+  Vec pressure;
+  ierr = DMCreateGlobalVector(da, &pressure); CHKERRQ(ierr);
+
+  for (size_t k=0; k<pencils.size(); k++)
+  {
+    ierr = createPencil(pencilDirections[k], &pencils[k]); CHKERRQ(ierr);
+
+    // position of each local point of the pencil in the previous layout
+    PetscInt start, end;
+    ierr = VecGetOwnershipRange(pencils[k], &start, &end); CHKERRQ(ierr);
+    std::vector<PetscInt> from(end-start);
+    PetscInt idx[3];
+    for (PetscInt p=start; p<end; p++)
+    {
+      pencilIndices(pencilDirections[k], p, idx);
+      if (k == 0)
+        from[p-start] = idx[0] + n[0]*(idx[1] + n[1]*idx[2]); // natural ordering
+      else
+        from[p-start] = pencilPosition(pencilDirections[k-1], idx);
+    }
+    if (k == 0)
+    {
+      ierr = AOApplicationToPetsc(ao, end-start, from.data()); CHKERRQ(ierr);
+    }
+    IS isFrom, isTo;
+    ierr = ISCreateGeneral(PETSC_COMM_SELF, end-start, from.data(), PETSC_COPY_VALUES, &isFrom); CHKERRQ(ierr);
+    ierr = ISCreateStride(PETSC_COMM_SELF, end-start, start, 1, &isTo); CHKERRQ(ierr);
+    ierr = VecScatterCreate((k == 0) ? pressure : pencils[k-1], isFrom, pencils[k], isTo, &scatters[k]); CHKERRQ(ierr);
+    ierr = ISDestroy(&isFrom); CHKERRQ(ierr);
+    ierr = ISDestroy(&isTo); CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&pressure); CHKERRQ(ierr);
+
+  forwardPlans.assign(transformed.size(), NULL);
+  backwardPlans.assign(transformed.size(), NULL);
+  for (size_t k=0; k<transformed.size(); k++)
+  {
+    ierr = createPlans(k); CHKERRQ(ierr);
+    // DFT: n; DCT: 2n (for a forward then backward transform)
+    normalization *= (periodic[transformed[k]]) ? n[transformed[k]] : 2*n[transformed[k]];
+  }
+
+  if (!remaining.empty())
+  {
+    ierr = createFactors(); CHKERRQ(ierr);
+  }
+
+  return 0;
+} // create
+
+
+/*!
+ * \brief Creates a vector whose processes own complete lines along the given directions.
+ *
+ * The lines are numbered in natural order of the other directions and split
+ * evenly among the processes; a point is stored at `line*lineSize + point`.
+ */
+PetscErrorCode FFTSolver::createPencil(const std::vector<PetscInt> &full, Vec *v)
+{
+  PetscErrorCode ierr;
+
+  PetscInt lineSize = 1;
+  for (size_t i=0; i<full.size(); i++)
+    lineSize *= n[full[i]];
+  PetscInt numLines = n[0]*n[1]*n[2]/lineSize;
+
+  PetscMPIInt rank, size;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank); CHKERRQ(ierr);
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD, &size); CHKERRQ(ierr);
+  PetscInt numLocalLines = numLines/size + ((rank < numLines%size) ? 1 : 0);
+
+  ierr = VecCreateMPI(PETSC_COMM_WORLD, numLocalLines*lineSize, numLines*lineSize, v); CHKERRQ(ierr);
+
+  return 0;
+} // createPencil
+
+
+/*!
+ * \brief Returns the position of a point in a pencil whose lines span the given directions.
+ */
+PetscInt FFTSolver::pencilPosition(const std::vector<PetscInt> &full, const PetscInt *idx)
+{
+  PetscInt line = 0, lineStride = 1,
+           point = 0, pointStride = 1;
+  for (PetscInt d=0; d<3; d++)
+  {
+    if (std::find(full.begin(), full.end(), d) != full.end())
+    {
+      point += idx[d]*pointStride;
+      pointStride *= n[d];
+    }
+    else
+    {
+      line += idx[d]*lineStride;
+      lineStride *= n[d];
+    }
+  }
+
+  return line*pointStride + point;
+} // pencilPosition
+
+
+/*!
+ * \brief Computes the indices of the point stored at a given position of a pencil.
+ */
+void FFTSolver::pencilIndices(const std::vector<PetscInt> &full, PetscInt position, PetscInt *idx)
+{
+  PetscInt lineSize = 1;
+  for (size_t i=0; i<full.size(); i++)
+    lineSize *= n[full[i]];
+  PetscInt line = position/lineSize,
+           point = position%lineSize;
+  for (PetscInt d=0; d<3; d++)
+  {
+    if (std::find(full.begin(), full.end(), d) != full.end())
+    {
+      idx[d] = point%n[d];
+      point /= n[d];
+    }
+    else
+    {
+      idx[d] = line%n[d];
+      line /= n[d];
+    }
+  }
+} // pencilIndices
+
+
+/*!
+ * \brief Plans the forward and backward transforms along the lines of a pencil.
+ *
+ * Periodic directions use a real-to-halfcomplex DFT; the others use the DCT-II
+ * (homogeneous Neumann conditions at cell-centered points) and its inverse,
+ * the DCT-III. The transforms are done in place.
+ */
+PetscErrorCode FFTSolver::createPlans(PetscInt k)
+{
+  PetscErrorCode ierr;
+
+  PetscInt d = transformed[k];
+  PetscInt localSize;
+  ierr = VecGetLocalSize(pencils[k], &localSize); CHKERRQ(ierr);
+  int length = n[d],
+      numLines = localSize/n[d];
+  if (numLines == 0)
+    return 0;
+
+  fftw_r2r_kind forwardKind = (periodic[d]) ? FFTW_R2HC : FFTW_REDFT10,
+                backwardKind = (periodic[d]) ? FFTW_HC2R : FFTW_REDFT01;
+  PetscScalar *array;
+  ierr = VecGetArray(pencils[k], &array); CHKERRQ(ierr);
+  forwardPlans[k] = fftw_plan_many_r2r(1, &length, numLines,
+                                       array, NULL, 1, length,
+                                       array, NULL, 1, length,
+                                       &forwardKind, FFTW_ESTIMATE);
+  backwardPlans[k] = fftw_plan_many_r2r(1, &length, numLines,
+                                        array, NULL, 1, length,
+                                        array, NULL, 1, length,
+                                        &backwardKind, FFTW_ESTIMATE);
+  ierr = VecRestoreArray(pencils[k], &array); CHKERRQ(ierr);
+
+  return 0;
+} // createPlans
+
+
+/*!
+ * \brief Returns the eigenvalue of the 1D second-difference operator (unit
+ *        spacing) along a transformed direction for a given wavenumber.
+ *
+ * In the halfcomplex layout, the entries `m` and `n-m` hold the same
+ * wavenumber and share the eigenvalue.
+ */
+PetscReal FFTSolver::eigenvalue(PetscInt d, PetscInt wavenumber)
+{
+  PetscReal theta = (periodic[d]) ? PETSC_PI*wavenumber/n[d] : 0.5*PETSC_PI*wavenumber/n[d];
+
+  return 4.0*PetscSinReal(theta)*PetscSinReal(theta);
+} // eigenvalue
+
+
+/*!
+ * \brief Factorizes the problems left in the remaining directions, one per
+ *        local line of wavenumbers.
+ *
+ * For the wavenumbers \f$ \kappa \f$ of the transformed directions, the problem is
+ * \f[ h \left( \sigma_\kappa W + \sum_d \left(\prod_{e \neq d} W_e\right) D_d \right) \f]
+ * where \f$ h \f$ is the product of the uniform widths, \f$ \sigma_\kappa \f$
+ * the sum of the scaled eigenvalues, \f$ W \f$ the cell-widths and \f$ D_d \f$
+ * the 1D operators of the remaining directions (weighted by the reciprocals of
+ * the distances between cell-centers). The zero wavenumber gives a singular
+ * problem, made regular by fixing its first unknown.
+ */
+PetscErrorCode FFTSolver::createFactors()
+{
+  PetscErrorCode ierr;
+
+  Vec &pencil = pencils.back();
+  const std::vector<PetscInt> &full = pencilDirections.back();
+  PetscInt lineSize = 1;
+  for (size_t i=0; i<full.size(); i++)
+    lineSize *= n[full[i]];
+  PetscInt start, end;
+  ierr = VecGetOwnershipRange(pencil, &start, &end); CHKERRQ(ierr);
+  PetscInt numLocalLines = (end-start)/lineSize;
+
+  PetscReal h = 1.0;
+  for (size_t i=0; i<transformed.size(); i++)
+    h *= widths[transformed[i]][0];
+
+  factors.assign(numLocalLines, NULL);
+  pinned.assign(numLocalLines, PETSC_FALSE);
+  PetscInt idx[3], nbr[3], col;
+  PetscReal value;
+  for (PetscInt l=0; l<numLocalLines; l++)
+  {
+    // wavenumbers of the line
+    pencilIndices(full, start + l*lineSize, idx);
+    PetscReal sigma = 0.0;
+    for (size_t i=0; i<transformed.size(); i++)
+    {
+      PetscInt d = transformed[i];
+      sigma += eigenvalue(d, idx[d])/(widths[d][0]*widths[d][0]);
+    }
+
+    Mat M;
+    ierr = MatCreateSeqAIJ(PETSC_COMM_SELF, lineSize, lineSize, 1+2*full.size(), NULL, &M); CHKERRQ(ierr);
+    PetscReal factor = normalization*scale*h;
+    for (PetscInt row=0; row<lineSize; row++)
+    {
+      pencilIndices(full, start + l*lineSize + row, idx);
+      PetscReal volume = 1.0;
+      for (size_t i=0; i<full.size(); i++)
+        volume *= widths[full[i]][idx[full[i]]];
+      value = factor*sigma*volume;
+      ierr = MatSetValues(M, 1, &row, 1, &row, &value, ADD_VALUES); CHKERRQ(ierr);
+      for (size_t i=0; i<full.size(); i++)
+      {
+        PetscInt d = full[i];
+        PetscReal area = volume/widths[d][idx[d]];
+        for (PetscInt side=-1; side<=1; side+=2)
+        {
+          PetscInt j = idx[d] + side;
+          if (j < 0 || j >= n[d])
+          {
+            if (!periodic[d])
+              continue;
+            j = (j+n[d])%n[d];
+          }
+          PetscReal distance = 0.5*(widths[d][idx[d]] + widths[d][j]);
+          std::copy(idx, idx+3, nbr);
+          nbr[d] = j;
+          col = pencilPosition(full, nbr) - (start + l*lineSize);
+          value = factor*area/distance;
+          ierr = MatSetValues(M, 1, &row, 1, &row, &value, ADD_VALUES); CHKERRQ(ierr);
+          value = -value;
+          ierr = MatSetValues(M, 1, &row, 1, &col, &value, ADD_VALUES); CHKERRQ(ierr);
+        }
+      }
+    }
+    ierr = MatAssemblyBegin(M, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(M, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+    if (sigma == 0.0)
+    {
+      PetscInt zero = 0;
+      ierr = MatZeroRows(M, 1, &zero, 1.0, NULL, NULL); CHKERRQ(ierr);
+      pinned[l] = PETSC_TRUE;
+    }
+
+    IS rowPerm, colPerm;
+    MatFactorInfo info;
+    ierr = MatFactorInfoInitialize(&info); CHKERRQ(ierr);
+    info.fill = (full.size() == 1) ? 2.0 : 5.0;
+    ierr = MatGetOrdering(M, (full.size() == 1) ? MATORDERINGNATURAL : MATORDERINGND, &rowPerm, &colPerm); CHKERRQ(ierr);
+    ierr = MatGetFactor(M, MATSOLVERPETSC, MAT_FACTOR_LU, &factors[l]); CHKERRQ(ierr);
+    ierr = MatLUFactorSymbolic(factors[l], M, rowPerm, colPerm, &info); CHKERRQ(ierr);
+    ierr = MatLUFactorNumeric(factors[l], M, &info); CHKERRQ(ierr);
+    ierr = ISDestroy(&rowPerm); CHKERRQ(ierr);
+    ierr = ISDestroy(&colPerm); CHKERRQ(ierr);
+    ierr = MatDestroy(&M); CHKERRQ(ierr);
+  }
+
+  ierr = VecDuplicate(pencil, &solution); CHKERRQ(ierr);
+  ierr = VecCreateSeqWithArray(PETSC_COMM_SELF, 1, lineSize, NULL, &bLine); CHKERRQ(ierr);
+  ierr = VecCreateSeqWithArray(PETSC_COMM_SELF, 1, lineSize, NULL, &xLine); CHKERRQ(ierr);
+
+  return 0;
+} // createFactors
+
+
+/*!
+ * \brief Applies the planned transforms to the lines of a pencil.
+ */
+PetscErrorCode FFTSolver::transform(PetscInt k, std::vector<fftw_plan> &plans)
+{
+  PetscErrorCode ierr;
+
+  if (!plans[k])
+    return 0;
+
+  PetscScalar *array;
+  ierr = VecGetArray(pencils[k], &array); CHKERRQ(ierr);
+  fftw_execute(plans[k]);
+  ierr = VecRestoreArray(pencils[k], &array); CHKERRQ(ierr);
+
+  return 0;
+} // transform
+
+
+/*!
+ * \brief Solves the system.
+ *
+ * The right-hand side is transformed direction after direction, the problems
+ * left for each wavenumber are solved (or the coefficients divided by the
+ * eigenvalues when all directions are transformed), then the solution is
+ * transformed back in reverse order.
+ */
+PetscErrorCode FFTSolver::solve(Vec &x, Vec &b)
+{
+  PetscErrorCode ierr;
+
+  PetscInt numTransforms = transformed.size(),
+           numPencils = pencils.size();
+
+  Vec from = b;
+  for (PetscInt k=0; k<numPencils; k++)
+  {
+    ierr = VecScatterBegin(scatters[k], from, pencils[k], INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+    ierr = VecScatterEnd(scatters[k], from, pencils[k], INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+    if (k < numTransforms)
+    {
+      ierr = transform(k, forwardPlans); CHKERRQ(ierr);
+    }
+    from = pencils[k];
+  }
+
+  Vec current;
+  PetscInt start, end;
+  PetscScalar *bArray, *xArray;
+  if (remaining.empty())
+  {
+    // diagonal operator
+    PetscReal factor = normalization*scale;
+    for (PetscInt i=0; i<numTransforms; i++)
+      factor *= widths[transformed[i]][0];
+    current = pencils.back();
+    ierr = VecGetOwnershipRange(current, &start, &end); CHKERRQ(ierr);
+    ierr = VecGetArray(current, &xArray); CHKERRQ(ierr);
+    PetscInt idx[3];
+    for (PetscInt p=start; p<end; p++)
+    {
+      pencilIndices(pencilDirections.back(), p, idx);
+      PetscReal sigma = 0.0;
+      for (PetscInt i=0; i<numTransforms; i++)
+      {
+        PetscInt d = transformed[i];
+        sigma += eigenvalue(d, idx[d])/(widths[d][0]*widths[d][0]);
+      }
+      xArray[p-start] = (sigma == 0.0) ? 0.0 : xArray[p-start]/(factor*sigma);
+    }
+    ierr = VecRestoreArray(current, &xArray); CHKERRQ(ierr);
+  }
+  else
+  {
+    current = solution;
+    ierr = VecGetOwnershipRange(pencils.back(), &start, &end); CHKERRQ(ierr);
+    PetscInt lineSize = (factors.empty()) ? 0 : (end-start)/factors.size();
+    ierr = VecGetArray(pencils.back(), &bArray); CHKERRQ(ierr);
+    ierr = VecGetArray(solution, &xArray); CHKERRQ(ierr);
+    for (size_t l=0; l<factors.size(); l++)
+    {
+      if (pinned[l])
+        bArray[l*lineSize] = 0.0;
+      ierr = VecPlaceArray(bLine, bArray + l*lineSize); CHKERRQ(ierr);
+      ierr = VecPlaceArray(xLine, xArray + l*lineSize); CHKERRQ(ierr);
+      ierr = MatSolve(factors[l], bLine, xLine); CHKERRQ(ierr);
+      ierr = VecResetArray(xLine); CHKERRQ(ierr);
+      ierr = VecResetArray(bLine); CHKERRQ(ierr);
+    }
+    ierr = VecRestoreArray(solution, &xArray); CHKERRQ(ierr);
+    ierr = VecRestoreArray(pencils.back(), &bArray); CHKERRQ(ierr);
+  }
+
+  for (PetscInt k=numPencils-1; k>=0; k--)
+  {
+    if (k < numTransforms)
+    {
+      ierr = transform(k, backwardPlans); CHKERRQ(ierr);
+    }
+    Vec to = (k > 0) ? pencils[k-1] : x;
+    ierr = VecScatterBegin(scatters[k], current, to, INSERT_VALUES, SCATTER_REVERSE); CHKERRQ(ierr);
+    ierr = VecScatterEnd(scatters[k], current, to, INSERT_VALUES, SCATTER_REVERSE); CHKERRQ(ierr);
+    current = to;
+  }
+
+  return 0;
+} // solve
+
+
+/*!
+ * \brief Get the number of iterations performed (none: the solver is direct).
+ */
+PetscErrorCode FFTSolver::getIters(PetscInt &iters)
+{
+  iters = 0;
+
+  return 0;
+} // getIters
+
+#endif
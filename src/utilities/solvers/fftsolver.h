@@ -0,0 +1,76 @@
+/*! Implementation of the class `FFTSolver`.
+ * \file fftsolver.h
+ */
+
+#if !defined(FFTSOLVER_H)
+#define FFTSOLVER_H
+
+#include "solver.h"
+
+#include <petscdmda.h>
+#include <petscmat.h>
+#include <fftw3.h>
+
+#include <vector>
+
+
+/*!
+ * \class FFTSolver
+ * \brief Direct solver of the pressure Poisson system using fast transforms.
+ *
+ * The Poisson matrix of the Navier-Stokes solver (no immersed boundary) is
+ * separable: along each direction, it combines the cell-widths and a 1D
+ * second-difference operator. Along uniform directions, the 1D operator is
+ * diagonalized by a real discrete Fourier transform (periodic direction)
+ * or by a discrete cosine transform (Neumann direction). After the transforms,
+ * one small problem per wavenumber remains in the other directions (a
+ * tridiagonal system or a 2D problem), solved with a sparse LU factorization
+ * computed once. The right-hand side travels between pencil layouts
+ * (processes own complete lines along the direction being treated) through
+ * vector scatters.
+ */
+class FFTSolver : public Solver
+{
+public:
+  FFTSolver(DM pda, const std::vector<PetscReal> *w, const PetscBool *u,
+            const PetscBool *p, PetscReal s);
+  virtual ~FFTSolver();
+
+  PetscErrorCode create(const Mat &A);
+  PetscErrorCode solve(Vec &x, Vec &b);
+  PetscErrorCode getIters(PetscInt &iters);
+
+private:
+  DM da;
+  PetscInt dim;
+  PetscInt n[3];                          // number of cells along each direction
+  std::vector<PetscReal> widths[3];       // cell-widths along each direction
+  PetscBool uniform[3],
+            periodic[3];
+  PetscReal scale;                        // factor of the operator (time-step)
+
+  std::vector<PetscInt> transformed,      // uniform directions, treated by transforms
+                        remaining;        // directions of the problems left after the transforms
+  std::vector<std::vector<PetscInt> > pencilDirections; // directions spanned by the lines of each pencil
+  std::vector<Vec> pencils;               // layouts: one per transformed direction, then the remaining directions
+  std::vector<VecScatter> scatters;       // previous layout (pressure vector first) to each pencil
+  std::vector<fftw_plan> forwardPlans,    // transforms along the lines of each transformed pencil
+                         backwardPlans;
+  PetscReal normalization;                // factor introduced by the unnormalized transforms
+
+  std::vector<Mat> factors;               // LU factors of the remaining problems (one per local line)
+  std::vector<PetscBool> pinned;          // whether the first unknown of a line is fixed (singular problem)
+  Vec solution,                           // solution in the layout of the remaining directions
+      bLine, xLine;                       // sequential vectors placed on one line
+
+  PetscErrorCode createPencil(const std::vector<PetscInt> &full, Vec *v);
+  PetscErrorCode createPlans(PetscInt k);
+  PetscErrorCode createFactors();
+  PetscErrorCode transform(PetscInt k, std::vector<fftw_plan> &plans);
+  PetscReal eigenvalue(PetscInt d, PetscInt wavenumber);
+  PetscInt pencilPosition(const std::vector<PetscInt> &full, const PetscInt *idx);
+  void pencilIndices(const std::vector<PetscInt> &full, PetscInt position, PetscInt *idx);
+
+}; // FFTSolver
+
+#endif
@@ -0,0 +1,199 @@
+/*! Implementation of the methods of the class `InitialGuess`.
+ * \file initialguess.cpp
+ */
+
+#include "initialguess.h"
+
+
+/*!
+ * \brief Destroys the stored solutions.
+ */
+InitialGuess::~InitialGuess()
+{
+  for (size_t h=0; h<histories.size(); h++)
+  {
+    History &history = histories[h];
+    for (size_t i=0; i<history.solutions.size(); i++)
+      VecDestroy(&history.solutions[i]);
+    for (size_t i=0; i<history.basis.size(); i++)
+    {
+      VecDestroy(&history.basis[i]);
+      VecDestroy(&history.basisA[i]);
+    }
+  }
+} // ~InitialGuess
+
+
+/*!
+ * \brief Reads the type of initial guess and the number of solutions to keep.
+ */
+PetscErrorCode InitialGuess::setFromOptions()
+{
+  PetscErrorCode ierr;
+
+  const char *types[] = {"zero", "previous", "linear", "quadratic", "projection"};
+  PetscInt choice = type;
+  ierr = PetscOptionsGetEList(NULL, prefix.c_str(), "-initial_guess_type", types, 5, &choice, NULL); CHKERRQ(ierr);
+  type = (Type) choice;
+  ierr = PetscOptionsGetInt(NULL, prefix.c_str(), "-initial_guess_size", &size, NULL); CHKERRQ(ierr);
+  if (size < 1)
+  {
+    SETERRQ1(PETSC_COMM_WORLD, PETSC_ERR_ARG_OUTOFRANGE,
+             "-%sinitial_guess_size should be positive", prefix.c_str());
+  }
+
+  return 0;
+} // setFromOptions
+
+
+/*!
+ * \brief Selects the history of the next solves (0 by default).
+ *
+ * \param h Index of the history; negative to neither build the initial guess
+ *        nor record the solution
+ */
+PetscErrorCode InitialGuess::select(PetscInt h)
+{
+  current = h;
+  if (h >= (PetscInt) histories.size())
+    histories.resize(h+1);
+
+  return 0;
+} // select
+
+
+/*!
+ * \brief Writes the initial guess into the solution vector, from the selected
+ *        history (the vector is left unchanged without history).
+ *
+ * Extrapolations use a lower order while fewer solutions are available.
+ *
+ * \param A Operator of the system
+ * \param x Solution vector
+ * \param b Right-hand side
+ */
+PetscErrorCode InitialGuess::build(Mat A, Vec x, Vec b)
+{
+  PetscErrorCode ierr;
+
+  if (type == ZERO || current < 0)
+    return 0;
+
+  std::vector<Vec> &history = histories[current].solutions,
+                   &basis = histories[current].basis;
+  PetscInt count = histories[current].count;
+  if (type == PROJECTION)
+  {
+    ierr = VecSet(x, 0.0); CHKERRQ(ierr);
+    if (count > 0)
+    {
+      // x = sum_i (b, u_i) u_i, with (A u_i, u_j) = delta_ij
+      std::vector<PetscScalar> alphas(count);
+      ierr = VecMDot(b, count, &basis[0], &alphas[0]); CHKERRQ(ierr);
+      ierr = VecMAXPY(x, count, &alphas[0], &basis[0]); CHKERRQ(ierr);
+    }
+    return 0;
+  }
+
+  switch (count)
+  {
+    case 0:
+      ierr = VecSet(x, 0.0); CHKERRQ(ierr);
+      break;
+    case 1:
+      ierr = VecCopy(history[0], x); CHKERRQ(ierr);
+      break;
+    case 2:
+      ierr = VecAXPBYPCZ(x, 2.0, -1.0, 0.0, history[0], history[1]); CHKERRQ(ierr);
+      break;
+    default:
+      ierr = VecAXPBYPCZ(x, 3.0, -3.0, 0.0, history[0], history[1]); CHKERRQ(ierr);
+      ierr = VecAXPY(x, 1.0, history[2]); CHKERRQ(ierr);
+      break;
+  }
+
+  return 0;
+} // build
+
+
+/*!
+ * \brief Stores the solution of the last solve in the selected history.
+ *
+ * For the projection, the solution is orthonormalized against the basis in
+ * the norm of the operator (one matrix-vector product); the basis restarts
+ * from the last solution once full.
+ *
+ * \param A Operator of the system
+ * \param x Solution vector
+ */
+PetscErrorCode InitialGuess::update(Mat A, Vec x)
+{
+  PetscErrorCode ierr;
+
+  if (type == ZERO || current < 0)
+    return 0;
+
+  std::vector<Vec> &history = histories[current].solutions,
+                   &basis = histories[current].basis,
+                   &basisA = histories[current].basisA;
+  PetscInt &count = histories[current].count;
+  if (type == PROJECTION)
+  {
+    if (basis.empty())
+    {
+      basis.assign(size, NULL);
+      basisA.assign(size, NULL);
+      for (PetscInt i=0; i<size; i++)
+      {
+        ierr = VecDuplicate(x, &basis[i]); CHKERRQ(ierr);
+        ierr = VecDuplicate(x, &basisA[i]); CHKERRQ(ierr);
+      }
+    }
+    if (count == size)
+      count = 0;
+    Vec u = basis[count],
+        Au = basisA[count];
+    ierr = VecCopy(x, u); CHKERRQ(ierr);
+    ierr = MatMult(A, u, Au); CHKERRQ(ierr);
+    PetscScalar norm2x;
+    ierr = VecDot(u, Au, &norm2x); CHKERRQ(ierr);
+    if (count > 0)
+    {
+      std::vector<PetscScalar> alphas(count);
+      ierr = VecMDot(x, count, &basisA[0], &alphas[0]); CHKERRQ(ierr);
+      for (PetscInt i=0; i<count; i++)
+        alphas[i] = -alphas[i];
+      ierr = VecMAXPY(u, count, &alphas[0], &basis[0]); CHKERRQ(ierr);
+      ierr = VecMAXPY(Au, count, &alphas[0], &basisA[0]); CHKERRQ(ierr);
+    }
+    PetscScalar norm2;
+    ierr = VecDot(u, Au, &norm2); CHKERRQ(ierr);
+    // skip a solution already in the span of the basis
+    if (PetscRealPart(norm2) > PETSC_SMALL*PetscRealPart(norm2x))
+    {
+      ierr = VecScale(u, 1.0/PetscSqrtReal(PetscRealPart(norm2))); CHKERRQ(ierr);
+      ierr = VecScale(Au, 1.0/PetscSqrtReal(PetscRealPart(norm2))); CHKERRQ(ierr);
+      count++;
+    }
+    return 0;
+  }
+
+  if (history.empty())
+  {
+    PetscInt numSolutions = (type == PREVIOUS) ? 1 : ((type == LINEAR) ? 2 : 3);
+    history.assign(numSolutions, NULL);
+    for (PetscInt i=0; i<numSolutions; i++)
+    {
+      ierr = VecDuplicate(x, &history[i]); CHKERRQ(ierr);
+    }
+  }
+  // recycle the oldest vector for the newest solution
+  Vec oldest = history.back();
+  for (size_t i=history.size()-1; i>0; i--)
+    history[i] = history[i-1];
+  history[0] = oldest;
+  ierr = VecCopy(x, history[0]); CHKERRQ(ierr);
+  count = PetscMin(count+1, (PetscInt) history.size());
+
+  return 0;
+} // update
@@ -0,0 +1,66 @@
+/*! Implementation of the class `InitialGuess`.
+ * \file initialguess.h
+ */
+
+#if !defined(INITIALGUESS_H)
+#define INITIALGUESS_H
+
+#include <petscmat.h>
+
+#include <string>
+#include <vector>
+
+
+/*!
+ * \class InitialGuess
+ * \brief Builds the initial guess of a linear solve from the previous solutions.
+ *
+ * The type is selected with `-<prefix>initial_guess_type`:
+ * - `zero` (default): no guess;
+ * - `previous`: solution of the previous solve;
+ * - `linear`, `quadratic`: polynomial extrapolation of the last 2 or 3 solutions
+ *   (assumes one solve per time-step and history);
+ * - `projection`: projection of the solution onto the span of the last
+ *   `-<prefix>initial_guess_size` solutions (default 5), in the norm of the
+ *   operator, as the first method of Fischer (1998); the operator should be
+ *   symmetric positive definite.
+ *
+ * A solver that solves several quantities with the same operator (or the same
+ * quantity several times per time-step) keeps one history per quantity and
+ * selects it before each solve (`select`); with no history selected, the
+ * solve starts from the given solution vector and is not recorded.
+ */
+class InitialGuess
+{
+public:
+  InitialGuess(std::string p): prefix(p), type(ZERO), size(5), current(0), histories(1) { };
+  ~InitialGuess();
+
+  PetscErrorCode setFromOptions();
+  PetscBool nonzero() { return (type == ZERO) ? PETSC_FALSE : PETSC_TRUE; };
+  PetscErrorCode build(Mat A, Vec x, Vec b);
+  PetscErrorCode update(Mat A, Vec x);
+  PetscErrorCode select(PetscInt h);
+
+private:
+  enum Type {ZERO, PREVIOUS, LINEAR, QUADRATIC, PROJECTION};
+
+  // previous solutions of one quantity
+  struct History
+  {
+    History(): count(0) { };
+    PetscInt count;             // number of solutions currently stored
+    std::vector<Vec> solutions, // solutions, from the most recent (extrapolation)
+                     basis,     // A-orthonormal basis of the span of the solutions (projection)
+                     basisA;    // product of the operator with the basis vectors
+  };
+
+  std::string prefix;
+  Type type;
+  PetscInt size;            // number of solutions kept
+  PetscInt current;         // history of the next solve (negative: none)
+  std::vector<History> histories;
+
+}; // InitialGuess
+
+#endif
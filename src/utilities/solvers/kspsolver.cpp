@@ -14,20 +14,103 @@ PetscErrorCode KSPSolver::create(const Mat &A)
 
   ierr = PetscOptionsInsertFile(PETSC_COMM_WORLD, NULL, 
                                 options.c_str(), PETSC_FALSE); CHKERRQ(ierr);
+  if (tuningFile.empty())
+    tuningFile = options.substr(0, options.find_last_of('/')+1) + prefix + "autotuned.info";
+  ierr = tuner.setFromOptions(tuningFile, (dm) ? PETSC_TRUE : PETSC_FALSE); CHKERRQ(ierr);
+  ierr = guess.setFromOptions(); CHKERRQ(ierr);
+  ierr = recycler.setFromOptions(); CHKERRQ(ierr);
 
-  // create KSP for intermediate fluxes system
-  ierr = KSPCreate(PETSC_COMM_WORLD, &ksp); CHKERRQ(ierr);
-  ierr = KSPSetOptionsPrefix(ksp, prefix.c_str()); CHKERRQ(ierr);
-  ierr = KSPSetOperators(ksp, A, A); CHKERRQ(ierr);
-  // ierr = KSPSetInitialGuessNonzero(ksp, PETSC_TRUE); CHKERRQ(ierr);
-  ierr = KSPSetType(ksp, KSPCG); CHKERRQ(ierr);
-  ierr = KSPSetReusePreconditioner(ksp, PETSC_TRUE); CHKERRQ(ierr);
-  ierr = KSPSetFromOptions(ksp); CHKERRQ(ierr);
+  ierr = createKSP(ksp, A); CHKERRQ(ierr);
 
   return 0;
 } // create
 
 
+/*!
+ * \brief Creates a KSP with the prefix of the solver from the current options.
+ */
+PetscErrorCode KSPSolver::createKSP(KSP &k, Mat A)
+{
+  PetscErrorCode ierr;
+
+  // create KSP for intermediate fluxes system
+  ierr = KSPCreate(PETSC_COMM_WORLD, &k); CHKERRQ(ierr);
+  ierr = KSPSetOptionsPrefix(k, prefix.c_str()); CHKERRQ(ierr);
+  ierr = KSPSetOperators(k, A, A); CHKERRQ(ierr);
+  if (dm)
+  {
+    // the DM only provides the grid hierarchy; the operators are given
+    ierr = KSPSetDM(k, dm); CHKERRQ(ierr);
+    ierr = KSPSetDMActive(k, PETSC_FALSE); CHKERRQ(ierr);
+  }
+  ierr = KSPSetInitialGuessNonzero(k, guess.nonzero()); CHKERRQ(ierr);
+  ierr = KSPSetType(k, KSPCG); CHKERRQ(ierr);
+  ierr = KSPSetReusePreconditioner(k, PETSC_TRUE); CHKERRQ(ierr);
+  ierr = KSPSetFromOptions(k); CHKERRQ(ierr);
+  if (!splitISs.empty())
+  {
+    PC pc;
+    PetscBool isFieldSplit;
+    ierr = KSPGetPC(k, &pc); CHKERRQ(ierr);
+    ierr = PetscObjectTypeCompare((PetscObject) pc, PCFIELDSPLIT, &isFieldSplit); CHKERRQ(ierr);
+    if (isFieldSplit)
+    {
+      for (size_t i=0; i<splitISs.size(); i++)
+      {
+        ierr = PCFieldSplitSetIS(pc, splitNames[i].c_str(), splitISs[i]); CHKERRQ(ierr);
+      }
+    }
+  }
+
+  return 0;
+} // createKSP
+
+
+/*!
+ * \brief Attaches the grid of the unknowns to the KSP (before `create`).
+ *
+ * With a DMDA attached, `-<prefix>pc_type mg` builds its levels by coarsening the grid.
+ */
+PetscErrorCode KSPSolver::setDM(DM da)
+{
+  dm = da;
+
+  return 0;
+} // setDM
+
+
+/*!
+ * \brief Names a block of unknowns (before `create`).
+ *
+ * With `-<prefix>pc_type fieldsplit`, the blocks become the splits, in the
+ * order they are added; the options of a split have the prefix
+ * `<prefix>fieldsplit_<name>_`.
+ */
+PetscErrorCode KSPSolver::addFieldSplit(std::string name, IS is)
+{
+  PetscErrorCode ierr;
+
+  ierr = PetscObjectReference((PetscObject) is); CHKERRQ(ierr);
+  splitNames.push_back(name);
+  splitISs.push_back(is);
+
+  return 0;
+} // addFieldSplit
+
+
+/*!
+ * \brief Sets the file of the options selected by the autotune (before `create`).
+ *
+ * By default, the file `<prefix>autotuned.info` is placed next to the options file.
+ */
+PetscErrorCode KSPSolver::setTuningFile(std::string f)
+{
+  tuningFile = f;
+
+  return 0;
+} // setTuningFile
+
+
 /*!
  * \brief Solves the system.
  */
@@ -35,10 +118,29 @@ PetscErrorCode KSPSolver::solve(Vec &x, Vec &b)
 {
   PetscErrorCode ierr;
 
-  ierr = KSPSolve(ksp, b, x); CHKERRQ(ierr);
+  Mat A;
+  ierr = KSPGetOperators(ksp, &A, NULL); CHKERRQ(ierr);
+  ierr = guess.build(A, x, b); CHKERRQ(ierr);
+
+  if (tuner.tuning())
+  {
+    ierr = tune(x, b); CHKERRQ(ierr);
+  }
 
   KSPConvergedReason reason;
-  ierr = KSPGetConvergedReason(ksp, &reason); CHKERRQ(ierr);
+  if (recycler.active())
+  {
+    ierr = recycler.solve(ksp, x, b, reason); CHKERRQ(ierr);
+    ierr = recycler.getIters(iters); CHKERRQ(ierr);
+    ierr = recycler.getResidualNorm(residualNorm); CHKERRQ(ierr);
+  }
+  else
+  {
+    ierr = KSPSolve(ksp, b, x); CHKERRQ(ierr);
+    ierr = KSPGetConvergedReason(ksp, &reason); CHKERRQ(ierr);
+    ierr = KSPGetIterationNumber(ksp, &iters); CHKERRQ(ierr);
+    ierr = KSPGetResidualNorm(ksp, &residualNorm); CHKERRQ(ierr);
+  }
   if (reason < 0)
   {
     ierr = PetscPrintf(PETSC_COMM_WORLD, 
@@ -47,19 +149,150 @@ PetscErrorCode KSPSolver::solve(Vec &x, Vec &b)
     ierr = PetscFinalize(); CHKERRQ(ierr);
     exit(1);
   }
+  ierr = guess.update(A, x); CHKERRQ(ierr);
 
   return 0;
 } // solve
 
 
 /*!
- * \brief Get the number of iterations performed.
+ * \brief Tries the candidates of the autotune on the system and keeps the
+ *        fastest KSP.
+ *
+ * The first candidate uses the KSP of the options file; the others are
+ * created and set up with their options. Each candidate solves the system
+ * from the same initial guess, once as a warm-up and then for the timed
+ * solves; a candidate that diverges is discarded. The solution is left
+ * unchanged.
  */
-PetscErrorCode KSPSolver::getIters(PetscInt &iters)
+PetscErrorCode KSPSolver::tune(Vec x, Vec b)
 {
   PetscErrorCode ierr;
 
-  ierr = KSPGetIterationNumber(ksp, &iters); CHKERRQ(ierr);
+  Mat A;
+  ierr = KSPGetOperators(ksp, &A, NULL); CHKERRQ(ierr);
+
+  Vec y;
+  ierr = VecDuplicate(x, &y); CHKERRQ(ierr);
+  while (tuner.tuning())
+  {
+    PetscInt c = tuner.candidate();
+    PetscLogDouble setupTime, start, end;
+    ierr = PetscTime(&start); CHKERRQ(ierr);
+    if (c > 0)
+    {
+      ierr = tuner.pushOptions(); CHKERRQ(ierr);
+      ierr = createKSP(trial, A); CHKERRQ(ierr);
+    }
+    ierr = KSPSetUp((c > 0) ? trial : ksp); CHKERRQ(ierr);
+    if (c > 0)
+    {
+      ierr = tuner.popOptions(); CHKERRQ(ierr);
+    }
+    ierr = PetscTime(&end); CHKERRQ(ierr);
+    setupTime = end - start;
+    KSP k = (c > 0) ? trial : ksp;
+
+    // warm-up solve (i = 0), then the timed solves
+    PetscBool done = PETSC_FALSE, better = PETSC_FALSE;
+    for (PetscInt i=0; !done; i++)
+    {
+      KSPConvergedReason reason;
+      PetscInt its;
+      ierr = VecCopy(x, y); CHKERRQ(ierr);
+      ierr = PetscTime(&start); CHKERRQ(ierr);
+      ierr = KSPSolve(k, b, y); CHKERRQ(ierr);
+      ierr = PetscTime(&end); CHKERRQ(ierr);
+      ierr = KSPGetConvergedReason(k, &reason); CHKERRQ(ierr);
+      ierr = KSPGetIterationNumber(k, &its); CHKERRQ(ierr);
+      if (reason < 0)
+      {
+        ierr = PetscPrintf(PETSC_COMM_WORLD,
+                           "Autotune of the %s solver: candidate %D diverged (reason %d)\n",
+                           prefix.substr(0, prefix.size()-1).c_str(), c, reason); CHKERRQ(ierr);
+        ierr = tuner.reject(); CHKERRQ(ierr);
+        break;
+      }
+      if (i > 0)
+      {
+        ierr = tuner.record((i == 1) ? setupTime : 0.0, end - start, its, done, better); CHKERRQ(ierr);
+      }
+    }
+
+    // keep the fastest KSP
+    if (c > 0)
+    {
+      if (better)
+      {
+        ierr = KSPDestroy(&ksp); CHKERRQ(ierr);
+        ksp = trial;
+        trial = NULL;
+      }
+      else
+      {
+        ierr = KSPDestroy(&trial); CHKERRQ(ierr);
+      }
+    }
+  }
+  ierr = VecDestroy(&y); CHKERRQ(ierr);
+
+  return 0;
+} // tune
+
+
+/*!
+ * \brief Get the number of iterations performed.
+ */
+PetscErrorCode KSPSolver::getIters(PetscInt &its)
+{
+  its = iters;
 
   return 0;
 } // getIters
+
+
+/*!
+ * \brief Get the number of iterations saved by recycling in the last solve
+ *        (-1 without recycling).
+ */
+PetscErrorCode KSPSolver::getSavedIters(PetscInt &iters)
+{
+  PetscErrorCode ierr;
+
+  iters = -1;
+  if (recycler.active())
+  {
+    ierr = recycler.getSavedIters(iters); CHKERRQ(ierr);
+  }
+
+  return 0;
+} // getSavedIters
+
+
+/*!
+ * \brief Get the residual norm at the end of the last solve (the norm used
+ *        by the convergence test of the KSP).
+ */
+PetscErrorCode KSPSolver::getResidualNorm(PetscReal &norm)
+{
+  norm = residualNorm;
+
+  return 0;
+} // getResidualNorm
+
+
+/*!
+ * \brief Selects the history of previous solutions used to build the initial
+ *        guess of the next solves, and where their solutions are stored.
+ *
+ * \param index Index of the history (0 by default); negative to start from the
+ *        given solution vector without storing the solution
+ */
+PetscErrorCode KSPSolver::setHistory(PetscInt index)
+{
+  PetscErrorCode ierr;
+
+  ierr = guess.select(index); CHKERRQ(ierr);
+
+  return 0;
+} // setHistory
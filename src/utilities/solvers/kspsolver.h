@@ -6,10 +6,14 @@
 #define KSPSOLVER_H
 
 #include "solver.h"
+#include "initialguess.h"
+#include "deflatedcg.h"
+#include "autotuner.h"
 
 #include <petscksp.h>
 
 #include <string>
+#include <vector>
 
 
 /*!
@@ -19,19 +23,42 @@
 class KSPSolver : public Solver
 {
 public:
-  KSPSolver(std::string p, std::string f): prefix(p), options(f) { };
+  KSPSolver(std::string p, std::string f)
+    : prefix(p), options(f), dm(NULL), iters(0), residualNorm(0.0), trial(NULL), guess(p), recycler(p), tuner(p) { };
   virtual ~KSPSolver(){
     KSPDestroy(&ksp);
+    KSPDestroy(&trial);
+    for (size_t i=0; i<splitISs.size(); i++)
+      ISDestroy(&splitISs[i]);
   };
 
   PetscErrorCode create(const Mat &A);
   PetscErrorCode solve(Vec &x, Vec &b);
   PetscErrorCode getIters(PetscInt &iters);
+  PetscErrorCode getSavedIters(PetscInt &iters);
+  PetscErrorCode setHistory(PetscInt index);
+  PetscErrorCode getResidualNorm(PetscReal &norm);
+  PetscErrorCode setDM(DM da);
+  PetscErrorCode addFieldSplit(std::string name, IS is);
+  PetscErrorCode setTuningFile(std::string f);
 
 private:
   KSP ksp;
   std::string prefix;
   std::string options;
+  DM dm; // grid of the unknowns, used by geometric multigrid
+  std::vector<std::string> splitNames; // blocks of unknowns, used by PCFIELDSPLIT
+  std::vector<IS> splitISs;
+  std::string tuningFile; // options selected by the autotune
+  PetscInt iters;         // iterations of the last solve
+  PetscReal residualNorm; // residual norm at the end of the last solve
+  KSP trial;              // candidate tried by the autotune
+  InitialGuess guess; // built from the previous solutions
+  DeflatedCG recycler; // replaces KSPSolve when a deflation space is recycled
+  Autotuner tuner;     // selects the KSP/PC during the first solves
+
+  PetscErrorCode createKSP(KSP &k, Mat A);
+  PetscErrorCode tune(Vec x, Vec b);
 
 
 }; // KSPSolver
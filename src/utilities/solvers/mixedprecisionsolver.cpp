@@ -0,0 +1,628 @@
+/*! Implementation of the methods of the class `MixedPrecisionSolver`.
+ * \file mixedprecisionsolver.cpp
+ */
+
+#include "mixedprecisionsolver.h"
+
+#include <algorithm>
+
+
+/*!
+ * \brief Destroys the single-precision levels, the KSP and the work vectors.
+ */
+MixedPrecisionSolver::~MixedPrecisionSolver()
+{
+  for (size_t l=0; l<operators.size(); l++)
+  {
+    delete operators[l];
+    delete interpolations[l];
+  }
+  KSPDestroy(&ksp);
+  KSPDestroy(&coarse);
+  VecDestroy(&coarseRHS);
+  VecDestroy(&coarseSolution);
+  VecDestroy(&r);
+  VecDestroy(&z);
+  VecDestroy(&p);
+  VecDestroy(&q);
+} // ~MixedPrecisionSolver
+
+
+/*!
+ * \brief Sets up the preconditioner in double precision, copies its levels in
+ *        single precision and releases the double-precision levels.
+ */
+PetscErrorCode MixedPrecisionSolver::create(const Mat &A)
+{
+  PetscErrorCode ierr;
+
+  ierr = PetscOptionsInsertFile(PETSC_COMM_WORLD, NULL,
+                                options.c_str(), PETSC_FALSE); CHKERRQ(ierr);
+
+  const char *precisions[] = {"single", "double"};
+  PetscInt choice = 0;
+  ierr = PetscOptionsGetEList(NULL, prefix.c_str(), "-mixed_krylov", precisions, 2, &choice, NULL); CHKERRQ(ierr);
+  singleKrylov = (choice == 0) ? PETSC_TRUE : PETSC_FALSE;
+  ierr = PetscOptionsGetReal(NULL, prefix.c_str(), "-mixed_inner_rtol", &innerRtol, NULL); CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL, prefix.c_str(), "-mixed_inner_max_it", &innerMaxIts, NULL); CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL, prefix.c_str(), "-mixed_smooth_its", &smoothIts, NULL); CHKERRQ(ierr);
+  if (innerMaxIts < 1 || smoothIts < 1)
+  {
+    SETERRQ1(PETSC_COMM_WORLD, PETSC_ERR_ARG_OUTOFRANGE,
+             "invalid mixed-precision parameters for the solver with prefix %s", prefix.c_str());
+  }
+
+  // single-precision copy of the null space (orthonormal vectors)
+  MatNullSpace nullsp;
+  ierr = MatGetNullSpace(A, &nullsp); CHKERRQ(ierr);
+  if (nullsp)
+  {
+    PetscInt numVecs;
+    const Vec *vecs;
+    ierr = MatNullSpaceGetVecs(nullsp, &removeMean, &numVecs, &vecs); CHKERRQ(ierr);
+    nullVectors.resize(numVecs);
+    for (PetscInt k=0; k<numVecs; k++)
+    {
+      PetscInt n;
+      const PetscScalar *a;
+      ierr = VecGetLocalSize(vecs[k], &n); CHKERRQ(ierr);
+      ierr = VecGetArrayRead(vecs[k], &a); CHKERRQ(ierr);
+      nullVectors[k].resize(n);
+      for (PetscInt i=0; i<n; i++)
+        nullVectors[k][i] = (SingleReal) PetscRealPart(a[i]);
+      ierr = VecRestoreArrayRead(vecs[k], &a); CHKERRQ(ierr);
+    }
+  }
+  ierr = MatGetSize(A, &globalSize, NULL); CHKERRQ(ierr);
+
+  // the KSP provides the tolerances and the multigrid hierarchy
+  ierr = KSPCreate(PETSC_COMM_WORLD, &ksp); CHKERRQ(ierr);
+  ierr = KSPSetOptionsPrefix(ksp, prefix.c_str()); CHKERRQ(ierr);
+  ierr = KSPSetOperators(ksp, A, A); CHKERRQ(ierr);
+  ierr = KSPSetType(ksp, KSPCG); CHKERRQ(ierr);
+  ierr = KSPSetFromOptions(ksp); CHKERRQ(ierr);
+  ierr = KSPSetUp(ksp); CHKERRQ(ierr);
+  ierr = setUpLevels(); CHKERRQ(ierr);
+
+  // the double-precision hierarchy is released once copied; the KSP keeps
+  // the operator and the tolerances, and only its coarse solver is kept:
+  // releasing the hierarchy resets the coarse solver (operators and
+  // factorization), which is then set up again with the coarse operator
+  PC pc;
+  Mat coarseOperator = NULL;
+  if (coarse)
+  {
+    ierr = PetscObjectReference((PetscObject) coarse); CHKERRQ(ierr);
+    ierr = KSPGetOperators(coarse, &coarseOperator, NULL); CHKERRQ(ierr);
+    ierr = PetscObjectReference((PetscObject) coarseOperator); CHKERRQ(ierr);
+  }
+  ierr = KSPGetPC(ksp, &pc); CHKERRQ(ierr);
+  ierr = PCSetType(pc, PCNONE); CHKERRQ(ierr);
+  if (coarse)
+  {
+    ierr = KSPSetOperators(coarse, coarseOperator, coarseOperator); CHKERRQ(ierr);
+    ierr = KSPSetUp(coarse); CHKERRQ(ierr);
+    ierr = MatDestroy(&coarseOperator); CHKERRQ(ierr);
+  }
+
+  ierr = MatCreateVecs(A, &r, NULL); CHKERRQ(ierr);
+  ierr = VecDuplicate(r, &z); CHKERRQ(ierr);
+  ierr = VecDuplicate(r, &p); CHKERRQ(ierr);
+  ierr = VecDuplicate(r, &q); CHKERRQ(ierr);
+  PetscInt n = operators.back()->getLocalRows();
+  innerX.assign(n, 0.0);
+  innerR.assign(n, 0.0);
+  innerZ.assign(n, 0.0);
+  innerP.assign(n, 0.0);
+  innerQ.assign(n, 0.0);
+
+  ierr = PetscPrintf(PETSC_COMM_WORLD,
+                     "Mixed-precision %s solver: %D single-precision levels%s, %s-precision Krylov\n",
+                     prefix.substr(0, prefix.size()-1).c_str(), (PetscInt) operators.size() - ((coarse) ? 1 : 0),
+                     (coarse) ? " and a double-precision coarse solve" : "",
+                     (singleKrylov) ? "single" : "double"); CHKERRQ(ierr);
+
+  return 0;
+} // create
+
+
+/*!
+ * \brief Copies the operators and the interpolations of the multigrid levels
+ *        of the KSP in single precision and estimates the largest eigenvalue
+ *        of the Jacobi-preconditioned operator of each level.
+ */
+PetscErrorCode MixedPrecisionSolver::setUpLevels()
+{
+  PetscErrorCode ierr;
+
+  PC pc;
+  PetscBool isMG;
+  PetscInt numLevels = 1;
+  ierr = KSPGetPC(ksp, &pc); CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompareAny((PetscObject) pc, &isMG, PCMG, PCGAMG, ""); CHKERRQ(ierr);
+  if (isMG)
+  {
+    ierr = PCMGGetLevels(pc, &numLevels); CHKERRQ(ierr);
+  }
+
+  operators.assign(numLevels, NULL);
+  interpolations.assign(numLevels, NULL);
+  invDiagonals.resize(numLevels);
+  rhs.resize(numLevels);
+  solution.resize(numLevels);
+  residual.resize(numLevels);
+  direction.resize(numLevels);
+  product.resize(numLevels);
+  maxEigenvalues.assign(numLevels, 0.0);
+  for (PetscInt l=0; l<numLevels; l++)
+  {
+    Mat Al;
+    PetscInt n;
+    if (isMG && l == 0)
+    {
+      // the coarsest level is solved in double precision
+      ierr = PCMGGetCoarseSolve(pc, &coarse); CHKERRQ(ierr);
+      ierr = KSPGetOperators(coarse, &Al, NULL); CHKERRQ(ierr);
+      ierr = MatCreateVecs(Al, &coarseSolution, &coarseRHS); CHKERRQ(ierr);
+      ierr = MatGetLocalSize(Al, &n, NULL); CHKERRQ(ierr);
+      rhs[l].assign(n, 0.0);
+      solution[l].assign(n, 0.0);
+      continue;
+    }
+    if (isMG)
+    {
+      KSP smoother;
+      ierr = PCMGGetSmoother(pc, l, &smoother); CHKERRQ(ierr);
+      ierr = KSPGetOperators(smoother, &Al, NULL); CHKERRQ(ierr);
+    }
+    else
+    {
+      ierr = KSPGetOperators(ksp, &Al, NULL); CHKERRQ(ierr);
+    }
+    operators[l] = new SingleMatrix;
+    ierr = operators[l]->create(Al); CHKERRQ(ierr);
+    n = operators[l]->getLocalRows();
+    invDiagonals[l].assign(n, 0.0);
+    ierr = operators[l]->getDiagonal(invDiagonals[l].data()); CHKERRQ(ierr);
+    for (PetscInt i=0; i<n; i++)
+      invDiagonals[l][i] = (invDiagonals[l][i] != 0.0) ? 1.0/invDiagonals[l][i] : 1.0;
+    rhs[l].assign(n, 0.0);
+    solution[l].assign(n, 0.0);
+    residual[l].assign(n, 0.0);
+    direction[l].assign(n, 0.0);
+    product[l].assign(n, 0.0);
+    if (isMG)
+    {
+      Mat P;
+      ierr = PCMGGetInterpolation(pc, l, &P); CHKERRQ(ierr);
+      interpolations[l] = new SingleMatrix;
+      ierr = interpolations[l]->create(P); CHKERRQ(ierr);
+    }
+    ierr = estimateMaxEigenvalue(l); CHKERRQ(ierr);
+  }
+
+  return 0;
+} // setUpLevels
+
+
+/*!
+ * \brief Estimates the largest eigenvalue of \f$ D^{-1} A \f$ on a level with
+ *        10 power iterations, increased by 10%.
+ */
+PetscErrorCode MixedPrecisionSolver::estimateMaxEigenvalue(PetscInt l)
+{
+  PetscErrorCode ierr;
+
+  PetscInt n = operators[l]->getLocalRows();
+  std::vector<SingleReal> &x = solution[l],
+                          &y = product[l];
+  // start away from the constant vector
+  for (PetscInt i=0; i<n; i++)
+    x[i] = 1.0 + (SingleReal) ((7*i)%11)/11.0;
+
+  PetscReal xx, yy, lambda = 0.0;
+  ierr = dot(n, x.data(), x.data(), xx); CHKERRQ(ierr);
+  for (PetscInt k=0; k<10 && xx > 0.0; k++)
+  {
+    ierr = operators[l]->mult(x.data(), y.data()); CHKERRQ(ierr);
+    for (PetscInt i=0; i<n; i++)
+      y[i] *= invDiagonals[l][i];
+    ierr = dot(n, y.data(), y.data(), yy); CHKERRQ(ierr);
+    if (yy <= 0.0)
+      break;
+    lambda = PetscSqrtReal(yy/xx);
+    SingleReal scale = (SingleReal) (1.0/PetscSqrtReal(yy));
+    for (PetscInt i=0; i<n; i++)
+      x[i] = scale*y[i];
+    xx = 1.0;
+  }
+  maxEigenvalues[l] = (SingleReal) (1.1*lambda);
+
+  return 0;
+} // estimateMaxEigenvalue
+
+
+/*!
+ * \brief Applies Chebyshev iterations, preconditioned by the diagonal, to the
+ *        system of a level, over the interval
+ *        \f$ [0.1 \lambda_{max}, \lambda_{max}] \f$ (as the default smoother of GAMG).
+ */
+PetscErrorCode MixedPrecisionSolver::smooth(PetscInt l)
+{
+  PetscErrorCode ierr;
+
+  PetscInt n = operators[l]->getLocalRows();
+  std::vector<SingleReal> &b = rhs[l],
+                          &x = solution[l],
+                          &res = residual[l],
+                          &d = direction[l],
+                          &Ad = product[l];
+  const std::vector<SingleReal> &invD = invDiagonals[l];
+  if (maxEigenvalues[l] <= 0.0)
+    return 0;
+
+  PetscReal upper = maxEigenvalues[l],
+            lower = 0.1*upper,
+            theta = 0.5*(upper + lower),
+            delta = 0.5*(upper - lower),
+            sigma = theta/delta,
+            rho = 1.0/sigma;
+
+  ierr = operators[l]->mult(x.data(), Ad.data()); CHKERRQ(ierr);
+  for (PetscInt i=0; i<n; i++)
+  {
+    res[i] = b[i] - Ad[i];
+    d[i] = (SingleReal) (1.0/theta)*invD[i]*res[i];
+  }
+  for (PetscInt k=0; k<smoothIts; k++)
+  {
+    for (PetscInt i=0; i<n; i++)
+      x[i] += d[i];
+    if (k == smoothIts-1)
+      break;
+    ierr = operators[l]->mult(d.data(), Ad.data()); CHKERRQ(ierr);
+    PetscReal rhoNew = 1.0/(2.0*sigma - rho);
+    SingleReal c1 = (SingleReal) (rhoNew*rho),
+               c2 = (SingleReal) (2.0*rhoNew/delta);
+    for (PetscInt i=0; i<n; i++)
+    {
+      res[i] -= Ad[i];
+      d[i] = c1*d[i] + c2*invD[i]*res[i];
+    }
+    rho = rhoNew;
+  }
+
+  return 0;
+} // smooth
+
+
+/*!
+ * \brief Applies a V-cycle from a level, with a zero initial guess.
+ *
+ * The right-hand side is read from `rhs[l]` and the solution written to
+ * `solution[l]`.
+ */
+PetscErrorCode MixedPrecisionSolver::cycle(PetscInt l)
+{
+  PetscErrorCode ierr;
+
+  if (coarse && l == 0)
+  {
+    PetscScalar *a;
+    PetscInt n = rhs[0].size();
+    ierr = VecGetArray(coarseRHS, &a); CHKERRQ(ierr);
+    for (PetscInt i=0; i<n; i++)
+      a[i] = rhs[0][i];
+    ierr = VecRestoreArray(coarseRHS, &a); CHKERRQ(ierr);
+    ierr = KSPSolve(coarse, coarseRHS, coarseSolution); CHKERRQ(ierr);
+    const PetscScalar *y;
+    ierr = VecGetArrayRead(coarseSolution, &y); CHKERRQ(ierr);
+    for (PetscInt i=0; i<n; i++)
+      solution[0][i] = (SingleReal) PetscRealPart(y[i]);
+    ierr = VecRestoreArrayRead(coarseSolution, &y); CHKERRQ(ierr);
+    return 0;
+  }
+
+  PetscInt n = operators[l]->getLocalRows();
+  std::fill(solution[l].begin(), solution[l].end(), (SingleReal) 0.0);
+  ierr = smooth(l); CHKERRQ(ierr);
+  if (l == 0)
+    return 0;
+
+  // coarse-grid correction
+  ierr = operators[l]->mult(solution[l].data(), product[l].data()); CHKERRQ(ierr);
+  for (PetscInt i=0; i<n; i++)
+    residual[l][i] = rhs[l][i] - product[l][i];
+  ierr = interpolations[l]->multTranspose(residual[l].data(), rhs[l-1].data()); CHKERRQ(ierr);
+  ierr = cycle(l-1); CHKERRQ(ierr);
+  ierr = interpolations[l]->mult(solution[l-1].data(), product[l].data()); CHKERRQ(ierr);
+  for (PetscInt i=0; i<n; i++)
+    solution[l][i] += product[l][i];
+
+  ierr = smooth(l); CHKERRQ(ierr);
+
+  return 0;
+} // cycle
+
+
+/*!
+ * \brief Applies the single-precision preconditioner to a vector of the
+ *        finest level.
+ */
+PetscErrorCode MixedPrecisionSolver::applyPreconditioner(const SingleReal *b, SingleReal *x)
+{
+  PetscErrorCode ierr;
+
+  PetscInt finest = operators.size()-1;
+  std::copy(b, b+rhs[finest].size(), rhs[finest].begin());
+  ierr = cycle(finest); CHKERRQ(ierr);
+  std::copy(solution[finest].begin(), solution[finest].end(), x);
+  ierr = removeNullSpace(x); CHKERRQ(ierr);
+
+  return 0;
+} // applyPreconditioner
+
+
+/*!
+ * \brief Applies the single-precision preconditioner to a double-precision vector.
+ */
+PetscErrorCode MixedPrecisionSolver::applyPreconditioner(Vec b, Vec x)
+{
+  PetscErrorCode ierr;
+
+  PetscInt n = innerR.size();
+  const PetscScalar *a;
+  ierr = VecGetArrayRead(b, &a); CHKERRQ(ierr);
+  for (PetscInt i=0; i<n; i++)
+    innerR[i] = (SingleReal) PetscRealPart(a[i]);
+  ierr = VecRestoreArrayRead(b, &a); CHKERRQ(ierr);
+  ierr = applyPreconditioner(innerR.data(), innerZ.data()); CHKERRQ(ierr);
+  PetscScalar *y;
+  ierr = VecGetArray(x, &y); CHKERRQ(ierr);
+  for (PetscInt i=0; i<n; i++)
+    y[i] = innerZ[i];
+  ierr = VecRestoreArray(x, &y); CHKERRQ(ierr);
+
+  return 0;
+} // applyPreconditioner
+
+
+/*!
+ * \brief Computes the dot product of two single-precision vectors, accumulated
+ *        in double precision.
+ */
+PetscErrorCode MixedPrecisionSolver::dot(PetscInt n, const SingleReal *x, const SingleReal *y, PetscReal &result)
+{
+  PetscErrorCode ierr;
+
+  PetscReal local = 0.0;
+  for (PetscInt i=0; i<n; i++)
+    local += ((PetscReal) x[i])*y[i];
+  ierr = MPI_Allreduce(&local, &result, 1, MPIU_REAL, MPIU_SUM, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+  return 0;
+} // dot
+
+
+/*!
+ * \brief Removes the components of a vector of the finest level along the
+ *        null space of the operator.
+ */
+PetscErrorCode MixedPrecisionSolver::removeNullSpace(SingleReal *x)
+{
+  PetscErrorCode ierr;
+
+  PetscInt n = innerX.size();
+  if (removeMean)
+  {
+    PetscReal local = 0.0, sum;
+    for (PetscInt i=0; i<n; i++)
+      local += x[i];
+    ierr = MPI_Allreduce(&local, &sum, 1, MPIU_REAL, MPIU_SUM, PETSC_COMM_WORLD); CHKERRQ(ierr);
+    SingleReal mean = (SingleReal) (sum/globalSize);
+    for (PetscInt i=0; i<n; i++)
+      x[i] -= mean;
+  }
+  for (size_t k=0; k<nullVectors.size(); k++)
+  {
+    PetscReal component;
+    ierr = dot(n, nullVectors[k].data(), x, component); CHKERRQ(ierr);
+    for (PetscInt i=0; i<n; i++)
+      x[i] -= ((SingleReal) component)*nullVectors[k][i];
+  }
+
+  return 0;
+} // removeNullSpace
+
+
+/*!
+ * \brief Solves the system for the correction with the single-precision
+ *        preconditioned conjugate gradient.
+ *
+ * \param b Residual of the outer loop
+ * \param x Correction
+ * \param its Returns the number of inner iterations
+ */
+PetscErrorCode MixedPrecisionSolver::innerSolve(Vec b, Vec x, PetscInt &its)
+{
+  PetscErrorCode ierr;
+
+  PetscInt n = innerX.size();
+  SingleMatrix *A = operators.back();
+  const PetscScalar *a;
+  ierr = VecGetArrayRead(b, &a); CHKERRQ(ierr);
+  for (PetscInt i=0; i<n; i++)
+    innerR[i] = (SingleReal) PetscRealPart(a[i]);
+  ierr = VecRestoreArrayRead(b, &a); CHKERRQ(ierr);
+  std::fill(innerX.begin(), innerX.end(), (SingleReal) 0.0);
+
+  PetscReal rr0, rr, rz, rzNew, pq;
+  its = 0;
+  ierr = dot(n, innerR.data(), innerR.data(), rr0); CHKERRQ(ierr);
+  if (rr0 > 0.0)
+  {
+    ierr = applyPreconditioner(innerR.data(), innerZ.data()); CHKERRQ(ierr);
+    ierr = dot(n, innerR.data(), innerZ.data(), rz); CHKERRQ(ierr);
+    innerP = innerZ;
+  }
+  while (rr0 > 0.0 && its < innerMaxIts)
+  {
+    ierr = A->mult(innerP.data(), innerQ.data()); CHKERRQ(ierr);
+    ierr = dot(n, innerP.data(), innerQ.data(), pq); CHKERRQ(ierr);
+    if (pq <= 0.0)
+      break;
+    SingleReal alpha = (SingleReal) (rz/pq);
+    for (PetscInt i=0; i<n; i++)
+    {
+      innerX[i] += alpha*innerP[i];
+      innerR[i] -= alpha*innerQ[i];
+    }
+    its++;
+    ierr = dot(n, innerR.data(), innerR.data(), rr); CHKERRQ(ierr);
+    if (rr <= innerRtol*innerRtol*rr0)
+      break;
+    ierr = applyPreconditioner(innerR.data(), innerZ.data()); CHKERRQ(ierr);
+    ierr = dot(n, innerR.data(), innerZ.data(), rzNew); CHKERRQ(ierr);
+    SingleReal beta = (SingleReal) (rzNew/rz);
+    rz = rzNew;
+    for (PetscInt i=0; i<n; i++)
+      innerP[i] = innerZ[i] + beta*innerP[i];
+  }
+
+  PetscScalar *y;
+  ierr = VecGetArray(x, &y); CHKERRQ(ierr);
+  for (PetscInt i=0; i<n; i++)
+    y[i] = innerX[i];
+  ierr = VecRestoreArray(x, &y); CHKERRQ(ierr);
+
+  return 0;
+} // innerSolve
+
+
+/*!
+ * \brief Solves the system.
+ *
+ * The residual is computed in double precision with the original operator,
+ * so the solution reaches the requested tolerances in double precision.
+ */
+PetscErrorCode MixedPrecisionSolver::solve(Vec &x, Vec &b)
+{
+  PetscErrorCode ierr;
+
+  Mat A;
+  MatNullSpace nullsp;
+  PetscReal rtol, atol;
+  PetscInt maxits;
+  PetscBool nonzero;
+  ierr = KSPGetOperators(ksp, &A, NULL); CHKERRQ(ierr);
+  ierr = MatGetNullSpace(A, &nullsp); CHKERRQ(ierr);
+  ierr = KSPGetTolerances(ksp, &rtol, &atol, NULL, &maxits); CHKERRQ(ierr);
+  ierr = KSPGetInitialGuessNonzero(ksp, &nonzero); CHKERRQ(ierr);
+  if (!nonzero)
+  {
+    ierr = VecSet(x, 0.0); CHKERRQ(ierr);
+  }
+
+  PetscReal bNorm, rNorm;
+  ierr = VecNorm(b, NORM_2, &bNorm); CHKERRQ(ierr);
+  PetscReal tol = PetscMax(rtol*bNorm, atol);
+  ierr = MatMult(A, x, r); CHKERRQ(ierr);
+  ierr = VecAYPX(r, -1.0, b); CHKERRQ(ierr);
+  if (nullsp)
+  {
+    ierr = MatNullSpaceRemove(nullsp, r); CHKERRQ(ierr);
+  }
+  ierr = VecNorm(r, NORM_2, &rNorm); CHKERRQ(ierr);
+
+  iters = 0;
+  if (singleKrylov)
+  {
+    // iterative refinement
+    while (rNorm > tol && iters < maxits)
+    {
+      PetscInt its;
+      ierr = innerSolve(r, z, its); CHKERRQ(ierr);
+      if (its == 0)
+        break;
+      iters += its;
+      ierr = VecAXPY(x, 1.0, z); CHKERRQ(ierr);
+      ierr = MatMult(A, x, r); CHKERRQ(ierr);
+      ierr = VecAYPX(r, -1.0, b); CHKERRQ(ierr);
+      if (nullsp)
+      {
+        ierr = MatNullSpaceRemove(nullsp, r); CHKERRQ(ierr);
+      }
+      ierr = VecNorm(r, NORM_2, &rNorm); CHKERRQ(ierr);
+    }
+  }
+  else
+  {
+    // flexible conjugate gradient (Polak-Ribiere)
+    PetscScalar rz, pq, zq, alpha, beta;
+    if (rNorm > tol)
+    {
+      ierr = applyPreconditioner(r, z); CHKERRQ(ierr);
+      ierr = VecDot(r, z, &rz); CHKERRQ(ierr);
+      ierr = VecCopy(z, p); CHKERRQ(ierr);
+    }
+    while (rNorm > tol && iters < maxits)
+    {
+      ierr = MatMult(A, p, q); CHKERRQ(ierr);
+      ierr = VecDot(p, q, &pq); CHKERRQ(ierr);
+      if (PetscRealPart(pq) <= 0.0)
+        break;
+      alpha = rz/pq;
+      ierr = VecAXPY(x, alpha, p); CHKERRQ(ierr);
+      ierr = VecAXPY(r, -alpha, q); CHKERRQ(ierr);
+      iters++;
+      ierr = VecNorm(r, NORM_2, &rNorm); CHKERRQ(ierr);
+      if (rNorm <= tol)
+        break;
+      ierr = applyPreconditioner(r, z); CHKERRQ(ierr);
+      if (nullsp)
+      {
+        ierr = MatNullSpaceRemove(nullsp, z); CHKERRQ(ierr);
+      }
+      // beta = (z_{k+1}, r_{k+1} - r_k)/(z_k, r_k), with r_{k+1} - r_k = -alpha q
+      ierr = VecDot(z, q, &zq); CHKERRQ(ierr);
+      beta = -alpha*zq/rz;
+      ierr = VecDot(r, z, &rz); CHKERRQ(ierr);
+      ierr = VecAYPX(p, beta, z); CHKERRQ(ierr);
+    }
+  }
+
+  residualNorm = rNorm;
+  if (rNorm > tol)
+  {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,
+            "\nERROR: %s mixed-precision solver did not converge (residual norm %g, tolerance %g)\n",
+            prefix.substr(0, prefix.size()-1).c_str(), (double) rNorm, (double) tol); CHKERRQ(ierr);
+    ierr = PetscFinalize(); CHKERRQ(ierr);
+    exit(1);
+  }
+
+  return 0;
+} // solve
+
+
+/*!
+ * \brief Get the number of iterations of the last solve (inner iterations
+ *        with a single-precision Krylov solver).
+ */
+PetscErrorCode MixedPrecisionSolver::getIters(PetscInt &its)
+{
+  its = iters;
+
+  return 0;
+} // getIters
+
+
+/*!
+ * \brief Get the 2-norm of the residual at the end of the last solve.
+ */
+PetscErrorCode MixedPrecisionSolver::getResidualNorm(PetscReal &norm)
+{
+  norm = residualNorm;
+
+  return 0;
+} // getResidualNorm
@@ -0,0 +1,95 @@
+/*! Implementation of the class `MixedPrecisionSolver`.
+ * \file mixedprecisionsolver.h
+ */
+
+#if !defined(MIXEDPRECISIONSOLVER_H)
+#define MIXEDPRECISIONSOLVER_H
+
+#include "solver.h"
+#include "singlematrix.h"
+
+#include <petscksp.h>
+
+#include <string>
+#include <vector>
+
+
+/*!
+ * \class MixedPrecisionSolver
+ * \brief Iterative solver with a single-precision multigrid preconditioner and
+ *        a double-precision outer loop.
+ *
+ * A KSP with the prefix of the solver sets up the preconditioner from the
+ * options file (for example, `-poisson_pc_type gamg`); the operators and the
+ * interpolations of its multigrid levels are then copied in single precision
+ * and the V-cycle runs in single precision, with Chebyshev/Jacobi smoothing on
+ * the finer levels and the coarse solver of the KSP (in double precision) on
+ * the coarsest level. The double-precision levels are then released, except
+ * the coarse solver. A preconditioner other than multigrid is replaced by the
+ * smoother alone.
+ *
+ * With `-<prefix>mixed_krylov single` (default), the inner conjugate gradient
+ * also runs in single precision, up to the relative tolerance
+ * `-<prefix>mixed_inner_rtol` (default 1e-3) or `-<prefix>mixed_inner_max_it`
+ * iterations (default 200), and an iterative refinement in double precision
+ * corrects the solution until the residual meets the tolerances of the KSP
+ * (`-<prefix>ksp_rtol`, `-<prefix>ksp_atol`, `-<prefix>ksp_max_it`, counted in
+ * inner iterations). With `-<prefix>mixed_krylov double`, a flexible conjugate
+ * gradient in double precision applies one single-precision V-cycle per
+ * iteration. The number of smoothing iterations is set with
+ * `-<prefix>mixed_smooth_its` (default 2). The operator should be symmetric
+ * positive (semi-)definite; its null space is removed in both precisions.
+ */
+class MixedPrecisionSolver : public Solver
+{
+public:
+  MixedPrecisionSolver(std::string p, std::string f)
+    : prefix(p), options(f), ksp(NULL), singleKrylov(PETSC_TRUE),
+      innerRtol(1.0E-03), innerMaxIts(200), smoothIts(2), iters(0), globalSize(0), residualNorm(0.0), removeMean(PETSC_FALSE),
+      coarse(NULL), coarseRHS(NULL), coarseSolution(NULL), r(NULL), z(NULL), p(NULL), q(NULL) { };
+  virtual ~MixedPrecisionSolver();
+
+  PetscErrorCode create(const Mat &A);
+  PetscErrorCode solve(Vec &x, Vec &b);
+  PetscErrorCode getIters(PetscInt &iters);
+  PetscErrorCode getResidualNorm(PetscReal &norm);
+
+private:
+  std::string prefix;
+  std::string options;
+  KSP ksp;                 // operator and tolerances (preconditioner released after the copy)
+  PetscBool singleKrylov;  // inner conjugate gradient in single precision
+  PetscReal innerRtol;
+  PetscInt innerMaxIts,
+           smoothIts;
+  PetscInt iters,          // iterations of the last solve
+           globalSize;     // number of unknowns
+  PetscReal residualNorm;  // 2-norm of the residual at the end of the last solve
+  PetscBool removeMean;    // constant null space
+  std::vector<std::vector<SingleReal> > nullVectors; // other vectors of the null space
+
+  // multigrid levels, from the coarsest (0) to the finest
+  std::vector<SingleMatrix*> operators,
+                             interpolations; // from level l-1 to level l
+  std::vector<std::vector<SingleReal> > invDiagonals,
+                                        rhs, solution, residual, direction, product;
+  std::vector<SingleReal> maxEigenvalues;
+  KSP coarse;              // coarse solver of the KSP (NULL without multigrid)
+  Vec coarseRHS, coarseSolution;
+  // work vectors of the inner conjugate gradient (finest level)
+  std::vector<SingleReal> innerX, innerR, innerZ, innerP, innerQ;
+  Vec r, z, p, q;          // work vectors of the outer loop
+
+  PetscErrorCode setUpLevels();
+  PetscErrorCode estimateMaxEigenvalue(PetscInt l);
+  PetscErrorCode smooth(PetscInt l);
+  PetscErrorCode cycle(PetscInt l);
+  PetscErrorCode applyPreconditioner(const SingleReal *b, SingleReal *x);
+  PetscErrorCode applyPreconditioner(Vec b, Vec x);
+  PetscErrorCode innerSolve(Vec b, Vec x, PetscInt &its);
+  PetscErrorCode dot(PetscInt n, const SingleReal *x, const SingleReal *y, PetscReal &result);
+  PetscErrorCode removeNullSpace(SingleReal *x);
+
+}; // MixedPrecisionSolver
+
+#endif
@@ -0,0 +1,187 @@
+/*! Implementation of the methods of the class `SingleMatrix`.
+ * \file singlematrix.cpp
+ */
+
+#include "singlematrix.h"
+
+#include <algorithm>
+
+
+/*!
+ * \brief Destroys the star forest.
+ */
+SingleMatrix::~SingleMatrix()
+{
+  PetscSFDestroy(&sf);
+} // ~SingleMatrix
+
+
+/*!
+ * \brief Copies the values of a sequential AIJ matrix in single precision.
+ */
+PetscErrorCode SingleMatrix::copyCSR(Mat M, std::vector<PetscInt> &rows, std::vector<PetscInt> &cols,
+                                     std::vector<SingleReal> &values)
+{
+  PetscErrorCode ierr;
+
+  PetscInt n;
+  const PetscInt *ia, *ja;
+  PetscBool done;
+  ierr = MatGetRowIJ(M, 0, PETSC_FALSE, PETSC_FALSE, &n, &ia, &ja, &done); CHKERRQ(ierr);
+  if (!done)
+  {
+    SETERRQ(PETSC_COMM_SELF, PETSC_ERR_SUP, "Unable to access the rows of the matrix");
+  }
+  PetscScalar *a;
+  ierr = MatSeqAIJGetArray(M, &a); CHKERRQ(ierr);
+  rows.assign(ia, ia+n+1);
+  cols.assign(ja, ja+ia[n]);
+  values.resize(ia[n]);
+  for (PetscInt k=0; k<ia[n]; k++)
+    values[k] = (SingleReal) PetscRealPart(a[k]);
+  ierr = MatSeqAIJRestoreArray(M, &a); CHKERRQ(ierr);
+  ierr = MatRestoreRowIJ(M, 0, PETSC_FALSE, PETSC_FALSE, &n, &ia, &ja, &done); CHKERRQ(ierr);
+
+  return 0;
+} // copyCSR
+
+
+/*!
+ * \brief Copies an assembled AIJ matrix (`MATSEQAIJ` or `MATMPIAIJ`).
+ *
+ * \param A Matrix (may be rectangular)
+ */
+PetscErrorCode SingleMatrix::create(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscBool isMPI, isSeq;
+  ierr = PetscObjectTypeCompare((PetscObject) A, MATMPIAIJ, &isMPI); CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject) A, MATSEQAIJ, &isSeq); CHKERRQ(ierr);
+  if (!isMPI && !isSeq)
+  {
+    SETERRQ(PetscObjectComm((PetscObject) A), PETSC_ERR_SUP,
+            "The single-precision copy requires an AIJ matrix");
+  }
+  ierr = MatGetLocalSize(A, &numRows, &numCols); CHKERRQ(ierr);
+  if (isSeq)
+  {
+    ierr = copyCSR(A, rowsDiag, colsDiag, valuesDiag); CHKERRQ(ierr);
+    return 0;
+  }
+
+  Mat Ad, Ao;
+  const PetscInt *garray;
+  ierr = MatMPIAIJGetSeqAIJ(A, &Ad, &Ao, &garray); CHKERRQ(ierr);
+  ierr = copyCSR(Ad, rowsDiag, colsDiag, valuesDiag); CHKERRQ(ierr);
+  ierr = copyCSR(Ao, rowsOff, colsOff, valuesOff); CHKERRQ(ierr);
+  // the off-diagonal block is compressed to the ghost columns
+  ierr = MatGetSize(Ao, NULL, &numGhosts); CHKERRQ(ierr);
+  ghosts.assign(numGhosts, 0.0);
+
+  // owner of each ghost column
+  MPI_Comm comm;
+  PetscMPIInt size;
+  const PetscInt *ranges;
+  ierr = PetscObjectGetComm((PetscObject) A, &comm); CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm, &size); CHKERRQ(ierr);
+  ierr = MatGetOwnershipRangesColumn(A, &ranges); CHKERRQ(ierr);
+  std::vector<PetscSFNode> remote(numGhosts);
+  for (PetscInt i=0; i<numGhosts; i++)
+  {
+    PetscInt rank = std::upper_bound(ranges, ranges+size+1, garray[i]) - ranges - 1;
+    remote[i].rank = rank;
+    remote[i].index = garray[i] - ranges[rank];
+  }
+  ierr = PetscSFCreate(comm, &sf); CHKERRQ(ierr);
+  ierr = PetscSFSetFromOptions(sf); CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(sf, numCols, numGhosts, NULL, PETSC_COPY_VALUES,
+                         (numGhosts > 0) ? &remote[0] : NULL, PETSC_COPY_VALUES); CHKERRQ(ierr);
+  ierr = PetscSFSetUp(sf); CHKERRQ(ierr);
+
+  return 0;
+} // create
+
+
+/*!
+ * \brief Computes \f$ y = A x \f$; the ghost exchange overlaps the product
+ *        with the owned columns.
+ */
+PetscErrorCode SingleMatrix::mult(const SingleReal *x, SingleReal *y)
+{
+  PetscErrorCode ierr;
+
+  if (sf)
+  {
+    ierr = PetscSFBcastBegin(sf, MPI_FLOAT, x, (numGhosts > 0) ? &ghosts[0] : NULL); CHKERRQ(ierr);
+  }
+  for (PetscInt i=0; i<numRows; i++)
+  {
+    SingleReal sum = 0.0;
+    for (PetscInt k=rowsDiag[i]; k<rowsDiag[i+1]; k++)
+      sum += valuesDiag[k]*x[colsDiag[k]];
+    y[i] = sum;
+  }
+  if (sf)
+  {
+    ierr = PetscSFBcastEnd(sf, MPI_FLOAT, x, (numGhosts > 0) ? &ghosts[0] : NULL); CHKERRQ(ierr);
+    for (PetscInt i=0; i<numRows; i++)
+    {
+      SingleReal sum = 0.0;
+      for (PetscInt k=rowsOff[i]; k<rowsOff[i+1]; k++)
+        sum += valuesOff[k]*ghosts[colsOff[k]];
+      y[i] += sum;
+    }
+  }
+
+  return 0;
+} // mult
+
+
+/*!
+ * \brief Computes \f$ y = A^T x \f$; the contributions to the ghost columns
+ *        are summed on their owners.
+ */
+PetscErrorCode SingleMatrix::multTranspose(const SingleReal *x, SingleReal *y)
+{
+  PetscErrorCode ierr;
+
+  std::fill(y, y+numCols, (SingleReal) 0.0);
+  for (PetscInt i=0; i<numRows; i++)
+  {
+    for (PetscInt k=rowsDiag[i]; k<rowsDiag[i+1]; k++)
+      y[colsDiag[k]] += valuesDiag[k]*x[i];
+  }
+  if (sf)
+  {
+    std::fill(ghosts.begin(), ghosts.end(), (SingleReal) 0.0);
+    for (PetscInt i=0; i<numRows; i++)
+    {
+      for (PetscInt k=rowsOff[i]; k<rowsOff[i+1]; k++)
+        ghosts[colsOff[k]] += valuesOff[k]*x[i];
+    }
+    ierr = PetscSFReduceBegin(sf, MPI_FLOAT, (numGhosts > 0) ? &ghosts[0] : NULL, y, MPI_SUM); CHKERRQ(ierr);
+    ierr = PetscSFReduceEnd(sf, MPI_FLOAT, (numGhosts > 0) ? &ghosts[0] : NULL, y, MPI_SUM); CHKERRQ(ierr);
+  }
+
+  return 0;
+} // multTranspose
+
+
+/*!
+ * \brief Gets the diagonal of a square matrix.
+ */
+PetscErrorCode SingleMatrix::getDiagonal(SingleReal *d)
+{
+  for (PetscInt i=0; i<numRows; i++)
+  {
+    d[i] = 0.0;
+    for (PetscInt k=rowsDiag[i]; k<rowsDiag[i+1]; k++)
+    {
+      if (colsDiag[k] == i)
+        d[i] = valuesDiag[k];
+    }
+  }
+
+  return 0;
+} // getDiagonal
@@ -0,0 +1,57 @@
+/*! Implementation of the class `SingleMatrix`.
+ * \file singlematrix.h
+ */
+
+#if !defined(SINGLEMATRIX_H)
+#define SINGLEMATRIX_H
+
+#include <petscmat.h>
+#include <petscsf.h>
+
+#include <vector>
+
+
+// single-precision scalar of the mixed-precision solver
+typedef float SingleReal;
+
+
+/*!
+ * \class SingleMatrix
+ * \brief Single-precision copy of a parallel AIJ matrix.
+ *
+ * The rows owned by the process are stored in CSR format as two blocks, the
+ * columns owned by the process and the ghost columns (the layout of
+ * `MATMPIAIJ`); the ghost values of the vector are exchanged with a star
+ * forest. The values take half the memory of the PETSc matrix, the column
+ * indices are unchanged. The vectors are plain arrays of the local rows or
+ * columns.
+ */
+class SingleMatrix
+{
+public:
+  SingleMatrix(): numRows(0), numCols(0), numGhosts(0), sf(NULL) { };
+  ~SingleMatrix();
+
+  PetscErrorCode create(Mat A);
+  PetscErrorCode mult(const SingleReal *x, SingleReal *y);
+  PetscErrorCode multTranspose(const SingleReal *x, SingleReal *y);
+  PetscErrorCode getDiagonal(SingleReal *d);
+  PetscInt getLocalRows() { return numRows; };
+  PetscInt getLocalCols() { return numCols; };
+
+private:
+  PetscInt numRows,   // local rows
+           numCols,   // local columns
+           numGhosts; // ghost columns
+  std::vector<PetscInt> rowsDiag, colsDiag, // owned columns
+                        rowsOff, colsOff;   // ghost columns
+  std::vector<SingleReal> valuesDiag, valuesOff;
+  std::vector<SingleReal> ghosts; // ghost values of the vector
+  PetscSF sf; // owned columns (roots) to ghost columns (leaves)
+
+  PetscErrorCode copyCSR(Mat M, std::vector<PetscInt> &rows, std::vector<PetscInt> &cols,
+                         std::vector<SingleReal> &values);
+
+}; // SingleMatrix
+
+#endif
@@ -19,6 +19,13 @@ public:
   virtual PetscErrorCode create(const Mat &A) = 0;
   virtual PetscErrorCode solve(Vec &x, Vec &b) = 0;
   virtual PetscErrorCode getIters(PetscInt &iters) = 0;
+  // iterations saved by recycling (negative when the solver does not recycle)
+  virtual PetscErrorCode getSavedIters(PetscInt &iters){ iters = -1; return 0; }
+  // residual norm at the end of the last solve (negative when not available)
+  virtual PetscErrorCode getResidualNorm(PetscReal &norm){ norm = -1.0; return 0; }
+  // history of previous solutions used for the initial guess of the next
+  // solves (negative: none)
+  virtual PetscErrorCode setHistory(PetscInt index){ return 0; }
 
 }; // Solver
 
@@ -246,10 +246,19 @@ ExecuteType stringToExecuteType(std::string s)
     return GPU;
   if (s == "CPU")
     return CPU;
+  if (s == "FFT")
+    return FFT;
+  if (s == "MIXED")
+    return MIXED;
+  if (s == "AGGLOMERATED")
+    return AGGLOMERATED;
   std::cout << "\nERROR: " << s << " - unknown executing space.\n";
   std::cout << "Acceptable executing spaces:\n";
   std::cout << "\tGPU\n";
-  std::cout << "\tCPU\n" << std::endl;
+  std::cout << "\tCPU\n";
+  std::cout << "\tFFT\n";
+  std::cout << "\tMIXED\n";
+  std::cout << "\tAGGLOMERATED\n" << std::endl;
   exit(EXIT_FAILURE);
 } // stringToExecuteType
 
@@ -269,8 +278,64 @@ std::string stringFromExecuteType(ExecuteType exeType)
     case CPU:
       return "CPU-based (currently, PETSc KSPs)";
       break;
+    case FFT:
+      return "CPU-based direct solver (fast transforms with FFTW)";
+      break;
+    case MIXED:
+      return "CPU-based mixed-precision solver (single-precision multigrid)";
+      break;
+    case AGGLOMERATED:
+      return "CPU-based (PETSc KSPs on a subset of the processes)";
+      break;
     default:
       return "ERROR";
       break;
   }
 } // stringFromExecuteType
+
+
+/**
+ * \brief Returns the mode of solution of the velocity components as an enum.
+ *
+ * \param s string that describes the mode.
+ */
+ComponentSolve stringToComponentSolve(std::string s)
+{
+  if (s == "MONOLITHIC")
+    return MONOLITHIC;
+  if (s == "SEQUENTIAL")
+    return SEQUENTIAL;
+  if (s == "CONCURRENT")
+    return CONCURRENT;
+  std::cout << "\nERROR: " << s << " - unknown mode to solve the velocity components.\n";
+  std::cout << "Acceptable modes:\n";
+  std::cout << "\tMONOLITHIC\n";
+  std::cout << "\tSEQUENTIAL\n";
+  std::cout << "\tCONCURRENT\n" << std::endl;
+  exit(EXIT_FAILURE);
+} // stringToComponentSolve
+
+
+/**
+ * \brief Returns the mode of solution of the velocity components as a string.
+ *
+ * \param mode mode as an enum.
+ */
+std::string stringFromComponentSolve(ComponentSolve mode)
+{
+  switch(mode)
+  {
+    case MONOLITHIC:
+      return "monolithic";
+      break;
+    case SEQUENTIAL:
+      return "one system per component, solved sequentially";
+      break;
+    case CONCURRENT:
+      return "one system per component, solved concurrently";
+      break;
+    default:
+      return "ERROR";
+      break;
+  }
+} // stringFromComponentSolve
@@ -100,17 +100,44 @@ enum StaggeredMode
 };
 
 
+/**
+ * \brief Subset of the points owned by a process on which a kernel is applied.
+ */
+enum KernelRegion
+{
+  ALL_POINTS,   ///< all owned points
+  HALO_FREE,    ///< owned points whose stencils involve no ghost point
+  HALO_ADJACENT ///< owned points whose stencils involve ghost points
+};
+
+
 /**
  * \brief Data type describing the executing space of linear solvers
  */
 enum ExecuteType
 {
     GPU, ///< GPU-based solver. Currently only AmgX solvers exist.
-    CPU  ///< CPU-based solver, i.e. PETSc solvers
+    CPU, ///< CPU-based solver, i.e. PETSc solvers
+    FFT, ///< CPU-based direct solver using fast transforms (Poisson system only)
+    MIXED, ///< CPU-based solver with a single-precision preconditioner (Poisson system only)
+    AGGLOMERATED ///< CPU-based solver on a subset of the processes (Poisson system only)
 };
 ExecuteType stringToExecuteType(std::string);
 std::string stringFromExecuteType(ExecuteType exeType);
 
+
+/**
+ * \brief How the velocity system is solved across the flux components.
+ */
+enum ComponentSolve
+{
+  MONOLITHIC, ///< one system for all components
+  SEQUENTIAL, ///< one system per component, solved one after another
+  CONCURRENT  ///< one system per component, solved at the same time on groups of processes
+};
+ComponentSolve stringToComponentSolve(std::string s);
+std::string stringFromComponentSolve(ComponentSolve mode);
+
 #endif
 
 /**
@@ -0,0 +1,162 @@
+/***************************************************************************//**
+ * \file AsyncWriterTest.cpp
+ * \brief Unit-tests for the class `AsyncWriter`: the files it writes are read
+ *        back with `VecLoad` and compared with the vectors staged.
+ */
+
+
+#include "AsyncWriter.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <petscdmda.h>
+#include <petscviewer.h>
+
+
+/**
+ * \brief Returns the largest difference between a DMDA vector and the one
+ *        read from a PETSc binary file.
+ */
+PetscReal loadDifference(Vec v, std::string filePath)
+{
+  DM da;
+  Vec w;
+  PetscViewer viewer;
+  PetscReal difference;
+
+  VecGetDM(v, &da);
+  DMCreateGlobalVector(da, &w);
+  PetscViewerBinaryOpen(PETSC_COMM_WORLD, filePath.c_str(), FILE_MODE_READ, &viewer);
+  VecLoad(w, viewer);
+  PetscViewerDestroy(&viewer);
+  VecAXPY(w, -1.0, v);
+  VecNorm(w, NORM_INFINITY, &difference);
+  VecDestroy(&w);
+
+  return difference;
+}
+
+
+/**
+ * \brief Writes snapshots of random 2D and 3D DMDA vectors through an
+ *        asynchronous writer and computes the largest difference between the
+ *        vectors staged and the files read back.
+ *
+ * The calls to the writer must succeed.
+ *
+ * There are more snapshots than buffers, so that staging waits for the writer;
+ * the 3D vector has two components per node.
+ */
+void writeAndLoad(PetscBool useThread, std::string prefix, PetscReal &difference)
+{
+  const PetscInt numSnapshots = 3;
+  DM da2d, da3d;
+  Vec v2d, v3d;
+  PetscRandom random;
+  std::vector<Vec> staged;
+  std::vector<std::string> filePaths;
+
+  DMDACreate2d(PETSC_COMM_WORLD, DM_BOUNDARY_NONE, DM_BOUNDARY_NONE, DMDA_STENCIL_BOX,
+               19, 13, PETSC_DECIDE, PETSC_DECIDE, 1, 1, NULL, NULL, &da2d);
+  DMDACreate3d(PETSC_COMM_WORLD, DM_BOUNDARY_NONE, DM_BOUNDARY_NONE, DM_BOUNDARY_NONE, DMDA_STENCIL_BOX,
+               9, 7, 5, PETSC_DECIDE, PETSC_DECIDE, PETSC_DECIDE, 2, 1, NULL, NULL, NULL, &da3d);
+  DMCreateGlobalVector(da2d, &v2d);
+  DMCreateGlobalVector(da3d, &v3d);
+  PetscRandomCreate(PETSC_COMM_WORLD, &random);
+
+  AsyncWriter writer;
+  ASSERT_EQ(0, writer.initialize(useThread, 2));
+  for (PetscInt s=0; s<numSnapshots; s++)
+  {
+    Vec vecs[2] = {v2d, v3d};
+    const char *names[2] = {"2d", "3d"};
+    for (PetscInt i=0; i<2; i++)
+    {
+      std::stringstream filePath;
+      filePath << prefix << names[i] << "_" << s << ".dat";
+      VecSetRandom(vecs[i], random);
+      ASSERT_EQ(0, writer.stage(vecs[i], filePath.str()));
+      // the vector may change once staged
+      Vec copy;
+      VecDuplicate(vecs[i], &copy);
+      VecCopy(vecs[i], copy);
+      staged.push_back(copy);
+      filePaths.push_back(filePath.str());
+    }
+    ASSERT_EQ(0, writer.commit());
+  }
+  ASSERT_EQ(0, writer.flush());
+
+  difference = 0.0;
+  for (size_t i=0; i<staged.size(); i++)
+  {
+    difference = std::max(difference, loadDifference(staged[i], filePaths[i]));
+    VecDestroy(&staged[i]);
+  }
+
+  PetscRandomDestroy(&random);
+  VecDestroy(&v2d);
+  VecDestroy(&v3d);
+  DMDestroy(&da2d);
+  DMDestroy(&da3d);
+}
+
+
+// files written by a thread of each process
+TEST(AsyncWriterTest, Thread)
+{
+  // with output servers, the writer always sends its snapshots to them
+  if (AsyncWriter::hasServers())
+    return;
+  PetscReal difference = -1.0;
+  writeAndLoad(PETSC_TRUE, "AsyncWriter/data/thread", difference);
+  EXPECT_EQ(0.0, difference);
+}
+
+// files written by output servers (`make check-io-servers`, run by `make check`:
+// -io_servers 1 on 3 processes)
+TEST(AsyncWriterTest, Servers)
+{
+  if (!AsyncWriter::hasServers())
+    return;
+  PetscReal difference = -1.0;
+  writeAndLoad(PETSC_FALSE, "AsyncWriter/data/servers", difference);
+  EXPECT_EQ(0.0, difference);
+}
+
+
+int main(int argc, char **argv)
+{
+  PetscErrorCode ierr, result;
+
+  ierr = MPI_Init(&argc, &argv); if (ierr) return ierr;
+  // processes set aside to write the files (with -io_servers)
+  PetscMPIInt numServers;
+  PetscBool isServer;
+  ierr = AsyncWriter::splitServers(argc, argv, numServers, isServer);
+  if (ierr)
+  {
+    MPI_Abort(MPI_COMM_WORLD, ierr);
+    return ierr;
+  }
+  if (isServer)
+  {
+    ierr = AsyncWriter::serve(numServers);
+    if (ierr)
+      MPI_Abort(MPI_COMM_WORLD, ierr);
+    ierr = MPI_Finalize();
+    return ierr;
+  }
+
+  ::testing::InitGoogleTest(&argc, argv);
+  ierr = PetscInitialize(&argc, &argv, NULL, NULL); CHKERRQ(ierr);
+  result = RUN_ALL_TESTS();
+  ierr = PetscFinalize(); CHKERRQ(ierr);
+  MPI_Finalize();
+
+  return result;
+}
@@ -144,6 +144,18 @@ TEST_F(CartesianMeshTest, stretchedMesh3dCellWidths)
   }
 }
 
+TEST_F(CartesianMeshTest, uniformity)
+{
+  EXPECT_TRUE(uniformMesh2d.uniform[0]);
+  EXPECT_TRUE(uniformMesh2d.uniform[1]);
+  EXPECT_TRUE(uniformMesh3d.uniform[0]);
+  EXPECT_TRUE(uniformMesh3d.uniform[1]);
+  EXPECT_TRUE(uniformMesh3d.uniform[2]);
+  EXPECT_FALSE(stretchedMesh3d.uniform[0]);
+  EXPECT_FALSE(stretchedMesh3d.uniform[1]);
+  EXPECT_FALSE(stretchedMesh3d.uniform[2]);
+}
+
 int main(int argc, char **argv)
 {
   PetscErrorCode ierr, result;
@@ -0,0 +1,125 @@
+/***************************************************************************//**
+ * \file CompressionTest.cpp
+ * \brief Unit-tests for the error-bounded compression of the fields: the
+ *        quantized values must stay within the tolerance.
+ */
+
+
+#include "compression.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <petscdmda.h>
+#ifdef PETSC_HAVE_HDF5
+#include <petscviewerhdf5.h>
+#endif
+
+
+/**
+ * \brief Quantizes random values spread over several orders of magnitude and
+ *        returns the largest error relative to the tolerance.
+ */
+PetscReal quantizationError(PetscReal tolerance)
+{
+  const PetscInt size = 10000;
+  std::mt19937 generator(12345);
+  std::uniform_real_distribution<PetscReal> mantissa(-1.0, 1.0),
+                                            exponent(-8.0, 4.0);
+  std::vector<PetscScalar> values(size), quantized(size);
+  for (PetscInt i=0; i<size; i++)
+    values[i] = mantissa(generator)*std::pow(10.0, exponent(generator));
+  quantized = values;
+
+  quantize(&quantized[0], size, tolerance);
+
+  PetscReal error = 0.0;
+  for (PetscInt i=0; i<size; i++)
+    error = std::max(error, std::abs(quantized[i]-values[i]));
+
+  return error/tolerance;
+}
+
+
+TEST(CompressionTest, QuantizeWithinTolerance)
+{
+  PetscReal tolerances[] = {1.0E-06, 3.0E-05, 0.1, 0.75, 10.0};
+  for (size_t t=0; t<sizeof(tolerances)/sizeof(tolerances[0]); t++)
+  {
+    EXPECT_LE(quantizationError(tolerances[t]), 1.0) << "tolerance " << tolerances[t];
+  }
+}
+
+TEST(CompressionTest, QuantizeZeroToleranceIsLossless)
+{
+  PetscScalar values[3] = {0.1, -2.0/3.0, 1.0E-300};
+  PetscScalar copies[3] = {0.1, -2.0/3.0, 1.0E-300};
+  quantize(values, 3, 0.0);
+  for (PetscInt i=0; i<3; i++)
+    EXPECT_EQ(copies[i], values[i]);
+}
+
+#ifdef PETSC_HAVE_HDF5
+/**
+ * \brief Writes a random DMDA vector with `viewCompressed` (tolerance relative
+ *        to its maximum absolute value), reads it back with `VecLoad` and
+ *        returns the largest error relative to the absolute tolerance.
+ */
+PetscReal compressedError(PetscReal tolerance)
+{
+  DM da;
+  Vec v, w;
+  PetscRandom random;
+  PetscViewer viewer;
+  PetscReal maxValue, error;
+
+  DMDACreate2d(PETSC_COMM_WORLD, DM_BOUNDARY_NONE, DM_BOUNDARY_NONE, DMDA_STENCIL_BOX,
+               33, 21, PETSC_DECIDE, PETSC_DECIDE, 1, 1, NULL, NULL, &da);
+  DMCreateGlobalVector(da, &v);
+  VecDuplicate(v, &w);
+  PetscObjectSetName((PetscObject) v, "phi");
+  PetscObjectSetName((PetscObject) w, "phi");
+  PetscRandomCreate(PETSC_COMM_WORLD, &random);
+  PetscRandomSetInterval(random, -50.0, 50.0);
+  VecSetRandom(v, random);
+  PetscRandomDestroy(&random);
+  VecNorm(v, NORM_INFINITY, &maxValue);
+
+  PetscViewerHDF5Open(PETSC_COMM_WORLD, "Compression/data/phi.h5", FILE_MODE_WRITE, &viewer);
+  viewCompressed(v, viewer, 4, tolerance, PETSC_TRUE);
+  PetscViewerDestroy(&viewer);
+  PetscViewerHDF5Open(PETSC_COMM_WORLD, "Compression/data/phi.h5", FILE_MODE_READ, &viewer);
+  VecLoad(w, viewer);
+  PetscViewerDestroy(&viewer);
+
+  VecAXPY(w, -1.0, v);
+  VecNorm(w, NORM_INFINITY, &error);
+  VecDestroy(&v);
+  VecDestroy(&w);
+  DMDestroy(&da);
+
+  return error/(tolerance*maxValue);
+}
+
+TEST(CompressionTest, CompressedFieldWithinTolerance)
+{
+  EXPECT_LE(compressedError(1.0E-04), 1.0);
+  EXPECT_LE(compressedError(1.0E-02), 1.0);
+}
+#endif
+
+
+int main(int argc, char **argv)
+{
+  PetscErrorCode ierr, result;
+
+  ::testing::InitGoogleTest(&argc, argv);
+  ierr = PetscInitialize(&argc, &argv, NULL, NULL); CHKERRQ(ierr);
+  result = RUN_ALL_TESTS();
+  ierr = PetscFinalize(); CHKERRQ(ierr);
+
+  return result;
+}
@@ -0,0 +1,102 @@
+/***************************************************************************//**
+ * \file FFTSolverTest.cpp
+ * \brief Unit-test for the FFT Poisson solver: its solution of the pressure
+ *        system is compared with the one of a conjugate gradient.
+ */
+
+
+#include "createSolver.h"
+#include "gtest/gtest.h"
+
+
+#ifdef PETSC_HAVE_FFTW
+/**
+ * \brief Solves the Poisson system of a case with the FFT solver and with a
+ *        Jacobi-preconditioned conjugate gradient; returns the relative
+ *        difference between the two solutions (without their mean, the
+ *        null space of the system).
+ *
+ * The right-hand side is the product of the operator with a random vector.
+ */
+PetscReal compareWithKSP(std::string directory)
+{
+  CartesianMesh cartesianMesh(directory+"/cartesianMesh.yaml");
+  FlowDescription<2> flowDescription(directory+"/flowDescription.yaml");
+  SimulationParameters simulationParameters(directory, directory+"/simulationParameters.yaml");
+  std::unique_ptr< NavierStokesSolver<2> > solver = createSolver<2>(&cartesianMesh,
+                                                                    &flowDescription,
+                                                                    &simulationParameters);
+  solver->initialize();
+
+  Vec exact, b, xFFT, xKSP;
+  MatCreateVecs(solver->QTBNQ, &exact, &b);
+  VecDuplicate(exact, &xFFT);
+  VecDuplicate(exact, &xKSP);
+  PetscRandom random;
+  PetscRandomCreate(PETSC_COMM_WORLD, &random);
+  VecSetRandom(exact, random);
+  PetscRandomDestroy(&random);
+  MatMult(solver->QTBNQ, exact, b);
+
+  // FFT solver of the Navier-Stokes solver
+  VecSet(xFFT, 0.0);
+  solver->poisson->solve(xFFT, b);
+
+  // conjugate gradient on the same matrix
+  MatNullSpace nsp;
+  MatNullSpaceCreate(PETSC_COMM_WORLD, PETSC_TRUE, 0, NULL, &nsp);
+  MatSetNullSpace(solver->QTBNQ, nsp);
+  KSP ksp;
+  PC pc;
+  KSPCreate(PETSC_COMM_WORLD, &ksp);
+  KSPSetOperators(ksp, solver->QTBNQ, solver->QTBNQ);
+  KSPSetType(ksp, KSPCG);
+  KSPGetPC(ksp, &pc);
+  PCSetType(pc, PCJACOBI);
+  KSPSetTolerances(ksp, 1.0E-12, 1.0E-50, PETSC_DEFAULT, 10000);
+  VecSet(xKSP, 0.0);
+  KSPSolve(ksp, b, xKSP);
+
+  PetscReal differenceNorm, norm;
+  MatNullSpaceRemove(nsp, xFFT);
+  MatNullSpaceRemove(nsp, xKSP);
+  VecNorm(xKSP, NORM_2, &norm);
+  VecAXPY(xFFT, -1.0, xKSP);
+  VecNorm(xFFT, NORM_2, &differenceNorm);
+
+  KSPDestroy(&ksp);
+  MatNullSpaceDestroy(&nsp);
+  VecDestroy(&exact);
+  VecDestroy(&b);
+  VecDestroy(&xFFT);
+  VecDestroy(&xKSP);
+  solver->finalize();
+
+  return differenceNorm/norm;
+}
+
+// uniform grid, periodic in both directions (transforms only)
+TEST(FFTSolverTest, Periodic)
+{
+  EXPECT_LT(compareWithKSP("FFTSolver/cases/periodic"), 1.0E-08);
+}
+
+// lid-driven cavity stretched along y (cosine transform and tridiagonal systems)
+TEST(FFTSolverTest, Cavity)
+{
+  EXPECT_LT(compareWithKSP("FFTSolver/cases/cavity"), 1.0E-08);
+}
+#endif
+
+
+int main(int argc, char **argv)
+{
+  PetscErrorCode ierr, result;
+
+  ::testing::InitGoogleTest(&argc, argv);
+  ierr = PetscInitialize(&argc, &argv, NULL, NULL); CHKERRQ(ierr);
+  result = RUN_ALL_TESTS();
+  ierr = PetscFinalize(); CHKERRQ(ierr);
+
+  return result;
+}
@@ -0,0 +1,106 @@
+/***************************************************************************//**
+ * \file MixedPrecisionTest.cpp
+ * \brief Unit-test for the mixed-precision Poisson solver: its solution of the
+ *        pressure system is compared with the one of a conjugate gradient in
+ *        double precision.
+ */
+
+
+#include "createSolver.h"
+#include "gtest/gtest.h"
+
+
+/**
+ * \brief Solves the Poisson system of a case with the mixed-precision solver
+ *        (GAMG levels copied in single precision, Krylov solver in the given
+ *        precision) and with a Jacobi-preconditioned conjugate gradient;
+ *        returns the relative difference between the two solutions (without
+ *        their mean, the null space of the system).
+ *
+ * The right-hand side is the product of the operator with a random vector.
+ */
+PetscReal compareWithKSP(std::string directory, std::string krylov)
+{
+  PetscOptionsSetValue(NULL, "-poisson_mixed_krylov", krylov.c_str());
+  CartesianMesh cartesianMesh(directory+"/cartesianMesh.yaml");
+  FlowDescription<2> flowDescription(directory+"/flowDescription.yaml");
+  SimulationParameters simulationParameters(directory, directory+"/simulationParameters.yaml");
+  std::unique_ptr< NavierStokesSolver<2> > solver = createSolver<2>(&cartesianMesh,
+                                                                    &flowDescription,
+                                                                    &simulationParameters);
+  EXPECT_EQ(0, solver->initialize());
+
+  Vec exact, b, xMixed, xKSP;
+  MatCreateVecs(solver->QTBNQ, &exact, &b);
+  VecDuplicate(exact, &xMixed);
+  VecDuplicate(exact, &xKSP);
+  PetscRandom random;
+  PetscRandomCreate(PETSC_COMM_WORLD, &random);
+  VecSetRandom(exact, random);
+  PetscRandomDestroy(&random);
+  MatMult(solver->QTBNQ, exact, b);
+
+  // mixed-precision solver of the Navier-Stokes solver (coarse solve included)
+  VecSet(xMixed, 0.0);
+  EXPECT_EQ(0, solver->poisson->solve(xMixed, b));
+  PetscInt iters;
+  solver->poisson->getIters(iters);
+  EXPECT_GT(iters, 0);
+
+  // conjugate gradient on the same matrix
+  MatNullSpace nsp;
+  MatNullSpaceCreate(PETSC_COMM_WORLD, PETSC_TRUE, 0, NULL, &nsp);
+  KSP ksp;
+  PC pc;
+  KSPCreate(PETSC_COMM_WORLD, &ksp);
+  KSPSetOperators(ksp, solver->QTBNQ, solver->QTBNQ);
+  KSPSetType(ksp, KSPCG);
+  KSPGetPC(ksp, &pc);
+  PCSetType(pc, PCJACOBI);
+  KSPSetTolerances(ksp, 1.0E-12, 1.0E-50, PETSC_DEFAULT, 10000);
+  VecSet(xKSP, 0.0);
+  KSPSolve(ksp, b, xKSP);
+
+  PetscReal differenceNorm, norm;
+  MatNullSpaceRemove(nsp, xMixed);
+  MatNullSpaceRemove(nsp, xKSP);
+  VecNorm(xKSP, NORM_2, &norm);
+  VecAXPY(xMixed, -1.0, xKSP);
+  VecNorm(xMixed, NORM_2, &differenceNorm);
+
+  KSPDestroy(&ksp);
+  MatNullSpaceDestroy(&nsp);
+  VecDestroy(&exact);
+  VecDestroy(&b);
+  VecDestroy(&xMixed);
+  VecDestroy(&xKSP);
+  solver->finalize();
+  PetscOptionsClearValue(NULL, "-poisson_mixed_krylov");
+
+  return differenceNorm/norm;
+}
+
+// single-precision conjugate gradient within an iterative refinement
+TEST(MixedPrecisionTest, SingleKrylov)
+{
+  EXPECT_LT(compareWithKSP("MixedPrecision/cases/cavity", "single"), 1.0E-06);
+}
+
+// double-precision flexible conjugate gradient, one single-precision V-cycle per iteration
+TEST(MixedPrecisionTest, DoubleKrylov)
+{
+  EXPECT_LT(compareWithKSP("MixedPrecision/cases/cavity", "double"), 1.0E-06);
+}
+
+
+int main(int argc, char **argv)
+{
+  PetscErrorCode ierr, result;
+
+  ::testing::InitGoogleTest(&argc, argv);
+  ierr = PetscInitialize(&argc, &argv, NULL, NULL); CHKERRQ(ierr);
+  result = RUN_ALL_TESTS();
+  ierr = PetscFinalize(); CHKERRQ(ierr);
+
+  return result;
+}
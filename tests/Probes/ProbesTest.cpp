@@ -0,0 +1,111 @@
+/***************************************************************************//**
+ * \file ProbesTest.cpp
+ * \brief Unit-tests for the class `Probes`: a probe placed on grid nodes
+ *        returns the values of the field at these nodes.
+ */
+
+
+#include "Probes.h"
+#include "gtest/gtest.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+/**
+ * \brief Reads the values of the first sample of a probe (after the time-step
+ *        index and the time).
+ */
+std::vector<PetscReal> readSample(std::string filePath)
+{
+  std::vector<PetscReal> values;
+  std::ifstream file(filePath.c_str());
+  std::string line, value;
+  std::getline(file, line);  // header
+  std::getline(file, line);
+  std::stringstream ss(line);
+  for (PetscInt i=0; std::getline(ss, value, ','); i++)
+  {
+    if (i >= 2)
+      values.push_back(std::stod(value));
+  }
+  return values;
+}
+
+
+// stations of the nodes: stretched along x, uniform along y
+static PetscReal xNode(PetscInt i) { return 0.25*i + 0.125*i*i; }
+static PetscReal yNode(PetscInt j) { return -1.0 + 0.5*j; }
+// value of the field at a node
+static PetscReal value(PetscInt i, PetscInt j) { return 10.0*i + j*j; }
+
+
+TEST(ProbesTest, NodesReturnFieldValues)
+{
+  const PetscInt M = 11, N = 9;
+  DM da;
+  Vec phi, scale;
+  std::vector<PetscReal> stations[3];
+
+  DMDACreate2d(PETSC_COMM_WORLD, DM_BOUNDARY_NONE, DM_BOUNDARY_NONE, DMDA_STENCIL_BOX,
+               M, N, PETSC_DECIDE, PETSC_DECIDE, 1, 1, NULL, NULL, &da);
+  DMCreateGlobalVector(da, &phi);
+  VecDuplicate(phi, &scale);
+  VecSet(scale, 0.5);
+  PetscInt xs, ys, m, n;
+  PetscReal **a;
+  DMDAGetCorners(da, &xs, &ys, NULL, &m, &n, NULL);
+  DMDAVecGetArray(da, phi, &a);
+  for (PetscInt j=ys; j<ys+n; j++)
+    for (PetscInt i=xs; i<xs+m; i++)
+      a[j][i] = value(i, j);
+  DMDAVecRestoreArray(da, phi, &a);
+  for (PetscInt i=0; i<M; i++)
+    stations[0].push_back(xNode(i));
+  for (PetscInt j=0; j<N; j++)
+    stations[1].push_back(yNode(j));
+
+  // the same field, unscaled and scaled by a vector destroyed after initialize
+  Probes probes;
+  probes.addField("phi", "pressure", da, stations, PETSC_NULL);
+  probes.addField("phiHalf", "pressure", da, stations, scale);
+  probes.initialize("Probes/cases/probes.yaml", "Probes/data", 0, 1);
+  VecDestroy(&scale);
+  std::vector<Vec> vecs(2, phi);
+  probes.sample(0, 0.0, vecs);
+  probes.flush();
+  MPI_Barrier(PETSC_COMM_WORLD);
+
+  // point probe on the node (3, 5)
+  std::vector<PetscReal> values = readSample("Probes/data/probes/node.csv");
+  ASSERT_EQ((size_t) 2, values.size());
+  EXPECT_DOUBLE_EQ(value(3, 5), values[0]);
+  EXPECT_DOUBLE_EQ(0.5*value(3, 5), values[1]);
+
+  // line probe through the nodes (1, 2) to (1, 6)
+  values = readSample("Probes/data/probes/nodes.csv");
+  ASSERT_EQ((size_t) 10, values.size());
+  for (PetscInt p=0; p<5; p++)
+  {
+    EXPECT_DOUBLE_EQ(value(1, 2+p), values[2*p]);
+    EXPECT_DOUBLE_EQ(0.5*value(1, 2+p), values[2*p+1]);
+  }
+
+  VecDestroy(&phi);
+  DMDestroy(&da);
+}
+
+
+int main(int argc, char **argv)
+{
+  PetscErrorCode ierr, result;
+
+  ::testing::InitGoogleTest(&argc, argv);
+  ierr = PetscInitialize(&argc, &argv, NULL, NULL); CHKERRQ(ierr);
+  result = RUN_ALL_TESTS();
+  ierr = PetscFinalize(); CHKERRQ(ierr);
+
+  return result;
+}
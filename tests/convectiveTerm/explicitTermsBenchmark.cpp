@@ -0,0 +1,417 @@
+/***************************************************************************//**
+ * \file explicitTermsBenchmark.cpp
+ * \brief Measures the throughput (points per second) of the kernel computing
+ *        the explicit terms of the momentum equation, and of the reference
+ *        kernel it replaced (one loop over all points with the general
+ *        formulas).
+ */
+
+
+#include "ConvectiveTerm.h"
+#include <navierStokes/NavierStokesSolver.h>
+#include <CartesianMesh.h>
+#include <FlowDescription.h>
+#include <SimulationParameters.h>
+
+#include <memory>
+
+#include <petscksp.h>
+#include <petsctime.h>
+
+#ifndef DIMENSIONS
+#define DIMENSIONS 3
+#endif
+
+
+/**
+ * \brief Calculates the second derivative on a non-uniform grid using a central
+ *        difference scheme.
+ */
+static inline PetscReal d2udx2(PetscReal uMinus, PetscReal uCenter, PetscReal uPlus,
+                               PetscReal dxMinus, PetscReal dxPlus)
+{
+  return (dxPlus*uMinus + dxMinus*uPlus - (dxPlus+dxMinus)*uCenter)*2.0/dxMinus/dxPlus/(dxMinus+dxPlus);
+} // d2udx2
+
+
+/**
+ * \brief Reference kernel: calculates the explicit terms as
+ *        `NavierStokesSolver<3>::calculateExplicitTerms` did before the split
+ *        into interior loops and boundary strips (one loop over all points,
+ *        with the boundary tests and the divisions in the loop body).
+ *
+ * \param solver Solver providing the grid, the fluxes and the convective terms
+ * \param r The vector in which the explicit terms are stored
+ * \param scaleByMHat Multiplies the explicit terms by \f$ \hat{M} \f$ if `PETSC_TRUE`
+ */
+PetscErrorCode referenceExplicitTerms(NavierStokesSolver<3> *solver, Vec r, PetscBool scaleByMHat)
+{
+  PetscErrorCode ierr;
+
+  PetscInt i, j, k,                // loop indices
+           M, N, P,                // global number of nodes along each direction
+           m, n, p,                // local number of nodes along each direction
+           mstart, nstart, pstart; // starting indices
+
+  PetscReal HnMinus1; // convection term at previous time-step
+  PetscReal u_W, u_P, u_E, u_S, u_N, u_B, u_F, // West, Point, East, South, North, Back, Front x-velocities
+            v_W, v_P, v_E, v_S, v_N, v_B, v_F, // West, Point, East, South, North, Back, Front y-velocities
+            w_W, w_P, w_E, w_S, w_N, w_B, w_F, // West, Point, East, South, North, Back, Front z-velocities
+            u_w, u_e, u_s, u_n, u_b, u_f, // interpolated x-velocities
+            v_w, v_e, v_s, v_n, v_b, v_f, // interpolated y-velocities
+            w_w, w_e, w_s, w_n, w_b, w_f; // interpolated z-velocities
+  PetscReal convectionTerm, // value of convection term
+            diffusionTerm;  // value of diffusion term
+
+  PetscReal *dx = &solver->mesh->dx[0],
+            *dy = &solver->mesh->dy[0],
+            *dz = &solver->mesh->dz[0];
+  PetscInt nx = solver->mesh->nx, 
+           ny = solver->mesh->ny, 
+           nz = solver->mesh->nz;
+
+  PetscReal nu = solver->flow->nu, // viscosity
+            dt = solver->parameters->dt, // time-increment
+            alpha = solver->parameters->diffusion.coefficients[1],  // explicit (n) diffusion coefficient
+            gamma = solver->parameters->convection.coefficients[1], // explicit (n) convection coefficient
+            zeta  = solver->parameters->convection.coefficients[2]; // explicit (n-1) convection coefficient
+
+  PetscReal dxMinus, dxPlus, dyMinus, dyPlus, dzMinus, dzPlus;
+
+  PetscBool periodicX = (solver->flow->boundaries[XMINUS][0].type == PERIODIC) ? PETSC_TRUE : PETSC_FALSE,
+            periodicY = (solver->flow->boundaries[YMINUS][0].type == PERIODIC) ? PETSC_TRUE : PETSC_FALSE,
+            periodicZ = (solver->flow->boundaries[ZMINUS][0].type == PERIODIC) ? PETSC_TRUE : PETSC_FALSE;
+
+  Vec HxGlobal, HyGlobal, HzGlobal;  
+  ierr = DMCompositeGetAccess(solver->qPack, solver->H,  &HxGlobal, &HyGlobal, &HzGlobal); CHKERRQ(ierr);
+  Vec rxGlobal, ryGlobal, rzGlobal;
+  ierr = DMCompositeGetAccess(solver->qPack, r, &rxGlobal, &ryGlobal, &rzGlobal); CHKERRQ(ierr);
+  
+  // access local vectors through multi-dimensional pointers
+  PetscReal ***qx, ***qy, ***qz;
+  ierr = DMDAVecGetArray(solver->uda, solver->qxLocal, &qx); CHKERRQ(ierr);
+  ierr = DMDAVecGetArray(solver->vda, solver->qyLocal, &qy); CHKERRQ(ierr);
+  ierr = DMDAVecGetArray(solver->wda, solver->qzLocal, &qz); CHKERRQ(ierr);
+  
+  // compute explicit terms: x-component
+  PetscReal ***Hx, ***rx;
+  ierr = DMDAVecGetArray(solver->uda, HxGlobal, &Hx); CHKERRQ(ierr);
+  ierr = DMDAVecGetArray(solver->uda, rxGlobal, &rx); CHKERRQ(ierr);
+  ierr = DMDAGetCorners(solver->uda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
+  ierr = DMDAGetInfo(solver->uda, NULL, &M, &N, &P, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
+  for (k=pstart; k<pstart+p; k++)
+  {
+    for (j=nstart; j<nstart+n; j++)
+    {
+      for (i=mstart; i<mstart+m; i++)
+      {
+        // velocity value at nodes
+        u_P = qx[k][j][i]/(dy[j]*dz[k]);
+        u_W = qx[k][j][i-1]/(dy[j]*dz[k]);
+        u_E = qx[k][j][i+1]/(dy[j]*dz[k]);
+        u_S = (j > 0)   ? qx[k][j-1][i]/(dy[j-1]*dz[k]) : (periodicY) ? qx[k][j-1][i]/(dy[ny-1]*dz[k]) : qx[k][j-1][i];
+        u_N = (j < N-1) ? qx[k][j+1][i]/(dy[j+1]*dz[k]) : (periodicY) ? qx[k][j+1][i]/(dy[0]*dz[k])    : qx[k][j+1][i];
+        u_B = (k > 0)   ? qx[k-1][j][i]/(dy[j]*dz[k-1]) : (periodicZ) ? qx[k-1][j][i]/(dy[j]*dz[nz-1]) : qx[k-1][j][i];
+        u_F = (k < P-1) ? qx[k+1][j][i]/(dy[j]*dz[k+1]) : (periodicZ) ? qx[k+1][j][i]/(dy[j]*dz[0])    : qx[k+1][j][i];
+        // interpolated velocity values
+        u_w = 0.5*(u_W + u_P);
+        u_e = 0.5*(u_P + u_E);
+        u_s = (j == 0 && !periodicY)   ? u_S : 0.5*(u_S + u_P);
+        u_n = (j == N-1 && !periodicY) ? u_N : 0.5*(u_P + u_N);
+        u_b = (k == 0 && !periodicZ)   ? u_B : 0.5*(u_B + u_P);
+        u_f = (k == P-1 && !periodicZ) ? u_F : 0.5*(u_P + u_F);
+        dxMinus = dx[i];
+        dxPlus = (i == M-1 && periodicX) ? dx[0] : dx[i+1];
+        v_s = 0.5*(qy[k][j-1][i]/(dxMinus*dz[k]) + qy[k][j-1][i+1]/(dxPlus*dz[k]));
+        v_n = 0.5*(qy[k][j][i]/(dxMinus*dz[k])   + qy[k][j][i+1]/(dxPlus*dz[k]));
+        w_b = 0.5*(qz[k-1][j][i]/(dxMinus*dy[j]) + qz[k-1][j][i+1]/(dxPlus*dy[j]));
+        w_f = 0.5*(qz[k][j][i]/(dxMinus*dy[j])   + qz[k][j][i+1]/(dxPlus*dy[j]));
+        // convection term: Hx = d(u^2)/dx + d(uv)/dy + d(uw)/dz
+        HnMinus1 = Hx[k][j][i];
+        Hx[k][j][i] = (  (u_e*u_e - u_w*u_w)/(0.5*(dxMinus + dxPlus)) 
+                       + (v_n*u_n - v_s*u_s)/dy[j]
+                       + (w_f*u_f - w_b*u_b)/dz[k] );
+        convectionTerm = gamma*Hx[k][j][i] + zeta*HnMinus1;
+        // diffusion term: d^2u/dx^2 + d^2u/dy^2 + d^2u/dz^2
+        dyMinus = (j > 0)  ? 0.5*(dy[j-1] + dy[j]) : (periodicY) ? 0.5*(dy[ny-1] + dy[j]) : 0.5*dy[j];
+        dyPlus = (j < N-1) ? 0.5*(dy[j] + dy[j+1]) : (periodicY) ? 0.5*(dy[j] + dy[0])    : 0.5*dy[j];
+        dzMinus = (k > 0)  ? 0.5*(dz[k-1] + dz[k]) : (periodicZ) ? 0.5*(dz[nz-1] + dz[k]) : 0.5*dz[k];
+        dzPlus = (k < P-1) ? 0.5*(dz[k] + dz[k+1]) : (periodicZ) ? 0.5*(dz[k] + dz[0])    : 0.5*dz[k];
+        diffusionTerm = alpha*nu * (  d2udx2(u_W, u_P, u_E, dxMinus, dxPlus)
+                                    + d2udx2(u_S, u_P, u_N, dyMinus, dyPlus)
+                                    + d2udx2(u_B, u_P, u_F, dzMinus, dzPlus) );
+        // explicit term
+        rx[k][j][i] = u_P/dt - convectionTerm + diffusionTerm;
+        if (scaleByMHat)
+          rx[k][j][i] *= 0.5*(dxMinus + dxPlus);
+      }
+    }
+  }
+  ierr = DMDAVecRestoreArray(solver->uda, HxGlobal, &Hx); CHKERRQ(ierr);
+  ierr = DMDAVecRestoreArray(solver->uda, rxGlobal, &rx); CHKERRQ(ierr);
+
+  // y-component
+  PetscReal ***Hy, ***ry;
+  ierr = DMDAVecGetArray(solver->vda, HyGlobal, &Hy); CHKERRQ(ierr);
+  ierr = DMDAVecGetArray(solver->vda, ryGlobal, &ry); CHKERRQ(ierr);
+  ierr = DMDAGetCorners(solver->vda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
+  ierr = DMDAGetInfo(solver->vda, NULL, &M, &N, &P, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
+  for (k=pstart; k<pstart+p; k++)
+  {
+    for (j=nstart; j<nstart+n; j++)
+    {
+      for (i=mstart; i<mstart+m; i++)
+      {
+        // velocity value at nodes
+        v_P = qy[k][j][i]/(dx[i]*dz[k]);
+        v_W = (i > 0)   ? qy[k][j][i-1]/(dx[i-1]*dz[k]) : (periodicX) ? qy[k][j][i-1]/(dx[nx-1]*dz[k]) : qy[k][j][i-1];
+        v_E = (i < M-1) ? qy[k][j][i+1]/(dx[i+1]*dz[k]) : (periodicX) ? qy[k][j][i+1]/(dx[0]*dz[k])    : qy[k][j][i+1];
+        v_S = qy[k][j-1][i]/(dx[i]*dz[k]);
+        v_N = qy[k][j+1][i]/(dx[i]*dz[k]);
+        v_B = (k > 0)   ? qy[k-1][j][i]/(dx[i]*dz[k-1]) : (periodicZ) ? qy[k-1][j][i]/(dx[i]*dz[nz-1]) : qy[k-1][j][i];
+        v_F = (k < P-1) ? qy[k+1][j][i]/(dx[i]*dz[k+1]) : (periodicZ) ? qy[k+1][j][i]/(dx[i]*dz[0])    : qy[k+1][j][i];
+        // interpolated velocity values
+        v_w = (i == 0 && !periodicX)   ? v_W : 0.5*(v_W + v_P);
+        v_e = (i == M-1 && !periodicX) ? v_E : 0.5*(v_P + v_E);
+        v_s = 0.5*(v_S + v_P);
+        v_n = 0.5*(v_P + v_N);
+        v_b = (k == 0 && !periodicZ)   ? v_B : 0.5*(v_B + v_P);
+        v_f = (k == P-1 && !periodicZ) ? v_F : 0.5*(v_P + v_F);
+        dyMinus = dy[j];
+        dyPlus = (j == N-1 && periodicY) ? dy[0] : dy[j+1];
+        u_w = 0.5*(qx[k][j][i-1]/(dyMinus*dz[k]) + qx[k][j+1][i-1]/(dyPlus*dz[k]));
+        u_e = 0.5*(qx[k][j][i]/(dyMinus*dz[k]) + qx[k][j+1][i]/(dyPlus*dz[k]));
+        w_b = 0.5*(qz[k-1][j][i]/(dx[i]*dyMinus) + qz[k-1][j+1][i]/(dx[i]*dyPlus));
+        w_f = 0.5*(qz[k][j][i]/(dx[i]*dyMinus) + qz[k][j+1][i]/(dx[i]*dyPlus));
+        // convection term: Hy = d(vu)/dx + d(v^2)/dy + d(vw)/dz
+        HnMinus1 = Hy[k][j][i];
+        Hy[k][j][i] = (  (u_e*v_e - u_w*v_w)/dx[i] 
+                       + (v_n*v_n - v_s*v_s)/(0.5*(dyMinus + dyPlus))
+                       + (w_f*v_f - w_b*v_b)/dz[k] );
+        convectionTerm = gamma*Hy[k][j][i] + zeta*HnMinus1;
+        // diffusion term: d^2v/dx^2 + d^2v/dy^2 + d^2v/dz^2
+        dxMinus = (i > 0)  ? 0.5*(dx[i-1] + dx[i]) : (periodicX) ? 0.5*(dx[nx-1] + dx[i]) : 0.5*dx[i];
+        dxPlus = (i < M-1) ? 0.5*(dx[i] + dx[i+1]) : (periodicX) ? 0.5*(dx[i] + dx[0])    : 0.5*dx[i];
+        dzMinus = (k > 0)  ? 0.5*(dz[k-1] + dz[k]) : (periodicZ) ? 0.5*(dz[nz-1] + dz[k]) : 0.5*dz[k];
+        dzPlus = (k < P-1) ? 0.5*(dz[k] + dz[k+1]) : (periodicZ) ? 0.5*(dz[k] + dz[0])    : 0.5*dz[k];
+        diffusionTerm = alpha*nu * (  d2udx2(v_W, v_P, v_E, dxMinus, dxPlus)
+                                    + d2udx2(v_S, v_P, v_N, dyMinus, dyPlus)
+                                    + d2udx2(v_B, v_P, v_F, dzMinus, dzPlus) );
+        // explicit term
+        ry[k][j][i] = v_P/dt - convectionTerm + diffusionTerm;
+        if (scaleByMHat)
+          ry[k][j][i] *= 0.5*(dyMinus + dyPlus);
+      }
+    }
+  }
+  ierr = DMDAVecRestoreArray(solver->vda, HyGlobal, &Hy); CHKERRQ(ierr);
+  ierr = DMDAVecRestoreArray(solver->vda, ryGlobal, &ry); CHKERRQ(ierr);
+
+  // z-component
+  PetscReal ***Hz, ***rz;
+  ierr = DMDAVecGetArray(solver->wda, HzGlobal, &Hz); CHKERRQ(ierr);
+  ierr = DMDAVecGetArray(solver->wda, rzGlobal, &rz); CHKERRQ(ierr);
+  ierr = DMDAGetCorners(solver->wda, &mstart, &nstart, &pstart, &m, &n, &p); CHKERRQ(ierr);
+  ierr = DMDAGetInfo(solver->wda, NULL, &M, &N, &P, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL); CHKERRQ(ierr);
+  for (k=pstart; k<pstart+p; k++)
+  {
+    for (j=nstart; j<nstart+n; j++)
+    {
+      for (i=mstart; i<mstart+m; i++)
+      {
+        // velocity value at nodes
+        w_P = qz[k][j][i]/(dx[i]*dy[j]);
+        w_W = (i > 0)   ? qz[k][j][i-1]/(dx[i-1]*dy[j]) : (periodicX) ? qz[k][j][i-1]/(dx[nx-1]*dy[j]) : qz[k][j][i-1];
+        w_E = (i < M-1) ? qz[k][j][i+1]/(dx[i+1]*dy[j]) : (periodicX) ? qz[k][j][i+1]/(dx[0]*dy[j])    : qz[k][j][i+1];
+        w_S = (j > 0)   ? qz[k][j-1][i]/(dx[i]*dy[j-1]) : (periodicY) ? qz[k][j-1][i]/(dx[i]*dy[ny-1]) : qz[k][j-1][i];
+        w_N = (j < N-1) ? qz[k][j+1][i]/(dx[i]*dy[j+1]) : (periodicY) ? qz[k][j+1][i]/(dx[i]*dy[0])    : qz[k][j+1][i];
+        w_B = qz[k-1][j][i]/(dx[i]*dy[j]);
+        w_F = qz[k+1][j][i]/(dx[i]*dy[j]);
+        // interpolated velocity values
+        w_w = (i == 0 && !periodicX)   ? w_W : 0.5*(w_W + w_P);
+        w_e = (i == M-1 && !periodicX) ? w_E : 0.5*(w_P + w_E);
+        w_s = (j == 0 && !periodicY)   ? w_S : 0.5*(w_S + w_P);
+        w_n = (j == N-1 && !periodicY) ? w_N : 0.5*(w_P + w_N);
+        w_b = 0.5*(w_B + w_P);
+        w_f = 0.5*(w_P + w_F);
+        dzMinus = dz[k];
+        dzPlus = (k == P-1 && periodicZ) ? dz[0] : dz[k+1];
+        u_w = 0.5*(qx[k][j][i-1]/(dy[j]*dzMinus) + qx[k+1][j][i-1]/(dy[j]*dzPlus));
+        u_e = 0.5*(qx[k][j][i]/(dy[j]*dzMinus) + qx[k+1][j][i]/(dy[j]*dzPlus));
+        v_s = 0.5*(qy[k][j-1][i]/(dx[i]*dzMinus) + qy[k+1][j-1][i]/(dx[i]*dzPlus));
+        v_n = 0.5*(qy[k][j][i]/(dx[i]*dzMinus) + qy[k+1][j][i]/(dx[i]*dzPlus));
+        // convection term: Hz = d(wu)/dx + d(wv)/dy + d(w^2)/dz
+        HnMinus1 = Hz[k][j][i];
+        Hz[k][j][i] = (  (u_e*w_e - u_w*w_w)/dx[i] 
+                       + (v_n*w_n - v_s*w_s)/dy[j]
+                       + (w_f*w_f - w_b*w_b)/(0.5*(dzMinus + dzPlus)) );
+        convectionTerm = gamma*Hz[k][j][i] + zeta*HnMinus1;
+        // diffusion term: d^2w/dx^2 + d^2w/dy^2 + d^2w/dz^2
+        dxMinus = (i > 0)  ? 0.5*(dx[i-1] + dx[i]) : (periodicX) ? 0.5*(dx[nx-1] + dx[i]) : 0.5*dx[i];
+        dxPlus = (i < M-1) ? 0.5*(dx[i] + dx[i+1]) : (periodicX) ? 0.5*(dx[i] + dx[0])    : 0.5*dx[i];
+        dyMinus = (j > 0)  ? 0.5*(dy[j-1] + dy[j]) : (periodicY) ? 0.5*(dy[ny-1] + dy[j]) : 0.5*dy[j];
+        dyPlus = (j < N-1) ? 0.5*(dy[j] + dy[j+1]) : (periodicY) ? 0.5*(dy[j] + dy[0])    : 0.5*dy[j];
+        diffusionTerm = alpha*nu * (  d2udx2(w_W, w_P, w_E, dxMinus, dxPlus)
+                                    + d2udx2(w_S, w_P, w_N, dyMinus, dyPlus)
+                                    + d2udx2(w_B, w_P, w_F, dzMinus, dzPlus) );
+        // explicit term
+        rz[k][j][i] = w_P/dt - convectionTerm + diffusionTerm;
+        if (scaleByMHat)
+          rz[k][j][i] *= 0.5*(dzMinus + dzPlus);
+      }
+    }
+  }
+  ierr = DMDAVecRestoreArray(solver->wda, HzGlobal, &Hz); CHKERRQ(ierr);
+  ierr = DMDAVecRestoreArray(solver->wda, rzGlobal, &rz); CHKERRQ(ierr);
+  
+  ierr = DMDAVecRestoreArray(solver->uda, solver->qxLocal, &qx); CHKERRQ(ierr);
+  ierr = DMDAVecRestoreArray(solver->vda, solver->qyLocal, &qy); CHKERRQ(ierr);
+  ierr = DMDAVecRestoreArray(solver->wda, solver->qzLocal, &qz); CHKERRQ(ierr);
+  
+  ierr = DMCompositeRestoreAccess(solver->qPack, solver->H,  &HxGlobal, &HyGlobal, &HzGlobal); CHKERRQ(ierr);
+  ierr = DMCompositeRestoreAccess(solver->qPack, r, &rxGlobal, &ryGlobal, &rzGlobal); CHKERRQ(ierr);
+
+  return 0;
+} // referenceExplicitTerms
+
+
+/**
+ * \brief Times a kernel; the slowest process sets the time of each repetition.
+ *
+ * \param solver Solver whose explicit terms are computed
+ * \param reference Times the reference kernel if `PETSC_TRUE`
+ * \param numRepetitions Number of timed repetitions (after one warm-up call)
+ * \param best Returns the best time of a repetition
+ * \param mean Returns the mean time of a repetition
+ */
+PetscErrorCode timeKernel(ConvectiveTerm<3> *solver, PetscBool reference, PetscInt numRepetitions,
+                          PetscLogDouble &best, PetscLogDouble &mean)
+{
+  PetscErrorCode ierr;
+
+  PetscLogDouble start, end, elapsed, total = 0.0;
+  best = PETSC_MAX_REAL;
+  for (PetscInt r=-1; r<numRepetitions; r++)
+  {
+    ierr = MPI_Barrier(PETSC_COMM_WORLD); CHKERRQ(ierr);
+    ierr = PetscTime(&start); CHKERRQ(ierr);
+    if (reference)
+    {
+      ierr = referenceExplicitTerms(solver, solver->rn, PETSC_FALSE); CHKERRQ(ierr);
+    }
+    else
+    {
+      ierr = solver->calculateExplicitTerms(solver->rn, PETSC_FALSE); CHKERRQ(ierr);
+    }
+    ierr = PetscTime(&end); CHKERRQ(ierr);
+    elapsed = end - start;
+    ierr = MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX, PETSC_COMM_WORLD); CHKERRQ(ierr);
+    // the first call is a warm-up
+    if (r < 0)
+      continue;
+    best = PetscMin(best, elapsed);
+    total += elapsed;
+  }
+  mean = total/numRepetitions;
+
+  return 0;
+} // timeKernel
+
+
+/**
+ * \brief Computes the largest difference between the explicit terms of the
+ *        kernel and of the reference kernel, relative to the largest value,
+ *        from the same convective terms of the previous time-step.
+ */
+PetscErrorCode compareKernels(ConvectiveTerm<3> *solver, PetscReal &difference)
+{
+  PetscErrorCode ierr;
+
+  Vec H0, rReference;
+  PetscReal maxValue;
+  ierr = VecDuplicate(solver->H, &H0); CHKERRQ(ierr);
+  ierr = VecCopy(solver->H, H0); CHKERRQ(ierr);
+  ierr = VecDuplicate(solver->rn, &rReference); CHKERRQ(ierr);
+
+  ierr = solver->calculateExplicitTerms(solver->rn, PETSC_FALSE); CHKERRQ(ierr);
+  ierr = VecCopy(H0, solver->H); CHKERRQ(ierr);
+  ierr = referenceExplicitTerms(solver, rReference, PETSC_FALSE); CHKERRQ(ierr);
+
+  ierr = VecNorm(rReference, NORM_INFINITY, &maxValue); CHKERRQ(ierr);
+  ierr = VecAXPY(rReference, -1.0, solver->rn); CHKERRQ(ierr);
+  ierr = VecNorm(rReference, NORM_INFINITY, &difference); CHKERRQ(ierr);
+  if (maxValue > 0.0)
+    difference /= maxValue;
+
+  ierr = VecDestroy(&H0); CHKERRQ(ierr);
+  ierr = VecDestroy(&rReference); CHKERRQ(ierr);
+
+  return 0;
+} // compareKernels
+
+
+int main(int argc, char **argv)
+{
+  PetscErrorCode ierr;
+
+  const PetscInt dim = DIMENSIONS;
+
+  ierr = PetscInitialize(&argc, &argv, NULL, NULL); CHKERRQ(ierr);
+
+  char dir[PETSC_MAX_PATH_LEN];
+  ierr = PetscOptionsGetString(NULL, NULL, "-directory", dir, sizeof(dir), NULL); CHKERRQ(ierr);
+  std::string directory(dir);
+  PetscInt numRepetitions = 100;
+  ierr = PetscOptionsGetInt(NULL, NULL, "-repetitions", &numRepetitions, NULL); CHKERRQ(ierr);
+  // kernels timed: the current one, the reference one, or both (default)
+  const char *kernels[] = {"fused", "reference", "both"};
+  PetscInt kernel = 2;
+  ierr = PetscOptionsGetEList(NULL, NULL, "-kernel", kernels, 3, &kernel, NULL); CHKERRQ(ierr);
+  if (numRepetitions < 1)
+  {
+    SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_ARG_OUTOFRANGE, "the number of repetitions must be positive");
+  }
+
+  CartesianMesh cartesianMesh(directory+"/cartesianMesh.yaml");
+  FlowDescription<dim> flowDescription(directory+"/flowDescription.yaml");
+  SimulationParameters simulationParameters(directory, directory+"/simulationParameters.yaml");
+
+  // the sinusoidal fluxes of the convective-term test give non-trivial values
+  std::unique_ptr< ConvectiveTerm<dim> > solver(new ConvectiveTerm<dim>(&cartesianMesh, 
+                                                                        &flowDescription, 
+                                                                        &simulationParameters));
+
+  ierr = solver->initialize(); CHKERRQ(ierr);
+
+  PetscInt numPoints;
+  ierr = VecGetSize(solver->rn, &numPoints); CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD, "explicit terms: %D points, %D repetitions\n", numPoints, numRepetitions); CHKERRQ(ierr);
+
+  if (kernel == 2)
+  {
+    PetscReal difference;
+    ierr = compareKernels(solver.get(), difference); CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD, "largest relative difference with the reference kernel: %e\n", difference); CHKERRQ(ierr);
+  }
+
+  PetscLogDouble best[2], mean[2];
+  for (PetscInt k=0; k<2; k++)
+  {
+    if (kernel != 2 && kernel != k)
+      continue;
+    ierr = timeKernel(solver.get(), (k == 1) ? PETSC_TRUE : PETSC_FALSE, numRepetitions, best[k], mean[k]); CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD, "%s kernel:\n", kernels[k]); CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD, "  best: %e s (%e points/s)\n", best[k], numPoints/best[k]); CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD, "  mean: %e s (%e points/s)\n", mean[k], numPoints/mean[k]); CHKERRQ(ierr);
+  }
+  if (kernel == 2)
+  {
+    ierr = PetscPrintf(PETSC_COMM_WORLD, "speed-up (best times): %.2f\n", best[1]/best[0]); CHKERRQ(ierr);
+  }
+
+  ierr = solver->finalize(); CHKERRQ(ierr);
+
+  ierr = PetscFinalize(); CHKERRQ(ierr);
+
+  return ierr;
+} // main